@@ -0,0 +1,1040 @@
+// Host benchmarks for the S.A.M C++ core (cpp/HybridSideFx.hpp)
+//
+// Storage sits on the stand-ins in ./host, so these numbers track S.A.M's own
+// overhead: listener matching, dispatch, JSON serialization and locking.
+// Compare runs with Google Benchmark's tools/compare.py on the JSON output.
+
+#include "HybridSideFx.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace margelo::nitro::sam;
+using SqlParams = std::vector<std::variant<margelo::nitro::NullType, bool, std::string, double>>;
+
+namespace {
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+std::shared_ptr<HybridSideFx> makeSideFx(const std::string& warmInstance = "default") {
+  auto sideFx = std::make_shared<HybridSideFx>();
+  sideFx->setWarmRootPath("/tmp/sam-bench");
+  sideFx->initializeWarm(warmInstance, std::nullopt);
+  return sideFx;
+}
+
+ListenerConfig warmKeysListener(std::vector<std::string> keys, const std::string& instanceId = "default") {
+  WarmListenerConfig warm;
+  warm.keys = std::move(keys);
+  warm.instanceId = instanceId;
+  return ListenerConfig(warm, std::nullopt, std::nullopt, std::nullopt);
+}
+
+ListenerConfig warmPatternListener(const std::string& pattern, const std::string& instanceId = "default") {
+  WarmListenerConfig warm;
+  warm.patterns = std::vector<std::string>{pattern};
+  warm.instanceId = instanceId;
+  return ListenerConfig(warm, std::nullopt, std::nullopt, std::nullopt);
+}
+
+/**
+ * Register `count` listeners on keys that benchmark writes never touch, so
+ * they cost matching time but produce no events
+ */
+void addIdleListeners(HybridSideFx& sideFx, int64_t count) {
+  for (int64_t i = 0; i < count; ++i) {
+    sideFx.addListener("idle-" + std::to_string(i), warmKeysListener({"idle.key." + std::to_string(i)}));
+  }
+}
+
+std::vector<std::string> makeKeys(const std::string& prefix, size_t count) {
+  std::vector<std::string> keys;
+  keys.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    keys.push_back(prefix + std::to_string(i));
+  }
+  return keys;
+}
+
+double percentile(std::vector<double>& samples, double p) {
+  if (samples.empty()) {
+    return 0;
+  }
+  size_t index = std::min(samples.size() - 1, static_cast<size_t>(p * static_cast<double>(samples.size())));
+  std::nth_element(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(index), samples.end());
+  return samples[index];
+}
+
+void reportPercentiles(benchmark::State& state, std::vector<double>& samplesUs) {
+  state.counters["p50_us"] = percentile(samplesUs, 0.50);
+  state.counters["p95_us"] = percentile(samplesUs, 0.95);
+  state.counters["p99_us"] = percentile(samplesUs, 0.99);
+  state.counters["max_us"] = percentile(samplesUs, 1.0);
+}
+
+// ============================================================================
+// Warm
+// ============================================================================
+
+/**
+ * setWarm throughput. Arg = listeners registered (0 skips capture entirely;
+ * otherwise one pattern listener matches every write and the rest are idle).
+ */
+void BM_SetWarm(benchmark::State& state) {
+  auto sideFx = makeSideFx();
+  if (state.range(0) > 0) {
+    sideFx->addListener("match", warmPatternListener("bench.*"));
+    addIdleListeners(*sideFx, state.range(0) - 1);
+  }
+  auto keys = makeKeys("bench.", 1024);
+  std::string value = "{\"id\":42,\"name\":\"value\"}";
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(sideFx->setWarm(keys[i++ & 1023], value, std::nullopt, std::nullopt));
+  }
+  sideFx->waitForDispatch();
+  auto stored = sideFx->getWarm(keys[(i - 1) & 1023], std::nullopt);
+  if (!std::holds_alternative<std::string>(stored) || std::get<std::string>(stored) != value) {
+    state.SkipWithError("setWarm did not store the value");
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SetWarm)->Arg(0)->Arg(1)->Arg(1000)->Arg(10000);
+
+void BM_GetWarm(benchmark::State& state) {
+  auto sideFx = makeSideFx();
+  auto keys = makeKeys("bench.", 1024);
+  for (const auto& key : keys) {
+    sideFx->setWarm(key, std::string(static_cast<size_t>(state.range(0)), 'x'), std::nullopt, std::nullopt);
+  }
+  auto first = sideFx->getWarm(keys[0], std::nullopt);
+  if (!std::holds_alternative<std::string>(first) ||
+      std::get<std::string>(first).size() != static_cast<size_t>(state.range(0))) {
+    state.SkipWithError("getWarm returned the wrong value");
+    return;
+  }
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(sideFx->getWarm(keys[i++ & 1023], std::nullopt));
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GetWarm)->Arg(16)->Arg(4096);
+
+void BM_GetWarmBuffer(benchmark::State& state) {
+  auto sideFx = makeSideFx();
+  auto keys = makeKeys("bench.", 1024);
+  for (const auto& key : keys) {
+    sideFx->setWarm(key, std::string(static_cast<size_t>(state.range(0)), 'x'), std::nullopt, std::nullopt);
+  }
+  auto first = sideFx->getWarmBuffer(keys[0], std::nullopt);
+  if (!std::holds_alternative<std::shared_ptr<margelo::nitro::ArrayBuffer>>(first) ||
+      std::get<std::shared_ptr<margelo::nitro::ArrayBuffer>>(first)->size() != static_cast<size_t>(state.range(0))) {
+    state.SkipWithError("getWarmBuffer returned the wrong value");
+    return;
+  }
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(sideFx->getWarmBuffer(keys[i++ & 1023], std::nullopt));
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GetWarmBuffer)->Arg(16)->Arg(4096);
+
+/**
+ * setWarm + getWarm on a plaintext (Arg 0 = 0) or encrypted (1) instance.
+ * Arg 1 = value bytes. With SAM_HOST_AES the stand-in runs AES-128-CFB over
+ * encrypted values, as MMKV does.
+ */
+void BM_WarmEncryptedRoundTrip(benchmark::State& state) {
+  bool encrypted = state.range(0) != 0;
+  std::string instance = encrypted ? "bench-encrypted" : "default";
+  auto sideFx = makeSideFx();
+  if (encrypted) {
+    sideFx->initializeWarm(instance, WarmConfig(std::string("bench-key-16byte"), std::nullopt));
+  }
+  auto keys = makeKeys("bench.", 1024);
+  std::string value(static_cast<size_t>(state.range(1)), 'x');
+  size_t i = 0;
+  for (auto _ : state) {
+    const std::string& key = keys[i++ & 1023];
+    benchmark::DoNotOptimize(sideFx->setWarm(key, value, instance, std::nullopt));
+    benchmark::DoNotOptimize(sideFx->getWarm(key, instance));
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * state.range(1) * 2);
+}
+BENCHMARK(BM_WarmEncryptedRoundTrip)->ArgsProduct({{0, 1}, {16, 4096}});
+
+/**
+ * Another process's write to a multi-process instance, from the read that
+ * notices it to the listener's event. Arg = keys in the instance, all of
+ * which are diffed against the snapshot.
+ */
+void BM_WarmOuterProcessChange(benchmark::State& state) {
+  std::string instance = "bench-shared-" + std::to_string(state.range(0));
+  auto sideFx = makeSideFx();
+  std::atomic<uint64_t> delivered{0};
+  std::atomic<int64_t> deliveredAtNs{0};
+  sideFx->setChangeEventHandler([&](const std::vector<ChangeEvent>& events) {
+    deliveredAtNs.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+    delivered.fetch_add(events.size(), std::memory_order_release);
+  });
+  // The stand-in instance stands for the other process's view of the file
+  mmkv::MMKV* outer = mmkv::MMKV::mmkvWithID(instance, mmkv::MMKV_MULTI_PROCESS);
+  for (const auto& key : makeKeys("shared.", static_cast<size_t>(state.range(0)))) {
+    outer->set(std::string("{\"v\":0}"), key);
+  }
+  sideFx->initializeWarm(instance, WarmConfig(std::nullopt, true));
+  sideFx->addListener("outer", warmKeysListener({"shared.0"}, instance));
+
+  std::vector<double> samplesUs;
+  double value = 0;
+  for (auto _ : state) {
+    uint64_t expected = delivered.load(std::memory_order_acquire) + 1;
+    outer->set(value++, "shared.0");
+    outer->markChangedByOuterProcess();
+    auto start = std::chrono::steady_clock::now();
+    benchmark::DoNotOptimize(sideFx->getWarm("shared.0", instance));
+    while (delivered.load(std::memory_order_acquire) < expected) {
+      std::this_thread::yield();
+    }
+    auto end = std::chrono::steady_clock::time_point(
+        std::chrono::steady_clock::duration(deliveredAtNs.load(std::memory_order_relaxed)));
+    double elapsed = std::chrono::duration<double>(end - start).count();
+    state.SetIterationTime(elapsed);
+    samplesUs.push_back(elapsed * 1e6);
+  }
+  reportPercentiles(state, samplesUs);
+}
+BENCHMARK(BM_WarmOuterProcessChange)->Arg(100)->Arg(10000)->UseManualTime();
+
+/**
+ * setWarm + getWarm without (Arg 0) or with (1) a TTL on every write. With
+ * a TTL the write also updates the expiry index and stores the deadline.
+ */
+void BM_WarmTtlRoundTrip(benchmark::State& state) {
+  std::string instance = "bench-ttl";
+  auto sideFx = makeSideFx(instance);
+  std::optional<double> ttlMs;
+  if (state.range(0) != 0) {
+    ttlMs = 3600000.0;
+  }
+  auto keys = makeKeys("bench.", 1024);
+  std::string value = "{\"id\":42,\"name\":\"value\"}";
+  size_t i = 0;
+  for (auto _ : state) {
+    const std::string& key = keys[i++ & 1023];
+    benchmark::DoNotOptimize(sideFx->setWarm(key, value, instance, ttlMs));
+    benchmark::DoNotOptimize(sideFx->getWarm(key, instance));
+  }
+  state.SetItemsProcessed(state.iterations());
+  for (const auto& key : keys) {
+    sideFx->deleteWarm(key, instance);
+  }
+}
+BENCHMARK(BM_WarmTtlRoundTrip)->Arg(0)->Arg(1);
+
+/**
+ * Background expiry: from the deadline of Arg keys written with a 1 ms TTL
+ * to the listener receiving the last DELETE. The sweeper works in batches.
+ */
+void BM_WarmExpirySweep(benchmark::State& state) {
+  std::string instance = "bench-expiry";
+  auto sideFx = makeSideFx(instance);
+  std::atomic<uint64_t> deleted{0};
+  sideFx->setChangeEventHandler([&](const std::vector<ChangeEvent>& events) {
+    for (const auto& event : events) {
+      if (event.operation == ChangeOperation::DELETE) {
+        deleted.fetch_add(1, std::memory_order_release);
+      }
+    }
+  });
+  sideFx->addListener("expiry", warmPatternListener("expiring.*", instance));
+  auto keys = makeKeys("expiring.", static_cast<size_t>(state.range(0)));
+  std::string value = "cached";
+  for (auto _ : state) {
+    uint64_t expected = deleted.load(std::memory_order_acquire) + keys.size();
+    for (const auto& key : keys) {
+      sideFx->setWarm(key, value, instance, 1.0);
+    }
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(1);
+    while (deleted.load(std::memory_order_acquire) < expected) {
+      std::this_thread::yield();
+    }
+    auto end = std::chrono::steady_clock::now();
+    state.SetIterationTime(std::max(0.0, std::chrono::duration<double>(end - deadline).count()));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_WarmExpirySweep)->Arg(100)->Arg(10000)->UseManualTime();
+
+// ============================================================================
+// Cold
+// ============================================================================
+
+const std::string kAsyncColdPath = "/tmp/sam-bench-cold-async.db";
+
+/**
+ * `rows` orders in database "bench". File-backed fixtures start from an empty
+ * file; async calls need one, since an in-memory database has no second
+ * connection.
+ */
+std::shared_ptr<HybridSideFx> makeColdFixture(int64_t rows, const std::string& path = ":memory:",
+                                              const std::optional<ColdConfig>& config = std::nullopt) {
+  if (path != ":memory:") {
+    for (const char* suffix : {"", "-wal", "-shm"}) {
+      std::remove((path + suffix).c_str());
+    }
+  }
+  auto sideFx = makeSideFx();
+  sideFx->initializeCold("bench", path, config);
+  sideFx->executeCold(
+      "CREATE TABLE orders (id INTEGER PRIMARY KEY, customer TEXT, total REAL, note TEXT, payload BLOB)",
+      std::nullopt, "bench");
+  sideFx->executeCold("BEGIN", std::nullopt, "bench");
+  for (int64_t i = 0; i < rows; ++i) {
+    sideFx->executeCold(
+        "INSERT INTO orders (customer, total, note, payload) VALUES (?, ?, ?, randomblob(16))",
+        SqlParams{std::string("customer \"") + std::to_string(i % 97) + "\"", static_cast<double>(i) * 1.25,
+                  std::string("line one\nline two")},
+        "bench");
+  }
+  sideFx->executeCold("COMMIT", std::nullopt, "bench");
+  return sideFx;
+}
+
+const std::string kQueryColdPath = "/tmp/sam-bench-cold-query.db";
+
+std::string escapeJsonBaseline(const std::string& str) {
+  std::ostringstream result;
+  for (char c : str) {
+    switch (c) {
+      case '"':  result << "\\\""; break;
+      case '\\': result << "\\\\"; break;
+      case '\b': result << "\\b";  break;
+      case '\f': result << "\\f";  break;
+      case '\n': result << "\\n";  break;
+      case '\r': result << "\\r";  break;
+      case '\t': result << "\\t";  break;
+      default:
+        if ('\x00' <= c && c <= '\x1f') {
+          result << "\\u" << std::hex << std::setfill('0') << std::setw(4) << static_cast<int>(c);
+        } else {
+          result << c;
+        }
+        break;
+    }
+  }
+  return result.str();
+}
+
+/**
+ * queryCold's serializer before JsonWriter (ostringstream, column names
+ * escaped per row, BLOBs as null), kept as the rows/sec baseline
+ */
+std::string queryJsonBaseline(sqlite3* db, const char* sql) {
+  sqlite3_stmt* stmt = nullptr;
+  if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+    return std::string();
+  }
+  std::ostringstream jsonStream;
+  jsonStream << "[";
+  int columnCount = sqlite3_column_count(stmt);
+  bool firstRow = true;
+  while (sqlite3_step(stmt) == SQLITE_ROW) {
+    if (!firstRow) {
+      jsonStream << ",";
+    }
+    firstRow = false;
+    jsonStream << "{";
+    for (int col = 0; col < columnCount; ++col) {
+      if (col > 0) {
+        jsonStream << ",";
+      }
+      const char* colName = sqlite3_column_name(stmt, col);
+      jsonStream << "\"" << escapeJsonBaseline(colName) << "\":";
+      switch (sqlite3_column_type(stmt, col)) {
+        case SQLITE_INTEGER:
+          jsonStream << sqlite3_column_int64(stmt, col);
+          break;
+        case SQLITE_FLOAT:
+          jsonStream << sqlite3_column_double(stmt, col);
+          break;
+        case SQLITE_TEXT: {
+          const char* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, col));
+          jsonStream << "\"" << escapeJsonBaseline(text ? text : "") << "\"";
+          break;
+        }
+        default:
+          jsonStream << "null";
+          break;
+      }
+    }
+    jsonStream << "}";
+  }
+  jsonStream << "]";
+  sqlite3_finalize(stmt);
+  return jsonStream.str();
+}
+
+/**
+ * Rows in a queryCold-style JSON array of orders
+ */
+int64_t countOrderRows(const std::string& json) {
+  int64_t rows = 0;
+  for (size_t at = json.find("{\"id\":"); at != std::string::npos; at = json.find("{\"id\":", at + 1)) {
+    rows++;
+  }
+  return rows;
+}
+
+/**
+ * queryCold rows/sec. Arg = rows returned. Compare with
+ * BM_QueryColdRowsBaseline, which reads the same file.
+ */
+void BM_QueryColdRows(benchmark::State& state) {
+  auto sideFx = makeColdFixture(state.range(0), kQueryColdPath);
+  auto check = sideFx->queryCold("SELECT * FROM orders", std::nullopt, "bench");
+  if (!std::holds_alternative<std::string>(check) || countOrderRows(std::get<std::string>(check)) != state.range(0)) {
+    state.SkipWithError("queryCold returned the wrong rows");
+    return;
+  }
+  size_t bytes = 0;
+  for (auto _ : state) {
+    auto result = sideFx->queryCold("SELECT * FROM orders", std::nullopt, "bench");
+    bytes += std::get<std::string>(result).size();
+    benchmark::DoNotOptimize(result);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+BENCHMARK(BM_QueryColdRows)->Arg(10)->Arg(1000)->Arg(10000)->Arg(100000);
+
+/**
+ * The same query through the pre-JsonWriter serializer, on its own
+ * connection to the fixture file
+ */
+void BM_QueryColdRowsBaseline(benchmark::State& state) {
+  auto sideFx = makeColdFixture(state.range(0), kQueryColdPath);
+  sqlite3* db = nullptr;
+  if (sqlite3_open_v2(kQueryColdPath.c_str(), &db, SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK) {
+    state.SkipWithError("Failed to open the fixture");
+    sqlite3_close(db);
+    return;
+  }
+  if (countOrderRows(queryJsonBaseline(db, "SELECT * FROM orders")) != state.range(0)) {
+    state.SkipWithError("The baseline returned the wrong rows");
+    sqlite3_close(db);
+    return;
+  }
+  size_t bytes = 0;
+  for (auto _ : state) {
+    std::string result = queryJsonBaseline(db, "SELECT * FROM orders");
+    bytes += result.size();
+    benchmark::DoNotOptimize(result);
+  }
+  sqlite3_close(db);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+BENCHMARK(BM_QueryColdRowsBaseline)->Arg(10)->Arg(1000)->Arg(10000)->Arg(100000);
+
+void BM_QueryColdBufferRows(benchmark::State& state) {
+  auto sideFx = makeColdFixture(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(sideFx->queryColdBuffer("SELECT * FROM orders", std::nullopt, "bench"));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_QueryColdBufferRows)->Arg(1000)->Arg(10000);
+
+/**
+ * The 20 newest of 20k messages containing a word that 20 of them contain.
+ * Arg 0 scans with LIKE '%word%' through queryColdBuffer; Arg 1 uses
+ * searchCold ranked by relevance and Arg 2 searchCold newest first, on an
+ * FTS5 index over the same column.
+ */
+void BM_SearchColdMessages(benchmark::State& state) {
+  auto sideFx = makeSideFx();
+  sideFx->initializeCold("bench", ":memory:", std::nullopt);
+  sideFx->executeCold("CREATE TABLE messages (id INTEGER PRIMARY KEY, sender TEXT, body TEXT)", std::nullopt,
+                      "bench");
+  sideFx->executeCold(
+      "WITH RECURSIVE n(i) AS (SELECT 1 UNION ALL SELECT i + 1 FROM n WHERE i < 20000) "
+      "INSERT INTO messages (sender, body) SELECT 'user ' || (i % 50), 'Message ' || i || ' about ' || "
+      "CASE WHEN i % 1000 = 0 THEN 'the invoice' ELSE 'lunch plans' END || "
+      "', with enough surrounding text to look like a real chat message body ' || (i * 7919 % 10007) FROM n",
+      std::nullopt, "bench");
+  int64_t mode = state.range(0);
+  if (mode != 0) {
+    sideFx->declareColdSearch(ColdSearchConfig("messages", {"body"}, std::nullopt, std::nullopt), "bench");
+  }
+  ColdSearchOptions options(20.0, std::nullopt, mode == 1 ? ColdSearchOrder::RANK : ColdSearchOrder::NEWEST,
+                            std::nullopt, std::nullopt, std::nullopt, std::nullopt);
+  for (auto _ : state) {
+    if (mode != 0) {
+      benchmark::DoNotOptimize(sideFx->searchCold("messages", "invoice", options, "bench"));
+    } else {
+      benchmark::DoNotOptimize(sideFx->queryColdBuffer(
+          "SELECT * FROM messages WHERE body LIKE ? ORDER BY id DESC LIMIT 20", SqlParams{std::string("%invoice%")},
+          "bench"));
+    }
+  }
+}
+BENCHMARK(BM_SearchColdMessages)->DenseRange(0, 2);
+
+/**
+ * executeCold with a matching Cold listener - covers the update hook, the
+ * queue hand-off and (off the timed thread) row fetch + serialization
+ */
+void BM_ExecuteColdObserved(benchmark::State& state) {
+  auto sideFx = makeColdFixture(0);
+  ColdListenerConfig cold;
+  cold.table = "orders";
+  cold.databaseName = "bench";
+  sideFx->addListener("orders", ListenerConfig(std::nullopt, cold, std::nullopt, std::nullopt));
+  int64_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(sideFx->executeCold(
+        "INSERT INTO orders (customer, total) VALUES (?, ?)",
+        SqlParams{std::string("c"), static_cast<double>(i++)}, "bench"));
+  }
+  sideFx->waitForDispatch();
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ExecuteColdObserved);
+
+/**
+ * queryColdAsync round trip, submit to promise settled. Arg = rows returned.
+ */
+void BM_QueryColdAsyncRows(benchmark::State& state) {
+  auto sideFx = makeColdFixture(state.range(0), kAsyncColdPath);
+  for (auto _ : state) {
+    auto result = sideFx->queryColdAsync("SELECT * FROM orders", std::nullopt, "bench", std::nullopt)->await().get();
+    benchmark::DoNotOptimize(result);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_QueryColdAsyncRows)->Arg(10)->Arg(1000)->UseRealTime();
+
+/**
+ * One query over four 10k-row file databases. Arg 0 awaits queryColdAsync on
+ * each in turn; Arg 1 issues a single queryColdAcross, which runs the four on
+ * parallel workers and merges them. Both keep each database's top 100 by
+ * total, and Arg 1 also merges them into one top 100.
+ */
+void BM_QueryColdAcross(benchmark::State& state) {
+  constexpr int kDatabases = 4;
+  constexpr int64_t kRows = 10000;
+  auto sideFx = makeSideFx();
+  std::vector<std::string> names;
+  for (int d = 0; d < kDatabases; ++d) {
+    std::string path = "/tmp/sam-bench-cold-across-" + std::to_string(d) + ".db";
+    for (const char* suffix : {"", "-wal", "-shm"}) {
+      std::remove((path + suffix).c_str());
+    }
+    names.push_back("bench" + std::to_string(d));
+    sideFx->initializeCold(names.back(), path, std::nullopt);
+    sideFx->executeCold("CREATE TABLE orders (id INTEGER PRIMARY KEY, customer TEXT, total REAL)", std::nullopt,
+                        names.back());
+    sideFx->executeCold(
+        "WITH RECURSIVE n(i) AS (SELECT 1 UNION ALL SELECT i + 1 FROM n WHERE i < ?) "
+        "INSERT INTO orders (customer, total) SELECT 'customer ' || (i % 97), (i * 7919 % 10007) * 1.25 FROM n",
+        SqlParams{static_cast<double>(kRows)}, names.back());
+  }
+  const std::string sql = "SELECT * FROM orders ORDER BY total DESC LIMIT 100";
+  bool across = state.range(0) != 0;
+  for (auto _ : state) {
+    if (across) {
+      benchmark::DoNotOptimize(
+          sideFx->queryColdAcross(sql, names, std::nullopt,
+                                  ColdAcrossOptions(std::string("total"), true, 100.0), std::nullopt)
+              ->await()
+              .get());
+    } else {
+      for (const std::string& name : names) {
+        benchmark::DoNotOptimize(sideFx->queryColdAsync(sql, std::nullopt, name, std::nullopt)->await().get());
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kDatabases * kRows);
+}
+BENCHMARK(BM_QueryColdAcross)->Arg(0)->Arg(1)->UseRealTime();
+
+/**
+ * getWarm latency on the calling ("JS") thread while another thread keeps a
+ * 10k-row report query running. Arg 0 issues it with queryCold, which holds
+ * the storage lock for the whole query; Arg 1 with queryColdAsync, which runs
+ * on its own connection without it.
+ */
+void BM_WarmReadDuringColdQuery(benchmark::State& state) {
+  auto sideFx = makeColdFixture(10000, kAsyncColdPath);
+  sideFx->setWarm("screen.title", std::string("Orders"), std::nullopt, std::nullopt);
+  bool async = state.range(0) != 0;
+  std::atomic<bool> stop{false};
+  std::thread reporter([&]() {
+    while (!stop.load(std::memory_order_relaxed)) {
+      if (async) {
+        sideFx->queryColdAsync("SELECT * FROM orders", std::nullopt, "bench", std::nullopt)->await().get();
+      } else {
+        sideFx->queryCold("SELECT * FROM orders", std::nullopt, "bench");
+      }
+    }
+  });
+  std::vector<double> samplesUs;
+  for (auto _ : state) {
+    auto start = std::chrono::steady_clock::now();
+    benchmark::DoNotOptimize(sideFx->getWarm("screen.title", std::nullopt));
+    samplesUs.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+  }
+  stop.store(true);
+  reporter.join();
+  reportPercentiles(state, samplesUs);
+}
+BENCHMARK(BM_WarmReadDuringColdQuery)->Arg(0)->Arg(1)->UseRealTime();
+
+// ----------------------------------------------------------------------------
+// Tuning profiles. Arg = ColdProfile. Each fixture first checks that the
+// profile's PRAGMAs took effect on the main and the async connection.
+// ----------------------------------------------------------------------------
+
+const std::string kProfileColdPath = "/tmp/sam-bench-cold-profile.db";
+
+const char* profileName(ColdProfile profile) {
+  switch (profile) {
+    case ColdProfile::DEFAULT: return "default";
+    case ColdProfile::READHEAVY: return "readHeavy";
+    case ColdProfile::WRITEHEAVY: return "writeHeavy";
+    case ColdProfile::LOWMEMORY: return "lowMemory";
+  }
+  return "?";
+}
+
+/**
+ * Whether `pragma` reads back as `expected` (skipped when the profile leaves
+ * it unset), through queryCold and through queryColdAsync
+ */
+bool pragmaMatches(HybridSideFx& sideFx, const std::string& pragma, int64_t expected) {
+  if (expected == ColdTuning::kUnset) {
+    return true;
+  }
+  std::string want = "[{\"" + pragma + "\":" + std::to_string(expected) + "}]";
+  auto sync = sideFx.queryCold("PRAGMA " + pragma, std::nullopt, "bench");
+  auto async = sideFx.queryColdAsync("PRAGMA " + pragma, std::nullopt, "bench", std::nullopt)->await().get();
+  return std::holds_alternative<std::string>(sync) && std::get<std::string>(sync) == want &&
+         std::holds_alternative<std::string>(async) && std::get<std::string>(async) == want;
+}
+
+std::shared_ptr<HybridSideFx> makeProfileFixture(benchmark::State& state, int64_t rows) {
+  auto profile = static_cast<ColdProfile>(state.range(0));
+  state.SetLabel(profileName(profile));
+  auto sideFx = makeColdFixture(
+      rows, kProfileColdPath,
+      ColdConfig(profile, std::nullopt, std::nullopt, std::nullopt, std::nullopt, std::nullopt, std::nullopt,
+                 std::nullopt));
+  // Measure the profile's own wal_autocheckpoint, as inline checkpoints
+  sideFx->configureColdCheckpoints(ColdCheckpointConfig(false, std::nullopt, std::nullopt, std::nullopt));
+  ColdTuning tuning = ColdTuning::forProfile(profile);
+  bool applied = pragmaMatches(*sideFx, "synchronous", tuning.synchronous) &&
+                 pragmaMatches(*sideFx, "mmap_size", tuning.mmapSizeBytes) &&
+                 pragmaMatches(*sideFx, "cache_size",
+                               tuning.cacheSizeKiB == ColdTuning::kUnset ? tuning.cacheSizeKiB : -tuning.cacheSizeKiB) &&
+                 pragmaMatches(*sideFx, "temp_store", tuning.tempStore) &&
+                 pragmaMatches(*sideFx, "wal_autocheckpoint", tuning.walAutocheckpointPages);
+  if (!applied) {
+    state.SkipWithError("Cold profile settings were not applied");
+  }
+  return sideFx;
+}
+
+/**
+ * Autocommit inserts, one fsync-bound transaction each
+ */
+void BM_ColdProfileInsert(benchmark::State& state) {
+  auto sideFx = makeProfileFixture(state, 0);
+  int64_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(sideFx->executeCold(
+        "INSERT INTO orders (customer, total) VALUES (?, ?)",
+        SqlParams{std::string("c"), static_cast<double>(i++)}, "bench"));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ColdProfileInsert)->DenseRange(0, 3)->UseRealTime();
+
+/**
+ * Full scan of 50k rows (~3 MB, more than SQLite's default 2 MB page cache),
+ * read from the checkpointed database file
+ */
+void BM_ColdProfileScan(benchmark::State& state) {
+  auto sideFx = makeProfileFixture(state, 50000);
+  sideFx->queryCold("PRAGMA wal_checkpoint(TRUNCATE)", std::nullopt, "bench");
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(sideFx->queryCold(
+        "SELECT count(*), sum(total) FROM orders WHERE note LIKE '%two%'", std::nullopt, "bench"));
+  }
+  state.SetItemsProcessed(state.iterations() * 50000);
+}
+BENCHMARK(BM_ColdProfileScan)->DenseRange(0, 3)->UseRealTime();
+
+// ----------------------------------------------------------------------------
+// WAL checkpoints
+// ----------------------------------------------------------------------------
+
+const std::string kCheckpointColdPath = "/tmp/sam-bench-cold-checkpoint.db";
+
+/**
+ * Autocommit inserts of 1 KiB rows. Arg 0 checkpoints inline, on the commit
+ * that crosses wal_autocheckpoint; Arg 1 leaves checkpoints to the
+ * maintenance thread. The tail percentiles are the commits that paid for a
+ * checkpoint.
+ */
+void BM_ColdCheckpointInsert(benchmark::State& state) {
+  bool background = state.range(0) != 0;
+  state.SetLabel(background ? "background" : "inline");
+  auto sideFx = makeColdFixture(
+      0, kCheckpointColdPath,
+      ColdConfig(std::nullopt, ColdSynchronous::NORMAL, std::nullopt, std::nullopt, std::nullopt, std::nullopt,
+                 std::nullopt, std::nullopt));
+  sideFx->configureColdCheckpoints(ColdCheckpointConfig(background, std::nullopt, std::nullopt, std::nullopt));
+  std::vector<double> samplesUs;
+  int64_t i = 0;
+  for (auto _ : state) {
+    auto start = std::chrono::steady_clock::now();
+    benchmark::DoNotOptimize(sideFx->executeCold(
+        "INSERT INTO orders (customer, total, payload) VALUES (?, ?, randomblob(1024))",
+        SqlParams{std::string("c"), static_cast<double>(i++)}, "bench"));
+    samplesUs.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+  }
+  reportPercentiles(state, samplesUs);
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ColdCheckpointInsert)->Arg(0)->Arg(1)->UseRealTime();
+
+// ============================================================================
+// Listeners
+// ============================================================================
+
+/**
+ * Add then remove Arg listeners; items = add + remove operations
+ */
+void BM_ListenerAddRemove(benchmark::State& state) {
+  auto sideFx = makeSideFx();
+  auto ids = makeKeys("listener-", static_cast<size_t>(state.range(0)));
+  std::vector<ListenerConfig> configs;
+  configs.reserve(ids.size());
+  for (const auto& id : ids) {
+    configs.push_back(warmKeysListener({"key." + id}));
+  }
+  if (!sideFx->addListener(ids[0], configs[0]).success || !sideFx->removeListener(ids[0]).success) {
+    state.SkipWithError("Failed to add and remove a listener");
+    return;
+  }
+  for (auto _ : state) {
+    for (size_t i = 0; i < ids.size(); ++i) {
+      sideFx->addListener(ids[i], configs[i]);
+    }
+    // Remove in a different order than insertion to exercise hole filling
+    for (size_t i = 0; i < ids.size(); i += 2) {
+      sideFx->removeListener(ids[i]);
+    }
+    for (size_t i = 1; i < ids.size(); i += 2) {
+      sideFx->removeListener(ids[i]);
+    }
+  }
+  if (!sideFx->getListeners().empty()) {
+    state.SkipWithError("Listeners were left behind");
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+}
+BENCHMARK(BM_ListenerAddRemove)->Arg(1000)->Arg(10000);
+
+void BM_GetListeners(benchmark::State& state) {
+  auto sideFx = makeSideFx();
+  addIdleListeners(*sideFx, state.range(0));
+  if (sideFx->getListeners().size() != static_cast<size_t>(state.range(0))) {
+    state.SkipWithError("getListeners returned the wrong count");
+    return;
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(sideFx->getListeners());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GetListeners)->Arg(10000);
+
+// ============================================================================
+// Dispatch latency
+// ============================================================================
+
+/**
+ * Time from setWarm() to the change handler running, with Arg idle
+ * listeners to match against. Reports percentiles as counters.
+ */
+void BM_DispatchLatency(benchmark::State& state) {
+  auto sideFx = makeSideFx();
+  std::atomic<uint64_t> delivered{0};
+  std::atomic<int64_t> deliveredAtNs{0};
+  sideFx->setChangeEventHandler([&](const std::vector<ChangeEvent>& events) {
+    deliveredAtNs.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+    delivered.fetch_add(events.size(), std::memory_order_release);
+  });
+  sideFx->addListener("latency", warmKeysListener({"latency.key"}));
+  addIdleListeners(*sideFx, state.range(0));
+
+  std::vector<double> samplesUs;
+  samplesUs.reserve(100000);
+  double value = 0;
+  for (auto _ : state) {
+    uint64_t expected = delivered.load(std::memory_order_acquire) + 1;
+    auto start = std::chrono::steady_clock::now();
+    sideFx->setWarm("latency.key", value++, std::nullopt, std::nullopt);
+    while (delivered.load(std::memory_order_acquire) < expected) {
+      std::this_thread::yield();
+    }
+    auto end = std::chrono::steady_clock::time_point(
+        std::chrono::steady_clock::duration(deliveredAtNs.load(std::memory_order_relaxed)));
+    double elapsed = std::chrono::duration<double>(end - start).count();
+    state.SetIterationTime(elapsed);
+    samplesUs.push_back(elapsed * 1e6);
+  }
+  reportPercentiles(state, samplesUs);
+}
+BENCHMARK(BM_DispatchLatency)->Arg(0)->Arg(1000)->Arg(10000)->UseManualTime();
+
+// ============================================================================
+// Metrics
+// ============================================================================
+
+void BM_HistogramRecord(benchmark::State& state) {
+  LatencyHistogram histogram;
+  uint64_t value = 1;
+  for (auto _ : state) {
+    histogram.record(value);
+    value = value * 2862933555777941757ULL + 3037000493ULL;
+    value &= (uint64_t{1} << 30) - 1;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HistogramRecord);
+
+void BM_SnapshotAndResetMetrics(benchmark::State& state) {
+  auto sideFx = makeSideFx();
+  for (auto _ : state) {
+    sideFx->setWarm("metrics.key", 1.0, std::nullopt, std::nullopt);
+    benchmark::DoNotOptimize(sideFx->snapshotAndResetMetrics());
+  }
+}
+BENCHMARK(BM_SnapshotAndResetMetrics);
+
+// ============================================================================
+// Missile action routing
+// ============================================================================
+
+/**
+ * Register `sagas` persistent routes, one exact and one prefix pattern each
+ */
+void addSagaRoutes(HybridSideFx& sideFx, int64_t sagas) {
+  for (int64_t i = 0; i < sagas; ++i) {
+    std::string prefix = "saga" + std::to_string(i) + "/";
+    sideFx.addActionRoute({prefix + "DONE", prefix + "progress/*"}, false);
+  }
+}
+
+/**
+ * matchActionRoutes for a type that hits one prefix route. Arg = sagas
+ * registered; cost should stay flat as it grows.
+ */
+void BM_MatchActionRoutes(benchmark::State& state) {
+  auto sideFx = std::make_shared<HybridSideFx>();
+  addSagaRoutes(*sideFx, state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(sideFx->matchActionRoutes("saga7/progress/tick"));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MatchActionRoutes)->Arg(10)->Arg(1000)->Arg(10000);
+
+/**
+ * One `take`: register a once route, dispatch a matching type (which
+ * consumes it). Arg = other sagas registered.
+ */
+void BM_TakeRoundTrip(benchmark::State& state) {
+  auto sideFx = std::make_shared<HybridSideFx>();
+  addSagaRoutes(*sideFx, state.range(0));
+  for (auto _ : state) {
+    sideFx->addActionRoute({"auth/LOGIN_SUCCESS"}, true);
+    benchmark::DoNotOptimize(sideFx->matchActionRoutes("auth/LOGIN_SUCCESS"));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TakeRoundTrip)->Arg(0)->Arg(10000);
+
+// ============================================================================
+// MFE registry
+// ============================================================================
+
+/**
+ * One loading -> versioned transition, persisted as a binary record
+ */
+void BM_SetMFERecord(benchmark::State& state) {
+  auto sideFx = makeSideFx("sam-mfe-registry");
+  MFERecordUpdate started(std::nullopt, std::nullopt, 1.0, std::nullopt, std::nullopt, std::nullopt);
+  MFERecordUpdate loaded(std::string("1.4.2"), std::nullopt, std::nullopt, std::nullopt, std::nullopt,
+                         std::nullopt);
+  for (auto _ : state) {
+    sideFx->setMFERecord("checkout", MFEPhase::LOADING, started);
+    benchmark::DoNotOptimize(sideFx->setMFERecord("checkout", MFEPhase::VERSIONED, loaded));
+  }
+  state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(BM_SetMFERecord);
+
+/**
+ * Startup hydration: every MFE's state in one call. Arg = MFEs tracked.
+ */
+void BM_GetAllMFEStates(benchmark::State& state) {
+  auto sideFx = makeSideFx("sam-mfe-registry");
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    sideFx->setMFERecord("mfe" + std::to_string(i), MFEPhase::MOUNTED, std::nullopt);
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(sideFx->getAllMFEStates());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GetAllMFEStates)->Arg(64);
+
+/**
+ * One load-time sample into the MFE's persisted sketch
+ */
+void BM_RecordMFELoadTime(benchmark::State& state) {
+  auto sideFx = makeSideFx("sam-mfe-registry");
+  double loadTimeMs = 1.0;
+  for (auto _ : state) {
+    sideFx->recordMFELoadTime("checkout", loadTimeMs);
+    loadTimeMs = loadTimeMs < 5000 ? loadTimeMs * 1.07 : 1.0;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RecordMFELoadTime);
+
+/**
+ * Load stats for every MFE in one call. Arg = MFEs tracked.
+ */
+void BM_GetMFELoadStats(benchmark::State& state) {
+  auto sideFx = makeSideFx("sam-mfe-registry");
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    for (int sample = 1; sample <= 100; ++sample) {
+      sideFx->recordMFELoadTime("mfe" + std::to_string(i), sample * 7.5);
+    }
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(sideFx->getMFELoadStats(std::nullopt));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GetMFELoadStats)->Arg(64);
+
+// ============================================================================
+// Secure value cache
+// ============================================================================
+
+/**
+ * Cached keychain read, e.g. an auth token fetched per HTTP request
+ */
+void BM_GetCachedSecureValue(benchmark::State& state) {
+  auto sideFx = makeSideFx();
+  sideFx->configureSecureCache("auth", 60000);
+  sideFx->cacheSecureValue("auth", "accessToken", std::string(static_cast<size_t>(state.range(0)), 't'), std::nullopt);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(sideFx->getCachedSecureValue("auth"));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GetCachedSecureValue)->Arg(64)->Arg(2048);
+
+// ============================================================================
+// Lock contention
+// ============================================================================
+
+std::shared_ptr<HybridSideFx> gSharedSideFx;
+
+/**
+ * Concurrent setWarm from N threads, each on its own keys, with one
+ * listener observing everything so every write is captured and dispatched
+ */
+void BM_ContendedSetWarm(benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    gSharedSideFx = makeSideFx();
+    gSharedSideFx->addListener("all", warmPatternListener("*"));
+  }
+  // Google Benchmark starts the timed region for all threads together,
+  // after thread 0's setup above
+  auto keys = makeKeys("thread" + std::to_string(state.thread_index()) + ".", 256);
+  size_t i = 0;
+  for (auto _ : state) {
+    gSharedSideFx->setWarm(keys[i & 255], static_cast<double>(i), std::nullopt, std::nullopt);
+    ++i;
+  }
+  state.SetItemsProcessed(state.iterations());
+  if (state.thread_index() == 0) {
+    gSharedSideFx->waitForDispatch();
+    for (const auto& op : gSharedSideFx->getMetrics().operations) {
+      if (op.name == "lock.storage") {
+        state.counters["lock_wait_p99_us"] = op.p99Us;
+      }
+    }
+    gSharedSideFx.reset();
+  }
+}
+BENCHMARK(BM_ContendedSetWarm)->ThreadRange(1, 8)->UseRealTime();
+
+/**
+ * One writer thread, the rest reading - readers and the writer share the
+ * storage lock, the dispatcher competes for none of it
+ */
+void BM_ContendedReadWrite(benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    gSharedSideFx = makeSideFx();
+    gSharedSideFx->addListener("all", warmPatternListener("*"));
+    for (int i = 0; i < 256; ++i) {
+      gSharedSideFx->setWarm("shared." + std::to_string(i), std::string("value"), std::nullopt, std::nullopt);
+    }
+  }
+  auto keys = makeKeys("shared.", 256);
+  size_t i = 0;
+  bool writer = state.thread_index() == 0;
+  for (auto _ : state) {
+    if (writer) {
+      gSharedSideFx->setWarm(keys[i++ & 255], std::string("updated"), std::nullopt, std::nullopt);
+    } else {
+      benchmark::DoNotOptimize(gSharedSideFx->getWarm(keys[i++ & 255], std::nullopt));
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+  if (writer) {
+    gSharedSideFx->waitForDispatch();
+    gSharedSideFx.reset();
+  }
+}
+BENCHMARK(BM_ContendedReadWrite)->ThreadRange(2, 8)->UseRealTime();
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,403 @@
+#pragma once
+
+// Host stand-in for MMKVCore (<MMKVCore/MMKV.h>). An in-memory hash map with
+// the subset of the MMKV API that cpp/HybridSideFx.hpp calls, so benchmark
+// numbers measure S.A.M's own overhead rather than mmap/protobuf encoding.
+// Like MMKV it is thread-safe, and it models the append-only file's size:
+// every write appends, a full file is compacted inline, trim() compacts and
+// shrinks it. An instance opened with a crypt key keeps it; when built with
+// SAM_HOST_AES, each of its values is run through AES-128-CFB on write and
+// read, as MMKV encrypts and decrypts them, so the cipher's cost is measured.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#if SAM_HOST_AES
+#include <openssl/evp.h>
+#endif
+
+namespace mmkv {
+
+enum MMKVMode : uint32_t {
+  MMKV_SINGLE_PROCESS = 1 << 0,
+  MMKV_MULTI_PROCESS = 1 << 1,
+};
+
+constexpr int DEFAULT_MMAP_SIZE = 4096;
+
+using ContentChangeHandler = void (*)(const std::string& mmapID);
+
+enum MMBufferCopyFlag : bool {
+  MMBufferCopy = false,
+  MMBufferNoCopy = true,
+};
+
+/**
+ * Byte buffer returned by getBytes() and accepted by set()
+ */
+class MMBuffer {
+public:
+  MMBuffer() = default;
+  explicit MMBuffer(size_t length)
+      : _ptr(length > 0 ? static_cast<char*>(std::malloc(length)) : nullptr), _size(length) {}
+  MMBuffer(void* source, size_t length, MMBufferCopyFlag flag = MMBufferCopy) : _size(length) {
+    if (flag == MMBufferNoCopy) {
+      _ptr = static_cast<char*>(source);
+      _owned = false;
+    } else if (length > 0) {
+      _ptr = static_cast<char*>(std::malloc(length));
+      std::memcpy(_ptr, source, length);
+    }
+  }
+  MMBuffer(MMBuffer&& other) noexcept : _ptr(other._ptr), _size(other._size), _owned(other._owned) {
+    other._ptr = nullptr;
+    other._size = 0;
+  }
+  MMBuffer& operator=(MMBuffer&& other) noexcept {
+    std::swap(_ptr, other._ptr);
+    std::swap(_size, other._size);
+    std::swap(_owned, other._owned);
+    return *this;
+  }
+  MMBuffer(const MMBuffer&) = delete;
+  MMBuffer& operator=(const MMBuffer&) = delete;
+  ~MMBuffer() {
+    if (_owned) {
+      std::free(_ptr);
+    }
+  }
+
+  void* getPtr() const { return _ptr; }
+  size_t length() const { return _size; }
+
+private:
+  char* _ptr = nullptr;
+  size_t _size = 0;
+  bool _owned = true;
+};
+
+class MMKV {
+public:
+  static void initializeMMKV(const std::string& /* rootDir */) {}
+
+  /**
+   * Like MMKV, instances are cached by ID: a later call returns the instance
+   * as first opened, whatever mode and `cryptKey` it passes
+   */
+  static MMKV* mmkvWithID(const std::string& mmapID, MMKVMode mode = MMKV_SINGLE_PROCESS,
+                          std::string* cryptKey = nullptr) {
+    static std::mutex instancesMutex;
+    static std::unordered_map<std::string, std::unique_ptr<MMKV>> instances;
+    std::lock_guard<std::mutex> lock(instancesMutex);
+    auto& instance = instances[mmapID];
+    if (!instance) {
+      instance.reset(new MMKV(mmapID, mode, cryptKey != nullptr ? *cryptKey : std::string()));
+    }
+    return instance.get();
+  }
+
+  static MMKV* mmkvWithID(const std::string& mmapID, int /* size */, MMKVMode mode, std::string* cryptKey = nullptr) {
+    return mmkvWithID(mmapID, mode, cryptKey);
+  }
+
+  ~MMKV() {
+#if SAM_HOST_AES
+    EVP_CIPHER_CTX_free(_cipher);
+#endif
+  }
+
+  /** The key the instance was opened with; empty if not encrypted */
+  std::string cryptKey() const { return _cryptKey; }
+
+  bool isMultiProcess() const { return _mode == MMKV_MULTI_PROCESS; }
+
+  /**
+   * Called with the instance ID when a multi-process instance finds that
+   * another process wrote to it
+   */
+  static void registerContentChangeHandler(ContentChangeHandler handler) { contentChangeHandler().store(handler); }
+  static void unRegisterContentChangeHandler() { contentChangeHandler().store(nullptr); }
+
+  /**
+   * Multi-process instances: reload if another process wrote since the last
+   * check and call the content change handler. MMKV also checks on every
+   * access; the stand-in checks here and on reads.
+   */
+  void checkContentChanged() {
+    ContentChangeHandler handler = contentChangeHandler().load();
+    if (isMultiProcess() && _changedByOuterProcess.exchange(false) && handler != nullptr) {
+      handler(_mmapID);
+    }
+  }
+
+  /**
+   * Host only: make the next checkContentChanged() report a write by another
+   * process, e.g. after writing to the instance directly
+   */
+  void markChangedByOuterProcess() { _changedByOuterProcess = true; }
+
+  /** Host only: whether a content change handler is registered */
+  static bool hasContentChangeHandler() { return contentChangeHandler().load() != nullptr; }
+
+  bool set(bool value, const std::string& key) { return store(key, value); }
+  bool set(double value, const std::string& key) { return store(key, value); }
+  bool set(const std::string& value, const std::string& key) { return store(key, value); }
+  bool set(const char* value, const std::string& key) { return store(key, std::string(value)); }
+  bool set(const MMBuffer& value, const std::string& key) {
+    return store(key, std::string(static_cast<const char*>(value.getPtr()), value.length()));
+  }
+
+  bool getString(const std::string& key, std::string& result) {
+    checkContentChanged();
+    std::lock_guard<std::mutex> lock(_lock);
+    auto it = _values.find(key);
+    if (it == _values.end() || !std::holds_alternative<std::string>(it->second)) {
+      return false;
+    }
+    result = std::get<std::string>(it->second);
+    crypt(result.data(), result.size());
+    return true;
+  }
+
+  bool getBool(const std::string& key, bool defaultValue = false, bool* hasValue = nullptr) {
+    return get<bool>(key, defaultValue, hasValue);
+  }
+
+  double getDouble(const std::string& key, double defaultValue = 0, bool* hasValue = nullptr) {
+    return get<double>(key, defaultValue, hasValue);
+  }
+
+  MMBuffer getBytes(const std::string& key) {
+    checkContentChanged();
+    std::lock_guard<std::mutex> lock(_lock);
+    auto it = _values.find(key);
+    if (it == _values.end() || !std::holds_alternative<std::string>(it->second)) {
+      return MMBuffer();
+    }
+    const auto& text = std::get<std::string>(it->second);
+    MMBuffer buffer(text.size());
+    if (!text.empty()) {
+      std::memcpy(buffer.getPtr(), text.data(), text.size());
+      crypt(buffer.getPtr(), text.size());
+    }
+    return buffer;
+  }
+
+  bool containsKey(const std::string& key) {
+    checkContentChanged();
+    std::lock_guard<std::mutex> lock(_lock);
+    return _values.count(key) > 0;
+  }
+
+  size_t count(bool /* filterExpire */ = false) {
+    std::lock_guard<std::mutex> lock(_lock);
+    return _values.size();
+  }
+
+  std::vector<std::string> allKeys(bool /* filterExpire */ = false) {
+    std::lock_guard<std::mutex> lock(_lock);
+    std::vector<std::string> keys;
+    keys.reserve(_values.size());
+    for (const auto& entry : _values) {
+      keys.push_back(entry.first);
+    }
+    return keys;
+  }
+  void removeValueForKey(const std::string& key) {
+    std::lock_guard<std::mutex> lock(_lock);
+    auto it = _values.find(key);
+    if (it == _values.end()) {
+      return;
+    }
+    _liveBytes -= entrySize(key, it->second);
+    _values.erase(it);
+    append(key.size() + kEntryOverhead);  // removal is an empty value
+  }
+
+  /**
+   * Size of a value; with `actualSize` false, including its length prefix
+   */
+  size_t getValueSize(const std::string& key, bool actualSize) {
+    std::lock_guard<std::mutex> lock(_lock);
+    auto it = _values.find(key);
+    if (it == _values.end()) {
+      return 0;
+    }
+    size_t size = valueSize(it->second);
+    return actualSize || !std::holds_alternative<std::string>(it->second) ? size : size + 1;
+  }
+
+  /** File size */
+  size_t totalSize() {
+    std::lock_guard<std::mutex> lock(_lock);
+    return _fileSize;
+  }
+
+  /** Bytes of the file used by the append log, overwritten entries included */
+  size_t actualSize() {
+    std::lock_guard<std::mutex> lock(_lock);
+    return _actualSize;
+  }
+
+  /**
+   * Rewrite live entries only, then shrink the file while it stays more than
+   * twice the data. Files at the default size are left alone.
+   */
+  void trim() {
+    std::lock_guard<std::mutex> lock(_lock);
+    if (_fileSize <= static_cast<size_t>(DEFAULT_MMAP_SIZE)) {
+      return;
+    }
+    fullWriteback();
+    while (_fileSize > static_cast<size_t>(DEFAULT_MMAP_SIZE) && _fileSize > (_actualSize + 4) * 2) {
+      _fileSize /= 2;
+    }
+  }
+
+  /**
+   * Unmap the file; MMKV maps it again on the next access. Values live in
+   * process memory here, so there is nothing to release.
+   */
+  void clearMemoryCache(bool /* keepSpace */ = false) {}
+
+private:
+  using Value = std::variant<bool, double, std::string>;
+
+  MMKV(std::string mmapID, MMKVMode mode, std::string cryptKey)
+      : _mmapID(std::move(mmapID)), _mode(mode), _cryptKey(std::move(cryptKey)) {
+#if SAM_HOST_AES
+    if (!_cryptKey.empty()) {
+      // Zero-padded to AES-128's 16 bytes; the IV only has to be fixed here
+      std::memcpy(_iv, _cryptKey.data(), std::min<size_t>(_cryptKey.size(), sizeof(_iv)));
+      _cipher = EVP_CIPHER_CTX_new();
+      EVP_EncryptInit_ex(_cipher, EVP_aes_128_cfb128(), nullptr, _iv, _iv);
+    }
+#endif
+  }
+
+  /**
+   * Run an encrypted instance's value bytes through AES-128-CFB. Values are
+   * kept in plaintext here and the ciphertext is discarded; only the cost is
+   * modelled. Caller holds _lock.
+   */
+  void crypt(const void* bytes, size_t size) {
+#if SAM_HOST_AES
+    if (_cipher == nullptr || size == 0) {
+      return;
+    }
+    _scratch.resize(size);
+    int length = 0;
+    EVP_EncryptInit_ex(_cipher, nullptr, nullptr, nullptr, _iv);
+    EVP_EncryptUpdate(_cipher, _scratch.data(), &length, static_cast<const unsigned char*>(bytes),
+                      static_cast<int>(size));
+#else
+    (void)bytes;
+    (void)size;
+#endif
+  }
+
+  void crypt(const Value& value) {
+    if (std::holds_alternative<std::string>(value)) {
+      const auto& text = std::get<std::string>(value);
+      crypt(text.data(), text.size());
+    } else if (std::holds_alternative<double>(value)) {
+      crypt(&std::get<double>(value), sizeof(double));
+    } else {
+      crypt(&std::get<bool>(value), sizeof(bool));
+    }
+  }
+
+  static constexpr size_t kEntryOverhead = 2;  // key and value length prefixes
+
+  static size_t valueSize(const Value& value) {
+    if (std::holds_alternative<bool>(value)) {
+      return 1;
+    }
+    if (std::holds_alternative<double>(value)) {
+      return 8;
+    }
+    return std::get<std::string>(value).size();
+  }
+
+  static size_t entrySize(const std::string& key, const Value& value) {
+    return key.size() + valueSize(value) + kEntryOverhead;
+  }
+
+  bool store(const std::string& key, Value value) {
+    std::lock_guard<std::mutex> lock(_lock);
+    size_t size = entrySize(key, value);
+    crypt(value);
+    auto [it, inserted] = _values.try_emplace(key);
+    if (!inserted) {
+      _liveBytes -= entrySize(key, it->second);
+    }
+    it->second = std::move(value);
+    _liveBytes += size;
+    append(size);
+    return true;
+  }
+
+  // Caller holds _lock
+  void append(size_t size) {
+    _actualSize += size;
+    if (_actualSize + 4 > _fileSize) {
+      // MMKV compacts inline when the log reaches the end of the file
+      fullWriteback();
+    }
+  }
+
+  // Caller holds _lock
+  void fullWriteback() {
+    _actualSize = _liveBytes;
+    while ((_actualSize + 4) * 2 > _fileSize) {
+      _fileSize *= 2;
+    }
+  }
+
+  template <typename T>
+  T get(const std::string& key, T defaultValue, bool* hasValue) {
+    checkContentChanged();
+    std::lock_guard<std::mutex> lock(_lock);
+    auto it = _values.find(key);
+    bool found = it != _values.end() && std::holds_alternative<T>(it->second);
+    if (hasValue != nullptr) {
+      *hasValue = found;
+    }
+    if (!found) {
+      return defaultValue;
+    }
+    crypt(it->second);
+    return std::get<T>(it->second);
+  }
+
+  static std::atomic<ContentChangeHandler>& contentChangeHandler() {
+    static std::atomic<ContentChangeHandler> handler{nullptr};
+    return handler;
+  }
+
+  std::mutex _lock;
+  std::string _mmapID;
+  MMKVMode _mode;
+  std::string _cryptKey;
+  std::atomic<bool> _changedByOuterProcess{false};
+#if SAM_HOST_AES
+  EVP_CIPHER_CTX* _cipher = nullptr;
+  unsigned char _iv[16] = {};
+  std::vector<unsigned char> _scratch;
+#endif
+  std::unordered_map<std::string, Value> _values;
+  size_t _fileSize = DEFAULT_MMAP_SIZE;
+  size_t _actualSize = 0;
+  size_t _liveBytes = 0;
+};
+
+} // namespace mmkv
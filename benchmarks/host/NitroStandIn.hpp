@@ -0,0 +1,172 @@
+#pragma once
+
+// Host stand-in for the parts of react-native-nitro-modules that
+// cpp/HybridSideFx.hpp uses. No JSI: just enough surface to compile and
+// exercise the C++ core on a desktop machine. Reached through the forwarding
+// headers <NitroModules/*.hpp> generated by benchmarks/CMakeLists.txt.
+
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace margelo::nitro {
+
+/**
+ * `null` in TypeScript
+ */
+struct NullType {};
+inline constexpr NullType null{};
+
+/**
+ * Base class of every HybridObject; only the name is kept
+ */
+class HybridObject : public std::enable_shared_from_this<HybridObject> {
+public:
+  explicit HybridObject(const char* name) : _name(name) {}
+  virtual ~HybridObject() = default;
+
+  const char* getName() const { return _name; }
+
+private:
+  const char* _name;
+};
+
+/**
+ * Native-owned ArrayBuffer with the same factory functions as Nitro's
+ */
+class ArrayBuffer {
+public:
+  using DeleteFn = std::function<void()>;
+
+  ArrayBuffer(uint8_t* data, size_t size, DeleteFn&& deleteFunc)
+      : _data(data), _size(size), _deleteFunc(std::move(deleteFunc)) {}
+  ~ArrayBuffer() {
+    if (_deleteFunc) {
+      _deleteFunc();
+    }
+  }
+
+  ArrayBuffer(const ArrayBuffer&) = delete;
+  ArrayBuffer& operator=(const ArrayBuffer&) = delete;
+
+  uint8_t* data() { return _data; }
+  size_t size() const { return _size; }
+
+  static std::shared_ptr<ArrayBuffer> wrap(uint8_t* data, size_t size, DeleteFn&& deleteFunc) {
+    return std::make_shared<ArrayBuffer>(data, size, std::move(deleteFunc));
+  }
+
+  static std::shared_ptr<ArrayBuffer> allocate(size_t size) {
+    auto* data = new uint8_t[size > 0 ? size : 1];
+    return wrap(data, size, [data]() { delete[] data; });
+  }
+
+  static std::shared_ptr<ArrayBuffer> copy(const uint8_t* data, size_t size) {
+    auto buffer = allocate(size);
+    if (size > 0) {
+      std::memcpy(buffer->data(), data, size);
+    }
+    return buffer;
+  }
+
+private:
+  uint8_t* _data;
+  size_t _size;
+  DeleteFn _deleteFunc;
+};
+
+/**
+ * Thread-safe Promise with the resolve/reject/listener surface of Nitro's.
+ * Listeners run on the thread that settles the promise (Nitro hops to the
+ * JS thread instead).
+ */
+template <typename TResult>
+class Promise {
+public:
+  using OnResolvedFunc = std::function<void(const TResult&)>;
+  using OnRejectedFunc = std::function<void(const std::exception_ptr&)>;
+
+  static std::shared_ptr<Promise> create() { return std::shared_ptr<Promise>(new Promise()); }
+
+  void resolve(TResult&& result) {
+    std::vector<OnResolvedFunc> listeners;
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _result.emplace(std::move(result));
+      listeners.swap(_onResolved);
+      _onRejected.clear();
+    }
+    for (auto& listener : listeners) {
+      listener(*_result);
+    }
+  }
+
+  void resolve(const TResult& result) { resolve(TResult(result)); }
+
+  void reject(const std::exception_ptr& error) {
+    std::vector<OnRejectedFunc> listeners;
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _error = error;
+      listeners.swap(_onRejected);
+      _onResolved.clear();
+    }
+    for (auto& listener : listeners) {
+      listener(error);
+    }
+  }
+
+  void addOnResolvedListener(OnResolvedFunc&& onResolved) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (_result.has_value()) {
+      lock.unlock();
+      onResolved(*_result);
+    } else if (!_error) {
+      _onResolved.push_back(std::move(onResolved));
+    }
+  }
+
+  void addOnRejectedListener(OnRejectedFunc&& onRejected) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (_error) {
+      std::exception_ptr error = _error;
+      lock.unlock();
+      onRejected(error);
+    } else if (!_result.has_value()) {
+      _onRejected.push_back(std::move(onRejected));
+    }
+  }
+
+  /**
+   * Block until settled; rethrows the rejection
+   */
+  std::future<TResult> await() {
+    auto promise = std::make_shared<std::promise<TResult>>();
+    std::future<TResult> future = promise->get_future();
+    addOnResolvedListener([promise](const TResult& result) { promise->set_value(result); });
+    addOnRejectedListener([promise](const std::exception_ptr& error) { promise->set_exception(error); });
+    return future;
+  }
+
+  bool isPending() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return !_result.has_value() && !_error;
+  }
+
+private:
+  Promise() = default;
+
+  std::mutex _mutex;
+  std::optional<TResult> _result;
+  std::exception_ptr _error;
+  std::vector<OnResolvedFunc> _onResolved;
+  std::vector<OnRejectedFunc> _onRejected;
+};
+
+} // namespace margelo::nitro
@@ -0,0 +1,708 @@
+#pragma once
+
+// Host stand-in for nitrogen's generated shared C++ output
+// (nitrogen/generated/shared/c++). Mirrors src/specs/SideFx.nitro.ts: every
+// struct keeps its field order and all-fields constructor, enums use
+// nitrogen's naming. Keep it in sync when the spec changes - the host build
+// fails loudly when a HybridSideFxSpec method is missing here.
+//
+// Each type is reached through a one-line forwarding header (e.g.
+// "ListenerConfig.hpp") generated by benchmarks/CMakeLists.txt.
+
+#include "NitroStandIn.hpp"
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace margelo::nitro::sam {
+
+using namespace margelo::nitro;
+
+// ============================================================================
+// Enums
+// ============================================================================
+
+enum class ConditionType {
+  EXISTS, NOTEXISTS, EQUALS, NOTEQUALS, CONTAINS, STARTSWITH, ENDSWITH, MATCHESREGEX,
+  GREATERTHAN, LESSTHAN, GREATERTHANOREQUAL, LESSTHANOREQUAL, CHANGED, IN, NOTIN,
+};
+enum class ColdOperation { INSERT, UPDATE, DELETE };
+enum class ColdProfile { DEFAULT, READHEAVY, WRITEHEAVY, LOWMEMORY };
+enum class ColdSynchronous { OFF, NORMAL, FULL };
+enum class ColdSearchOrder { RANK, NEWEST, OLDEST };
+enum class CombineLogic { AND, OR };
+enum class ChangeSource { WARM, COLD, MMKV, SQLITE };
+enum class ChangeOperation { SET, DELETE, INSERT, UPDATE };
+enum class NetworkStatus { ONLINE, OFFLINE, UNKNOWN };
+enum class ConnectionType { WIFI, CELLULAR, ETHERNET, BLUETOOTH, VPN, NONE, UNKNOWN };
+enum class CellularGeneration { _2G, _3G, _4G, _5G, UNKNOWN };
+enum class LogCategory { GENERAL, LISTENERS, WARM, COLD, DISPATCH, NETWORK };
+
+// ============================================================================
+// Listener Configuration
+// ============================================================================
+
+struct Condition {
+  ConditionType type;
+  std::optional<std::variant<bool, std::string, double>> value;
+  std::optional<std::vector<std::variant<std::string, double>>> values;
+  std::optional<std::string> regex;
+
+  Condition() = default;
+  Condition(ConditionType type, std::optional<std::variant<bool, std::string, double>> value,
+            std::optional<std::vector<std::variant<std::string, double>>> values,
+            std::optional<std::string> regex)
+      : type(type), value(value), values(values), regex(regex) {}
+};
+
+struct WarmListenerConfig {
+  std::optional<std::vector<std::string>> keys;
+  std::optional<std::vector<std::string>> patterns;
+  std::optional<std::vector<Condition>> conditions;
+  std::optional<std::string> instanceId;
+
+  WarmListenerConfig() = default;
+  WarmListenerConfig(std::optional<std::vector<std::string>> keys,
+                     std::optional<std::vector<std::string>> patterns,
+                     std::optional<std::vector<Condition>> conditions,
+                     std::optional<std::string> instanceId)
+      : keys(keys), patterns(patterns), conditions(conditions), instanceId(instanceId) {}
+};
+
+struct RowCondition {
+  std::string column;
+  Condition condition;
+
+  RowCondition() = default;
+  RowCondition(std::string column, Condition condition) : column(column), condition(condition) {}
+};
+
+struct SecureCachedValue {
+  std::string username;
+  std::string password;
+
+  SecureCachedValue() = default;
+  SecureCachedValue(std::string username, std::string password)
+      : username(std::move(username)), password(std::move(password)) {}
+};
+
+struct WarmConfig {
+  std::optional<std::string> encryptionKey;
+  std::optional<bool> multiProcess;
+
+  WarmConfig() = default;
+  WarmConfig(std::optional<std::string> encryptionKey, std::optional<bool> multiProcess)
+      : encryptionKey(std::move(encryptionKey)), multiProcess(multiProcess) {}
+};
+
+struct WarmPrewarmInstance {
+  std::string instanceId;
+  std::optional<WarmConfig> config;
+
+  WarmPrewarmInstance() = default;
+  WarmPrewarmInstance(std::string instanceId, std::optional<WarmConfig> config)
+      : instanceId(std::move(instanceId)), config(std::move(config)) {}
+};
+
+struct ColdConfig {
+  std::optional<ColdProfile> profile;
+  std::optional<ColdSynchronous> synchronous;
+  std::optional<double> mmapSizeBytes;
+  std::optional<double> cacheSizeKiB;
+  std::optional<bool> tempStoreMemory;
+  std::optional<double> walAutocheckpointPages;
+  std::optional<double> busyTimeoutMs;
+  std::optional<std::vector<std::string>> migrations;
+
+  ColdConfig() = default;
+  ColdConfig(std::optional<ColdProfile> profile, std::optional<ColdSynchronous> synchronous,
+             std::optional<double> mmapSizeBytes, std::optional<double> cacheSizeKiB,
+             std::optional<bool> tempStoreMemory, std::optional<double> walAutocheckpointPages,
+             std::optional<double> busyTimeoutMs, std::optional<std::vector<std::string>> migrations)
+      : profile(profile), synchronous(synchronous), mmapSizeBytes(mmapSizeBytes), cacheSizeKiB(cacheSizeKiB),
+        tempStoreMemory(tempStoreMemory), walAutocheckpointPages(walAutocheckpointPages),
+        busyTimeoutMs(busyTimeoutMs), migrations(std::move(migrations)) {}
+};
+
+struct ColdListenerConfig {
+  std::optional<std::string> table;
+  std::optional<std::vector<std::string>> columns;
+  std::optional<std::vector<ColdOperation>> operations;
+  std::optional<std::vector<RowCondition>> where;
+  std::optional<std::string> query;
+  std::optional<std::vector<std::variant<NullType, std::string, double>>> queryParams;
+  std::optional<std::string> databaseName;
+
+  ColdListenerConfig() = default;
+  ColdListenerConfig(std::optional<std::string> table, std::optional<std::vector<std::string>> columns,
+                     std::optional<std::vector<ColdOperation>> operations,
+                     std::optional<std::vector<RowCondition>> where, std::optional<std::string> query,
+                     std::optional<std::vector<std::variant<NullType, std::string, double>>> queryParams,
+                     std::optional<std::string> databaseName)
+      : table(table), columns(columns), operations(operations), where(where), query(query),
+        queryParams(queryParams), databaseName(databaseName) {}
+};
+
+struct CorrelationConfig {
+  std::string warmKey;
+  std::string coldParam;
+
+  CorrelationConfig() = default;
+  CorrelationConfig(std::string warmKey, std::string coldParam) : warmKey(warmKey), coldParam(coldParam) {}
+};
+
+struct CombinedListenerConfig {
+  std::optional<WarmListenerConfig> warm;
+  std::optional<ColdListenerConfig> cold;
+  std::optional<CombineLogic> logic;
+  std::optional<CorrelationConfig> correlation;
+
+  CombinedListenerConfig() = default;
+  CombinedListenerConfig(std::optional<WarmListenerConfig> warm, std::optional<ColdListenerConfig> cold,
+                         std::optional<CombineLogic> logic, std::optional<CorrelationConfig> correlation)
+      : warm(warm), cold(cold), logic(logic), correlation(correlation) {}
+};
+
+struct ListenerOptions {
+  std::optional<double> debounceMs;
+  std::optional<double> throttleMs;
+  std::optional<bool> fireImmediately;
+  std::optional<bool> debug;
+
+  ListenerOptions() = default;
+  ListenerOptions(std::optional<double> debounceMs, std::optional<double> throttleMs,
+                  std::optional<bool> fireImmediately, std::optional<bool> debug)
+      : debounceMs(debounceMs), throttleMs(throttleMs), fireImmediately(fireImmediately), debug(debug) {}
+};
+
+struct ListenerConfig {
+  std::optional<WarmListenerConfig> warm;
+  std::optional<ColdListenerConfig> cold;
+  std::optional<CombinedListenerConfig> combined;
+  std::optional<ListenerOptions> options;
+
+  ListenerConfig() = default;
+  ListenerConfig(std::optional<WarmListenerConfig> warm, std::optional<ColdListenerConfig> cold,
+                 std::optional<CombinedListenerConfig> combined, std::optional<ListenerOptions> options)
+      : warm(warm), cold(cold), combined(combined), options(options) {}
+};
+
+// ============================================================================
+// Events and Results
+// ============================================================================
+
+struct RowData {
+  std::string json;
+
+  RowData() = default;
+  explicit RowData(std::string json) : json(json) {}
+};
+
+struct ChangeEvent {
+  std::string listenerId;
+  ChangeSource source;
+  std::optional<std::string> key;
+  std::optional<std::string> table;
+  std::optional<double> rowId;
+  ChangeOperation operation;
+  std::optional<std::variant<NullType, bool, std::string, double>> oldValue;
+  std::optional<std::variant<NullType, bool, std::string, double>> newValue;
+  std::optional<RowData> row;
+  double timestamp;
+  std::optional<std::string> actionType;
+  std::optional<std::vector<double>> routeIds;
+
+  ChangeEvent() = default;
+  ChangeEvent(std::string listenerId, ChangeSource source, std::optional<std::string> key,
+              std::optional<std::string> table, std::optional<double> rowId, ChangeOperation operation,
+              std::optional<std::variant<NullType, bool, std::string, double>> oldValue,
+              std::optional<std::variant<NullType, bool, std::string, double>> newValue,
+              std::optional<RowData> row, double timestamp, std::optional<std::string> actionType,
+              std::optional<std::vector<double>> routeIds)
+      : listenerId(listenerId), source(source), key(key), table(table), rowId(rowId), operation(operation),
+        oldValue(oldValue), newValue(newValue), row(row), timestamp(timestamp), actionType(actionType),
+        routeIds(routeIds) {}
+};
+
+struct ListenerResult {
+  bool success;
+  std::optional<std::string> error;
+
+  ListenerResult() = default;
+  ListenerResult(bool success, std::optional<std::string> error) : success(success), error(error) {}
+};
+
+struct ListenerInfo {
+  std::string id;
+  ListenerConfig config;
+  double createdAt;
+  double triggerCount;
+  std::optional<double> lastTriggered;
+  bool isPaused;
+
+  ListenerInfo() = default;
+  ListenerInfo(std::string id, ListenerConfig config, double createdAt, double triggerCount,
+               std::optional<double> lastTriggered, bool isPaused)
+      : id(id), config(config), createdAt(createdAt), triggerCount(triggerCount),
+        lastTriggered(lastTriggered), isPaused(isPaused) {}
+};
+
+struct SAMConfig {
+  std::optional<bool> debug;
+  std::optional<double> maxListeners;
+  std::optional<double> cacheSize;
+
+  SAMConfig() = default;
+  SAMConfig(std::optional<bool> debug, std::optional<double> maxListeners, std::optional<double> cacheSize)
+      : debug(debug), maxListeners(maxListeners), cacheSize(cacheSize) {}
+};
+
+struct DispatchAllocationStats {
+  bool enabled;
+  double batches;
+  double eventsBuilt;
+  double arenaBlockAllocations;
+  double arenaBytesReserved;
+  double arenaHighWaterBytes;
+  double bufferGrowths;
+
+  DispatchAllocationStats() = default;
+  DispatchAllocationStats(bool enabled, double batches, double eventsBuilt, double arenaBlockAllocations,
+                          double arenaBytesReserved, double arenaHighWaterBytes, double bufferGrowths)
+      : enabled(enabled), batches(batches), eventsBuilt(eventsBuilt),
+        arenaBlockAllocations(arenaBlockAllocations), arenaBytesReserved(arenaBytesReserved),
+        arenaHighWaterBytes(arenaHighWaterBytes), bufferGrowths(bufferGrowths) {}
+};
+
+struct OperationMetrics {
+  std::string name;
+  double count;
+  double errors;
+  double meanUs;
+  double minUs;
+  double maxUs;
+  double p50Us;
+  double p90Us;
+  double p99Us;
+  double p999Us;
+
+  OperationMetrics() = default;
+  OperationMetrics(std::string name, double count, double errors, double meanUs, double minUs, double maxUs,
+                   double p50Us, double p90Us, double p99Us, double p999Us)
+      : name(std::move(name)), count(count), errors(errors), meanUs(meanUs), minUs(minUs), maxUs(maxUs),
+        p50Us(p50Us), p90Us(p90Us), p99Us(p99Us), p999Us(p999Us) {}
+};
+
+struct SAMMetrics {
+  bool enabled;
+  double intervalMs;
+  std::vector<OperationMetrics> operations;
+  double eventsDelivered;
+  double pendingChanges;
+
+  SAMMetrics() = default;
+  SAMMetrics(bool enabled, double intervalMs, std::vector<OperationMetrics> operations,
+             double eventsDelivered, double pendingChanges)
+      : enabled(enabled), intervalMs(intervalMs), operations(std::move(operations)), eventsDelivered(eventsDelivered),
+        pendingChanges(pendingChanges) {}
+};
+
+struct WarmCompactionConfig {
+  std::optional<bool> enabled;
+  std::optional<double> idleMs;
+  std::optional<double> minFileBytes;
+  std::optional<double> maxAmplification;
+
+  WarmCompactionConfig() = default;
+  WarmCompactionConfig(std::optional<bool> enabled, std::optional<double> idleMs, std::optional<double> minFileBytes,
+                       std::optional<double> maxAmplification)
+      : enabled(enabled), idleMs(idleMs), minFileBytes(minFileBytes), maxAmplification(maxAmplification) {}
+};
+
+struct WarmCompactionStats {
+  std::string instanceId;
+  double fileBytes;
+  double usedBytes;
+  double liveBytes;
+  double compactions;
+  double lastCompactionMs;
+  double lastCompactedAt;
+  double bytesReclaimed;
+
+  WarmCompactionStats() = default;
+  WarmCompactionStats(std::string instanceId, double fileBytes, double usedBytes, double liveBytes,
+                      double compactions, double lastCompactionMs, double lastCompactedAt, double bytesReclaimed)
+      : instanceId(instanceId), fileBytes(fileBytes), usedBytes(usedBytes), liveBytes(liveBytes),
+        compactions(compactions), lastCompactionMs(lastCompactionMs), lastCompactedAt(lastCompactedAt),
+        bytesReclaimed(bytesReclaimed) {}
+};
+
+struct ColdCheckpointConfig {
+  std::optional<bool> enabled;
+  std::optional<double> intervalMs;
+  std::optional<double> truncateWalBytes;
+  std::optional<double> maxWalBytes;
+
+  ColdCheckpointConfig() = default;
+  ColdCheckpointConfig(std::optional<bool> enabled, std::optional<double> intervalMs,
+                       std::optional<double> truncateWalBytes, std::optional<double> maxWalBytes)
+      : enabled(enabled), intervalMs(intervalMs), truncateWalBytes(truncateWalBytes), maxWalBytes(maxWalBytes) {}
+};
+
+struct ColdCheckpointStats {
+  std::string databaseName;
+  double walBytes;
+  double checkpoints;
+  double truncateCheckpoints;
+  double incompleteCheckpoints;
+  double lastCheckpointMs;
+  double maxCheckpointMs;
+  double lastCheckpointAt;
+
+  ColdCheckpointStats() = default;
+  ColdCheckpointStats(std::string databaseName, double walBytes, double checkpoints, double truncateCheckpoints,
+                      double incompleteCheckpoints, double lastCheckpointMs, double maxCheckpointMs,
+                      double lastCheckpointAt)
+      : databaseName(databaseName), walBytes(walBytes), checkpoints(checkpoints),
+        truncateCheckpoints(truncateCheckpoints), incompleteCheckpoints(incompleteCheckpoints),
+        lastCheckpointMs(lastCheckpointMs), maxCheckpointMs(maxCheckpointMs), lastCheckpointAt(lastCheckpointAt) {}
+};
+
+struct ColdAcrossOptions {
+  std::optional<std::string> orderBy;
+  std::optional<bool> descending;
+  std::optional<double> limit;
+
+  ColdAcrossOptions() = default;
+  ColdAcrossOptions(std::optional<std::string> orderBy, std::optional<bool> descending, std::optional<double> limit)
+      : orderBy(orderBy), descending(descending), limit(limit) {}
+};
+
+struct ColdSearchConfig {
+  std::string table;
+  std::vector<std::string> columns;
+  std::optional<std::string> tokenizer;
+  std::optional<std::vector<double>> prefixLengths;
+
+  ColdSearchConfig() = default;
+  ColdSearchConfig(std::string table, std::vector<std::string> columns, std::optional<std::string> tokenizer,
+                   std::optional<std::vector<double>> prefixLengths)
+      : table(table), columns(columns), tokenizer(tokenizer), prefixLengths(prefixLengths) {}
+};
+
+struct ColdSearchOptions {
+  std::optional<double> limit;
+  std::optional<double> offset;
+  std::optional<ColdSearchOrder> order;
+  std::optional<std::string> snippetColumn;
+  std::optional<std::string> highlightOpen;
+  std::optional<std::string> highlightClose;
+  std::optional<double> snippetTokens;
+
+  ColdSearchOptions() = default;
+  ColdSearchOptions(std::optional<double> limit, std::optional<double> offset, std::optional<ColdSearchOrder> order,
+                    std::optional<std::string> snippetColumn, std::optional<std::string> highlightOpen,
+                    std::optional<std::string> highlightClose, std::optional<double> snippetTokens)
+      : limit(limit), offset(offset), order(order), snippetColumn(snippetColumn), highlightOpen(highlightOpen),
+        highlightClose(highlightClose), snippetTokens(snippetTokens) {}
+};
+
+// ============================================================================
+// Startup Types
+// ============================================================================
+
+struct StartupConfig {
+  std::optional<bool> lazyCold;
+
+  StartupConfig() = default;
+  explicit StartupConfig(std::optional<bool> lazyCold) : lazyCold(lazyCold) {}
+};
+
+struct StartupStage {
+  std::string stage;
+  double startMs;
+  double durationMs;
+  bool background;
+
+  StartupStage() = default;
+  StartupStage(std::string stage, double startMs, double durationMs, bool background)
+      : stage(stage), startMs(startMs), durationMs(durationMs), background(background) {}
+};
+
+// ============================================================================
+// Memory Governor Types
+// ============================================================================
+
+enum class MemoryPressureLevel { NORMAL, MODERATE, CRITICAL };
+
+struct MemoryUsage {
+  double budgetBytes;
+  double totalBytes;
+  double warmMappedBytes;
+  double warmInstances;
+  double warmResidentInstances;
+  double warmSnapshotBytes;
+  double coldCacheBytes;
+  double listenerBytes;
+  double dispatchBytes;
+  double mfeBytes;
+  double warmEvictions;
+  MemoryPressureLevel lastPressure;
+
+  MemoryUsage() = default;
+  MemoryUsage(double budgetBytes, double totalBytes, double warmMappedBytes, double warmInstances,
+              double warmResidentInstances, double warmSnapshotBytes, double coldCacheBytes, double listenerBytes,
+              double dispatchBytes, double mfeBytes, double warmEvictions, MemoryPressureLevel lastPressure)
+      : budgetBytes(budgetBytes), totalBytes(totalBytes), warmMappedBytes(warmMappedBytes),
+        warmInstances(warmInstances), warmResidentInstances(warmResidentInstances),
+        warmSnapshotBytes(warmSnapshotBytes), coldCacheBytes(coldCacheBytes),
+        listenerBytes(listenerBytes), dispatchBytes(dispatchBytes), mfeBytes(mfeBytes), warmEvictions(warmEvictions),
+        lastPressure(lastPressure) {}
+};
+
+// ============================================================================
+// MFE Registry Types
+// ============================================================================
+
+enum class MFEPhase { IDLE, LOADING, LOADED, VERSIONED, MOUNTED, FAILED };
+
+struct MFERecord {
+  std::string mfeId;
+  MFEPhase phase;
+  std::optional<std::string> version;
+  std::optional<std::string> errorMessage;
+  std::optional<double> loadedAt;
+  std::optional<double> mountedAt;
+  std::optional<double> unmountedAt;
+  std::optional<double> loadTimeMs;
+  double updatedAt;
+
+  MFERecord() = default;
+  MFERecord(std::string mfeId, MFEPhase phase, std::optional<std::string> version,
+            std::optional<std::string> errorMessage, std::optional<double> loadedAt,
+            std::optional<double> mountedAt, std::optional<double> unmountedAt,
+            std::optional<double> loadTimeMs, double updatedAt)
+      : mfeId(mfeId), phase(phase), version(version), errorMessage(errorMessage), loadedAt(loadedAt),
+        mountedAt(mountedAt), unmountedAt(unmountedAt), loadTimeMs(loadTimeMs), updatedAt(updatedAt) {}
+};
+
+struct MFERecordUpdate {
+  std::optional<std::string> version;
+  std::optional<std::string> errorMessage;
+  std::optional<double> loadedAt;
+  std::optional<double> mountedAt;
+  std::optional<double> unmountedAt;
+  std::optional<double> loadTimeMs;
+
+  MFERecordUpdate() = default;
+  MFERecordUpdate(std::optional<std::string> version, std::optional<std::string> errorMessage,
+                  std::optional<double> loadedAt, std::optional<double> mountedAt,
+                  std::optional<double> unmountedAt, std::optional<double> loadTimeMs)
+      : version(version), errorMessage(errorMessage), loadedAt(loadedAt), mountedAt(mountedAt),
+        unmountedAt(unmountedAt), loadTimeMs(loadTimeMs) {}
+};
+
+struct MFELoadStats {
+  std::string mfeId;
+  double count;
+  double minMs;
+  double maxMs;
+  double meanMs;
+  double p50Ms;
+  double p95Ms;
+
+  MFELoadStats() = default;
+  MFELoadStats(std::string mfeId, double count, double minMs, double maxMs, double meanMs, double p50Ms,
+               double p95Ms)
+      : mfeId(mfeId), count(count), minMs(minMs), maxMs(maxMs), meanMs(meanMs), p50Ms(p50Ms), p95Ms(p95Ms) {}
+};
+
+struct MFETransition {
+  std::string mfeId;
+  MFEPhase previousPhase;
+  std::optional<MFERecord> record;
+
+  MFETransition() = default;
+  MFETransition(std::string mfeId, MFEPhase previousPhase, std::optional<MFERecord> record)
+      : mfeId(mfeId), previousPhase(previousPhase), record(record) {}
+};
+
+// ============================================================================
+// Network Types
+// ============================================================================
+
+struct NetworkState {
+  NetworkStatus status;
+  ConnectionType type;
+  bool isConnected;
+  double isInternetReachable;
+  CellularGeneration cellularGeneration;
+  double wifiStrength;
+  bool isConnectionExpensive;
+  double timestamp;
+
+  NetworkState() = default;
+  NetworkState(NetworkStatus status, ConnectionType type, bool isConnected, double isInternetReachable,
+               CellularGeneration cellularGeneration, double wifiStrength, bool isConnectionExpensive,
+               double timestamp)
+      : status(status), type(type), isConnected(isConnected), isInternetReachable(isInternetReachable),
+        cellularGeneration(cellularGeneration), wifiStrength(wifiStrength),
+        isConnectionExpensive(isConnectionExpensive), timestamp(timestamp) {}
+};
+
+// ============================================================================
+// HybridSideFxSpec
+// ============================================================================
+
+class HybridSideFxSpec : public virtual HybridObject {
+public:
+  static constexpr auto TAG = "SideFx";
+
+  HybridSideFxSpec() : HybridObject(TAG) {}
+  ~HybridSideFxSpec() override = default;
+
+  // Listener Management
+  virtual ListenerResult addListener(const std::string& id, const ListenerConfig& config) = 0;
+  virtual ListenerResult addStorageTrigger(const std::string& id, const std::string& actionType,
+                                           const ListenerConfig& config) = 0;
+  virtual ListenerResult removeListener(const std::string& id) = 0;
+  virtual double removeAllListeners() = 0;
+  virtual bool hasListener(const std::string& id) = 0;
+  virtual std::vector<std::string> getListenerIds() = 0;
+  virtual std::vector<ListenerInfo> getListeners() = 0;
+  virtual std::optional<ListenerInfo> getListener(const std::string& id) = 0;
+  virtual ListenerResult pauseListener(const std::string& id) = 0;
+  virtual ListenerResult resumeListener(const std::string& id) = 0;
+
+  // Configuration
+  virtual void configure(const SAMConfig& config) = 0;
+  virtual std::string getDefaultWarmPath() = 0;
+  virtual void setWarmRootPath(const std::string& rootPath) = 0;
+  virtual ListenerResult initializeWarm(const std::optional<std::string>& instanceId,
+                                        const std::optional<WarmConfig>& config) = 0;
+  virtual std::string createWarmEncryptionKey() = 0;
+  virtual ListenerResult initializeCold(const std::string& databaseName, const std::string& databasePath,
+                                       const std::optional<ColdConfig>& config) = 0;
+  virtual bool isWarmInitialized(const std::optional<std::string>& instanceId) = 0;
+  virtual bool isColdInitialized(const std::optional<std::string>& databaseName) = 0;
+
+  // Manual Triggers
+  virtual void checkWarmChanges() = 0;
+  virtual void checkColdChanges(const std::string& databaseName, const std::optional<std::string>& table) = 0;
+
+  // Debug
+  virtual bool isDebugMode() = 0;
+  virtual void setDebugMode(bool enabled) = 0;
+  virtual void setLogLevel(double level, const std::optional<LogCategory>& category) = 0;
+  virtual double getLogLevel(const std::optional<LogCategory>& category) = 0;
+  virtual void flushLogs() = 0;
+  virtual std::string getVersion() = 0;
+
+  // Storage Operations
+  virtual ListenerResult setWarm(const std::string& key, const std::variant<bool, std::string, double>& value,
+                                 const std::optional<std::string>& instanceId,
+                                 const std::optional<double>& ttlMs) = 0;
+  virtual std::variant<NullType, bool, std::string, double> getWarm(
+      const std::string& key, const std::optional<std::string>& instanceId) = 0;
+  virtual ListenerResult deleteWarm(const std::string& key, const std::optional<std::string>& instanceId) = 0;
+  virtual ListenerResult executeCold(
+      const std::string& sql, const std::optional<std::vector<std::variant<NullType, bool, std::string, double>>>& params,
+      const std::optional<std::string>& databaseName) = 0;
+  virtual ListenerResult executeColdScript(const std::string& sql, const std::optional<std::string>& databaseName) = 0;
+  virtual std::variant<NullType, std::string> queryCold(
+      const std::string& sql, const std::optional<std::vector<std::variant<NullType, bool, std::string, double>>>& params,
+      const std::optional<std::string>& databaseName) = 0;
+
+  // Zero-copy Buffer Reads
+  virtual std::variant<NullType, std::shared_ptr<ArrayBuffer>> getWarmBuffer(
+      const std::string& key, const std::optional<std::string>& instanceId) = 0;
+  virtual std::variant<NullType, std::shared_ptr<ArrayBuffer>> queryColdBuffer(
+      const std::string& sql, const std::optional<std::vector<std::variant<NullType, bool, std::string, double>>>& params,
+      const std::optional<std::string>& databaseName) = 0;
+
+  // Full-Text Search
+  virtual ListenerResult declareColdSearch(const ColdSearchConfig& config,
+                                           const std::optional<std::string>& databaseName) = 0;
+  virtual std::variant<NullType, std::shared_ptr<ArrayBuffer>> searchCold(
+      const std::string& table, const std::string& query, const std::optional<ColdSearchOptions>& options,
+      const std::optional<std::string>& databaseName) = 0;
+
+  // Warm Compaction
+  virtual void configureWarmCompaction(const WarmCompactionConfig& config) = 0;
+  virtual void compactWarm(const std::optional<std::string>& instanceId) = 0;
+  virtual std::vector<WarmCompactionStats> getWarmCompactionStats(const std::optional<std::string>& instanceId) = 0;
+
+  // Cold Checkpoints
+  virtual void configureColdCheckpoints(const ColdCheckpointConfig& config) = 0;
+  virtual void checkpointCold(const std::optional<std::string>& databaseName) = 0;
+  virtual std::vector<ColdCheckpointStats> getColdCheckpointStats(const std::optional<std::string>& databaseName) = 0;
+
+  // Startup
+  virtual void configureStartup(const StartupConfig& config) = 0;
+  virtual std::shared_ptr<Promise<ListenerResult>> prewarmWarm(const std::vector<WarmPrewarmInstance>& instances) = 0;
+  virtual std::vector<StartupStage> getStartupTimings() = 0;
+  virtual MemoryUsage getMemoryUsage() = 0;
+  virtual void handleMemoryPressure(MemoryPressureLevel level) = 0;
+  virtual void configureSecureCache(const std::string& service, double ttlMs) = 0;
+  virtual double getSecureCacheGeneration(const std::string& service) = 0;
+  virtual bool cacheSecureValue(const std::string& service, const std::string& username,
+                                const std::string& password, const std::optional<double>& generation) = 0;
+  virtual std::optional<SecureCachedValue> getCachedSecureValue(const std::string& service) = 0;
+  virtual void invalidateSecureValue(const std::optional<std::string>& service) = 0;
+
+  // Async Cold Storage
+  virtual std::shared_ptr<Promise<ListenerResult>> executeColdAsync(
+      const std::string& sql, const std::optional<std::vector<std::variant<NullType, bool, std::string, double>>>& params,
+      const std::optional<std::string>& databaseName, const std::optional<double>& cancelToken) = 0;
+  virtual std::shared_ptr<Promise<std::variant<NullType, std::string>>> queryColdAsync(
+      const std::string& sql, const std::optional<std::vector<std::variant<NullType, bool, std::string, double>>>& params,
+      const std::optional<std::string>& databaseName, const std::optional<double>& cancelToken) = 0;
+  virtual std::shared_ptr<Promise<std::variant<NullType, std::string>>> queryColdAcross(
+      const std::string& sql, const std::vector<std::string>& databaseNames,
+      const std::optional<std::vector<std::variant<NullType, bool, std::string, double>>>& params,
+      const std::optional<ColdAcrossOptions>& options, const std::optional<double>& cancelToken) = 0;
+  virtual bool cancelColdRequests(double cancelToken) = 0;
+
+  // Change Dispatch
+  virtual void setChangeEventHandler(
+      const std::function<void(const std::vector<ChangeEvent>& /* events */)>& handler) = 0;
+  virtual DispatchAllocationStats getDispatchAllocationStats() = 0;
+
+  // Metrics
+  virtual SAMMetrics getMetrics() = 0;
+  virtual SAMMetrics snapshotAndResetMetrics() = 0;
+
+  // Action Routing (Missile)
+  virtual double addActionRoute(const std::vector<std::string>& patterns, bool once) = 0;
+  virtual bool removeActionRoute(double routeId) = 0;
+  virtual std::vector<double> matchActionRoutes(const std::string& actionType) = 0;
+
+  // MFE Registry
+  virtual MFERecord setMFERecord(const std::string& mfeId, MFEPhase phase,
+                                 const std::optional<MFERecordUpdate>& update) = 0;
+  virtual std::optional<MFERecord> getMFERecord(const std::string& mfeId) = 0;
+  virtual std::vector<MFERecord> getAllMFEStates() = 0;
+  virtual bool clearMFERecord(const std::string& mfeId) = 0;
+  virtual void recordMFELoadTime(const std::string& mfeId, double loadTimeMs) = 0;
+  virtual std::vector<MFELoadStats> getMFELoadStats(const std::optional<std::string>& mfeId) = 0;
+  virtual void resetMFELoadStats(const std::optional<std::string>& mfeId) = 0;
+  virtual void setMFETransitionHandler(
+      const std::function<void(const std::vector<MFETransition>& /* transitions */)>& handler) = 0;
+
+  // Network Monitoring
+  virtual ListenerResult startNetworkMonitoring() = 0;
+  virtual ListenerResult stopNetworkMonitoring() = 0;
+  virtual bool isNetworkMonitoringActive() = 0;
+  virtual NetworkState getNetworkState() = 0;
+  virtual void refreshNetworkState() = 0;
+  virtual void setActivePingMode(bool enabled) = 0;
+  virtual void reportNetworkLatency(double latencyMs) = 0;
+  virtual void reportNetworkFailure() = 0;
+  virtual void setPingEndpoints(const std::vector<std::string>& endpoints) = 0;
+};
+
+} // namespace margelo::nitro::sam
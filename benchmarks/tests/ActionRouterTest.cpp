@@ -0,0 +1,75 @@
+#include "ActionRouter.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace margelo::nitro::sam;
+using Ids = std::vector<uint32_t>;
+
+namespace {
+
+Ids matchIds(ActionRouter& router, std::string_view type) {
+  Ids out;
+  router.match(type, out);
+  return out;
+}
+
+} // namespace
+
+TEST_CASE("ActionRouter matches exact, prefix and catch-all patterns", "[ActionRouter]") {
+  ActionRouter router;
+  uint32_t exact = router.add({"cart/ADD"}, false);
+  uint32_t prefix = router.add({"cart/*"}, false);
+  uint32_t all = router.add({"*"}, false);
+
+  CHECK(matchIds(router, "cart/ADD") == Ids{exact, prefix, all});
+  CHECK(matchIds(router, "cart/REMOVE") == Ids{prefix, all});
+  // The prefix keeps its slash, so "cartography" is not under "cart/"
+  CHECK(matchIds(router, "cartography") == Ids{all});
+  CHECK(matchIds(router, "cart/ADD/extra") == Ids{prefix, all});
+  CHECK(matchIds(router, "cart") == Ids{all});
+}
+
+TEST_CASE("ActionRouter returns each route once, in registration order", "[ActionRouter]") {
+  ActionRouter router;
+  uint32_t first = router.add({"user/*", "user/LOGIN"}, false);
+  uint32_t second = router.add({"user/LOGIN"}, false);
+
+  CHECK(matchIds(router, "user/LOGIN") == Ids{first, second});
+  CHECK(matchIds(router, "user/LOGOUT") == Ids{first});
+}
+
+TEST_CASE("ActionRouter consumes once routes on their first match", "[ActionRouter]") {
+  ActionRouter router;
+  uint32_t take = router.add({"auth/TOKEN"}, true);
+  uint32_t watcher = router.add({"auth/*"}, false);
+
+  CHECK(router.hasMatch("auth/TOKEN"));
+  CHECK(matchIds(router, "auth/TOKEN") == Ids{take, watcher});
+  CHECK(matchIds(router, "auth/TOKEN") == Ids{watcher});
+  CHECK(router.size() == 1);
+}
+
+TEST_CASE("ActionRouter removes routes and resets an idle trie", "[ActionRouter]") {
+  ActionRouter router;
+  uint32_t route = router.add({"a/b"}, false);
+  CHECK(router.remove(route));
+  CHECK_FALSE(router.remove(route));
+  CHECK(matchIds(router, "a/b").empty());
+  CHECK_FALSE(router.hasMatch("a/b"));
+
+  std::vector<uint32_t> ids;
+  for (int i = 0; i < 5000; ++i) {
+    ids.push_back(router.add({"long/type/number/" + std::to_string(i)}, false));
+  }
+  REQUIRE(router.nodeCount() > 4096);
+  for (uint32_t id : ids) {
+    router.remove(id);
+  }
+  CHECK(router.size() == 0);
+  CHECK(router.nodeCount() == 1);
+}
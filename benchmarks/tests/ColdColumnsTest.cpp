@@ -0,0 +1,97 @@
+#include "ColdColumns.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace margelo::nitro::sam;
+
+namespace {
+
+/**
+ * Read the rows of `sql` (a SELECT over VALUES) into a part
+ */
+std::unique_ptr<ColdColumns> readPart(const char* sql) {
+  sqlite3* db = nullptr;
+  REQUIRE(sqlite3_open(":memory:", &db) == SQLITE_OK);
+  sqlite3_stmt* stmt = nullptr;
+  REQUIRE(sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK);
+  auto part = std::make_unique<ColdColumns>();
+  CHECK(part->read(stmt) == SQLITE_OK);
+  sqlite3_finalize(stmt);
+  sqlite3_close(db);
+  return part;
+}
+
+std::string merge(const std::vector<std::unique_ptr<ColdColumns>>& parts, std::optional<size_t> column,
+                  bool descending, size_t limit) {
+  std::vector<const ColdColumns*> pointers;
+  std::vector<std::string> databases;
+  for (size_t i = 0; i < parts.size(); ++i) {
+    pointers.push_back(parts[i].get());
+    databases.push_back("db" + std::to_string(i));
+  }
+  return ColdColumns::mergeJson(pointers, databases, column, descending, limit);
+}
+
+} // namespace
+
+TEST_CASE("ColdColumns merges sorted parts in order, ties to the earlier part", "[ColdColumns]") {
+  std::vector<std::unique_ptr<ColdColumns>> parts;
+  parts.push_back(readPart("SELECT column1 AS id, column2 AS tag FROM (VALUES (5,'a5'),(1,'a1'),(3,'a3'))"));
+  parts.push_back(readPart("SELECT column1 AS id, column2 AS tag FROM (VALUES (6,'b6'),(2,'b2'),(1,'b1'))"));
+  for (auto& part : parts) {
+    part->sort(*part->columnIndex("id"), false, 10);
+  }
+
+  CHECK(merge(parts, 0, false, 10) ==
+        R"({"columns":["id","tag"],"databases":["db0","db1"],"rowCount":6,"source":[0,1,1,0,0,1],)"
+        R"("values":[[1,1,2,3,5,6],["a1","b1","b2","a3","a5","b6"]]})");
+}
+
+TEST_CASE("ColdColumns merges descending parts up to the limit", "[ColdColumns]") {
+  std::vector<std::unique_ptr<ColdColumns>> parts;
+  parts.push_back(readPart("SELECT column1 AS total FROM (VALUES (1.5),(9),(4))"));
+  parts.push_back(readPart("SELECT column1 AS total FROM (VALUES (7),(8.25),(2))"));
+  for (auto& part : parts) {
+    part->sort(0, true, 3);
+    CHECK(part->rowCount() == 3);
+  }
+
+  CHECK(merge(parts, 0, true, 3) ==
+        R"({"columns":["total"],"databases":["db0","db1"],"rowCount":3,"source":[0,1,1],"values":[[9,8.25,7]]})");
+}
+
+TEST_CASE("ColdColumns sorts by SQLite's type order", "[ColdColumns]") {
+  std::vector<std::unique_ptr<ColdColumns>> parts;
+  parts.push_back(readPart("SELECT column1 AS v FROM (VALUES (x'00'),('b'),(2.5),(NULL),('a'),(2),(x''),(10))"));
+  parts[0]->sort(0, false, 100);
+
+  CHECK(merge(parts, 0, false, 100) ==
+        R"({"columns":["v"],"databases":["db0"],"rowCount":8,"source":[0,0,0,0,0,0,0,0],)"
+        R"("values":[[null,2,2.5,10,"a","b","","AA=="]]})");
+}
+
+TEST_CASE("ColdColumns concatenates unsorted parts in part order", "[ColdColumns]") {
+  std::vector<std::unique_ptr<ColdColumns>> parts;
+  parts.push_back(readPart("SELECT column1 AS id FROM (VALUES (3),(1))"));
+  parts.push_back(readPart("SELECT column1 AS id FROM (VALUES (2))"));
+  parts.push_back(readPart("SELECT column1 AS id FROM (VALUES (9),(8))"));
+
+  CHECK(merge(parts, std::nullopt, false, 4) ==
+        R"({"columns":["id"],"databases":["db0","db1","db2"],"rowCount":4,"source":[0,0,1,2],"values":[[3,1,2,9]]})");
+}
+
+TEST_CASE("ColdColumns truncates to the first rows in query order", "[ColdColumns]") {
+  std::vector<std::unique_ptr<ColdColumns>> parts;
+  parts.push_back(readPart("SELECT column1 AS id FROM (VALUES (3),(1),(2))"));
+  parts[0]->truncate(2);
+  CHECK(parts[0]->rowCount() == 2);
+  parts.push_back(readPart("SELECT column1 AS id FROM (VALUES (4)) WHERE 0"));
+
+  CHECK(merge(parts, std::nullopt, false, 10) ==
+        R"({"columns":["id"],"databases":["db0","db1"],"rowCount":2,"source":[0,0],"values":[[3,1]]})");
+}
@@ -0,0 +1,120 @@
+#include "MFERecordCodec.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <optional>
+#include <string>
+
+using namespace margelo::nitro::sam;
+
+namespace {
+
+MFERecord fullRecord() {
+  return MFERecord("checkout", MFEPhase::VERSIONED, std::string("3.1.4"), std::string("retry \"later\""), 1000.5,
+                   2000.25, std::nullopt, 123.0, 4000.0);
+}
+
+void checkSame(const MFERecord& a, const MFERecord& b) {
+  CHECK(a.mfeId == b.mfeId);
+  CHECK(a.phase == b.phase);
+  CHECK(a.version == b.version);
+  CHECK(a.errorMessage == b.errorMessage);
+  CHECK(a.loadedAt == b.loadedAt);
+  CHECK(a.mountedAt == b.mountedAt);
+  CHECK(a.unmountedAt == b.unmountedAt);
+  CHECK(a.loadTimeMs == b.loadTimeMs);
+  CHECK(a.updatedAt == b.updatedAt);
+}
+
+} // namespace
+
+TEST_CASE("MFE records round-trip through the binary codec", "[MFERecordCodec]") {
+  std::string bytes;
+  MFERecord record = fullRecord();
+  mfe_record::encode(record, bytes);
+  CHECK(bytes.size() == mfe_record::kHeaderSize + 5 + 13);
+
+  auto decoded = mfe_record::decode("checkout", bytes.data(), bytes.size());
+  REQUIRE(decoded.has_value());
+  checkSame(*decoded, record);
+
+  // Absent optionals stay absent, and an empty string is still present
+  MFERecord sparse("idle", MFEPhase::IDLE, std::string(), std::nullopt, std::nullopt, std::nullopt,
+                   std::nullopt, std::nullopt, 1.0);
+  mfe_record::encode(sparse, bytes);
+  decoded = mfe_record::decode("idle", bytes.data(), bytes.size());
+  REQUIRE(decoded.has_value());
+  checkSame(*decoded, sparse);
+}
+
+TEST_CASE("The codec rejects truncated, oversized and unknown records", "[MFERecordCodec]") {
+  std::string bytes;
+  mfe_record::encode(fullRecord(), bytes);
+
+  CHECK_FALSE(mfe_record::decode("x", bytes.data(), bytes.size() - 1).has_value());
+  CHECK_FALSE(mfe_record::decode("x", bytes.data(), mfe_record::kHeaderSize - 1).has_value());
+  std::string longer = bytes + "!";
+  CHECK_FALSE(mfe_record::decode("x", longer.data(), longer.size()).has_value());
+
+  std::string unknownFormat = bytes;
+  unknownFormat[0] = static_cast<char>(mfe_record::kFormat + 1);
+  CHECK_FALSE(mfe_record::decode("x", unknownFormat.data(), unknownFormat.size()).has_value());
+
+  std::string badPhase = bytes;
+  badPhase[1] = static_cast<char>(static_cast<uint8_t>(MFEPhase::FAILED) + 1);
+  CHECK_FALSE(mfe_record::decode("x", badPhase.data(), badPhase.size()).has_value());
+}
+
+TEST_CASE("Legacy state strings map to phases", "[MFERecordCodec]") {
+  using mfe_record::legacy::phaseOf;
+  CHECK(phaseOf("") == MFEPhase::IDLE);
+  CHECK(phaseOf("loading") == MFEPhase::LOADING);
+  CHECK(phaseOf("loaded") == MFEPhase::LOADED);
+  CHECK(phaseOf("mounted") == MFEPhase::MOUNTED);
+  CHECK(phaseOf("error") == MFEPhase::FAILED);
+  CHECK(phaseOf("1.0.0") == MFEPhase::VERSIONED);
+}
+
+TEST_CASE("Legacy state and metadata JSON decode into a record", "[MFERecordCodec]") {
+  auto record = mfe_record::legacy::decode(
+      "home", std::string("mounted"),
+      std::string(R"({"state":"mounted","version":"1.2.0","loadedAt":1000,"mountedAt":2500.5,)"
+                  R"("loadTimeMs":150,"errorMessage":"line\nnext \"q\" é😀"})"),
+      9999);
+  REQUIRE(record.has_value());
+  CHECK(record->mfeId == "home");
+  CHECK(record->phase == MFEPhase::MOUNTED);
+  CHECK(record->version == "1.2.0");
+  CHECK(record->errorMessage == "line\nnext \"q\" \xc3\xa9\xf0\x9f\x98\x80");
+  CHECK(record->loadedAt == 1000);
+  CHECK(record->mountedAt == 2500.5);
+  CHECK_FALSE(record->unmountedAt.has_value());
+  CHECK(record->loadTimeMs == 150);
+  // No update time in the legacy format: the latest timestamp stands in
+  CHECK(record->updatedAt == 2500.5);
+}
+
+TEST_CASE("Legacy records decode from either key alone", "[MFERecordCodec]") {
+  // A version state without metadata keeps the version
+  auto versioned = mfe_record::legacy::decode("cart", std::string("2.0.1"), std::nullopt, 42);
+  REQUIRE(versioned.has_value());
+  CHECK(versioned->phase == MFEPhase::VERSIONED);
+  CHECK(versioned->version == "2.0.1");
+  CHECK(versioned->updatedAt == 42);
+
+  // Metadata alone supplies the state
+  auto failed = mfe_record::legacy::decode(
+      "settings", std::nullopt, std::string(R"( { "state" : "error" , "errorMessage" : "boom", "x": null } )"), 7);
+  REQUIRE(failed.has_value());
+  CHECK(failed->phase == MFEPhase::FAILED);
+  CHECK(failed->errorMessage == "boom");
+
+  // Unreadable metadata is ignored when the state key is there
+  auto stateOnly = mfe_record::legacy::decode("feed", std::string("loaded"), std::string("{not json"), 7);
+  REQUIRE(stateOnly.has_value());
+  CHECK(stateOnly->phase == MFEPhase::LOADED);
+  CHECK_FALSE(stateOnly->loadedAt.has_value());
+
+  CHECK_FALSE(mfe_record::legacy::decode("gone", std::nullopt, std::string(R"({"a":{"nested":1}})"), 7).has_value());
+  CHECK_FALSE(mfe_record::legacy::decode("gone", std::nullopt, std::nullopt, 7).has_value());
+}
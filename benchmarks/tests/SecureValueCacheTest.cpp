@@ -0,0 +1,112 @@
+#include "SecureValueCache.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <chrono>
+
+using namespace margelo::nitro::sam;
+using namespace std::chrono_literals;
+
+namespace {
+
+using Clock = SecureValueCache::Clock;
+
+const Clock::time_point kStart{};
+
+} // namespace
+
+TEST_CASE("SecureValueCache only caches services with a TTL", "[SecureValueCache]") {
+  SecureValueCache cache;
+  CHECK_FALSE(cache.put("auth", "user", "token", kStart));
+  CHECK(cache.size() == 0);
+
+  cache.setTtl("auth", 100ms);
+  REQUIRE(cache.put("auth", "user", "token", kStart));
+  auto value = cache.get("auth", kStart + 99ms);
+  REQUIRE(value.has_value());
+  CHECK(value->username == "user");
+  CHECK(value->password == "token");
+
+  CHECK_FALSE(cache.get("auth", kStart + 100ms).has_value());
+  CHECK(cache.size() == 0);
+}
+
+TEST_CASE("SecureValueCache drops a service when its TTL is turned off", "[SecureValueCache]") {
+  SecureValueCache cache;
+  cache.setTtl("auth", 100ms);
+  REQUIRE(cache.put("auth", "", "", kStart));
+  CHECK(cache.get("auth", kStart).has_value());
+
+  cache.setTtl("auth", 0ms);
+  CHECK(cache.size() == 0);
+  CHECK_FALSE(cache.put("auth", "user", "token", kStart));
+}
+
+TEST_CASE("SecureValueCache generations advance on erase and clear", "[SecureValueCache]") {
+  SecureValueCache cache;
+  uint64_t auth = cache.generation("auth");
+  uint64_t api = cache.generation("api");
+
+  cache.erase("auth");
+  CHECK(cache.generation("auth") != auth);
+  CHECK(cache.generation("api") == api);
+
+  uint64_t erased = cache.generation("auth");
+  cache.clear();
+  CHECK(cache.generation("auth") != erased);
+  CHECK(cache.generation("api") != api);
+
+  // An erase after clear() still moves the service forward
+  uint64_t cleared = cache.generation("auth");
+  cache.erase("auth");
+  CHECK(cache.generation("auth") > cleared);
+}
+
+TEST_CASE("SecureValueCache refuses a put from before an invalidation", "[SecureValueCache]") {
+  SecureValueCache cache;
+  cache.setTtl("auth", 1s);
+  cache.setTtl("api", 1s);
+
+  SECTION("erase of the same service") {
+    uint64_t generation = cache.generation("auth");
+    cache.erase("auth");
+    CHECK_FALSE(cache.put("auth", "user", "stale", kStart, generation));
+    CHECK_FALSE(cache.get("auth", kStart).has_value());
+    CHECK(cache.put("auth", "user", "fresh", kStart, cache.generation("auth")));
+  }
+
+  SECTION("erase of another service") {
+    uint64_t generation = cache.generation("auth");
+    cache.erase("api");
+    CHECK(cache.put("auth", "user", "token", kStart, generation));
+  }
+
+  SECTION("clear") {
+    uint64_t generation = cache.generation("auth");
+    cache.clear();
+    CHECK_FALSE(cache.put("auth", "user", "stale", kStart, generation));
+  }
+
+  SECTION("no generation given") {
+    cache.erase("auth");
+    CHECK(cache.put("auth", "user", "token", kStart));
+  }
+}
+
+TEST_CASE("SecureValueCache purges and reports expiries", "[SecureValueCache]") {
+  SecureValueCache cache;
+  cache.setTtl("short", 10ms);
+  cache.setTtl("long", 50ms);
+  CHECK_FALSE(cache.nextExpiry().has_value());
+
+  cache.put("long", "a", "b", kStart);
+  cache.put("short", "c", "d", kStart);
+  REQUIRE(cache.nextExpiry().has_value());
+  CHECK(*cache.nextExpiry() == kStart + 10ms);
+
+  CHECK(cache.purgeExpired(kStart + 10ms) == 1);
+  CHECK(cache.size() == 1);
+  CHECK(*cache.nextExpiry() == kStart + 50ms);
+  CHECK(cache.purgeExpired(kStart + 60ms) == 1);
+  CHECK(cache.size() == 0);
+}
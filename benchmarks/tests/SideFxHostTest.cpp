@@ -0,0 +1,293 @@
+// Host tests for cpp/HybridSideFx.hpp on the stand-ins in ../host: the Warm,
+// Cold and listener paths the benchmark suite times, checked for results
+
+#include "HybridSideFx.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace margelo::nitro::sam;
+using margelo::nitro::NullType;
+
+namespace {
+
+std::shared_ptr<HybridSideFx> makeSideFx() {
+  auto sideFx = std::make_shared<HybridSideFx>();
+  sideFx->setWarmRootPath("/tmp/sam-tests");
+  sideFx->initializeWarm("default", std::nullopt);
+  return sideFx;
+}
+
+ListenerConfig warmKeysListener(std::vector<std::string> keys, const std::string& instanceId = "default") {
+  WarmListenerConfig warm;
+  warm.keys = std::move(keys);
+  warm.instanceId = instanceId;
+  return ListenerConfig(warm, std::nullopt, std::nullopt, std::nullopt);
+}
+
+/**
+ * Collects the events delivered to a HybridSideFx's change handler
+ */
+struct EventSink {
+  std::mutex mutex;
+  std::vector<ChangeEvent> events;
+
+  void attach(HybridSideFx& sideFx) {
+    sideFx.setChangeEventHandler([this](const std::vector<ChangeEvent>& batch) {
+      std::lock_guard<std::mutex> lock(mutex);
+      events.insert(events.end(), batch.begin(), batch.end());
+    });
+  }
+
+  std::vector<ChangeEvent> take() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return std::exchange(events, {});
+  }
+
+  /** Wait up to two seconds for `count` events, then take them */
+  std::vector<ChangeEvent> take(size_t count) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (std::chrono::steady_clock::now() < deadline) {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (events.size() >= count) {
+          break;
+        }
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return take();
+  }
+};
+
+} // namespace
+
+TEST_CASE("Warm values round-trip by type", "[host]") {
+  auto sideFx = makeSideFx();
+  sideFx->setWarm("host.string", std::string("value"), std::nullopt, std::nullopt);
+  sideFx->setWarm("host.number", 42.5, std::nullopt, std::nullopt);
+  sideFx->setWarm("host.bool", true, std::nullopt, std::nullopt);
+
+  CHECK(std::get<std::string>(sideFx->getWarm("host.string", std::nullopt)) == "value");
+  CHECK(std::get<double>(sideFx->getWarm("host.number", std::nullopt)) == 42.5);
+  CHECK(std::get<bool>(sideFx->getWarm("host.bool", std::nullopt)));
+
+  sideFx->deleteWarm("host.string", std::nullopt);
+  CHECK(std::holds_alternative<NullType>(sideFx->getWarm("host.string", std::nullopt)));
+}
+
+TEST_CASE("queryCold escapes text in its JSON", "[host]") {
+  auto sideFx = makeSideFx();
+  sideFx->initializeCold("host", ":memory:", std::nullopt);
+  sideFx->executeCold("CREATE TABLE notes (id INTEGER PRIMARY KEY, body TEXT)", std::nullopt, "host");
+  sideFx->executeCold("INSERT INTO notes (body) VALUES ('say \"hi\"\nbye')", std::nullopt, "host");
+
+  auto result = sideFx->queryCold("SELECT id, body FROM notes", std::nullopt, "host");
+  CHECK(std::get<std::string>(result) == "[{\"id\":1,\"body\":\"say \\\"hi\\\"\\nbye\"}]");
+}
+
+TEST_CASE("A listener receives only matching writes", "[host]") {
+  auto sideFx = makeSideFx();
+  EventSink sink;
+  sink.attach(*sideFx);
+  REQUIRE(sideFx->addListener("watch", warmKeysListener({"host.watched"})).success);
+
+  sideFx->setWarm("host.watched", std::string("a"), std::nullopt, std::nullopt);
+  sideFx->setWarm("host.ignored", std::string("b"), std::nullopt, std::nullopt);
+  sideFx->waitForDispatch();
+
+  auto events = sink.take();
+  REQUIRE(events.size() == 1);
+  CHECK(events[0].listenerId == "watch");
+  CHECK(events[0].key == "host.watched");
+  CHECK(events[0].operation == ChangeOperation::SET);
+  REQUIRE(events[0].newValue.has_value());
+  CHECK(std::get<std::string>(*events[0].newValue) == "a");
+}
+
+TEST_CASE("A removed listener stops receiving", "[host]") {
+  auto sideFx = makeSideFx();
+  EventSink sink;
+  sink.attach(*sideFx);
+  sideFx->addListener("first", warmKeysListener({"host.key"}));
+  sideFx->addListener("second", warmKeysListener({"host.key"}));
+  REQUIRE(sideFx->getListeners().size() == 2);
+
+  sideFx->removeListener("first");
+  sideFx->setWarm("host.key", 1.0, std::nullopt, std::nullopt);
+  sideFx->waitForDispatch();
+
+  auto events = sink.take();
+  REQUIRE(events.size() == 1);
+  CHECK(events[0].listenerId == "second");
+  REQUIRE(sideFx->getListeners().size() == 1);
+  CHECK(sideFx->getListeners()[0].id == "second");
+}
+
+TEST_CASE("setLogLevel clamps out-of-range levels and ignores non-finite ones", "[host]") {
+  auto sideFx = makeSideFx();
+  sideFx->setLogLevel(2, std::nullopt);
+  sideFx->setLogLevel(std::nan(""), std::nullopt);
+  CHECK(sideFx->getLogLevel(std::nullopt) == 2);
+  sideFx->setLogLevel(HUGE_VAL, LogCategory::COLD);
+  CHECK(sideFx->getLogLevel(LogCategory::COLD) == 2);
+  sideFx->setLogLevel(9, LogCategory::COLD);
+  CHECK(sideFx->getLogLevel(LogCategory::COLD) == 5);
+  sideFx->setLogLevel(-3, std::nullopt);
+  CHECK(sideFx->getLogLevel(std::nullopt) == 0);
+}
+
+TEST_CASE("Hydrating the MFE registry migrates the JS registry's keys", "[host]") {
+  mmkv::MMKV* storage = mmkv::MMKV::mmkvWithID("sam-mfe-registry");
+  for (const std::string& key : storage->allKeys()) {
+    storage->removeValueForKey(key);
+  }
+  storage->set(std::string("mounted"), "mfe.home");
+  storage->set(std::string(R"({"state":"mounted","version":"1.2.0","loadedAt":1000,"mountedAt":2000})"),
+               "mfe.home.meta");
+  storage->set(std::string("2.0.1"), "mfe.cart");
+  storage->set(std::string(R"({"state":"error","errorMessage":"boom"})"), "mfe.settings.meta");
+  // A binary record is newer than the legacy keys of the same MFE
+  storage->set(std::string("loading"), "mfe.feed");
+  std::string bytes;
+  mfe_record::encode(MFERecord("feed", MFEPhase::LOADED, std::nullopt, std::nullopt, std::nullopt,
+                               std::nullopt, std::nullopt, std::nullopt, 5.0),
+                     bytes);
+  storage->set(mmkv::MMBuffer(bytes.data(), bytes.size()), "mfe#feed");
+
+  auto sideFx = makeSideFx();
+  sideFx->initializeWarm("sam-mfe-registry", std::nullopt);
+  std::unordered_map<std::string, MFERecord> records;
+  for (MFERecord& record : sideFx->getAllMFEStates()) {
+    records.emplace(record.mfeId, std::move(record));
+  }
+
+  REQUIRE(records.size() == 4);
+  CHECK(records["home"].phase == MFEPhase::MOUNTED);
+  CHECK(records["home"].version == "1.2.0");
+  CHECK(records["home"].mountedAt == 2000);
+  CHECK(records["cart"].phase == MFEPhase::VERSIONED);
+  CHECK(records["cart"].version == "2.0.1");
+  CHECK(records["settings"].phase == MFEPhase::FAILED);
+  CHECK(records["settings"].errorMessage == "boom");
+  CHECK(records["feed"].phase == MFEPhase::LOADED);
+
+  // Legacy keys are gone and each MFE has a binary record
+  for (const std::string& key : storage->allKeys()) {
+    CHECK(key.rfind("mfe.", 0) != 0);
+  }
+  for (const char* mfeId : {"home", "cart", "settings", "feed"}) {
+    CHECK(storage->containsKey(std::string("mfe#") + mfeId));
+  }
+
+  // A second instance reads the migrated records back
+  auto reloaded = makeSideFx();
+  reloaded->initializeWarm("sam-mfe-registry", std::nullopt);
+  CHECK(reloaded->getAllMFEStates().size() == 4);
+}
+
+TEST_CASE("Another process's writes are diffed against a compact snapshot", "[host]") {
+  const std::string instance = "host-shared";
+  // The stand-in instance stands for the other process's view of the file
+  mmkv::MMKV* outer = mmkv::MMKV::mmkvWithID(instance, mmkv::MMKV_MULTI_PROCESS);
+  for (const std::string& key : outer->allKeys()) {
+    outer->removeValueForKey(key);
+  }
+  const std::string longValue(1000, 'x');
+  outer->set(std::string("short"), "shared.short");
+  outer->set(longValue, "shared.long");
+  outer->set(std::string("gone"), "shared.deleted");
+
+  auto sideFx = makeSideFx();
+  REQUIRE(sideFx->initializeWarm(instance, WarmConfig(std::nullopt, true)).success);
+  // The long value is held as a hash, not a copy
+  double snapshotBytes = sideFx->getMemoryUsage().warmSnapshotBytes;
+  CHECK(snapshotBytes > 0);
+  CHECK(snapshotBytes < static_cast<double>(longValue.size()));
+
+  EventSink sink;
+  sink.attach(*sideFx);
+  sideFx->addListener("shared", warmKeysListener({"shared.short", "shared.long", "shared.deleted"}, instance));
+
+  outer->set(std::string("changed"), "shared.short");
+  outer->set(longValue + "y", "shared.long");
+  outer->removeValueForKey("shared.deleted");
+  outer->markChangedByOuterProcess();
+  // MMKV notices the write on the next access
+  sideFx->getWarm("shared.short", instance);
+
+  auto events = sink.take(3);
+  REQUIRE(events.size() == 3);
+  std::unordered_map<std::string, ChangeEvent> byKey;
+  for (ChangeEvent& event : events) {
+    byKey.emplace(event.key.value_or(""), std::move(event));
+  }
+  REQUIRE(byKey.count("shared.short") == 1);
+  CHECK(std::get<std::string>(*byKey["shared.short"].oldValue) == "short");
+  CHECK(std::get<std::string>(*byKey["shared.short"].newValue) == "changed");
+  REQUIRE(byKey.count("shared.long") == 1);
+  CHECK_FALSE(byKey["shared.long"].oldValue.has_value());
+  CHECK(std::get<std::string>(*byKey["shared.long"].newValue).size() == longValue.size() + 1);
+  REQUIRE(byKey.count("shared.deleted") == 1);
+  CHECK(byKey["shared.deleted"].operation == ChangeOperation::DELETE);
+  CHECK(std::get<std::string>(*byKey["shared.deleted"].oldValue) == "gone");
+
+  // This process's own writes are not reported again
+  sideFx->setWarm("shared.short", std::string("mine"), instance, std::nullopt);
+  CHECK(sink.take(1).size() == 1);
+  outer->markChangedByOuterProcess();
+  sideFx->getWarm("shared.short", instance);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  CHECK(sink.take().empty());
+}
+
+TEST_CASE("checkWarmChanges diffs shared instances without MMKV's handler", "[host]") {
+  const std::string instance = "host-shared-manual";
+  mmkv::MMKV* outer = mmkv::MMKV::mmkvWithID(instance, mmkv::MMKV_MULTI_PROCESS);
+  outer->set(std::string("before"), "shared.key");
+
+  auto sideFx = makeSideFx();
+  REQUIRE(sideFx->initializeWarm(instance, WarmConfig(std::nullopt, true)).success);
+  CHECK(mmkv::MMKV::hasContentChangeHandler());
+  EventSink sink;
+  sink.attach(*sideFx);
+  sideFx->addListener("shared", warmKeysListener({"shared.key"}, instance));
+
+  // Another library takes MMKV's single handler slot
+  mmkv::MMKV::unRegisterContentChangeHandler();
+  outer->set(std::string("after"), "shared.key");
+  sideFx->checkWarmChanges();
+  sideFx->waitForDispatch();
+
+  auto events = sink.take();
+  REQUIRE(events.size() == 1);
+  CHECK(std::get<std::string>(*events[0].oldValue) == "before");
+  CHECK(std::get<std::string>(*events[0].newValue) == "after");
+}
+
+TEST_CASE("The last owner unregisters MMKV's content change handler", "[host]") {
+  auto first = makeSideFx();
+  auto second = makeSideFx();
+  REQUIRE(first->initializeWarm("host-shared-owners", WarmConfig(std::nullopt, true)).success);
+  REQUIRE(second->initializeWarm("host-shared-owners", WarmConfig(std::nullopt, true)).success);
+  CHECK(mmkv::MMKV::hasContentChangeHandler());
+
+  first.reset();
+  CHECK(mmkv::MMKV::hasContentChangeHandler());
+  second.reset();
+  CHECK_FALSE(mmkv::MMKV::hasContentChangeHandler());
+
+  // Nothing to check without a multi-process instance
+  auto single = makeSideFx();
+  single->checkWarmChanges();
+  CHECK_FALSE(mmkv::MMKV::hasContentChangeHandler());
+}
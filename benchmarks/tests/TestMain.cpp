@@ -0,0 +1,3 @@
+// Catch2's main(); the tests live in the other files in this directory
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
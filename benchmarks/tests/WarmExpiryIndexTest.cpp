@@ -0,0 +1,103 @@
+#include "WarmExpiryIndex.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace margelo::nitro::sam;
+
+namespace {
+
+std::vector<std::string> popKeys(WarmExpiryIndex& index, double nowMs, size_t limit = 100) {
+  std::vector<WarmExpiryIndex::Expired> expired;
+  index.popExpired(nowMs, limit, expired);
+  std::vector<std::string> keys;
+  for (const auto& entry : expired) {
+    keys.push_back(entry.instanceId + "/" + entry.key);
+  }
+  return keys;
+}
+
+} // namespace
+
+TEST_CASE("WarmExpiryIndex pops due keys earliest first", "[WarmExpiryIndex]") {
+  WarmExpiryIndex index;
+  index.set("default", "c", 300);
+  index.set("default", "a", 100);
+  index.set("shared", "b", 200);
+  CHECK(index.size() == 3);
+  CHECK(index.nextDeadline() == 100);
+
+  CHECK(popKeys(index, 250) == std::vector<std::string>{"default/a", "shared/b"});
+  CHECK(index.size() == 1);
+  CHECK_FALSE(index.deadline("default", "a").has_value());
+  CHECK(index.nextDeadline() == 300);
+
+  CHECK(popKeys(index, 299).empty());
+  CHECK(popKeys(index, 300) == std::vector<std::string>{"default/c"});
+  CHECK(index.empty());
+  CHECK_FALSE(index.nextDeadline().has_value());
+}
+
+TEST_CASE("WarmExpiryIndex stops at the limit", "[WarmExpiryIndex]") {
+  WarmExpiryIndex index;
+  double deadline = 0;
+  for (const char* key : {"k0", "k1", "k2", "k3", "k4"}) {
+    index.set("default", key, deadline += 10);
+  }
+  CHECK(popKeys(index, 100, 2) == std::vector<std::string>{"default/k0", "default/k1"});
+  CHECK(popKeys(index, 100, 2) == std::vector<std::string>{"default/k2", "default/k3"});
+  CHECK(index.size() == 1);
+}
+
+TEST_CASE("WarmExpiryIndex skips replaced and cleared deadlines", "[WarmExpiryIndex]") {
+  WarmExpiryIndex index;
+  index.set("default", "moved", 100);
+  index.set("default", "cleared", 150);
+  index.set("default", "kept", 200);
+  index.set("default", "moved", 500);
+  CHECK(index.size() == 3);
+
+  CHECK(index.clear("default", "cleared"));
+  CHECK_FALSE(index.clear("default", "cleared"));
+  CHECK_FALSE(index.clear("other", "kept"));
+  CHECK(index.size() == 2);
+
+  CHECK(index.nextDeadline() == 200);
+  CHECK(index.deadline("default", "moved") == 500);
+  CHECK(popKeys(index, 400) == std::vector<std::string>{"default/kept"});
+  CHECK(popKeys(index, 500) == std::vector<std::string>{"default/moved"});
+}
+
+TEST_CASE("WarmExpiryIndex replaces one instance's deadlines", "[WarmExpiryIndex]") {
+  WarmExpiryIndex index;
+  index.set("shared", "old", 100);
+  index.set("shared", "both", 100);
+  index.set("default", "other", 300);
+
+  index.replace("shared", {{"both", 250}, {"new", 200}});
+  CHECK(index.size() == 3);
+  CHECK_FALSE(index.deadline("shared", "old").has_value());
+  CHECK(index.deadline("shared", "both") == 250);
+  CHECK(popKeys(index, 1000) == std::vector<std::string>{"shared/new", "shared/both", "default/other"});
+
+  index.set("shared", "gone", 100);
+  index.replace("shared", {});
+  CHECK(index.empty());
+  CHECK(popKeys(index, 1000).empty());
+}
+
+TEST_CASE("WarmExpiryIndex rebuilds once stale entries pile up", "[WarmExpiryIndex]") {
+  WarmExpiryIndex index;
+  index.set("default", "steady", 5000);
+  // Each renewal leaves a stale heap entry behind; the rebuilds drop them
+  for (int i = 0; i < 10000; ++i) {
+    index.set("default", "renewed", 1000.0 + i);
+  }
+  CHECK(index.size() == 2);
+  CHECK(index.deadline("default", "renewed") == 10999);
+  CHECK(index.nextDeadline() == 5000);
+  CHECK(popKeys(index, 10999) == std::vector<std::string>{"default/steady", "default/renewed"});
+  CHECK(index.empty());
+}
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace margelo::nitro::sam {
+
+/**
+ * Action-type routing table for the missile saga runtime
+ *
+ * A route is a set of string patterns: an exact type ("cart/ADD"), a prefix
+ * ending in a slash-star wildcard (matching every type that starts with
+ * "cart/", slash included) or a lone "*". Patterns live in a character trie -
+ * exact routes on the node of their last character, prefix routes on the
+ * node of the prefix, "*" on the root as the empty prefix - so matching walks
+ * the action type once and costs O(type length + matches), no matter how
+ * many routes are registered.
+ *
+ * Route IDs increase monotonically and matches are returned in ID order, so
+ * callers see routes in registration order. A route added with `once` (a
+ * pending `take`) is removed by the match that returns it. Not thread-safe.
+ */
+class ActionRouter {
+public:
+  ActionRouter() { _nodes.emplace_back(); }
+
+  uint32_t add(const std::vector<std::string>& patterns, bool once) {
+    uint32_t id = _nextId++;
+    Route& route = _routes[id];
+    route.once = once;
+    for (const std::string& pattern : patterns) {
+      std::string_view text(pattern);
+      bool prefix = false;
+      if (text == "*") {
+        text = {};
+        prefix = true;
+      } else if (text.size() >= 2 && text.substr(text.size() - 2) == "/*") {
+        text.remove_suffix(1);  // keep the '/'
+        prefix = true;
+      }
+      uint32_t node = insertPath(text);
+      std::vector<uint32_t>& list = prefix ? _nodes[node].prefixRoutes : _nodes[node].exactRoutes;
+      list.push_back(id);
+      route.attachments.emplace_back(node, prefix);
+    }
+    return id;
+  }
+
+  bool remove(uint32_t id) {
+    auto it = _routes.find(id);
+    if (it == _routes.end()) {
+      return false;
+    }
+    for (const auto& [node, prefix] : it->second.attachments) {
+      std::vector<uint32_t>& list = prefix ? _nodes[node].prefixRoutes : _nodes[node].exactRoutes;
+      auto pos = std::find(list.begin(), list.end(), id);
+      if (pos != list.end()) {
+        *pos = list.back();
+        list.pop_back();
+      }
+    }
+    _routes.erase(it);
+    // Nodes are never unlinked one by one; drop the whole trie once it is
+    // unused and large, so short-lived patterns can't accumulate
+    if (_routes.empty() && _nodes.size() > kMaxIdleNodes) {
+      _nodes.clear();
+      _nodes.emplace_back();
+    }
+    return true;
+  }
+
+  /**
+   * Route IDs matching `type` into `out` (cleared first), in ID order.
+   * `once` routes among them are removed.
+   */
+  void match(std::string_view type, std::vector<uint32_t>& out) {
+    out.clear();
+    uint32_t node = 0;
+    append(out, _nodes[0].prefixRoutes);
+    bool reached = true;
+    for (char c : type) {
+      node = child(node, c);
+      if (node == kNoNode) {
+        reached = false;
+        break;
+      }
+      append(out, _nodes[node].prefixRoutes);
+    }
+    if (reached) {
+      append(out, _nodes[node].exactRoutes);
+    }
+    if (out.empty()) {
+      return;
+    }
+
+    // A route with several patterns can match more than once
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+    for (uint32_t id : out) {
+      auto it = _routes.find(id);
+      if (it != _routes.end() && it->second.once) {
+        remove(id);
+      }
+    }
+  }
+
+  /**
+   * Whether any route matches `type`, without consuming `once` routes
+   */
+  bool hasMatch(std::string_view type) const {
+    uint32_t node = 0;
+    if (!_nodes[0].prefixRoutes.empty()) {
+      return true;
+    }
+    for (char c : type) {
+      node = child(node, c);
+      if (node == kNoNode) {
+        return false;
+      }
+      if (!_nodes[node].prefixRoutes.empty()) {
+        return true;
+      }
+    }
+    return !_nodes[node].exactRoutes.empty();
+  }
+
+  size_t size() const { return _routes.size(); }
+
+  size_t nodeCount() const { return _nodes.size(); }
+
+private:
+  static constexpr uint32_t kNoNode = 0xFFFFFFFFu;
+  static constexpr size_t kMaxIdleNodes = 4096;
+
+  struct Node {
+    std::vector<std::pair<char, uint32_t>> children;  // few per node; scanned linearly
+    std::vector<uint32_t> exactRoutes;
+    std::vector<uint32_t> prefixRoutes;
+  };
+
+  struct Route {
+    bool once = false;
+    std::vector<std::pair<uint32_t, bool>> attachments;  // node, is prefix route
+  };
+
+  uint32_t child(uint32_t node, char c) const {
+    for (const auto& [label, next] : _nodes[node].children) {
+      if (label == c) {
+        return next;
+      }
+    }
+    return kNoNode;
+  }
+
+  uint32_t insertPath(std::string_view text) {
+    uint32_t node = 0;
+    for (char c : text) {
+      uint32_t next = child(node, c);
+      if (next == kNoNode) {
+        next = static_cast<uint32_t>(_nodes.size());
+        _nodes.emplace_back();
+        _nodes[node].children.emplace_back(c, next);
+      }
+      node = next;
+    }
+    return node;
+  }
+
+  static void append(std::vector<uint32_t>& out, const std::vector<uint32_t>& routes) {
+    out.insert(out.end(), routes.begin(), routes.end());
+  }
+
+  std::vector<Node> _nodes;
+  std::unordered_map<uint32_t, Route> _routes;
+  uint32_t _nextId = 1;
+};
+
+} // namespace margelo::nitro::sam
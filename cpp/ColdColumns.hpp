@@ -0,0 +1,308 @@
+#pragma once
+
+#include "JsonWriter.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <sqlite3.h>
+
+namespace margelo::nitro::sam {
+
+/**
+ * One database's rows for queryColdAcross, stored by column
+ *
+ * Each database is read on its own worker lane; text and blob bytes go to
+ * one heap per part, so a cell is a fixed 32 bytes and reading allocates
+ * only when a vector grows. With an order column, the part is sorted on the
+ * same lane and the parts are then k-way merged - a parallel merge sort.
+ *
+ * Merged output is columnar JSON, with each column's values in one array so
+ * column names are not repeated per row:
+ *
+ *   {"columns":["id","total"],"databases":["t1","t2"],"rowCount":3,
+ *    "source":[0,1,1],"values":[[4,2,7],[9.5,1,2]]}
+ *
+ * `source` holds each row's index into `databases`. Values are encoded as
+ * queryCold encodes them (BLOBs as base64). Not thread-safe.
+ */
+class ColdColumns {
+public:
+  struct Value {
+    int type = SQLITE_NULL;
+    union {
+      int64_t integer;
+      double real;
+    };
+    size_t offset = 0;                        // TEXT / BLOB bytes in the part's heap
+    size_t length = 0;
+
+    Value() : integer(0) {}
+  };
+
+  /**
+   * Step `stmt` to completion, keeping every row
+   * @return SQLITE_OK, or the failing result code
+   */
+  int read(sqlite3_stmt* stmt) {
+    int columnCount = sqlite3_column_count(stmt);
+    _names.clear();
+    _columns.assign(static_cast<size_t>(columnCount), {});
+    for (int col = 0; col < columnCount; ++col) {
+      const char* name = sqlite3_column_name(stmt, col);
+      _names.emplace_back(name ? name : "");
+    }
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+      for (int col = 0; col < columnCount; ++col) {
+        Value value;
+        value.type = sqlite3_column_type(stmt, col);
+        switch (value.type) {
+          case SQLITE_INTEGER:
+            value.integer = sqlite3_column_int64(stmt, col);
+            break;
+          case SQLITE_FLOAT:
+            value.real = sqlite3_column_double(stmt, col);
+            break;
+          case SQLITE_TEXT:
+          case SQLITE_BLOB: {
+            const void* bytes = value.type == SQLITE_TEXT ? static_cast<const void*>(sqlite3_column_text(stmt, col))
+                                                          : sqlite3_column_blob(stmt, col);
+            value.offset = _heap.size();
+            value.length = static_cast<size_t>(sqlite3_column_bytes(stmt, col));
+            if (bytes != nullptr) {
+              _heap.append(static_cast<const char*>(bytes), value.length);
+            } else {
+              value.length = 0;
+            }
+            break;
+          }
+          default:
+            break;
+        }
+        _columns[static_cast<size_t>(col)].push_back(value);
+      }
+      _rows++;
+    }
+    return rc == SQLITE_DONE ? SQLITE_OK : rc;
+  }
+
+  const std::vector<std::string>& names() const { return _names; }
+  size_t rowCount() const { return _order.has_value() ? _order->size() : _rows; }
+
+  std::optional<size_t> columnIndex(const std::string& name) const {
+    for (size_t i = 0; i < _names.size(); ++i) {
+      if (_names[i] == name) {
+        return i;
+      }
+    }
+    return std::nullopt;
+  }
+
+  /**
+   * Order rows by `column` (stable), keeping the first `limit`
+   */
+  void sort(size_t column, bool descending, size_t limit) {
+    std::vector<uint32_t> order(_rows);
+    for (size_t i = 0; i < _rows; ++i) {
+      order[i] = static_cast<uint32_t>(i);
+    }
+    const std::vector<Value>& values = _columns[column];
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+      int result = compare(values[a], *this, values[b], *this);
+      return descending ? result > 0 : result < 0;
+    });
+    if (order.size() > limit) {
+      order.resize(limit);
+    }
+    _order = std::move(order);
+  }
+
+  /**
+   * Keep the first `limit` rows, in query order
+   */
+  void truncate(size_t limit) {
+    _rows = std::min(_rows, limit);
+    for (auto& column : _columns) {
+      column.resize(std::min(column.size(), limit));
+    }
+  }
+
+  /**
+   * SQLite's ordering with BINARY collation: NULL, then numbers, text and
+   * blobs
+   */
+  static int compare(const Value& a, const ColdColumns& aPart, const Value& b, const ColdColumns& bPart) {
+    int aRank = rank(a.type);
+    int bRank = rank(b.type);
+    if (aRank != bRank) {
+      return aRank < bRank ? -1 : 1;
+    }
+    switch (aRank) {
+      case 1: {
+        if (a.type == SQLITE_INTEGER && b.type == SQLITE_INTEGER) {
+          return a.integer < b.integer ? -1 : a.integer > b.integer ? 1 : 0;
+        }
+        double x = a.type == SQLITE_INTEGER ? static_cast<double>(a.integer) : a.real;
+        double y = b.type == SQLITE_INTEGER ? static_cast<double>(b.integer) : b.real;
+        return x < y ? -1 : x > y ? 1 : 0;
+      }
+      case 2:
+      case 3: {
+        int result = std::memcmp(aPart._heap.data() + a.offset, bPart._heap.data() + b.offset,
+                                 std::min(a.length, b.length));
+        if (result != 0) {
+          return result;
+        }
+        return a.length < b.length ? -1 : a.length > b.length ? 1 : 0;
+      }
+      default:
+        return 0;
+    }
+  }
+
+  /**
+   * Merge `parts` (same columns, part i read from databases[i]) into
+   * columnar JSON, at most `limit` rows. With `column`, every part must have
+   * been sorted on it and rows are merged in order, ties going to the earlier
+   * part; otherwise parts are concatenated in order.
+   */
+  static std::string mergeJson(const std::vector<const ColdColumns*>& parts, const std::vector<std::string>& databases,
+                               std::optional<size_t> column, bool descending, size_t limit) {
+    // (part, row) for every output row
+    std::vector<std::pair<uint32_t, uint32_t>> rows;
+    size_t total = 0;
+    for (const ColdColumns* part : parts) {
+      total += part->rowCount();
+    }
+    rows.reserve(std::min(total, limit));
+    if (column.has_value()) {
+      size_t c = column.value();
+      std::vector<size_t> cursor(parts.size(), 0);
+      auto after = [&](uint32_t x, uint32_t y) {
+        const ColdColumns& a = *parts[x];
+        const ColdColumns& b = *parts[y];
+        int result = compare(a._columns[c][a.rowAt(cursor[x])], a, b._columns[c][b.rowAt(cursor[y])], b);
+        if (descending) {
+          result = -result;
+        }
+        return result != 0 ? result > 0 : x > y;
+      };
+      std::priority_queue<uint32_t, std::vector<uint32_t>, decltype(after)> heads(after);
+      for (uint32_t i = 0; i < parts.size(); ++i) {
+        if (parts[i]->rowCount() > 0) {
+          heads.push(i);
+        }
+      }
+      while (!heads.empty() && rows.size() < limit) {
+        uint32_t i = heads.top();
+        heads.pop();
+        rows.emplace_back(i, static_cast<uint32_t>(parts[i]->rowAt(cursor[i])));
+        if (++cursor[i] < parts[i]->rowCount()) {
+          heads.push(i);
+        }
+      }
+    } else {
+      for (uint32_t i = 0; i < parts.size() && rows.size() < limit; ++i) {
+        for (size_t r = 0; r < parts[i]->rowCount() && rows.size() < limit; ++r) {
+          rows.emplace_back(i, static_cast<uint32_t>(parts[i]->rowAt(r)));
+        }
+      }
+    }
+
+    JsonWriter json(64 + rows.size() * 16);
+    json.raw(std::string_view("{\"columns\":["));
+    static const std::vector<std::string> kNoColumns;
+    const std::vector<std::string>& names = parts.empty() ? kNoColumns : parts[0]->_names;
+    for (size_t i = 0; i < names.size(); ++i) {
+      if (i > 0) {
+        json.raw(',');
+      }
+      json.string(names[i]);
+    }
+    json.raw(std::string_view("],\"databases\":["));
+    for (size_t i = 0; i < databases.size(); ++i) {
+      if (i > 0) {
+        json.raw(',');
+      }
+      json.string(databases[i]);
+    }
+    json.raw(std::string_view("],\"rowCount\":"));
+    json.number(static_cast<int64_t>(rows.size()));
+    json.raw(std::string_view(",\"source\":["));
+    for (size_t r = 0; r < rows.size(); ++r) {
+      if (r > 0) {
+        json.raw(',');
+      }
+      json.number(static_cast<int64_t>(rows[r].first));
+    }
+    json.raw(std::string_view("],\"values\":["));
+    for (size_t c = 0; c < names.size(); ++c) {
+      if (c > 0) {
+        json.raw(',');
+      }
+      json.raw('[');
+      for (size_t r = 0; r < rows.size(); ++r) {
+        if (r > 0) {
+          json.raw(',');
+        }
+        const ColdColumns& part = *parts[rows[r].first];
+        part.writeValue(part._columns[c][rows[r].second], json);
+      }
+      json.raw(']');
+    }
+    json.raw(std::string_view("]}"));
+    return json.take();
+  }
+
+private:
+  static int rank(int type) {
+    switch (type) {
+      case SQLITE_INTEGER:
+      case SQLITE_FLOAT:
+        return 1;
+      case SQLITE_TEXT:
+        return 2;
+      case SQLITE_BLOB:
+        return 3;
+      default:
+        return 0;
+    }
+  }
+
+  size_t rowAt(size_t position) const { return _order.has_value() ? (*_order)[position] : position; }
+
+  void writeValue(const Value& value, JsonWriter& json) const {
+    switch (value.type) {
+      case SQLITE_INTEGER:
+        json.number(value.integer);
+        break;
+      case SQLITE_FLOAT:
+        json.number(value.real);
+        break;
+      case SQLITE_TEXT:
+        json.string(std::string_view(_heap.data() + value.offset, value.length));
+        break;
+      case SQLITE_BLOB:
+        json.base64(reinterpret_cast<const uint8_t*>(_heap.data() + value.offset), value.length);
+        break;
+      default:
+        json.null();
+        break;
+    }
+  }
+
+  std::vector<std::string> _names;
+  std::vector<std::vector<Value>> _columns;   // _columns[column][row]
+  std::string _heap;
+  size_t _rows = 0;
+  std::optional<std::vector<uint32_t>> _order;  // row order after sort()
+};
+
+} // namespace margelo::nitro::sam
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "ColdConfig.hpp"
+#include "ColdProfile.hpp"
+#include "ColdSynchronous.hpp"
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include <sqlite3.h>
+
+namespace margelo::nitro::sam {
+
+/**
+ * Connection settings for a Cold database, resolved from a ColdConfig
+ *
+ * A profile supplies the baseline and explicit ColdConfig fields override
+ * it. Every setting here is per connection, so the same tuning is applied to
+ * the main connection and to the database's async lane connection.
+ *
+ *   profile      synchronous  mmap_size  cache_size  temp_store  wal_autocheckpoint  busy_timeout
+ *   default      (SQLite)     (SQLite)   (SQLite)    (SQLite)    (SQLite)            5000
+ *   readHeavy    NORMAL       256 MiB    16 MiB      (SQLite)    1000                5000
+ *   writeHeavy   NORMAL       64 MiB     8 MiB       MEMORY      4000                10000
+ *   lowMemory    NORMAL       0          1 MiB       FILE        500                 5000
+ *
+ * NORMAL is durable in WAL mode except for the last transactions before a
+ * power loss. `default` keeps SQLite's own defaults (synchronous FULL).
+ * wal_autocheckpoint only holds while background checkpoints are disabled;
+ * otherwise HybridSideFx sets it to 0 after apply().
+ */
+struct ColdTuning {
+  static constexpr int kUnset = -1;
+  static constexpr int kDefaultBusyTimeoutMs = 5000;
+
+  int synchronous = kUnset;          // 0 OFF, 1 NORMAL, 2 FULL
+  int64_t mmapSizeBytes = kUnset;
+  int64_t cacheSizeKiB = kUnset;
+  int tempStore = kUnset;            // 1 FILE, 2 MEMORY
+  int walAutocheckpointPages = kUnset;
+  int busyTimeoutMs = kDefaultBusyTimeoutMs;
+
+  static ColdTuning forProfile(ColdProfile profile) {
+    ColdTuning tuning;
+    switch (profile) {
+      case ColdProfile::DEFAULT:
+        break;
+      case ColdProfile::READHEAVY:
+        tuning.synchronous = 1;
+        tuning.mmapSizeBytes = 256ll << 20;
+        tuning.cacheSizeKiB = 16 << 10;
+        tuning.walAutocheckpointPages = 1000;
+        break;
+      case ColdProfile::WRITEHEAVY:
+        // A longer WAL between checkpoints means fewer, larger checkpoints
+        tuning.synchronous = 1;
+        tuning.mmapSizeBytes = 64ll << 20;
+        tuning.cacheSizeKiB = 8 << 10;
+        tuning.tempStore = 2;
+        tuning.walAutocheckpointPages = 4000;
+        tuning.busyTimeoutMs = 10000;
+        break;
+      case ColdProfile::LOWMEMORY:
+        tuning.synchronous = 1;
+        tuning.mmapSizeBytes = 0;
+        tuning.cacheSizeKiB = 1 << 10;
+        tuning.tempStore = 1;
+        tuning.walAutocheckpointPages = 500;
+        break;
+    }
+    return tuning;
+  }
+
+  static ColdTuning resolve(const std::optional<ColdConfig>& config) {
+    if (!config.has_value()) {
+      return ColdTuning();
+    }
+    ColdTuning tuning = forProfile(config->profile.value_or(ColdProfile::DEFAULT));
+    if (config->synchronous.has_value()) {
+      switch (config->synchronous.value()) {
+        case ColdSynchronous::OFF: tuning.synchronous = 0; break;
+        case ColdSynchronous::NORMAL: tuning.synchronous = 1; break;
+        case ColdSynchronous::FULL: tuning.synchronous = 2; break;
+      }
+    }
+    if (config->mmapSizeBytes.has_value() && config->mmapSizeBytes.value() >= 0) {
+      tuning.mmapSizeBytes = static_cast<int64_t>(config->mmapSizeBytes.value());
+    }
+    if (config->cacheSizeKiB.has_value() && config->cacheSizeKiB.value() > 0) {
+      tuning.cacheSizeKiB = static_cast<int64_t>(config->cacheSizeKiB.value());
+    }
+    if (config->tempStoreMemory.has_value()) {
+      tuning.tempStore = config->tempStoreMemory.value() ? 2 : 1;
+    }
+    if (config->walAutocheckpointPages.has_value() && config->walAutocheckpointPages.value() >= 0) {
+      tuning.walAutocheckpointPages = static_cast<int>(config->walAutocheckpointPages.value());
+    }
+    if (config->busyTimeoutMs.has_value() && config->busyTimeoutMs.value() >= 0) {
+      tuning.busyTimeoutMs = static_cast<int>(config->busyTimeoutMs.value());
+    }
+    return tuning;
+  }
+
+  /**
+   * Apply to a freshly opened connection. Returns false with `error` set if
+   * SQLite rejects a setting.
+   */
+  bool apply(sqlite3* db, std::string& error) const {
+    std::string sql;
+    if (synchronous != kUnset) {
+      sql += "PRAGMA synchronous=" + std::to_string(synchronous) + ";";
+    }
+    if (mmapSizeBytes != kUnset) {
+      sql += "PRAGMA mmap_size=" + std::to_string(mmapSizeBytes) + ";";
+    }
+    if (cacheSizeKiB != kUnset) {
+      sql += "PRAGMA cache_size=-" + std::to_string(cacheSizeKiB) + ";";  // negative: KiB, not pages
+    }
+    if (tempStore != kUnset) {
+      sql += "PRAGMA temp_store=" + std::to_string(tempStore) + ";";
+    }
+    if (walAutocheckpointPages != kUnset) {
+      sql += "PRAGMA wal_autocheckpoint=" + std::to_string(walAutocheckpointPages) + ";";
+    }
+    sqlite3_busy_timeout(db, busyTimeoutMs);
+    if (sql.empty()) {
+      return true;
+    }
+    char* errMsg = nullptr;
+    if (sqlite3_exec(db, sql.c_str(), nullptr, nullptr, &errMsg) != SQLITE_OK) {
+      error = errMsg != nullptr ? errMsg : sqlite3_errmsg(db);
+      sqlite3_free(errMsg);
+      return false;
+    }
+    return true;
+  }
+};
+
+} // namespace margelo::nitro::sam
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// Allocation counters are compiled into debug builds only, so release builds
+// pay nothing for them. Define SAM_DISPATCH_ALLOC_STATS=1 to force them on.
+#ifndef SAM_DISPATCH_ALLOC_STATS
+#ifdef NDEBUG
+#define SAM_DISPATCH_ALLOC_STATS 0
+#else
+#define SAM_DISPATCH_ALLOC_STATS 1
+#endif
+#endif
+
+namespace margelo::nitro::sam {
+
+/**
+ * Monotonic bump allocator for one dispatch batch
+ *
+ * Everything built while matching a batch of changes (pending events, keys,
+ * table names, row payloads) is carved out of a few large blocks and released
+ * in one shot by reset() once the batch has been delivered. Blocks are kept
+ * across batches, so once the arena has grown to the working-set size the
+ * dispatch path stops touching the heap entirely.
+ *
+ * Only trivially destructible types may be placed in the arena; nothing is
+ * destroyed on reset().
+ */
+class DispatchArena {
+public:
+  struct Stats {
+    uint64_t blockAllocations = 0;  // heap allocations made by the arena
+    uint64_t bytesReserved = 0;     // total bytes held in blocks
+    uint64_t highWaterBytes = 0;    // largest single batch
+    uint64_t resets = 0;            // batches released
+  };
+
+  explicit DispatchArena(size_t blockSize = 16 * 1024) : _blockSize(blockSize) {}
+
+  ~DispatchArena() {
+    for (auto& block : _blocks) {
+      std::free(block.data);
+    }
+  }
+
+  DispatchArena(const DispatchArena&) = delete;
+  DispatchArena& operator=(const DispatchArena&) = delete;
+
+  void* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+    while (_current < _blocks.size()) {
+      Block& block = _blocks[_current];
+      size_t aligned = (block.used + alignment - 1) & ~(alignment - 1);
+      if (aligned + size <= block.size) {
+        block.used = aligned + size;
+        _batchBytes += size;
+        return block.data + aligned;
+      }
+      // Block exhausted - move on to the next retained block (if any)
+      ++_current;
+    }
+    addBlock(std::max(_blockSize, size + alignment));
+    return allocate(size, alignment);
+  }
+
+  template <typename T, typename... Args>
+  T* make(Args&&... args) {
+    static_assert(std::is_trivially_destructible_v<T>,
+                  "DispatchArena never runs destructors");
+    return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+  }
+
+  /**
+   * Copy `text` into the arena and return a view of the copy
+   */
+  std::string_view copy(std::string_view text) {
+    if (text.empty()) {
+      return {};
+    }
+    char* dest = static_cast<char*>(allocate(text.size(), 1));
+    std::memcpy(dest, text.data(), text.size());
+    return {dest, text.size()};
+  }
+
+  /**
+   * Release everything allocated since the last reset, keeping the blocks
+   */
+  void reset() {
+#if SAM_DISPATCH_ALLOC_STATS
+    _stats.highWaterBytes = std::max<uint64_t>(_stats.highWaterBytes, _batchBytes);
+    _stats.resets++;
+#endif
+    for (auto& block : _blocks) {
+      block.used = 0;
+    }
+    _current = 0;
+    _batchBytes = 0;
+  }
+
+  const Stats& stats() const { return _stats; }
+
+  /**
+   * Bytes held in blocks, whether or not a batch is using them
+   */
+  size_t bytesHeld() const {
+    size_t total = 0;
+    for (const auto& block : _blocks) {
+      total += block.size;
+    }
+    return total;
+  }
+
+  /**
+   * Free every block but the first, e.g. under memory pressure after a burst
+   * grew the arena. Only between batches (nothing allocated since reset()).
+   */
+  void trim() {
+    for (size_t i = 1; i < _blocks.size(); ++i) {
+      std::free(_blocks[i].data);
+    }
+    if (_blocks.size() > 1) {
+      _blocks.erase(_blocks.begin() + 1, _blocks.end());
+    }
+    _blocks.shrink_to_fit();
+    _current = 0;
+#if SAM_DISPATCH_ALLOC_STATS
+    _stats.bytesReserved = bytesHeld();
+#endif
+  }
+
+private:
+  struct Block {
+    char* data;
+    size_t size;
+    size_t used;
+  };
+
+  void addBlock(size_t size) {
+    char* data = static_cast<char*>(std::malloc(size));
+    if (data == nullptr) {
+      throw std::bad_alloc();
+    }
+    _blocks.push_back(Block{data, size, 0});
+    _current = _blocks.size() - 1;
+#if SAM_DISPATCH_ALLOC_STATS
+    _stats.blockAllocations++;
+    _stats.bytesReserved += size;
+#endif
+  }
+
+  size_t _blockSize;
+  std::vector<Block> _blocks;
+  size_t _current = 0;
+  size_t _batchBytes = 0;
+  Stats _stats;
+};
+
+} // namespace margelo::nitro::sam
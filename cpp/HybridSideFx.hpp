@@ -1,27 +1,87 @@
 #pragma once
 
-#include "../nitrogen/generated/shared/c++/HybridSideFxSpec.hpp"
-#include "../nitrogen/generated/shared/c++/ListenerConfig.hpp"
-#include "../nitrogen/generated/shared/c++/ListenerInfo.hpp"
-#include "../nitrogen/generated/shared/c++/ListenerResult.hpp"
-#include "../nitrogen/generated/shared/c++/SAMConfig.hpp"
-#include "../nitrogen/generated/shared/c++/NetworkState.hpp"
-#include "../nitrogen/generated/shared/c++/NetworkStatus.hpp"
-#include "../nitrogen/generated/shared/c++/ConnectionType.hpp"
-#include "../nitrogen/generated/shared/c++/CellularGeneration.hpp"
+#include "HybridSideFxSpec.hpp"
+#include "ListenerConfig.hpp"
+#include "ListenerInfo.hpp"
+#include "ListenerResult.hpp"
+#include "SAMConfig.hpp"
+#include "NetworkState.hpp"
+#include "NetworkStatus.hpp"
+#include "ConnectionType.hpp"
+#include "CellularGeneration.hpp"
+#include "ChangeEvent.hpp"
+#include "ChangeSource.hpp"
+#include "ChangeOperation.hpp"
+#include "ColdAcrossOptions.hpp"
+#include "ColdCheckpointConfig.hpp"
+#include "ColdCheckpointStats.hpp"
+#include "ColdConfig.hpp"
+#include "ColdSearchConfig.hpp"
+#include "ColdSearchOptions.hpp"
+#include "ColdSearchOrder.hpp"
+#include "RowData.hpp"
+#include "DispatchAllocationStats.hpp"
+#include "LogCategory.hpp"
+#include "MFEPhase.hpp"
+#include "MFERecord.hpp"
+#include "MFELoadStats.hpp"
+#include "MFERecordUpdate.hpp"
+#include "MFETransition.hpp"
+#include "OperationMetrics.hpp"
+#include "SAMMetrics.hpp"
+#include "SecureCachedValue.hpp"
+#include "MemoryPressureLevel.hpp"
+#include "MemoryUsage.hpp"
+#include "StartupConfig.hpp"
+#include "StartupStage.hpp"
+#include "WarmCompactionConfig.hpp"
+#include "WarmCompactionStats.hpp"
+#include "WarmConfig.hpp"
+#include "WarmPrewarmInstance.hpp"
+#include <NitroModules/ArrayBuffer.hpp>
 #include <NitroModules/Null.hpp>
+#include <NitroModules/Promise.hpp>
+#include <algorithm>
+#include <cctype>
+#include <array>
+#include <cmath>
+#include <atomic>
 #include <chrono>
-#include <iostream>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <random>
+#include <regex>
 #include <set>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
 #include <variant>
 #include <vector>
 #include <sqlite3.h>
-#include <sstream>
-#include <iomanip>
+#include <sys/stat.h>
+
+#include "ActionRouter.hpp"
+#include "ColdColumns.hpp"
+#include "ColdTuning.hpp"
+#include "DispatchArena.hpp"
+#include "JsonWriter.hpp"
+#include "LatencyHistogram.hpp"
+#include "Logger.hpp"
+#include "ListenerTable.hpp"
+#include "LoadTimeSketch.hpp"
+#include "MaintenanceScheduler.hpp"
+#include "MFERecordCodec.hpp"
+#include "MpscQueue.hpp"
+#include "SecureValueCache.hpp"
+#include "SerialWorkerPool.hpp"
+#include "WarmExpiryIndex.hpp"
 
 // MMKV C++ Core library - shared with react-native-mmkv
 #include <MMKVCore/MMKV.h>
@@ -50,6 +110,53 @@ public:
   HybridSideFx() : HybridObject(TAG), _debugMode(false), _maxListeners(10000) {}
 
   ~HybridSideFx() {
+    // Background maintenance touches Warm instances and the state below
+#ifdef __APPLE__
+    if (_memoryPressureSource != nullptr) {
+      dispatch_source_cancel(_memoryPressureSource);
+      _memoryPressureSource = nullptr;
+    }
+#endif
+    {
+      // No more content change notifications for this object; the last
+      // owner gives MMKV's handler slot back
+      std::lock_guard<std::mutex> lock(outerWarmOwnersMutex());
+      auto& owners = outerWarmOwners();
+      auto owner = std::find(owners.begin(), owners.end(), this);
+      if (owner != owners.end()) {
+        owners.erase(owner);
+        if (owners.empty()) {
+          mmkv::MMKV::unRegisterContentChangeHandler();
+        }
+      }
+    }
+    _maintenance.shutdown();
+    for (auto& pair : _checkpointCursors) {
+      if (pair.second.db != nullptr) {
+        sqlite3_close(pair.second.db);
+      }
+    }
+    _checkpointCursors.clear();
+
+    // Settle outstanding async Cold work first: it reads the connections
+    // below and queues changes for the dispatcher
+    _coldWorkers.shutdown();
+    for (auto& pair : _coldLanes) {
+      if (pair.second->db != nullptr) {
+        sqlite3_close(pair.second->db);
+      }
+    }
+    _coldLanes.clear();
+
+    // Drain and stop the dispatcher before the state it reads goes away
+    stopDispatcher();
+    for (auto& [dbName, tables] : _rowStmts) {
+      for (auto& [table, stmt] : tables) {
+        sqlite3_finalize(stmt);
+      }
+    }
+    _rowStmts.clear();
+
     // Close all SQLite database connections
     for (auto& pair : _sqliteDatabases) {
       if (pair.second != nullptr) {
@@ -65,123 +172,106 @@ public:
 
   ListenerResult addListener(const std::string& id,
                              const ListenerConfig& config) override {
-    std::lock_guard<std::mutex> lock(_mutex);
-
-    // Check if ID already exists
-    if (_listeners.find(id) != _listeners.end()) {
-      return ListenerResult(false, "Listener with ID '" + id + "' already exists");
-    }
-
-    // Check max listeners limit
-    if (_listeners.size() >= _maxListeners) {
-      return ListenerResult(false, "Maximum listener limit reached");
-    }
-
-    // Validate config
-    if (!config.warm.has_value() && !config.cold.has_value() &&
-        !config.combined.has_value()) {
-      return ListenerResult(false, "At least one of warm, cold, or combined must be specified");
-    }
-
-    // Create listener entry
-    ListenerEntry entry;
-    entry.id = id;
-    entry.config = config;
-    entry.createdAt = getCurrentTimestamp();
-    entry.triggerCount = 0;
-    entry.isPaused = false;
-    entry.nextAllowedTrigger = std::nullopt;
-    entry.hasPendingEvent = false;
-
-    _listeners[id] = entry;
+    return registerListener(id, config, std::string());
+  }
 
-    if (_debugMode) {
-      logDebug("Added listener: " + id);
+  /**
+   * A listener whose events become missile actions of type `actionType`.
+   * Its events are only built while a missile route (a pending take or an
+   * action subscriber) matches that type, and they carry the matched route
+   * IDs, so JS resolves takes without matching again. Removed with
+   * removeListener like any other listener.
+   */
+  ListenerResult addStorageTrigger(const std::string& id,
+                                   const std::string& actionType,
+                                   const ListenerConfig& config) override {
+    if (actionType.empty()) {
+      return ListenerResult(false, "Storage trigger '" + id + "' needs an action type");
     }
-
-    return ListenerResult(true, std::nullopt);
+    return registerListener(id, config, actionType);
   }
 
   ListenerResult removeListener(const std::string& id) override {
-    std::lock_guard<std::mutex> lock(_mutex);
+    OperationTimer timer(_operationStats[kOpRemoveListener]);
+    auto lock = lockTimed(_dispatchMutex, kOpListenerLockWait);
 
-    auto it = _listeners.find(id);
-    if (it == _listeners.end()) {
-      return ListenerResult(false, "Listener '" + id + "' not found");
+    auto index = _listeners.find(id);
+    if (!index.has_value()) {
+      return timer.fail(ListenerResult(false, "Listener '" + id + "' not found"));
     }
+    _heldChanges.erase(_listeners.handleOf(index.value()).slot);
+    _listeners.erase(id);
+    syncListenerCounts();
 
-    _listeners.erase(it);
-
-    if (_debugMode) {
-      logDebug("Removed listener: " + id);
-    }
+    SAM_LOG_DEBUG(_logger, LogCategory::LISTENERS, "Removed listener: ", id);
 
     return ListenerResult(true, std::nullopt);
   }
 
   double removeAllListeners() override {
-    std::lock_guard<std::mutex> lock(_mutex);
+    std::lock_guard<std::mutex> lock(_dispatchMutex);
     double count = static_cast<double>(_listeners.size());
     _listeners.clear();
+    _heldChanges.clear();
+    _immediateEvents.clear();
+    syncListenerCounts();
 
-    if (_debugMode) {
-      logDebug("Removed all listeners: " + std::to_string(static_cast<int>(count)));
-    }
+    SAM_LOG_DEBUG(_logger, LogCategory::LISTENERS, "Removed all listeners: ", count);
 
     return count;
   }
 
   bool hasListener(const std::string& id) override {
-    std::lock_guard<std::mutex> lock(_mutex);
-    return _listeners.find(id) != _listeners.end();
+    std::lock_guard<std::mutex> lock(_dispatchMutex);
+    return _listeners.find(id).has_value();
   }
 
   std::vector<std::string> getListenerIds() override {
-    std::lock_guard<std::mutex> lock(_mutex);
+    std::lock_guard<std::mutex> lock(_dispatchMutex);
     std::vector<std::string> ids;
     ids.reserve(_listeners.size());
-    for (const auto& pair : _listeners) {
-      ids.push_back(pair.first);
+    for (uint32_t i = 0; i < _listeners.size(); ++i) {
+      ids.push_back(_listeners.id(i));
     }
     return ids;
   }
 
   std::vector<ListenerInfo> getListeners() override {
-    std::lock_guard<std::mutex> lock(_mutex);
+    std::lock_guard<std::mutex> lock(_dispatchMutex);
     std::vector<ListenerInfo> infos;
     infos.reserve(_listeners.size());
-    for (const auto& pair : _listeners) {
-      infos.push_back(createListenerInfo(pair.second));
+    for (uint32_t i = 0; i < _listeners.size(); ++i) {
+      infos.push_back(createListenerInfo(i));
     }
     return infos;
   }
 
   std::optional<ListenerInfo> getListener(const std::string& id) override {
-    std::lock_guard<std::mutex> lock(_mutex);
-    auto it = _listeners.find(id);
-    if (it == _listeners.end()) {
+    std::lock_guard<std::mutex> lock(_dispatchMutex);
+    auto index = _listeners.find(id);
+    if (!index.has_value()) {
       return std::nullopt;
     }
-    return createListenerInfo(it->second);
+    return createListenerInfo(index.value());
   }
 
   ListenerResult pauseListener(const std::string& id) override {
-    std::lock_guard<std::mutex> lock(_mutex);
-    auto it = _listeners.find(id);
-    if (it == _listeners.end()) {
+    std::lock_guard<std::mutex> lock(_dispatchMutex);
+    auto index = _listeners.find(id);
+    if (!index.has_value()) {
       return ListenerResult(false, "Listener '" + id + "' not found");
     }
-    it->second.isPaused = true;
+    _listeners.flags(index.value()) |= ListenerTable::kPaused;
     return ListenerResult(true, std::nullopt);
   }
 
   ListenerResult resumeListener(const std::string& id) override {
-    std::lock_guard<std::mutex> lock(_mutex);
-    auto it = _listeners.find(id);
-    if (it == _listeners.end()) {
+    std::lock_guard<std::mutex> lock(_dispatchMutex);
+    auto index = _listeners.find(id);
+    if (!index.has_value()) {
       return ListenerResult(false, "Listener '" + id + "' not found");
     }
-    it->second.isPaused = false;
+    _listeners.flags(index.value()) &= static_cast<uint16_t>(~ListenerTable::kPaused);
     return ListenerResult(true, std::nullopt);
   }
 
@@ -192,12 +282,18 @@ public:
   void configure(const SAMConfig& config) override {
     std::lock_guard<std::mutex> lock(_mutex);
     if (config.debug.has_value()) {
-      _debugMode = config.debug.value();
+      applyDebugMode(config.debug.value());
     }
     if (config.maxListeners.has_value()) {
       _maxListeners = static_cast<size_t>(config.maxListeners.value());
     }
-    // cacheSize is stored for future use
+    if (config.cacheSize.has_value()) {
+      double budget = config.cacheSize.value();
+      _memoryBudget.store(budget > 0 ? static_cast<size_t>(budget) : 0, std::memory_order_relaxed);
+      if (budget > 0 && _maintenanceScheduled) {
+        _maintenance.runSoon(kGovernorTask);
+      }
+    }
   }
 
   // =========================================================================
@@ -211,104 +307,120 @@ public:
   void setWarmRootPath(const std::string& rootPath) override {
     std::lock_guard<std::mutex> lock(_mutex);
     if (_warmGlobalInitialized) {
-      logDebug("Warning: Warm storage already initialized, setWarmRootPath has no effect");
+      SAM_LOG_WARN(_logger, LogCategory::WARM,
+                   "Warm storage already initialized, setWarmRootPath has no effect");
       return;
     }
     _warmRootPath = rootPath;
-    if (_debugMode) {
-      logDebug("Warm storage root path set to: " + rootPath);
-    }
+    SAM_LOG_DEBUG(_logger, LogCategory::WARM, "Warm storage root path set to: ", rootPath);
   }
 
-  ListenerResult initializeWarm(const std::optional<std::string>& instanceId) override {
+  ListenerResult initializeWarm(const std::optional<std::string>& instanceId,
+                                const std::optional<WarmConfig>& config) override {
     std::lock_guard<std::mutex> lock(_mutex);
     std::string id = instanceId.value_or("default");
+    std::optional<std::string> key;
+    if (config.has_value() && config->encryptionKey.has_value()) {
+      key = config->encryptionKey.value();
+      if (!isValidWarmKey(*key)) {
+        return ListenerResult(false, "Warm encryption key must be 1-16 bytes");
+      }
+    }
+
+    bool multiProcess = config.has_value() && config->multiProcess.value_or(false);
 
     // Check if already initialized in our tracking
-    if (_warmInstances.find(id) != _warmInstances.end()) {
-      if (_debugMode) {
-        logDebug("Warm instance already initialized: " + id);
+    auto existing = _warmInstances.find(id);
+    if (existing != _warmInstances.end()) {
+      // The open instance keeps its key; a different one would read garbage
+      if (key.has_value() && (!existing->second.encrypted || existing->second.storage->cryptKey() != *key)) {
+        return ListenerResult(false, "Warm instance already open with a different encryption key: " + id);
       }
+      if (multiProcess && existing->second.snapshot == nullptr) {
+        return ListenerResult(false, "Warm instance already open in single-process mode: " + id);
+      }
+      SAM_LOG_DEBUG(_logger, LogCategory::WARM, "Warm instance already initialized: ", id);
       return ListenerResult(true, std::nullopt);
     }
 
-    // Initialize Warm storage globally if not done yet
-    // This uses the same default path that react-native-mmkv uses,
-    // so storage is shared if both libraries are present
-    if (!_warmGlobalInitialized) {
-      // Auto-detect default path if not explicitly set
-      if (_warmRootPath.empty()) {
-        _warmRootPath = getDefaultWarmPathInternal();
-        if (_warmRootPath.empty()) {
-          return ListenerResult(false,
-            "Warm root path not set and could not auto-detect. "
-            "Call setWarmRootPath() first with your app's files directory + '/mmkv'");
-        }
-        if (_debugMode) {
-          logDebug("Auto-detected Warm root path: " + _warmRootPath);
-        }
-      }
-
-      // Initialize MMKV with the configured root path
-      mmkv::MMKV::initializeMMKV(_warmRootPath);
-      _warmGlobalInitialized = true;
-      if (_debugMode) {
-        logDebug("Warm storage globally initialized at: " + _warmRootPath);
-      }
+    std::string error;
+    if (!initializeWarmGlobal(error, false)) {
+      return ListenerResult(false, error);
     }
 
     // Get or create the Warm instance
-    mmkv::MMKV* warmInstance = getWarmInstance(id);
-    if (warmInstance == nullptr) {
+    uint64_t start = monotonicNanos();
+    mmkv::MMKV* storage = getWarmInstance(id, key.has_value() ? &*key : nullptr, multiProcess);
+    if (storage != nullptr && key.has_value() && storage->cryptKey() != *key) {
+      // MMKV caches instances by ID, e.g. one opened without a key elsewhere in the process
+      return ListenerResult(false, "Warm instance already open with a different encryption key: " + id);
+    }
+    if (storage != nullptr && multiProcess && !storage->isMultiProcess()) {
+      return ListenerResult(false, "Warm instance already open in single-process mode: " + id);
+    }
+    if (registerWarmInstance(id, storage) == nullptr) {
       return ListenerResult(false, "Failed to create Warm instance: " + id);
     }
+    recordStartupStage("warm:" + id, start, false);
 
-    _warmInstances.insert(id);
-
-    if (_debugMode) {
-      logDebug("Initialized Warm instance: " + id);
-    }
+    SAM_LOG_DEBUG(_logger, LogCategory::WARM, "Initialized Warm instance: ", id, key.has_value() ? " (encrypted)" : "",
+                  multiProcess ? " (multi-process)" : "");
 
     return ListenerResult(true, std::nullopt);
   }
 
+  std::string createWarmEncryptionKey() override {
+    static constexpr char kAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789";
+    std::random_device random;  // the OS CSPRNG on iOS and Android
+    std::string key;
+    key.reserve(kWarmKeyMaxBytes);
+    while (key.size() < kWarmKeyMaxBytes) {
+      unsigned int value = random() & 0xFF;
+      if (value < 248) {  // 4 * 62: reject the rest so every character is equally likely
+        key.push_back(kAlphabet[value % 62]);
+      }
+    }
+    return key;
+  }
+
   ListenerResult initializeCold(const std::string& databaseName,
-                                   const std::string& databasePath) override {
+                                   const std::string& databasePath,
+                                   const std::optional<ColdConfig>& config) override {
     std::lock_guard<std::mutex> lock(_mutex);
 
     // Check if already initialized
     if (_sqliteDatabases.find(databaseName) != _sqliteDatabases.end()) {
-      if (_debugMode) {
-        logDebug("Cold storage database already initialized: " + databaseName);
-      }
+      SAM_LOG_DEBUG(_logger, LogCategory::COLD, "Cold storage database already initialized: ", databaseName);
       return ListenerResult(true, std::nullopt);
     }
 
-    // Open SQLite database
-    sqlite3* db = nullptr;
-    int rc = sqlite3_open(databasePath.c_str(), &db);
-
-    if (rc != SQLITE_OK) {
-      std::string error = sqlite3_errmsg(db);
-      sqlite3_close(db);
-      return ListenerResult(false, "Failed to open Cold storage database: " + error);
+    // With lazy Cold, the connection is opened by the first call that needs it
+    ColdTuning tuning = ColdTuning::resolve(config);
+    std::vector<std::string> migrations;
+    if (config.has_value() && config->migrations.has_value()) {
+      migrations = config->migrations.value();
     }
-
-    // Enable WAL mode for better concurrency
-    char* errMsg = nullptr;
-    sqlite3_exec(db, "PRAGMA journal_mode=WAL;", nullptr, nullptr, &errMsg);
-    if (errMsg) {
-      sqlite3_free(errMsg);
+    sqlite3* db = nullptr;
+    if (!_lazyCold) {
+      std::string error;
+      db = openColdDatabase(databaseName, databasePath, tuning, migrations, error);
+      if (db == nullptr) {
+        return ListenerResult(false, error);
+      }
     }
 
     // Store the database handle
     _sqliteDatabases[databaseName] = db;
     _coldDatabasePaths[databaseName] = databasePath;
-
-    if (_debugMode) {
-      logDebug("Initialized Cold storage database: " + databaseName + " at " + databasePath);
+    _coldTunings[databaseName] = tuning;
+    _coldMigrations[databaseName] = std::move(migrations);
+    if (!isInMemoryPath(databasePath)) {
+      scheduleMaintenance();  // WAL checkpoints
     }
 
+    SAM_LOG_DEBUG(_logger, LogCategory::COLD, _lazyCold ? "Declared" : "Initialized",
+                  " Cold storage database: ", databaseName, " at ", databasePath);
+
     return ListenerResult(true, std::nullopt);
   }
 
@@ -323,31 +435,92 @@ public:
     if (!databaseName.has_value()) {
       return !_sqliteDatabases.empty();
     }
-    auto it = _sqliteDatabases.find(databaseName.value());
-    return it != _sqliteDatabases.end() && it->second != nullptr;
+    // A lazily opened database counts once it is declared
+    return _sqliteDatabases.find(databaseName.value()) != _sqliteDatabases.end();
+  }
+
+  // =========================================================================
+  // Startup
+  // =========================================================================
+
+  void configureStartup(const StartupConfig& config) override {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (config.lazyCold.has_value()) {
+      _lazyCold = config.lazyCold.value();
+    }
+  }
+
+  std::shared_ptr<Promise<ListenerResult>> prewarmWarm(const std::vector<WarmPrewarmInstance>& instances) override {
+    auto promise = Promise<ListenerResult>::create();
+    if (instances.empty()) {
+      promise->resolve(ListenerResult(true, std::nullopt));
+      return promise;
+    }
+    // A bad key is refused before anything opens: MMKV would create the
+    // file with it
+    for (const WarmPrewarmInstance& instance : instances) {
+      if (instance.config.has_value() && instance.config->encryptionKey.has_value() &&
+          !isValidWarmKey(instance.config->encryptionKey.value())) {
+        promise->resolve(ListenerResult(false, "Warm encryption key must be 1-16 bytes: " + instance.instanceId));
+        return promise;
+      }
+    }
+    auto state = std::make_shared<WarmPrewarm>();
+    state->remaining = instances.size();
+    state->promise = promise;
+
+    // MMKV's global setup runs first, also off the calling thread
+    _coldWorkers.submit(kWarmStartupLane, [this, instances, state](bool cancelled) {
+      std::string error = "Warm prewarm abandoned: SideFx was destroyed";
+      if (!cancelled) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        cancelled = !initializeWarmGlobal(error, true);
+      }
+      if (cancelled) {
+        state->promise->resolve(ListenerResult(false, error));
+        return;
+      }
+      for (const WarmPrewarmInstance& instance : instances) {
+        _coldWorkers.submit(kWarmStartupLane + instance.instanceId, [this, instance, state](bool cancelled) {
+          prewarmWarmInstance(instance, *state, cancelled);
+        });
+      }
+    });
+    return promise;
+  }
+
+  std::vector<StartupStage> getStartupTimings() override {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _startupStages;
   }
 
   // =========================================================================
   // Manual Change Checks
   // =========================================================================
 
+  /**
+   * Diff every multi-process instance now, whether or not MMKV reported a
+   * write: the handler slot may have been taken by another library.
+   * Single-process instances only change through this process, which
+   * reports its writes as it makes them, so there is nothing else to check.
+   */
   void checkWarmChanges() override {
-    // TODO: Implement Warm storage change detection
-    if (_debugMode) {
-      logDebug("Checking Warm storage changes");
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (!_multiProcessWarm) {
+        SAM_LOG_DEBUG(_logger, LogCategory::WARM, "No multi-process Warm instances to check");
+        return;
+      }
     }
+    SAM_LOG_DEBUG(_logger, LogCategory::WARM, "Checking Warm storage changes");
+    runOuterWarmCheck(true);
   }
 
   void checkColdChanges(const std::string& databaseName,
                           const std::optional<std::string>& table) override {
     // TODO: Implement Cold storage change detection
-    if (_debugMode) {
-      std::string msg = "Checking Cold storage changes for database: " + databaseName;
-      if (table.has_value()) {
-        msg += ", table: " + table.value();
-      }
-      logDebug(msg);
-    }
+    SAM_LOG_DEBUG(_logger, LogCategory::COLD, "Checking Cold storage changes for database: ",
+                  databaseName, table.has_value() ? ", table: " : "", table.value_or(""));
   }
 
   // =========================================================================
@@ -359,7 +532,34 @@ public:
   }
 
   void setDebugMode(bool enabled) override {
-    _debugMode = enabled;
+    applyDebugMode(enabled);
+  }
+
+  // =========================================================================
+  // Logging
+  // =========================================================================
+
+  void setLogLevel(double level, const std::optional<LogCategory>& category) override {
+    // NaN would pass the clamp below, and casting it is undefined
+    if (!std::isfinite(level)) {
+      SAM_LOG_WARN(_logger, LogCategory::GENERAL, "Ignoring non-finite log level");
+      return;
+    }
+    double clamped = level < 0 ? 0 : level > 5 ? 5 : level;
+    auto logLevel = static_cast<LogLevel>(static_cast<uint8_t>(clamped));
+    if (category.has_value()) {
+      _logger.setLevel(category.value(), logLevel);
+    } else {
+      _logger.setLevel(logLevel);
+    }
+  }
+
+  double getLogLevel(const std::optional<LogCategory>& category) override {
+    return static_cast<double>(_logger.level(category.value_or(LogCategory::GENERAL)));
+  }
+
+  void flushLogs() override {
+    _logger.flush();
   }
 
   // =========================================================================
@@ -376,38 +576,37 @@ public:
 
   ListenerResult setWarm(const std::string& key,
                           const std::variant<bool, std::string, double>& value,
-                          const std::optional<std::string>& instanceId) override {
-    std::lock_guard<std::mutex> lock(_mutex);
+                          const std::optional<std::string>& instanceId,
+                          const std::optional<double>& ttlMs) override {
+    OperationTimer timer(_operationStats[kOpSetWarm]);
+    if (ttlMs.has_value() && !(std::isfinite(ttlMs.value()) && ttlMs.value() > 0)) {
+      return timer.fail(ListenerResult(false, "ttlMs must be a positive number"));
+    }
+    auto lock = lockTimed(_mutex, kOpStorageLockWait);
     std::string id = instanceId.value_or("default");
 
     // Validate Warm instance is initialized
-    if (_warmInstances.find(id) == _warmInstances.end()) {
-      return ListenerResult(false, "Warm instance '" + id + "' not initialized");
-    }
-
-    // Get the Warm instance
-    mmkv::MMKV* warmStorage = getWarmInstance(id);
-    if (warmStorage == nullptr) {
-      return ListenerResult(false, "Failed to get Warm instance: " + id);
+    auto instance = _warmInstances.find(id);
+    if (instance == _warmInstances.end()) {
+      return timer.fail(ListenerResult(false, "Warm instance '" + id + "' not initialized"));
     }
+    mmkv::MMKV* warmStorage = useWarmInstance(instance->second);
 
-    // Set value based on type
-    bool success = false;
-    if (std::holds_alternative<bool>(value)) {
-      success = warmStorage->set(std::get<bool>(value), key);
-    } else if (std::holds_alternative<std::string>(value)) {
-      success = warmStorage->set(std::get<std::string>(value), key);
-    } else if (std::holds_alternative<double>(value)) {
-      success = warmStorage->set(std::get<double>(value), key);
+    // An expired value is deleted first, so it can't reach listeners as the
+    // old value of this write
+    expireWarmKeyIfDue(id, instance->second, key);
+    if (!writeWarmValue(id, warmStorage, key, value)) {
+      return timer.fail(ListenerResult(false, "Failed to set Warm key: " + key));
     }
-
-    if (!success) {
-      return ListenerResult(false, "Failed to set Warm key: " + key);
+    // Like Redis SET, a write without a TTL makes the key persistent again
+    if (ttlMs.has_value()) {
+      setWarmExpiry(id, instance->second, key, getCurrentTimestamp() + ttlMs.value());
+    } else if (!_warmExpiry.empty() || instance->second.snapshot != nullptr) {
+      // Another process may have given a shared key a TTL this one hasn't loaded yet
+      clearWarmExpiry(id, instance->second, key);
     }
 
-    if (_debugMode) {
-      logDebug("Set Warm key '" + key + "' in instance '" + id + "'");
-    }
+    SAM_LOG_DEBUG(_logger, LogCategory::WARM, "Set Warm key '", key, "' in instance '", id, "'");
 
     return ListenerResult(true, std::nullopt);
   }
@@ -415,91 +614,76 @@ public:
   std::variant<nitro::NullType, bool, std::string, double> getWarm(
       const std::string& key,
       const std::optional<std::string>& instanceId) override {
-    std::lock_guard<std::mutex> lock(_mutex);
+    OperationTimer timer(_operationStats[kOpGetWarm]);
+    auto lock = lockTimed(_mutex, kOpStorageLockWait);
     std::string id = instanceId.value_or("default");
 
     // Check if instance is initialized
-    if (_warmInstances.find(id) == _warmInstances.end()) {
-      return nitro::NullType();
-    }
-
-    // Get the Warm instance
-    mmkv::MMKV* warmStorage = getWarmInstance(id);
-    if (warmStorage == nullptr) {
+    auto instance = _warmInstances.find(id);
+    if (instance == _warmInstances.end()) {
+      timer.fail();
       return nitro::NullType();
     }
-
-    // Check if key exists
-    if (!warmStorage->containsKey(key)) {
+    mmkv::MMKV* warmStorage = useWarmInstance(instance->second);
+    if (expireWarmKeyIfDue(id, instance->second, key)) {
       return nitro::NullType();
     }
 
-    // Try to get the value - we need to determine the type
-    // MMKV doesn't store type info, so we try each type in order
-    // First try string (most common for JSON data)
     std::string stringValue;
-    if (warmStorage->getString(key, stringValue)) {
-      // Check if it's a JSON boolean or number encoded as string
-      if (stringValue == "true") {
-        return true;
-      } else if (stringValue == "false") {
-        return false;
-      }
-      // Try to parse as double
-      try {
-        size_t pos;
-        double doubleValue = std::stod(stringValue, &pos);
-        if (pos == stringValue.length()) {
-          return doubleValue;
-        }
-      } catch (...) {
-        // Not a number, return as string
-      }
-      return stringValue;
+    ValueView value = readWarmValue(warmStorage, key, stringValue);
+    switch (value.kind) {
+      case ValueView::Kind::Bool:
+        return value.boolValue;
+      case ValueView::Kind::Number:
+        return value.numberValue;
+      case ValueView::Kind::String:
+        return stringValue;
+      default:
+        return nitro::NullType();
     }
-
-    // Try bool
-    bool hasValue = false;
-    bool boolValue = warmStorage->getBool(key, false, &hasValue);
-    if (hasValue) {
-      return boolValue;
-    }
-
-    // Try double
-    double doubleValue = warmStorage->getDouble(key, 0.0, &hasValue);
-    if (hasValue) {
-      return doubleValue;
-    }
-
-    return nitro::NullType();
   }
 
   ListenerResult deleteWarm(const std::string& key,
                             const std::optional<std::string>& instanceId) override {
-    std::lock_guard<std::mutex> lock(_mutex);
+    OperationTimer timer(_operationStats[kOpDeleteWarm]);
+    auto lock = lockTimed(_mutex, kOpStorageLockWait);
     std::string id = instanceId.value_or("default");
 
     // Check if instance is initialized
-    if (_warmInstances.find(id) == _warmInstances.end()) {
-      return ListenerResult(false, "Warm instance '" + id + "' not initialized");
+    auto instance = _warmInstances.find(id);
+    if (instance == _warmInstances.end()) {
+      return timer.fail(ListenerResult(false, "Warm instance '" + id + "' not initialized"));
     }
+    mmkv::MMKV* warmStorage = useWarmInstance(instance->second);
 
-    // Get the Warm instance
-    mmkv::MMKV* warmStorage = getWarmInstance(id);
-    if (warmStorage == nullptr) {
-      return ListenerResult(false, "Failed to get Warm instance: " + id);
+    // Check if key exists
+    if (expireWarmKeyIfDue(id, instance->second, key) || !warmStorage->containsKey(key)) {
+      return timer.fail(ListenerResult(false, "Key '" + key + "' not found"));
     }
 
-    // Check if key exists
-    if (!warmStorage->containsKey(key)) {
-      return ListenerResult(false, "Key '" + key + "' not found");
+    // Capture the previous value only when someone can observe it
+    bool observed = _warmListenerCount.load(std::memory_order_relaxed) > 0;
+    ValueView oldValue;
+    if (observed) {
+      oldValue = readWarmValue(warmStorage, key, _scratchValue);
     }
 
     // Remove the key
     warmStorage->removeValueForKey(key);
+    _warmWrites.fetch_add(1, std::memory_order_relaxed);
+    if (instance->second.snapshot != nullptr) {
+      instance->second.snapshot->erase(key);
+    }
+    if (!_warmExpiry.empty() || instance->second.snapshot != nullptr) {
+      clearWarmExpiry(id, instance->second, key);
+    }
+
+    SAM_LOG_DEBUG(_logger, LogCategory::WARM, "Deleted Warm key '", key, "' from instance '", id, "'");
 
-    if (_debugMode) {
-      logDebug("Deleted Warm key '" + key + "' from instance '" + id + "'");
+    if (observed) {
+      ValueView deleted;
+      deleted.kind = ValueView::Kind::Null;
+      enqueueWarmChange(id, key, ChangeOperation::DELETE, oldValue, deleted);
     }
 
     return ListenerResult(true, std::nullopt);
@@ -509,59 +693,58 @@ public:
       const std::string& sql,
       const std::optional<std::vector<std::variant<nitro::NullType, bool, std::string, double>>>& params,
       const std::optional<std::string>& databaseName) override {
-    std::lock_guard<std::mutex> lock(_mutex);
+    OperationTimer timer(_operationStats[kOpExecuteCold]);
+    auto lock = lockTimed(_mutex, kOpStorageLockWait);
     std::string dbName = databaseName.value_or("default");
 
-    // Check if database exists
-    auto dbIt = _sqliteDatabases.find(dbName);
-    if (dbIt == _sqliteDatabases.end() || dbIt->second == nullptr) {
-      return ListenerResult(false, "Cold storage database '" + dbName + "' not initialized");
+    std::string error;
+    sqlite3* db = coldDatabase(dbName, &error);
+    if (db == nullptr) {
+      return timer.fail(ListenerResult(false, error));
     }
 
-    sqlite3* db = dbIt->second;
+    SAM_LOG_DEBUG(_logger, LogCategory::COLD, "Execute SQL on Cold storage '", dbName, "': ", sql);
 
-    if (_debugMode) {
-      logDebug("Execute SQL on Cold storage '" + dbName + "': " + sql);
+    int rc = runColdStatement(db, sql, params, error);
+    // A failed statement was rolled back, so the rows it touched never changed
+    enqueueColdChanges(dbName, _pendingColdChanges, rc == SQLITE_OK);
+    if (rc != SQLITE_OK) {
+      return timer.fail(ListenerResult(false, error));
     }
 
-    // Prepare statement
-    sqlite3_stmt* stmt = nullptr;
-    int rc = sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr);
+    return ListenerResult(true, std::nullopt);
+  }
 
-    if (rc != SQLITE_OK) {
-      std::string error = sqlite3_errmsg(db);
-      return ListenerResult(false, "SQL prepare error: " + error);
-    }
+  ListenerResult executeColdScript(const std::string& sql, const std::optional<std::string>& databaseName) override {
+    OperationTimer timer(_operationStats[kOpExecuteColdScript]);
+    auto lock = lockTimed(_mutex, kOpStorageLockWait);
+    std::string dbName = databaseName.value_or("default");
 
-    // Bind parameters if provided
-    if (params.has_value()) {
-      const auto& paramVec = params.value();
-      for (size_t i = 0; i < paramVec.size(); ++i) {
-        int paramIndex = static_cast<int>(i + 1);  // SQLite params are 1-indexed
-        const auto& param = paramVec[i];
-
-        if (std::holds_alternative<nitro::NullType>(param)) {
-          sqlite3_bind_null(stmt, paramIndex);
-        } else if (std::holds_alternative<bool>(param)) {
-          sqlite3_bind_int(stmt, paramIndex, std::get<bool>(param) ? 1 : 0);
-        } else if (std::holds_alternative<std::string>(param)) {
-          const std::string& str = std::get<std::string>(param);
-          sqlite3_bind_text(stmt, paramIndex, str.c_str(), static_cast<int>(str.length()), SQLITE_TRANSIENT);
-        } else if (std::holds_alternative<double>(param)) {
-          sqlite3_bind_double(stmt, paramIndex, std::get<double>(param));
-        }
-      }
+    std::string error;
+    sqlite3* db = coldDatabase(dbName, &error);
+    if (db == nullptr) {
+      return timer.fail(ListenerResult(false, error));
     }
 
-    // Execute statement
-    rc = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
-
-    if (rc != SQLITE_DONE && rc != SQLITE_ROW) {
-      std::string error = sqlite3_errmsg(db);
-      return ListenerResult(false, "SQL execution error: " + error);
+    SAM_LOG_DEBUG(_logger, LogCategory::COLD, "Execute SQL script on Cold storage '", dbName, "' (", sql.size(),
+                  " bytes)");
+
+    bool autocommit = sqlite3_get_autocommit(db) != 0;
+    std::vector<ColdChange> applied;
+    size_t statements = 0;
+    int rc = runColdScript(db, sql, _pendingColdChanges, applied, statements, error);
+    bool rolledBack = false;
+    if (rc != SQLITE_OK && autocommit && sqlite3_get_autocommit(db) == 0) {
+      // Don't leave a transaction the script began open on the shared connection
+      sqlite3_exec(db, "ROLLBACK", nullptr, nullptr, nullptr);
+      rolledBack = true;
+    }
+    enqueueColdChanges(dbName, applied, !rolledBack);
+    if (rc != SQLITE_OK) {
+      return timer.fail(ListenerResult(false, error));
     }
 
+    SAM_LOG_DEBUG(_logger, LogCategory::COLD, "Ran ", statements, " statements on Cold storage '", dbName, "'");
     return ListenerResult(true, std::nullopt);
   }
 
@@ -569,124 +752,700 @@ public:
       const std::string& sql,
       const std::optional<std::vector<std::variant<nitro::NullType, bool, std::string, double>>>& params,
       const std::optional<std::string>& databaseName) override {
-    std::lock_guard<std::mutex> lock(_mutex);
+    OperationTimer timer(_operationStats[kOpQueryCold]);
+    auto lock = lockTimed(_mutex, kOpStorageLockWait);
     std::string dbName = databaseName.value_or("default");
-
-    // Check if database exists
-    auto dbIt = _sqliteDatabases.find(dbName);
-    if (dbIt == _sqliteDatabases.end() || dbIt->second == nullptr) {
+    std::string json;
+    sqlite3* db = coldDatabase(dbName);
+    bool ok = db != nullptr && runColdQueryJson(db, dbName, sql, params, json) == SQLITE_OK;
+    // A successful query may still have written rows (e.g. INSERT ... RETURNING)
+    enqueueColdChanges(dbName, _pendingColdChanges, ok);
+    if (!ok) {
+      timer.fail();
       return nitro::NullType();
     }
+    return json;
+  }
 
-    sqlite3* db = dbIt->second;
-
-    if (_debugMode) {
-      logDebug("Query Cold storage '" + dbName + "': " + sql);
-    }
+  // =========================================================================
+  // Zero-copy Buffer Reads
+  // =========================================================================
 
-    // Prepare statement
-    sqlite3_stmt* stmt = nullptr;
-    int rc = sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr);
+  std::variant<nitro::NullType, std::shared_ptr<ArrayBuffer>> getWarmBuffer(
+      const std::string& key,
+      const std::optional<std::string>& instanceId) override {
+    OperationTimer timer(_operationStats[kOpGetWarmBuffer]);
+    auto lock = lockTimed(_mutex, kOpStorageLockWait);
+    std::string id = instanceId.value_or("default");
 
-    if (rc != SQLITE_OK) {
-      std::string error = sqlite3_errmsg(db);
-      logDebug("SQL prepare error: " + error);
+    auto instance = _warmInstances.find(id);
+    if (instance == _warmInstances.end()) {
+      timer.fail();
       return nitro::NullType();
     }
 
-    // Bind parameters if provided
-    if (params.has_value()) {
-      const auto& paramVec = params.value();
-      for (size_t i = 0; i < paramVec.size(); ++i) {
-        int paramIndex = static_cast<int>(i + 1);
-        const auto& param = paramVec[i];
-
-        if (std::holds_alternative<nitro::NullType>(param)) {
-          sqlite3_bind_null(stmt, paramIndex);
-        } else if (std::holds_alternative<bool>(param)) {
-          sqlite3_bind_int(stmt, paramIndex, std::get<bool>(param) ? 1 : 0);
-        } else if (std::holds_alternative<std::string>(param)) {
-          const std::string& str = std::get<std::string>(param);
-          sqlite3_bind_text(stmt, paramIndex, str.c_str(), static_cast<int>(str.length()), SQLITE_TRANSIENT);
-        } else if (std::holds_alternative<double>(param)) {
-          sqlite3_bind_double(stmt, paramIndex, std::get<double>(param));
-        }
-      }
+    mmkv::MMKV* warmStorage = useWarmInstance(instance->second);
+    if (expireWarmKeyIfDue(id, instance->second, key) || !warmStorage->containsKey(key)) {
+      return nitro::NullType();
     }
 
-    // Collect results as JSON array
-    std::ostringstream jsonStream;
-    jsonStream << "[";
-
-    int columnCount = sqlite3_column_count(stmt);
-    bool firstRow = true;
+    // getBytes performs the single copy out of the mmap. The mmap itself can be
+    // remapped by the next write, so it is never safe to hand JS a view of it;
+    // instead the decoded MMBuffer is moved to the heap and owned by the
+    // ArrayBuffer, so no further copy happens on the way into JS.
+    auto* bytes = new mmkv::MMBuffer(warmStorage->getBytes(key));
+    if (bytes->length() == 0) {
+      delete bytes;
+      return ArrayBuffer::allocate(0);
+    }
+    return ArrayBuffer::wrap(static_cast<uint8_t*>(bytes->getPtr()), bytes->length(),
+                             [bytes]() { delete bytes; });
+  }
 
-    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
-      if (!firstRow) {
-        jsonStream << ",";
-      }
-      firstRow = false;
+  std::variant<nitro::NullType, std::shared_ptr<ArrayBuffer>> queryColdBuffer(
+      const std::string& sql,
+      const std::optional<std::vector<std::variant<nitro::NullType, bool, std::string, double>>>& params,
+      const std::optional<std::string>& databaseName) override {
+    OperationTimer timer(_operationStats[kOpQueryColdBuffer]);
+    auto lock = lockTimed(_mutex, kOpStorageLockWait);
+    std::string dbName = databaseName.value_or("default");
+    auto* json = new std::string();
+    sqlite3* db = coldDatabase(dbName);
+    bool ok = db != nullptr && runColdQueryJson(db, dbName, sql, params, *json) == SQLITE_OK;
+    enqueueColdChanges(dbName, _pendingColdChanges, ok);
+    if (!ok) {
+      timer.fail();
+      delete json;
+      return nitro::NullType();
+    }
+    // Hand the serialized result over as-is instead of converting it to a JS string
+    return ArrayBuffer::wrap(reinterpret_cast<uint8_t*>(json->data()), json->size(),
+                             [json]() { delete json; });
+  }
 
-      jsonStream << "{";
+  // =========================================================================
+  // Full-Text Search
+  // =========================================================================
 
-      for (int col = 0; col < columnCount; ++col) {
-        if (col > 0) {
-          jsonStream << ",";
-        }
+  ListenerResult declareColdSearch(const ColdSearchConfig& config,
+                                   const std::optional<std::string>& databaseName) override {
+    auto lock = lockTimed(_mutex, kOpStorageLockWait);
+    std::string dbName = databaseName.value_or("default");
+    std::string error;
+    sqlite3* db = coldDatabase(dbName, &error);
+    if (db == nullptr) {
+      return ListenerResult(false, error);
+    }
+    bool ok = createColdSearch(db, config, error);
+    enqueueColdChanges(dbName, _pendingColdChanges, ok);
+    if (!ok) {
+      SAM_LOG_WARN(_logger, LogCategory::COLD, "Failed to declare search on '", config.table, "': ", error);
+      return ListenerResult(false, error);
+    }
+    SAM_LOG_INFO(_logger, LogCategory::COLD, "Declared search on Cold table '", config.table, "' in '", dbName, "'");
+    return ListenerResult(true, std::nullopt);
+  }
 
-        const char* colName = sqlite3_column_name(stmt, col);
-        jsonStream << "\"" << escapeJsonString(colName) << "\":";
+  std::variant<nitro::NullType, std::shared_ptr<ArrayBuffer>> searchCold(
+      const std::string& table,
+      const std::string& query,
+      const std::optional<ColdSearchOptions>& options,
+      const std::optional<std::string>& databaseName) override {
+    OperationTimer timer(_operationStats[kOpSearchCold]);
+    auto lock = lockTimed(_mutex, kOpStorageLockWait);
+    std::string dbName = databaseName.value_or("default");
+    sqlite3* db = coldDatabase(dbName);
+    if (db == nullptr) {
+      timer.fail();
+      return nitro::NullType();
+    }
 
-        int colType = sqlite3_column_type(stmt, col);
-        switch (colType) {
-          case SQLITE_NULL:
-            jsonStream << "null";
-            break;
-          case SQLITE_INTEGER:
-            jsonStream << sqlite3_column_int64(stmt, col);
-            break;
-          case SQLITE_FLOAT:
-            jsonStream << sqlite3_column_double(stmt, col);
-            break;
-          case SQLITE_TEXT: {
-            const char* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, col));
-            jsonStream << "\"" << escapeJsonString(text ? text : "") << "\"";
-            break;
-          }
-          case SQLITE_BLOB:
-            // Convert blob to base64 or skip - for simplicity, output as null
-            jsonStream << "null";
-            break;
-          default:
-            jsonStream << "null";
-            break;
-        }
+    ColdSearchOptions opts = options.value_or(ColdSearchOptions());
+    std::string index = table + kSearchSuffix;
+    int snippetColumn = -1;  // FTS5 picks the best-matching column
+    if (opts.snippetColumn.has_value()) {
+      std::vector<std::string> columns = coldTableColumns(db, index);
+      auto it = std::find(columns.begin(), columns.end(), opts.snippetColumn.value());
+      if (it == columns.end()) {
+        SAM_LOG_WARN(_logger, LogCategory::COLD, "searchCold: '", opts.snippetColumn.value(),
+                     "' is not a searchable column of '", table, "'");
+        timer.fail();
+        return nitro::NullType();
       }
-
-      jsonStream << "}";
+      snippetColumn = static_cast<int>(it - columns.begin());
     }
 
-    sqlite3_finalize(stmt);
+    // Pick and snippet the page in the index alone, then join only those
+    // rows to the table. Rowid order walks the index's doclists in order
+    // and stops at the limit; rank has to score every match first.
+    const char* order;
+    switch (opts.order.value_or(ColdSearchOrder::RANK)) {
+      case ColdSearchOrder::NEWEST: order = "rowid DESC"; break;
+      case ColdSearchOrder::OLDEST: order = "rowid"; break;
+      default: order = "rank"; break;
+    }
+    std::string sql =
+        "SELECT t.*, m.rowid AS \"_rowid\", -m.rank AS \"_score\", m.snippet AS \"_snippet\" FROM ("
+        "SELECT rowid, rank, snippet(" + quoteColdIdentifier(index) + ", ?, ?, ?, ?, ?) AS snippet FROM " +
+        quoteColdIdentifier(index) + " WHERE " + quoteColdIdentifier(index) + " MATCH ? ORDER BY " + order +
+        " LIMIT ? OFFSET ?) AS m JOIN " + quoteColdIdentifier(table) + " AS t ON t.rowid = m.rowid ORDER BY m." +
+        order;
+    double tokens = std::clamp(opts.snippetTokens.value_or(16.0), 1.0, 64.0);
+    std::vector<std::variant<nitro::NullType, bool, std::string, double>> params = {
+        static_cast<double>(snippetColumn),
+        opts.highlightOpen.value_or("<b>"),
+        opts.highlightClose.value_or("</b>"),
+        std::string("\u2026"),
+        std::floor(tokens),
+        query,
+        std::max(0.0, std::floor(opts.limit.value_or(50.0))),
+        std::max(0.0, std::floor(opts.offset.value_or(0.0))),
+    };
 
-    if (rc != SQLITE_DONE) {
-      std::string error = sqlite3_errmsg(db);
-      logDebug("SQL step error: " + error);
+    auto* json = new std::string();
+    bool ok = runColdQueryJson(db, dbName, sql, params, *json) == SQLITE_OK;
+    if (!ok) {
+      timer.fail();
+      delete json;
       return nitro::NullType();
     }
-
-    jsonStream << "]";
-    return jsonStream.str();
+    return ArrayBuffer::wrap(reinterpret_cast<uint8_t*>(json->data()), json->size(),
+                             [json]() { delete json; });
   }
 
   // =========================================================================
-  // Network Monitoring
+  // Warm Compaction
   // =========================================================================
 
-  ListenerResult startNetworkMonitoring() override {
-    std::lock_guard<std::mutex> lock(_mutex);
-
-    if (_networkMonitoringActive) {
-      return ListenerResult(true, std::nullopt);
+  void configureWarmCompaction(const WarmCompactionConfig& config) override {
+    std::lock_guard<std::mutex> lock(_compactionMutex);
+    if (config.enabled.has_value()) {
+      _compactionPolicy.enabled = config.enabled.value();
+    }
+    if (config.idleMs.has_value() && config.idleMs.value() > 0) {
+      _compactionPolicy.idle = std::chrono::milliseconds(static_cast<int64_t>(config.idleMs.value()));
+      _maintenance.setInterval(kCompactionTask, _compactionPolicy.idle);
+    }
+    if (config.minFileBytes.has_value() && config.minFileBytes.value() >= 0) {
+      _compactionPolicy.minFileBytes = static_cast<size_t>(config.minFileBytes.value());
+    }
+    if (config.maxAmplification.has_value() && config.maxAmplification.value() >= 1) {
+      _compactionPolicy.maxAmplification = config.maxAmplification.value();
+    }
+  }
+
+  void compactWarm(const std::optional<std::string>& instanceId) override {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      scheduleMaintenance();
+    }
+    {
+      std::lock_guard<std::mutex> lock(_compactionMutex);
+      _compactionRequests.insert(instanceId.value_or(std::string()));
+    }
+    _maintenance.runSoon(kCompactionTask);
+  }
+
+  std::vector<WarmCompactionStats> getWarmCompactionStats(const std::optional<std::string>& instanceId) override {
+    std::vector<WarmCompactionStats> stats;
+    for (const auto& [id, storage] : residentWarmInstances()) {
+      if (instanceId.has_value() && id != *instanceId) {
+        continue;
+      }
+      double fileBytes = static_cast<double>(storage->totalSize());
+      double usedBytes = static_cast<double>(storage->actualSize());
+      double liveBytes = static_cast<double>(measureLiveBytes(id, storage));
+      std::lock_guard<std::mutex> lock(_compactionMutex);
+      const WarmCompactionState& state = _compactionStates[id];
+      stats.emplace_back(id, fileBytes, usedBytes, liveBytes, state.compactions, state.lastDurationMs,
+                         state.lastCompactedAt, state.bytesReclaimed);
+    }
+    return stats;
+  }
+
+  // =========================================================================
+  // Cold Checkpoints
+  // =========================================================================
+
+  void configureColdCheckpoints(const ColdCheckpointConfig& config) override {
+    bool toggled = false;
+    {
+      std::lock_guard<std::mutex> lock(_checkpointMutex);
+      if (config.enabled.has_value() && config.enabled.value() != _checkpointPolicy.enabled) {
+        _checkpointPolicy.enabled = config.enabled.value();
+        _checkpointsEnabled.store(_checkpointPolicy.enabled, std::memory_order_relaxed);
+        toggled = true;
+      }
+      if (config.intervalMs.has_value() && config.intervalMs.value() > 0) {
+        _checkpointPolicy.interval = std::chrono::milliseconds(static_cast<int64_t>(config.intervalMs.value()));
+        _maintenance.setInterval(kCheckpointTask, _checkpointPolicy.interval);
+      }
+      if (config.truncateWalBytes.has_value() && config.truncateWalBytes.value() >= 0) {
+        _checkpointPolicy.truncateWalBytes = static_cast<uint64_t>(config.truncateWalBytes.value());
+      }
+      if (config.maxWalBytes.has_value() && config.maxWalBytes.value() > 0) {
+        _checkpointPolicy.maxWalBytes = static_cast<uint64_t>(config.maxWalBytes.value());
+      }
+    }
+    if (toggled) {
+      applyWalAutocheckpoints();
+    }
+  }
+
+  void checkpointCold(const std::optional<std::string>& databaseName) override {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      scheduleMaintenance();
+    }
+    {
+      std::lock_guard<std::mutex> lock(_checkpointMutex);
+      _checkpointRequests.insert(databaseName.value_or(std::string()));
+    }
+    _maintenance.runSoon(kCheckpointTask);
+  }
+
+  std::vector<ColdCheckpointStats> getColdCheckpointStats(const std::optional<std::string>& databaseName) override {
+    std::vector<ColdCheckpointStats> stats;
+    for (const auto& [name, path] : fileColdDatabases()) {
+      if (databaseName.has_value() && name != *databaseName) {
+        continue;
+      }
+      double walBytes = static_cast<double>(walFileBytes(path));
+      std::lock_guard<std::mutex> lock(_checkpointMutex);
+      ColdCheckpointState state;
+      auto it = _checkpointStates.find(name);
+      if (it != _checkpointStates.end()) {
+        state = it->second;
+      }
+      stats.emplace_back(name, walBytes, state.checkpoints, state.truncateCheckpoints, state.incompleteCheckpoints,
+                         state.lastDurationMs, state.maxDurationMs, state.lastCheckpointAt);
+    }
+    return stats;
+  }
+
+  // =========================================================================
+  // Memory Governor
+  // =========================================================================
+
+  MemoryUsage getMemoryUsage() override {
+    return measureMemory();
+  }
+
+  void handleMemoryPressure(MemoryPressureLevel level) override {
+    {
+      std::lock_guard<std::mutex> lock(_governorMutex);
+      _lastPressure = level;
+      if (level == MemoryPressureLevel::NORMAL) {
+        return;
+      }
+      if (!_pendingPressure.has_value() || *_pendingPressure < level) {
+        _pendingPressure = level;
+      }
+    }
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      scheduleMaintenance();
+    }
+    _maintenance.runSoon(kGovernorTask);
+  }
+
+  // =========================================================================
+  // Secure Value Cache
+  // =========================================================================
+
+  void configureSecureCache(const std::string& service, double ttlMs) override {
+    std::lock_guard<std::mutex> lock(_secureMutex);
+    auto ttl = std::chrono::milliseconds(std::isfinite(ttlMs) && ttlMs > 0 ? static_cast<int64_t>(ttlMs) : 0);
+    _secureCache.setTtl(service, ttl);
+    scheduleSecureExpiry();
+  }
+
+  double getSecureCacheGeneration(const std::string& service) override {
+    std::lock_guard<std::mutex> lock(_secureMutex);
+    return static_cast<double>(_secureCache.generation(service));
+  }
+
+  bool cacheSecureValue(const std::string& service, const std::string& username,
+                        const std::string& password, const std::optional<double>& generation) override {
+    std::lock_guard<std::mutex> lock(_secureMutex);
+    std::optional<uint64_t> expected;
+    if (generation.has_value()) {
+      expected = static_cast<uint64_t>(generation.value());
+    }
+    if (!_secureCache.put(service, username, password, SecureValueCache::Clock::now(), expected)) {
+      return false;
+    }
+    scheduleSecureExpiry();
+    return true;
+  }
+
+  std::optional<SecureCachedValue> getCachedSecureValue(const std::string& service) override {
+    OperationTimer timer(_operationStats[kOpGetCachedSecure]);
+    std::lock_guard<std::mutex> lock(_secureMutex);
+    auto value = _secureCache.get(service, SecureValueCache::Clock::now());
+    if (!value.has_value()) {
+      return std::nullopt;
+    }
+    return SecureCachedValue(std::move(value->username), std::move(value->password));
+  }
+
+  void invalidateSecureValue(const std::optional<std::string>& service) override {
+    std::lock_guard<std::mutex> lock(_secureMutex);
+    if (service.has_value()) {
+      _secureCache.erase(service.value());
+    } else {
+      _secureCache.clear();
+    }
+    scheduleSecureExpiry();
+  }
+
+  // =========================================================================
+  // Async Cold Storage
+  // =========================================================================
+
+  std::shared_ptr<Promise<ListenerResult>> executeColdAsync(
+      const std::string& sql,
+      const std::optional<std::vector<std::variant<nitro::NullType, bool, std::string, double>>>& params,
+      const std::optional<std::string>& databaseName,
+      const std::optional<double>& cancelToken) override {
+    auto promise = Promise<ListenerResult>::create();
+    std::string dbName = databaseName.value_or("default");
+    bool queued = submitColdJob<ListenerResult>(
+        dbName, cancelToken, kOpExecuteColdAsync, promise,
+        [this, sql, params, dbName](sqlite3* db, int& rc) {
+          if (db == nullptr) {
+            rc = SQLITE_CANTOPEN;
+            return ListenerResult(false, "Failed to open Cold storage database '" + dbName + "'");
+          }
+          SAM_LOG_DEBUG(_logger, LogCategory::COLD, "Execute SQL async on Cold storage '", dbName, "': ", sql);
+          std::string error;
+          rc = runColdStatement(db, sql, params, error);
+          return rc == SQLITE_OK ? ListenerResult(true, std::nullopt) : ListenerResult(false, error);
+        });
+    if (!queued) {
+      _operationStats[kOpExecuteColdAsync].errors.fetch_add(1, std::memory_order_relaxed);
+      promise->resolve(ListenerResult(false, "Cold storage database '" + dbName + "' not initialized"));
+    }
+    return promise;
+  }
+
+  std::shared_ptr<Promise<std::variant<nitro::NullType, std::string>>> queryColdAsync(
+      const std::string& sql,
+      const std::optional<std::vector<std::variant<nitro::NullType, bool, std::string, double>>>& params,
+      const std::optional<std::string>& databaseName,
+      const std::optional<double>& cancelToken) override {
+    using QueryResult = std::variant<nitro::NullType, std::string>;
+    auto promise = Promise<QueryResult>::create();
+    std::string dbName = databaseName.value_or("default");
+    bool queued = submitColdJob<QueryResult>(
+        dbName, cancelToken, kOpQueryColdAsync, promise,
+        [this, sql, params, dbName](sqlite3* db, int& rc) -> QueryResult {
+          if (db == nullptr) {
+            rc = SQLITE_CANTOPEN;
+            return nitro::NullType();
+          }
+          std::string json;
+          rc = runColdQueryJson(db, dbName, sql, params, json);
+          if (rc != SQLITE_OK) {
+            return nitro::NullType();
+          }
+          return json;
+        });
+    if (!queued) {
+      _operationStats[kOpQueryColdAsync].errors.fetch_add(1, std::memory_order_relaxed);
+      promise->resolve(QueryResult(nitro::NullType()));
+    }
+    return promise;
+  }
+
+  std::shared_ptr<Promise<std::variant<nitro::NullType, std::string>>> queryColdAcross(
+      const std::string& sql,
+      const std::vector<std::string>& databaseNames,
+      const std::optional<std::vector<std::variant<nitro::NullType, bool, std::string, double>>>& params,
+      const std::optional<ColdAcrossOptions>& options,
+      const std::optional<double>& cancelToken) override {
+    using QueryResult = std::variant<nitro::NullType, std::string>;
+    auto query = std::make_shared<ColdAcrossQuery>();
+    query->promise = Promise<QueryResult>::create();
+    query->startedNs = monotonicNanos();
+    if (databaseNames.empty()) {
+      _operationStats[kOpQueryColdAcross].errors.fetch_add(1, std::memory_order_relaxed);
+      query->promise->resolve(QueryResult(nitro::NullType()));
+      return query->promise;
+    }
+    query->databases = databaseNames;
+    query->parts.resize(databaseNames.size());
+    if (options.has_value()) {
+      query->orderBy = options->orderBy.value_or("");
+      query->descending = options->descending.value_or(false);
+      if (options->limit.has_value() && options->limit.value() >= 0) {
+        query->limit = static_cast<size_t>(options->limit.value());
+      }
+    }
+    query->remaining.store(databaseNames.size(), std::memory_order_relaxed);
+
+    for (size_t i = 0; i < databaseNames.size(); ++i) {
+      const std::string& dbName = databaseNames[i];
+      auto part = Promise<bool>::create();
+      part->addOnResolvedListener([this, query](const bool& ok) {
+        if (!ok) {
+          query->failed.store(true, std::memory_order_relaxed);
+        }
+        finishColdAcrossPart(query);
+      });
+      part->addOnRejectedListener([this, query](const std::exception_ptr& error) {
+        if (!query->failed.exchange(true, std::memory_order_relaxed)) {
+          query->error = error;
+        }
+        finishColdAcrossPart(query);
+      });
+      bool queued = submitColdJob<bool>(
+          dbName, cancelToken, kOpQueryColdAcrossPart, part,
+          [this, query, i, sql, params, dbName](sqlite3* db, int& rc) {
+            if (db == nullptr) {
+              rc = SQLITE_CANTOPEN;
+              return false;
+            }
+            rc = runColdQueryColumns(db, dbName, sql, params, *query, query->parts[i]);
+            return rc == SQLITE_OK;
+          });
+      if (!queued) {
+        SAM_LOG_WARN(_logger, LogCategory::COLD, "Cold storage database '", dbName, "' not initialized");
+        _operationStats[kOpQueryColdAcrossPart].errors.fetch_add(1, std::memory_order_relaxed);
+        part->resolve(false);
+      }
+    }
+    return query->promise;
+  }
+
+  bool cancelColdRequests(double cancelToken) override {
+    std::shared_ptr<ColdCancelState> state;
+    {
+      std::lock_guard<std::mutex> lock(_coldCancelMutex);
+      auto it = _coldCancelTokens.find(static_cast<int64_t>(cancelToken));
+      if (it == _coldCancelTokens.end()) {
+        return false;
+      }
+      state = it->second;
+      // Requests submitted with this token from now on start a new batch
+      _coldCancelTokens.erase(it);
+    }
+    // Queued jobs see the flag before they start; a running statement sees
+    // it in its progress handler and stops with SQLITE_INTERRUPT
+    state->cancelled.store(true, std::memory_order_release);
+    SAM_LOG_DEBUG(_logger, LogCategory::COLD, "Cancelled Cold requests for token ", cancelToken);
+    return true;
+  }
+
+  // =========================================================================
+  // Change Dispatch
+  // =========================================================================
+
+  void setChangeEventHandler(
+      const std::function<void(const std::vector<ChangeEvent>& /* events */)>& handler) override {
+    std::lock_guard<std::mutex> lock(_dispatchMutex);
+    _changeEventHandler = std::make_shared<ChangeEventHandler>(handler);
+  }
+
+  DispatchAllocationStats getDispatchAllocationStats() override {
+    std::lock_guard<std::mutex> lock(_dispatchMutex);
+    const auto& arena = _dispatchArena.stats();
+    return DispatchAllocationStats(
+        SAM_DISPATCH_ALLOC_STATS != 0,
+        static_cast<double>(_dispatchStats.batches),
+        static_cast<double>(_dispatchStats.eventsBuilt),
+        static_cast<double>(arena.blockAllocations),
+        static_cast<double>(arena.bytesReserved),
+        static_cast<double>(arena.highWaterBytes),
+        static_cast<double>(_dispatchStats.bufferGrowths));
+  }
+
+  /**
+   * Block until every change enqueued before this call has been matched and
+   * delivered. Native-only; used by tests and benchmarks that need to observe
+   * events synchronously. Must not be called from inside a change handler.
+   */
+  void waitForDispatch() {
+    uint64_t target = _changesEnqueued.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(_parkMutex);
+    _idleCv.wait(lock, [this, target]() {
+      return _changesDispatched.load(std::memory_order_acquire) >= target;
+    });
+  }
+
+  // =========================================================================
+  // Metrics
+  // =========================================================================
+
+  SAMMetrics getMetrics() override {
+    return collectMetrics(false);
+  }
+
+  SAMMetrics snapshotAndResetMetrics() override {
+    return collectMetrics(true);
+  }
+
+  // =========================================================================
+  // Action Routing (Missile)
+  // =========================================================================
+
+  double addActionRoute(const std::vector<std::string>& patterns, bool once) override {
+    std::lock_guard<std::mutex> lock(_routerMutex);
+    return static_cast<double>(_actionRouter.add(patterns, once));
+  }
+
+  bool removeActionRoute(double routeId) override {
+    std::lock_guard<std::mutex> lock(_routerMutex);
+    return _actionRouter.remove(static_cast<uint32_t>(routeId));
+  }
+
+  std::vector<double> matchActionRoutes(const std::string& actionType) override {
+    std::lock_guard<std::mutex> lock(_routerMutex);
+    _actionRouter.match(actionType, _routeMatches);
+    return std::vector<double>(_routeMatches.begin(), _routeMatches.end());
+  }
+
+  // =========================================================================
+  // MFE Registry
+  // =========================================================================
+
+  MFERecord setMFERecord(const std::string& mfeId, MFEPhase phase,
+                         const std::optional<MFERecordUpdate>& update) override {
+    OperationTimer timer(_operationStats[kOpSetMFERecord]);
+    auto lock = lockTimed(_mutex, kOpStorageLockWait);
+    hydrateMFERegistry();
+
+    double now = getCurrentTimestamp();
+    auto [it, inserted] = _mfeRecords.try_emplace(mfeId);
+    MFERecord& record = it->second;
+    MFEPhase previous = inserted ? MFEPhase::IDLE : record.phase;
+    if (inserted) {
+      record.mfeId = mfeId;
+    }
+    record.phase = phase;
+    if (update.has_value()) {
+      mergeMFEField(record.version, update->version);
+      mergeMFEField(record.errorMessage, update->errorMessage);
+      mergeMFEField(record.loadedAt, update->loadedAt);
+      mergeMFEField(record.mountedAt, update->mountedAt);
+      mergeMFEField(record.unmountedAt, update->unmountedAt);
+      mergeMFEField(record.loadTimeMs, update->loadTimeMs);
+    }
+    bool finishedLoading = previous == MFEPhase::LOADING &&
+                           (phase == MFEPhase::LOADED || phase == MFEPhase::VERSIONED);
+    if (finishedLoading) {
+      std::optional<double> measured;
+      if (update.has_value() && update->loadTimeMs.has_value()) {
+        measured = update->loadTimeMs;
+      } else if (record.loadedAt.has_value()) {
+        measured = now - *record.loadedAt;
+        record.loadTimeMs = measured;
+      }
+      if (measured.has_value()) {
+        recordMFELoadTimeLocked(mfeId, *measured);
+      }
+    }
+    record.updatedAt = now;
+
+    persistMFERecord(record);
+    enqueueMFETransition(mfeId, previous, &record, now);
+    return record;
+  }
+
+  std::optional<MFERecord> getMFERecord(const std::string& mfeId) override {
+    auto lock = lockTimed(_mutex, kOpStorageLockWait);
+    hydrateMFERegistry();
+    auto it = _mfeRecords.find(mfeId);
+    if (it == _mfeRecords.end()) {
+      return std::nullopt;
+    }
+    return it->second;
+  }
+
+  std::vector<MFERecord> getAllMFEStates() override {
+    OperationTimer timer(_operationStats[kOpGetAllMFEStates]);
+    auto lock = lockTimed(_mutex, kOpStorageLockWait);
+    hydrateMFERegistry();
+    std::vector<MFERecord> records;
+    records.reserve(_mfeRecords.size());
+    for (const auto& entry : _mfeRecords) {
+      records.push_back(entry.second);
+    }
+    return records;
+  }
+
+  bool clearMFERecord(const std::string& mfeId) override {
+    auto lock = lockTimed(_mutex, kOpStorageLockWait);
+    hydrateMFERegistry();
+    auto it = _mfeRecords.find(mfeId);
+    if (it == _mfeRecords.end()) {
+      return false;
+    }
+    MFEPhase previous = it->second.phase;
+    _mfeRecords.erase(it);
+    if (mmkv::MMKV* storage = mfeStorage()) {
+      storage->removeValueForKey(kMFEKeyPrefix + mfeId);
+    }
+    enqueueMFETransition(mfeId, previous, nullptr, getCurrentTimestamp());
+    return true;
+  }
+
+  void recordMFELoadTime(const std::string& mfeId, double loadTimeMs) override {
+    auto lock = lockTimed(_mutex, kOpStorageLockWait);
+    hydrateMFERegistry();
+    recordMFELoadTimeLocked(mfeId, loadTimeMs);
+  }
+
+  std::vector<MFELoadStats> getMFELoadStats(const std::optional<std::string>& mfeId) override {
+    auto lock = lockTimed(_mutex, kOpStorageLockWait);
+    hydrateMFERegistry();
+    std::vector<MFELoadStats> stats;
+    if (mfeId.has_value()) {
+      auto it = _mfeLoadSketches.find(*mfeId);
+      if (it != _mfeLoadSketches.end()) {
+        stats.push_back(toMFELoadStats(it->first, it->second));
+      }
+      return stats;
+    }
+    stats.reserve(_mfeLoadSketches.size());
+    for (const auto& [id, sketch] : _mfeLoadSketches) {
+      stats.push_back(toMFELoadStats(id, sketch));
+    }
+    return stats;
+  }
+
+  void resetMFELoadStats(const std::optional<std::string>& mfeId) override {
+    auto lock = lockTimed(_mutex, kOpStorageLockWait);
+    hydrateMFERegistry();
+    mmkv::MMKV* storage = mfeStorage();
+    for (auto it = _mfeLoadSketches.begin(); it != _mfeLoadSketches.end();) {
+      if (mfeId.has_value() && it->first != *mfeId) {
+        ++it;
+        continue;
+      }
+      if (storage != nullptr) {
+        storage->removeValueForKey(kMFELoadKeyPrefix + it->first);
+      }
+      it = _mfeLoadSketches.erase(it);
+    }
+  }
+
+  void setMFETransitionHandler(
+      const std::function<void(const std::vector<MFETransition>& /* transitions */)>& handler) override {
+    std::lock_guard<std::mutex> lock(_dispatchMutex);
+    _mfeTransitionHandler = std::make_shared<MFETransitionHandler>(handler);
+    _mfeTransitionsWanted.store(static_cast<bool>(handler), std::memory_order_relaxed);
+  }
+
+  // =========================================================================
+  // Network Monitoring
+  // =========================================================================
+
+  ListenerResult startNetworkMonitoring() override {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (_networkMonitoringActive) {
+      return ListenerResult(true, std::nullopt);
     }
 
 #ifdef __APPLE__
@@ -705,6 +1464,7 @@ public:
       nw_path_monitor_set_update_handler(_networkPathMonitor, ^(nw_path_t path) {
         self->updateNetworkStateFromPath(path);
         // Also check internet quality when network changes
+        std::lock_guard<std::mutex> lock(self->_mutex);
         self->checkInternetQualityAsync();
       });
 
@@ -719,15 +1479,14 @@ public:
       uint64_t intervalNs = _useActivePing ? (10 * NSEC_PER_SEC) : (30 * NSEC_PER_SEC);
       dispatch_source_set_timer(_pingTimer, dispatch_time(DISPATCH_TIME_NOW, 0), intervalNs, 1 * NSEC_PER_SEC);
       dispatch_source_set_event_handler(_pingTimer, ^{
+        std::lock_guard<std::mutex> lock(self->_mutex);
         self->checkInternetQualityAsync();
       });
       dispatch_resume(_pingTimer);
 
       _networkMonitoringActive = true;
 
-      if (_debugMode) {
-        logDebug("Network monitoring started with internet quality checks");
-      }
+      SAM_LOG_DEBUG(_logger, LogCategory::NETWORK, "Network monitoring started with internet quality checks");
     }
 #else
     // Android implementation would go here
@@ -757,9 +1516,7 @@ public:
 
     _networkMonitoringActive = false;
 
-    if (_debugMode) {
-      logDebug("Network monitoring stopped");
-    }
+    SAM_LOG_DEBUG(_logger, LogCategory::NETWORK, "Network monitoring stopped");
 
     return ListenerResult(true, std::nullopt);
   }
@@ -782,6 +1539,7 @@ public:
       if (reachability != NULL) {
         SCNetworkReachabilityFlags flags;
         if (SCNetworkReachabilityGetFlags(reachability, &flags)) {
+          std::lock_guard<std::mutex> lock(_mutex);
           updateNetworkStateFromReachabilityFlags(flags);
         }
         CFRelease(reachability);
@@ -791,18 +1549,14 @@ public:
     // Android implementation would go here
 #endif
 
-    if (_debugMode) {
-      logDebug("Network state refreshed");
-    }
+    SAM_LOG_DEBUG(_logger, LogCategory::NETWORK, "Network state refreshed");
   }
 
   void setActivePingMode(bool enabled) override {
     std::lock_guard<std::mutex> lock(_mutex);
     _useActivePing = enabled;
 
-    if (_debugMode) {
-      logDebug("Active ping mode " + std::string(enabled ? "enabled" : "disabled"));
-    }
+    SAM_LOG_DEBUG(_logger, LogCategory::NETWORK, "Active ping mode ", enabled ? "enabled" : "disabled");
 
 #ifdef __APPLE__
     // Update timer interval based on mode
@@ -820,286 +1574,4060 @@ public:
     }
   }
 
-  void reportNetworkLatency(double latencyMs) override {
-    std::lock_guard<std::mutex> lock(_mutex);
-
-    // Ignore invalid values
-    if (latencyMs < 0) {
+  void reportNetworkLatency(double latencyMs) override {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // Ignore invalid values
+    if (latencyMs < 0) {
+      return;
+    }
+
+    // Update latency and quality
+    _lastPingLatencyMs = latencyMs;
+    _internetQuality = latencyToQuality(latencyMs);
+
+    // A successful network call means internet is reachable!
+    // This is crucial for passive mode to work correctly.
+    _internetReachable = true;
+    _isCheckingOfflineRecovery = false;  // No longer need to check for recovery
+
+    SAM_LOG_DEBUG(_logger, LogCategory::NETWORK, "Reported network latency: ", static_cast<int>(latencyMs),
+                  "ms, quality: ", _internetQuality, ", reachable: true");
+
+    // Update Warm storage with the new quality
+    updateInternetQualityWarmKeys();
+  }
+
+  void reportNetworkFailure() override {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // A network failure means internet may be unreachable
+    _internetReachable = false;
+    _internetQuality = "offline";
+    _lastPingLatencyMs = -1;
+    _isCheckingOfflineRecovery = true;  // Start checking for recovery
+
+    SAM_LOG_DEBUG(_logger, LogCategory::NETWORK, "Reported network failure - starting offline recovery checks");
+
+    // Update Warm storage
+    updateInternetQualityWarmKeys();
+  }
+
+  void setPingEndpoints(const std::vector<std::string>& endpoints) override {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // Empty array resets to defaults
+    if (endpoints.empty()) {
+      _customPingEndpoints.clear();
+      SAM_LOG_DEBUG(_logger, LogCategory::NETWORK, "Reset ping endpoints to defaults");
+    } else {
+      _customPingEndpoints = endpoints;
+      SAM_LOG_DEBUG(_logger, LogCategory::NETWORK, "Set ", endpoints.size(), " custom ping endpoints");
+    }
+
+    // Reset endpoint index to start fresh with new endpoints
+    _pingEndpointIndex = 0;
+  }
+
+private:
+  using ChangeEventHandler = std::function<void(const std::vector<ChangeEvent>&)>;
+  using MFETransitionHandler = std::function<void(const std::vector<MFETransition>&)>;
+
+  /**
+   * Lightweight view of a Warm value or Cold column used while matching.
+   * Strings point into the dispatch arena, a scratch buffer, or SQLite's
+   * column memory - never owned.
+   */
+  struct ValueView {
+    enum class Kind : uint8_t { Absent, Null, Bool, String, Number };
+    Kind kind = Kind::Absent;
+    bool boolValue = false;
+    double numberValue = 0;
+    std::string_view stringValue;
+  };
+
+  /**
+   * A change event waiting for delivery, bump-allocated in _dispatchArena.
+   * listenerId views the interned ID in _listeners, so IDs are never copied
+   * while matching; all other strings live in the arena.
+   */
+  struct PendingChangeEvent {
+    std::string_view listenerId;
+    ChangeSource source;
+    ChangeOperation operation;
+    std::string_view key;
+    std::string_view table;
+    bool hasRowId;
+    double rowId;
+    ValueView oldValue;
+    ValueView newValue;
+    bool hasRow;
+    std::string_view rowJson;
+    double timestamp;
+    std::string_view actionType;  // storage triggers only; views _listeners
+    uint32_t routeBegin;          // matched routes in _batchRouteIds
+    uint32_t routeCount;
+  };
+
+  /**
+   * Owned counterpart of ValueView, carried by a ChangeRecord across threads
+   */
+  struct StoredValue {
+    ValueView::Kind kind = ValueView::Kind::Absent;
+    bool boolValue = false;
+    double numberValue = 0;
+    std::string stringValue;
+
+    void assign(const ValueView& view) {
+      kind = view.kind;
+      boolValue = view.boolValue;
+      numberValue = view.numberValue;
+      stringValue.assign(view.stringValue.data(), view.stringValue.size());
+    }
+
+    ValueView view() const {
+      ValueView value;
+      value.kind = kind;
+      value.boolValue = boolValue;
+      value.numberValue = numberValue;
+      value.stringValue = stringValue;
+      return value;
+    }
+  };
+
+  /**
+   * A storage change captured on the writing thread and matched later by the
+   * dispatcher thread. Owns its strings, since the writer has long returned
+   * by the time the record is processed.
+   */
+  struct ChangeRecord {
+    // MFE transitions ride the same queue: scope is the MFE ID, oldValue
+    // the previous phase and newValue the encoded record (absent if cleared)
+    enum class Kind : uint8_t { Storage, MFETransition };
+    Kind kind = Kind::Storage;
+    ChangeSource source = ChangeSource::WARM;
+    ChangeOperation operation = ChangeOperation::SET;
+    std::string scope;        // Warm instance ID or Cold database name
+    std::string name;         // Warm key or Cold table
+    sqlite3_int64 rowId = 0;
+    StoredValue oldValue;
+    StoredValue newValue;
+    double timestamp = 0;
+    uint64_t enqueuedNs = 0;  // monotonic, for dispatch latency
+  };
+
+  /**
+   * Row change reported by sqlite3_update_hook, drained after each statement
+   */
+  struct ColdChange {
+    int operation;            // SQLITE_INSERT / SQLITE_UPDATE / SQLITE_DELETE
+    std::string table;
+    sqlite3_int64 rowId;
+  };
+
+  /**
+   * Serial lane for async Cold work on one database. Jobs on a lane never
+   * overlap, so the connection and change list need no lock.
+   */
+  struct ColdLane {
+    HybridSideFx* owner = nullptr;
+    std::string dbName;
+    std::string path;
+    ColdTuning tuning;
+    bool shared = false;                      // in-memory: use the main connection under _mutex
+    bool migrated = true;                     // false until the main connection has run migrations
+    sqlite3* db = nullptr;                    // lane connection, opened by the first job
+    std::vector<ColdChange> pendingChanges;   // rows touched by the current statement
+    std::atomic<size_t> memoryBytes{0};       // cache + schema + statements after the last job
+  };
+
+  /**
+   * Cancellation state shared by every async Cold request submitted under
+   * one token since it was last cancelled
+   */
+  struct ColdCancelState {
+    int64_t token = 0;
+    std::atomic<bool> cancelled{false};
+    size_t jobs = 0;                          // guarded by _coldCancelMutex
+  };
+
+  /**
+   * One queryColdAcross call. Part i is written only by its lane job; the
+   * job that settles last reads every part and merges them.
+   */
+  struct ColdAcrossQuery {
+    std::vector<std::string> databases;
+    std::vector<ColdColumns> parts;
+    std::string orderBy;
+    bool descending = false;
+    size_t limit = SIZE_MAX;
+    std::atomic<size_t> remaining{0};
+    std::atomic<bool> failed{false};
+    std::exception_ptr error;                 // first rejection, set by whoever first sets `failed`
+    std::shared_ptr<Promise<std::variant<nitro::NullType, std::string>>> promise;
+    uint64_t startedNs = 0;
+  };
+
+  /**
+   * Materialized events plus the handler to call once _dispatchMutex is released
+   */
+  struct ChangeDelivery {
+    std::shared_ptr<ChangeEventHandler> handler;
+    std::vector<ChangeEvent> events;
+    std::shared_ptr<MFETransitionHandler> transitionHandler;
+    std::vector<MFETransition> transitions;
+  };
+
+  struct DispatchStats {
+    uint64_t batches = 0;
+    uint64_t eventsBuilt = 0;
+    uint64_t bufferGrowths = 0;  // growth of the reusable scratch vectors
+  };
+
+  // Thread safety
+  // _mutex guards storage (Warm instances, SQLite handles, network state).
+  // _dispatchMutex guards listeners and dispatch state. When both are needed
+  // _dispatchMutex is taken first; writers holding _mutex never wait on it.
+  std::mutex _mutex;
+  std::mutex _dispatchMutex;
+
+  // Listener storage (slot map, hot fields split out for dispatch)
+  ListenerTable _listeners;
+
+  // Configuration
+  bool _debugMode;
+  size_t _maxListeners;
+
+  // Logging - formatted on the calling thread, written by the logger's thread
+  Logger _logger;
+
+  // Change dispatch - everything below is guarded by _dispatchMutex
+  std::shared_ptr<ChangeEventHandler> _changeEventHandler;
+  DispatchArena _dispatchArena;
+  std::vector<PendingChangeEvent*> _pendingEvents;      // capacity reused across batches
+  std::vector<uint32_t> _batchRouteIds;                 // routes claimed by the batch's trigger events
+  std::shared_ptr<MFETransitionHandler> _mfeTransitionHandler;
+  std::vector<MFETransition> _pendingTransitions;
+  std::vector<uint32_t> _coldCandidates;                // capacity reused across batches
+  std::unordered_map<std::string, std::regex> _regexCache;
+  JsonWriter _rowWriter;                                // Cold row payload serialization
+  std::string _rowSql;                                  // Cold row lookup statement text
+  DispatchStats _dispatchStats;
+
+  /**
+   * A change held back by a listener's debounce or throttle window, or a
+   * fireImmediately snapshot waiting for the dispatcher. Owns its strings,
+   * since it outlives the batch arena.
+   */
+  struct HeldEvent {
+    ListenerHandle handle;
+    ChangeSource source = ChangeSource::WARM;
+    ChangeOperation operation = ChangeOperation::SET;
+    std::string name;                                   // Warm key or Cold table
+    bool hasRowId = false;
+    int64_t rowId = 0;
+    StoredValue oldValue;
+    StoredValue newValue;
+    bool hasRow = false;
+    std::string rowJson;
+    double timestamp = 0;
+    double due = 0;                                     // wall ms when it may be delivered
+  };
+  std::unordered_map<uint32_t, HeldEvent> _heldChanges; // latest held change per listener slot
+  std::vector<HeldEvent> _immediateEvents;              // fireImmediately snapshots
+  std::atomic<double> _heldDue{HUGE_VAL};               // earliest due held event, read unlocked
+
+  // Change capture - guarded by _mutex (writer side)
+  std::vector<ColdChange> _pendingColdChanges;          // rows touched by the current statement
+  // Cold row lookups prepared once per (database, table), reset after each use
+  std::unordered_map<std::string, std::unordered_map<std::string, sqlite3_stmt*>> _rowStmts;
+  std::string _scratchValue;                            // previous Warm value being read
+
+  // Dispatcher thread - writers enqueue ChangeRecords and return immediately
+  static constexpr size_t kMaxDispatchBatch = 256;      // records matched per delivery
+  MpscQueue<ChangeRecord> _changeQueue;
+  std::thread _dispatcher;
+  std::once_flag _dispatcherStarted;
+  std::atomic<bool> _dispatcherStop{false};
+  std::atomic<bool> _dispatcherParked{false};
+  std::mutex _parkMutex;
+  std::condition_variable _parkCv;
+  std::condition_variable _idleCv;
+  std::atomic<uint64_t> _changesEnqueued{0};
+  std::atomic<uint64_t> _changesDispatched{0};
+
+  // Listener counts mirrored for writers, which must not take _dispatchMutex
+  std::atomic<size_t> _warmListenerCount{0};
+  std::atomic<size_t> _coldListenerCount{0};
+
+  // Metrics - always on, lock-free; reported in this order by getMetrics()
+  enum Operation : size_t {
+    kOpSetWarm,
+    kOpGetWarm,
+    kOpDeleteWarm,
+    kOpGetWarmBuffer,
+    kOpExecuteCold,
+    kOpQueryCold,
+    kOpQueryColdBuffer,
+    kOpExecuteColdScript,
+    kOpSearchCold,
+    kOpExecuteColdAsync,   // submit to settle, queueing included
+    kOpQueryColdAsync,
+    kOpQueryColdAcross,    // submit to merged result, whole fan-out
+    kOpQueryColdAcrossPart,  // one database of a fan-out
+    kOpAddListener,
+    kOpRemoveListener,
+    kOpGetCachedSecure,
+    kOpSetMFERecord,
+    kOpGetAllMFEStates,
+    kOpDispatchBatch,      // lock + match + deliver for one batch
+    kOpDispatchLatency,    // enqueue to handler return, per change
+    kOpStorageLockWait,    // waiting for _mutex
+    kOpListenerLockWait,   // waiting for _dispatchMutex
+    kOpColdCheckpoint,     // one background WAL checkpoint
+    kOpWarmExpiry,         // one background pass deleting expired Warm keys
+    kOperationCount
+  };
+  static constexpr const char* kOperationNames[kOperationCount] = {
+      "setWarm", "getWarm", "deleteWarm", "getWarmBuffer",
+      "executeCold", "queryCold", "queryColdBuffer", "executeColdScript", "searchCold",
+      "executeColdAsync", "queryColdAsync", "queryColdAcross", "queryColdAcross.db",
+      "addListener", "removeListener",
+      "getCachedSecureValue",
+      "setMFERecord", "getAllMFEStates",
+      "dispatch.batch", "dispatch.latency",
+      "lock.storage", "lock.listeners",
+      "cold.checkpoint", "warm.expiry",
+  };
+  std::array<OperationStats, kOperationCount> _operationStats;
+  std::atomic<uint64_t> _eventsDelivered{0};
+  std::atomic<uint64_t> _metricsIntervalStart{monotonicNanos()};
+  std::vector<uint64_t> _batchEnqueuedNs;               // dispatcher thread only
+
+  /**
+   * A multi-process instance's values as last seen by this process, diffed
+   * against the file when another process writes. Values up to kInlineBytes
+   * are kept whole, so a change reports them as oldValue; longer strings
+   * only by length and hash, so the snapshot costs about its keys rather
+   * than a second copy of the file. A change to one reports no oldValue.
+   */
+  struct WarmSnapshot {
+    struct Entry {
+      StoredValue value;                      // a long string's text is not kept
+      size_t length = 0;                      // strings only
+      size_t hash = 0;                        // long strings only
+      uint64_t pass = 0;                      // last diff that found the key
+    };
+    using Entries = std::unordered_map<std::string, Entry>;
+    static constexpr size_t kInlineBytes = 64;
+    static constexpr size_t kNodeOverheadBytes = 32;  // hash node and bucket, approximate
+
+    Entries entries;
+    size_t bytes = 0;                         // approximate, for measureMemory
+    uint64_t pass = 0;
+
+    Entry& set(const std::string& key, const ValueView& value) {
+      auto [it, inserted] = entries.try_emplace(key);
+      Entry& entry = it->second;
+      if (!inserted) {
+        bytes -= entryBytes(key, entry);
+      }
+      bool whole = value.kind != ValueView::Kind::String || value.stringValue.size() <= kInlineBytes;
+      if (whole) {
+        entry.value.assign(value);
+        entry.hash = 0;
+      } else {
+        entry.value.kind = value.kind;
+        entry.value.stringValue.clear();
+        entry.value.stringValue.shrink_to_fit();
+        entry.hash = std::hash<std::string_view>{}(value.stringValue);
+      }
+      entry.length = value.stringValue.size();
+      bytes += entryBytes(key, entry);
+      return entry;
+    }
+
+    void erase(const std::string& key) {
+      auto it = entries.find(key);
+      if (it != entries.end()) {
+        erase(it);
+      }
+    }
+
+    Entries::iterator erase(Entries::iterator it) {
+      bytes -= entryBytes(it->first, it->second);
+      return entries.erase(it);
+    }
+
+    static bool matches(const Entry& entry, const ValueView& value) {
+      if (value.kind != ValueView::Kind::String || entry.value.kind != ValueView::Kind::String) {
+        return sameValue(entry.value.view(), value);
+      }
+      if (entry.length != value.stringValue.size()) {
+        return false;
+      }
+      return entry.length <= kInlineBytes ? entry.value.stringValue == value.stringValue
+                                          : entry.hash == std::hash<std::string_view>{}(value.stringValue);
+    }
+
+    /** The value a change reports as old; absent for a long string */
+    static ValueView oldValue(const Entry& entry) {
+      if (entry.value.kind == ValueView::Kind::String && entry.length > kInlineBytes) {
+        return ValueView();
+      }
+      return entry.value.view();
+    }
+
+  private:
+    static size_t entryBytes(const std::string& key, const Entry& entry) {
+      return key.capacity() + sizeof(Entry) + entry.value.stringValue.capacity() + kNodeOverheadBytes;
+    }
+  };
+
+  /**
+   * An initialized Warm instance. The governor evicts idle instances with
+   * clearMemoryCache(), which unmaps the file but keeps the MMKV object, so
+   * `storage` stays valid and MMKV maps the file again on next use.
+   */
+  struct WarmInstance {
+    mmkv::MMKV* storage = nullptr;
+    uint64_t lastUsed = 0;                    // _warmUseClock at the last access
+    size_t mappedBytes = 0;                   // file size when last measured
+    bool resident = true;
+    bool encrypted = false;                   // remapping decrypts the whole file again
+    std::unique_ptr<WarmSnapshot> snapshot;   // multi-process instances only
+  };
+
+  // Initialized storage instances - guarded by _mutex
+  std::map<std::string, WarmInstance> _warmInstances;
+  uint64_t _warmUseClock = 0;
+  static constexpr size_t kWarmKeyMaxBytes = 16;  // MMKV's AES-128 key length
+  bool _multiProcessWarm = false;                 // any instance has a snapshot
+  std::map<std::string, std::string> _coldDatabasePaths;
+  std::map<std::string, ColdTuning> _coldTunings;
+  std::map<std::string, std::vector<std::string>> _coldMigrations;  // ColdConfig.migrations, run at open
+  static constexpr const char* kSearchSuffix = "_fts";  // declareColdSearch indexes T in FTS5 table T_fts
+
+  // Cold storage database handles; nullptr until first use for a database
+  // declared with lazy Cold
+  std::map<std::string, sqlite3*> _sqliteDatabases;
+
+  // Startup pipeline - guarded by _mutex
+  static constexpr const char* kWarmStartupLane = "warm.startup:";  // worker lanes, + instance ID per open
+  const uint64_t _createdNs = monotonicNanos();
+  bool _lazyCold = false;
+  std::vector<StartupStage> _startupStages;
+
+  // Async Cold storage - a serial lane per database, each with its own
+  // connection so long queries never hold _mutex
+  static constexpr int kColdProgressInterval = 1000;    // VM steps between cancel checks
+  SerialWorkerPool _coldWorkers{defaultColdWorkerCount()};
+  std::unordered_map<std::string, std::unique_ptr<ColdLane>> _coldLanes;  // guarded by _mutex
+  std::mutex _coldCancelMutex;
+  std::unordered_map<int64_t, std::shared_ptr<ColdCancelState>> _coldCancelTokens;
+
+  // Missile action routing - its own lock, taken last (under _dispatchMutex
+  // when storage triggers claim routes)
+  std::mutex _routerMutex;
+  ActionRouter _actionRouter;
+  std::vector<uint32_t> _routeMatches;                  // capacity reused across matches
+
+  // Warm compaction - runs on the maintenance thread once Warm writes pause
+  struct WarmCompactionPolicy {
+    bool enabled = true;
+    std::chrono::milliseconds idle{5000};             // also the check interval
+    size_t minFileBytes = 64 * 1024;
+    double maxAmplification = 2.0;                    // log bytes per live byte
+  };
+  struct WarmCompactionState {
+    uint64_t liveMeasuredAt = UINT64_MAX;             // _warmWrites when liveBytes was measured
+    size_t liveBytes = 0;
+    double compactions = 0;
+    double lastDurationMs = 0;
+    double lastCompactedAt = 0;
+    double bytesReclaimed = 0;
+  };
+  static constexpr const char* kCompactionTask = "warm.compaction";
+  std::atomic<uint64_t> _warmWrites{0};                 // every Warm write and delete
+  std::mutex _compactionMutex;                          // guards the three below
+  WarmCompactionPolicy _compactionPolicy;
+  std::set<std::string> _compactionRequests;            // from compactWarm; "" = every instance
+  std::unordered_map<std::string, WarmCompactionState> _compactionStates;
+  uint64_t _compactionWritesSeen = 0;                   // maintenance thread only
+
+  // Cold checkpoints - WAL checkpoints on the maintenance thread, through a
+  // connection of its own, instead of inline on whichever commit crosses
+  // wal_autocheckpoint
+  struct ColdCheckpointPolicy {
+    bool enabled = true;
+    std::chrono::milliseconds interval{2000};         // a database is idle if no commit landed in one interval
+    uint64_t truncateWalBytes = 4 * 1024 * 1024;      // idle passes reset a WAL this large to zero bytes
+    uint64_t maxWalBytes = 16 * 1024 * 1024;          // checkpoint even while writes continue
+  };
+  struct ColdCheckpointState {
+    double checkpoints = 0;
+    double truncateCheckpoints = 0;
+    double incompleteCheckpoints = 0;
+    double lastDurationMs = 0;
+    double maxDurationMs = 0;
+    double lastCheckpointAt = 0;
+  };
+  struct ColdCheckpointCursor {
+    sqlite3* db = nullptr;                            // checkpoint connection
+    int64_t seenVersion = -1;                         // PRAGMA data_version at the last pass
+    int64_t checkpointedVersion = -1;                 // data_version the WAL was last fully copied at
+    bool incomplete = false;                          // last checkpoint left frames behind
+    bool truncateBlocked = false;                     // a TRUNCATE timed out; PASSIVE until one completes
+  };
+  static constexpr const char* kCheckpointTask = "cold.checkpoint";
+  static constexpr int kCheckpointBusyTimeoutMs = 250;  // TRUNCATE waits this long for readers and writers
+  static constexpr int kDefaultWalAutocheckpointPages = 1000;  // SQLite's own default
+  std::atomic<bool> _checkpointsEnabled{true};          // mirrors _checkpointPolicy.enabled
+  std::mutex _checkpointMutex;                          // guards the three below
+  ColdCheckpointPolicy _checkpointPolicy;
+  std::set<std::string> _checkpointRequests;            // from checkpointCold; "" = every database
+  std::unordered_map<std::string, ColdCheckpointState> _checkpointStates;
+  std::unordered_map<std::string, ColdCheckpointCursor> _checkpointCursors;  // maintenance thread only
+
+  // Memory governor - enforces SAMConfig.cacheSize on the maintenance thread,
+  // which is the only place Warm instances are evicted
+  static constexpr const char* kGovernorTask = "memory.governor";
+  static constexpr std::chrono::milliseconds kGovernorInterval{10000};
+  static constexpr size_t kRegexEstimateBytes = 2048;   // std::regex does not report its size
+  std::atomic<size_t> _memoryBudget{0};                 // bytes; 0 = unlimited
+  std::mutex _governorMutex;                            // guards the three below
+  std::optional<MemoryPressureLevel> _pendingPressure;
+  MemoryPressureLevel _lastPressure = MemoryPressureLevel::NORMAL;
+  double _warmEvictions = 0;
+  uint64_t _governorUseMark = 0;                        // maintenance thread only
+#ifdef __APPLE__
+  dispatch_source_t _memoryPressureSource = nullptr;
+#endif
+
+  // Secure value cache - keychain values for SecureStorage. Entries are
+  // purged by a maintenance task due at the earliest expiry, so a value
+  // leaves memory at its TTL even if it is never read again.
+  static constexpr const char* kSecureExpiryTask = "secure.expiry";
+  std::mutex _secureMutex;                              // leaf; guards _secureCache
+  SecureValueCache _secureCache;
+
+  // Multi-process Warm - MMKV reports another process's writes to a single
+  // process-wide handler, which forwards the instance ID to every
+  // HybridSideFx. A maintenance pass diffs the instance against its snapshot.
+  static constexpr const char* kWarmProcessTask = "warm.process";
+  static constexpr std::chrono::milliseconds kWarmProcessInterval{1000};
+  std::mutex _outerWarmMutex;                           // leaf; guards _outerWarmChanges
+  std::set<std::string> _outerWarmChanges;              // instance IDs written by another process
+
+  // Warm expiry - deadlines of keys written with a TTL, guarded by _mutex.
+  // They are also stored in a Warm instance of their own, so a TTL outlives
+  // the process: single-process instances' deadlines in one opened
+  // single-process, multi-process instances' in one opened multi-process,
+  // which every process sharing them reads and writes. A due key is deleted
+  // when it is next accessed, or by a maintenance task due at the earliest
+  // deadline.
+  static constexpr const char* kWarmExpiryTask = "warm.expiry";
+  static constexpr const char* kWarmExpiryInstanceId = "sam-warm-expiry";
+  static constexpr const char* kWarmExpirySharedInstanceId = "sam-warm-expiry.shared";
+  static constexpr char kWarmExpirySeparator = '\x1f';  // stored key: instance ID, separator, key
+  static constexpr size_t kWarmExpiryBatch = 256;       // keys deleted per pass, so _mutex is released between
+  WarmExpiryIndex _warmExpiry;
+  mmkv::MMKV* _warmExpiryStorage = nullptr;             // opened on first use
+  mmkv::MMKV* _warmExpirySharedStorage = nullptr;       // opened with the first multi-process instance
+  double _warmExpiryDue = HUGE_VAL;                     // deadline the task is scheduled for
+
+  MaintenanceScheduler _maintenance;
+
+  // MFE registry - guarded by _mutex. Records live in memory and are written
+  // through to the registry's Warm instance once JS has initialized it.
+  static constexpr const char* kMFEInstanceId = "sam-mfe-registry";
+  static constexpr const char* kMFEKeyPrefix = "mfe#";
+  static constexpr const char* kMFELoadKeyPrefix = "mfeload#";
+  std::unordered_map<std::string, MFERecord> _mfeRecords;
+  std::unordered_map<std::string, LoadTimeSketch> _mfeLoadSketches;
+  bool _mfeHydrated = false;
+  std::string _mfeScratch;                              // encoded record being written
+  std::atomic<bool> _mfeTransitionsWanted{false};
+
+  // Warm storage global initialization state
+  bool _warmGlobalInitialized = false;
+  bool _maintenanceScheduled = false;
+  std::string _warmRootPath;  // Empty string means use MMKV's default path
+
+  // Network monitoring state
+  bool _networkMonitoringActive = false;
+  NetworkState _currentNetworkState = NetworkState(
+      NetworkStatus::UNKNOWN,
+      ConnectionType::UNKNOWN,
+      false,   // isConnected
+      -1,      // isInternetReachable (-1 = unknown)
+      CellularGeneration::UNKNOWN,
+      -1,      // wifiStrength (-1 = unavailable)
+      false,   // isConnectionExpensive
+      0        // timestamp
+  );
+
+  // Internet quality tracking
+  double _lastPingLatencyMs = -1;  // -1 = unknown, >= 0 = latency in ms
+  std::string _internetQuality = "unknown";  // "excellent", "good", "fair", "poor", "offline", "unknown"
+  bool _internetReachable = false;  // True if internet is actually reachable (single source of truth)
+  bool _useActivePing = false;  // If true, use active HTTP pings. If false, rely on passive observation.
+  int _pingEndpointIndex = 0;  // Current endpoint index for round-robin
+  bool _isCheckingOfflineRecovery = false;  // If true, we're in offline state doing recovery checks
+  std::vector<std::string> _customPingEndpoints;  // User-defined endpoints (empty = use defaults)
+
+#ifdef __APPLE__
+  nw_path_monitor_t _networkPathMonitor = nullptr;
+  dispatch_queue_t _networkQueue = nullptr;
+  dispatch_source_t _pingTimer = nullptr;
+#endif
+
+  // =========================================================================
+  // Helper Methods
+  // =========================================================================
+
+  /**
+   * Get a Warm storage (MMKV) instance by ID
+   * Handles cross-platform differences in the MMKV API. MMKV caches the
+   * instance, decrypted, under its ID: `cryptKey` and the mode only apply to
+   * the first open in the process.
+   */
+  mmkv::MMKV* getWarmInstance(const std::string& id, std::string* cryptKey = nullptr, bool multiProcess = false) {
+    mmkv::MMKVMode mode = multiProcess ? mmkv::MMKV_MULTI_PROCESS : mmkv::MMKV_SINGLE_PROCESS;
+#ifdef __ANDROID__
+    // Android version has an additional size parameter
+    return mmkv::MMKV::mmkvWithID(id, mmkv::DEFAULT_MMAP_SIZE, mode, cryptKey);
+#else
+    // iOS/macOS version
+    return mmkv::MMKV::mmkvWithID(id, mode, cryptKey);
+#endif
+  }
+
+  /**
+   * Track a newly initialized Warm instance. Caller must hold _mutex.
+   */
+  mmkv::MMKV* registerWarmInstance(const std::string& id) {
+    return registerWarmInstance(id, getWarmInstance(id));
+  }
+
+  mmkv::MMKV* registerWarmInstance(const std::string& id, mmkv::MMKV* storage) {
+    if (storage == nullptr) {
+      return nullptr;
+    }
+    WarmInstance& instance = _warmInstances[id];
+    bool firstRegistration = instance.storage == nullptr;
+    instance.storage = storage;
+    instance.encrypted = !storage->cryptKey().empty();
+    if (storage->isMultiProcess() && instance.snapshot == nullptr) {
+      instance.snapshot = std::make_unique<WarmSnapshot>();
+      for (const std::string& key : storage->allKeys()) {
+        instance.snapshot->set(key, readWarmValue(storage, key, _scratchValue));
+      }
+      watchOuterWarmChanges();
+    }
+    instance.lastUsed = ++_warmUseClock;
+    instance.mappedBytes = storage->totalSize();
+    if (firstRegistration) {
+      loadWarmExpiries(id, instance);
+    }
+    scheduleMaintenance();
+    if (_memoryBudget.load(std::memory_order_relaxed) > 0) {
+      _maintenance.runSoon(kGovernorTask);
+    }
+    return storage;
+  }
+
+  /**
+   * Mark an instance as used and return its storage. An evicted instance
+   * becomes resident again (MMKV maps it back in). Caller must hold _mutex.
+   */
+  mmkv::MMKV* useWarmInstance(WarmInstance& instance) {
+    instance.lastUsed = ++_warmUseClock;
+    if (!instance.resident) {
+      instance.resident = true;
+      if (_memoryBudget.load(std::memory_order_relaxed) > 0) {
+        _maintenance.runSoon(kGovernorTask);
+      }
+    }
+    return instance.storage;
+  }
+
+  /**
+   * IDs and storage of the Warm instances currently mapped in. Background
+   * work skips evicted ones rather than mapping them back.
+   */
+  std::vector<std::pair<std::string, mmkv::MMKV*>> residentWarmInstances() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::vector<std::pair<std::string, mmkv::MMKV*>> resident;
+    for (const auto& [id, instance] : _warmInstances) {
+      if (instance.resident) {
+        resident.emplace_back(id, instance.storage);
+      }
+    }
+    return resident;
+  }
+
+  // -------------------------------------------------------------------------
+  // Warm expiry
+  // -------------------------------------------------------------------------
+
+  /**
+   * The instance holding the TTL deadlines of `instance`'s keys, opened in
+   * the same mode, so processes sharing an instance share its deadlines.
+   * Caller must hold _mutex.
+   */
+  mmkv::MMKV* warmExpiryStorage(const WarmInstance& instance) {
+    if (instance.snapshot == nullptr) {
+      if (_warmExpiryStorage == nullptr) {
+        _warmExpiryStorage = getWarmInstance(kWarmExpiryInstanceId);
+      }
+      return _warmExpiryStorage;
+    }
+    if (_warmExpirySharedStorage == nullptr) {
+      _warmExpirySharedStorage = getWarmInstance(kWarmExpirySharedInstanceId, nullptr, true);
+    }
+    return _warmExpirySharedStorage;
+  }
+
+  static std::string warmExpiryKey(const std::string& instanceId, const std::string& key) {
+    std::string stored;
+    stored.reserve(instanceId.size() + 1 + key.size());
+    stored.append(instanceId);
+    stored.push_back(kWarmExpirySeparator);
+    stored.append(key);
+    return stored;
+  }
+
+  /**
+   * Give `key` a deadline (Unix epoch ms), replacing any earlier one.
+   * Caller must hold _mutex.
+   */
+  void setWarmExpiry(const std::string& id, const WarmInstance& instance, const std::string& key, double deadlineMs) {
+    _warmExpiry.set(id, key, deadlineMs);
+    if (mmkv::MMKV* storage = warmExpiryStorage(instance)) {
+      storage->set(deadlineMs, warmExpiryKey(id, key));
+    }
+    if (deadlineMs < _warmExpiryDue) {
+      scheduleWarmExpiry();
+    }
+  }
+
+  /**
+   * Make `key` persistent again. The task is left scheduled; a pass that
+   * finds nothing due reschedules itself. A shared instance's stored
+   * deadline is always removed: another process may have set one that this
+   * process hasn't loaded. Caller must hold _mutex.
+   */
+  void clearWarmExpiry(const std::string& id, const WarmInstance& instance, const std::string& key) {
+    if (_warmExpiry.clear(id, key) || instance.snapshot != nullptr) {
+      if (mmkv::MMKV* storage = warmExpiryStorage(instance)) {
+        storage->removeValueForKey(warmExpiryKey(id, key));
+      }
+    }
+  }
+
+  /**
+   * Read back the stored deadlines of a newly registered instance's keys,
+   * or reload a shared instance's after another process changed them. Keys
+   * that expired while the app wasn't running go in the next pass.
+   * Caller must hold _mutex.
+   */
+  void loadWarmExpiries(const std::string& id, const WarmInstance& instance) {
+    mmkv::MMKV* storage = warmExpiryStorage(instance);
+    if (storage == nullptr) {
+      return;
+    }
+    std::string prefix = warmExpiryKey(id, "");
+    std::unordered_map<std::string, double> deadlines;
+    for (const std::string& stored : storage->allKeys()) {
+      if (stored.compare(0, prefix.size(), prefix) == 0) {
+        deadlines[stored.substr(prefix.size())] = storage->getDouble(stored);
+      }
+    }
+    if (deadlines.empty() && _warmExpiry.empty()) {
+      return;
+    }
+    SAM_LOG_DEBUG(_logger, LogCategory::WARM, "Loaded ", deadlines.size(), " TTLs for Warm instance '", id, "'");
+    _warmExpiry.replace(id, deadlines);
+    scheduleWarmExpiry();
+  }
+
+  /**
+   * Whether a key whose indexed deadline has passed is really due. A shared
+   * instance's deadline may have been moved or cleared by another process
+   * since it was loaded, so the stored one decides, and the index takes it.
+   * Caller must hold _mutex.
+   */
+  bool confirmWarmExpiry(const std::string& id, const WarmInstance& instance, const std::string& key, double now) {
+    if (instance.snapshot == nullptr) {
+      return true;
+    }
+    mmkv::MMKV* storage = warmExpiryStorage(instance);
+    if (storage == nullptr) {
+      return true;
+    }
+    bool hasValue = false;
+    double stored = storage->getDouble(warmExpiryKey(id, key), 0.0, &hasValue);
+    if (!hasValue) {
+      _warmExpiry.clear(id, key);
+      return false;
+    }
+    if (stored > now) {
+      _warmExpiry.set(id, key, stored);
+      return false;
+    }
+    return true;
+  }
+
+  /**
+   * Delete `key` now if its TTL has run out; returns true if it did.
+   * Caller must hold _mutex.
+   */
+  bool expireWarmKeyIfDue(const std::string& id, WarmInstance& instance, const std::string& key) {
+    if (_warmExpiry.empty()) {
+      return false;
+    }
+    std::optional<double> deadline = _warmExpiry.deadline(id, key);
+    double now = getCurrentTimestamp();
+    if (!deadline.has_value() || deadline.value() > now || !confirmWarmExpiry(id, instance, key, now)) {
+      return false;
+    }
+    clearWarmExpiry(id, instance, key);
+    removeExpiredWarmKey(id, instance, key);
+    return true;
+  }
+
+  /**
+   * Delete a key whose deadline has already left the index. Its DELETE
+   * change has no old value, so an expired value never reaches a
+   * listener. Deleting a key another process already expired is a no-op.
+   * Caller must hold _mutex.
+   */
+  void removeExpiredWarmKey(const std::string& id, WarmInstance& instance, const std::string& key) {
+    if (!instance.storage->containsKey(key)) {
+      return;
+    }
+    instance.storage->removeValueForKey(key);
+    _warmWrites.fetch_add(1, std::memory_order_relaxed);
+    if (instance.snapshot != nullptr) {
+      instance.snapshot->erase(key);
+    }
+    if (_warmListenerCount.load(std::memory_order_relaxed) > 0) {
+      ValueView deleted;
+      deleted.kind = ValueView::Kind::Null;
+      enqueueWarmChange(id, key, ChangeOperation::DELETE, ValueView(), deleted);
+    }
+  }
+
+  /**
+   * Schedule the expiry pass for the earliest deadline, or drop the task
+   * when no key has one. Caller must hold _mutex.
+   */
+  void scheduleWarmExpiry() {
+    std::optional<double> next = _warmExpiry.nextDeadline();
+    if (!next.has_value()) {
+      _warmExpiryDue = HUGE_VAL;
+      _maintenance.remove(kWarmExpiryTask);
+      return;
+    }
+    _warmExpiryDue = next.value();
+    auto wait = std::chrono::milliseconds(static_cast<int64_t>(std::ceil(next.value() - getCurrentTimestamp())));
+    _maintenance.add(kWarmExpiryTask, std::max(wait, std::chrono::milliseconds(1)), [this]() { runWarmExpiry(); });
+  }
+
+  /**
+   * Maintenance pass: delete up to kWarmExpiryBatch due keys, earliest
+   * first, then schedule the next pass - right away if more are due.
+   * Every process sharing an instance sweeps it; each delete is confirmed
+   * against the shared deadline first, so the slower process finds the key
+   * already gone or its TTL renewed.
+   */
+  void runWarmExpiry() {
+    OperationTimer timer(_operationStats[kOpWarmExpiry]);
+    std::lock_guard<std::mutex> lock(_mutex);
+    double now = getCurrentTimestamp();
+    std::vector<WarmExpiryIndex::Expired> expired;
+    _warmExpiry.popExpired(now, kWarmExpiryBatch, expired);
+    size_t removed = 0;
+    for (const auto& entry : expired) {
+      auto instance = _warmInstances.find(entry.instanceId);
+      if (instance == _warmInstances.end()) {
+        continue;
+      }
+      if (!confirmWarmExpiry(entry.instanceId, instance->second, entry.key, now)) {
+        continue;
+      }
+      if (mmkv::MMKV* storage = warmExpiryStorage(instance->second)) {
+        storage->removeValueForKey(warmExpiryKey(entry.instanceId, entry.key));
+      }
+      useWarmInstance(instance->second);
+      removeExpiredWarmKey(entry.instanceId, instance->second, entry.key);
+      removed++;
+    }
+    scheduleWarmExpiry();
+    if (removed > 0) {
+      SAM_LOG_DEBUG(_logger, LogCategory::WARM, "Expired ", removed, " Warm keys");
+    }
+  }
+
+  // -------------------------------------------------------------------------
+  // Warm compaction
+  // -------------------------------------------------------------------------
+
+  /**
+   * Register the compaction pass, the Cold checkpoint pass and the memory
+   * governor with the maintenance thread (once). Caller must hold _mutex.
+   */
+  void scheduleMaintenance() {
+    if (_maintenanceScheduled) {
+      return;
+    }
+    _maintenanceScheduled = true;
+    std::chrono::milliseconds idle;
+    {
+      std::lock_guard<std::mutex> lock(_compactionMutex);
+      idle = _compactionPolicy.idle;
+    }
+    std::chrono::milliseconds checkpointInterval;
+    {
+      std::lock_guard<std::mutex> lock(_checkpointMutex);
+      checkpointInterval = _checkpointPolicy.interval;
+    }
+    _maintenance.add(kCompactionTask, idle, [this]() { runWarmCompaction(); });
+    _maintenance.add(kCheckpointTask, checkpointInterval, [this]() { runColdCheckpoints(); });
+    _maintenance.add(kGovernorTask, kGovernorInterval, [this]() { runMemoryGovernor(); });
+    startMemoryPressureSource();
+  }
+
+  /**
+   * Schedule the secure cache purge for the earliest expiry, or drop the
+   * task when the cache is empty. Caller must hold _secureMutex.
+   */
+  void scheduleSecureExpiry() {
+    auto next = _secureCache.nextExpiry();
+    if (!next.has_value()) {
+      _maintenance.remove(kSecureExpiryTask);
+      return;
+    }
+    auto wait = std::chrono::ceil<std::chrono::milliseconds>(*next - SecureValueCache::Clock::now());
+    _maintenance.add(kSecureExpiryTask, std::max(wait, std::chrono::milliseconds(1)), [this]() {
+      std::lock_guard<std::mutex> lock(_secureMutex);
+      _secureCache.purgeExpired(SecureValueCache::Clock::now());
+      scheduleSecureExpiry();
+    });
+  }
+
+  /**
+   * Start watching for other processes' writes: register with the
+   * process-wide MMKV handler and schedule the check. MMKV has a single
+   * handler slot, so the first owner registers and the last one to be
+   * destroyed unregisters. Caller must hold _mutex.
+   */
+  void watchOuterWarmChanges() {
+    if (_multiProcessWarm) {
+      return;
+    }
+    _multiProcessWarm = true;
+    {
+      std::lock_guard<std::mutex> lock(outerWarmOwnersMutex());
+      auto& owners = outerWarmOwners();
+      if (owners.empty()) {
+        mmkv::MMKV::registerContentChangeHandler(onOuterWarmChange);
+      }
+      owners.push_back(this);
+    }
+    _maintenance.add(kWarmProcessTask, kWarmProcessInterval, [this]() { runOuterWarmCheck(); });
+  }
+
+  static std::mutex& outerWarmOwnersMutex() {
+    static std::mutex mutex;
+    return mutex;
+  }
+
+  static std::vector<HybridSideFx*>& outerWarmOwners() {
+    static std::vector<HybridSideFx*> owners;
+    return owners;
+  }
+
+  /**
+   * MMKV content change handler. Runs on whichever thread touched the
+   * instance, inside MMKV's own lock, so it only records the ID.
+   */
+  static void onOuterWarmChange(const std::string& mmapID) {
+    std::lock_guard<std::mutex> lock(outerWarmOwnersMutex());
+    for (HybridSideFx* owner : outerWarmOwners()) {
+      {
+        std::lock_guard<std::mutex> changesLock(owner->_outerWarmMutex);
+        owner->_outerWarmChanges.insert(mmapID);
+      }
+      owner->_maintenance.runSoon(kWarmProcessTask);
+    }
+  }
+
+  /**
+   * Maintenance pass for multi-process instances. MMKV notices another
+   * process's writes when an instance is accessed; checkContentChanged()
+   * makes it look now, for resident instances. Each instance reported since
+   * the last pass is diffed against its snapshot, or every instance when
+   * `everyInstance` is set. When the shared TTL store changed, every shared
+   * instance's deadlines are reloaded from it.
+   */
+  void runOuterWarmCheck(bool everyInstance = false) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (auto& [id, instance] : _warmInstances) {
+      if (instance.snapshot != nullptr && instance.resident) {
+        instance.storage->checkContentChanged();
+      }
+    }
+    if (_warmExpirySharedStorage != nullptr) {
+      _warmExpirySharedStorage->checkContentChanged();
+    }
+    std::set<std::string> changed;
+    {
+      std::lock_guard<std::mutex> changesLock(_outerWarmMutex);
+      changed.swap(_outerWarmChanges);
+    }
+    if (everyInstance) {
+      for (const auto& [id, instance] : _warmInstances) {
+        if (instance.snapshot != nullptr) {
+          changed.insert(id);
+        }
+      }
+      changed.insert(kWarmExpirySharedInstanceId);
+    }
+    for (const std::string& id : changed) {
+      auto instance = _warmInstances.find(id);
+      if (instance != _warmInstances.end() && instance->second.snapshot != nullptr) {
+        diffWarmSnapshot(id, instance->second);
+      }
+    }
+    if (changed.count(kWarmExpirySharedInstanceId) > 0) {
+      for (const auto& [id, instance] : _warmInstances) {
+        if (instance.snapshot != nullptr) {
+          loadWarmExpiries(id, instance);
+        }
+      }
+    }
+  }
+
+  /**
+   * Queue a change for every key another process set or deleted since the
+   * snapshot, updating the snapshot in place. Caller must hold _mutex.
+   */
+  void diffWarmSnapshot(const std::string& id, WarmInstance& instance) {
+    bool observed = _warmListenerCount.load(std::memory_order_relaxed) > 0;
+    WarmSnapshot& snapshot = *instance.snapshot;
+    uint64_t pass = ++snapshot.pass;
+    size_t changes = 0;
+    for (const std::string& key : instance.storage->allKeys()) {
+      ValueView value = readWarmValue(instance.storage, key, _scratchValue);
+      auto previous = snapshot.entries.find(key);
+      if (previous != snapshot.entries.end() && WarmSnapshot::matches(previous->second, value)) {
+        previous->second.pass = pass;
+        continue;
+      }
+      if (observed) {
+        ValueView oldValue = previous != snapshot.entries.end() ? WarmSnapshot::oldValue(previous->second) : ValueView();
+        enqueueWarmChange(id, key, ChangeOperation::SET, oldValue, value);
+      }
+      snapshot.set(key, value).pass = pass;
+      changes++;
+    }
+    for (auto it = snapshot.entries.begin(); it != snapshot.entries.end();) {
+      if (it->second.pass == pass) {
+        ++it;
+        continue;
+      }
+      if (observed) {
+        ValueView deleted;
+        deleted.kind = ValueView::Kind::Null;
+        enqueueWarmChange(id, it->first, ChangeOperation::DELETE, WarmSnapshot::oldValue(it->second), deleted);
+      }
+      it = snapshot.erase(it);
+      changes++;
+    }
+    SAM_LOG_DEBUG(_logger, LogCategory::WARM, "Warm instance '", id, "' changed by another process: ", changes,
+                  " keys");
+  }
+
+  /**
+   * One maintenance pass. Instances asked for by compactWarm are always
+   * compacted. The others only when no Warm write happened since the last
+   * pass, and only if their append log is mostly overwritten entries and
+   * either close to filling the file (MMKV would compact inline on the
+   * writer's thread) or far larger than the live data.
+   */
+  void runWarmCompaction() {
+    WarmCompactionPolicy policy;
+    std::set<std::string> requested;
+    {
+      std::lock_guard<std::mutex> lock(_compactionMutex);
+      policy = _compactionPolicy;
+      requested.swap(_compactionRequests);
+    }
+    uint64_t writes = _warmWrites.load(std::memory_order_relaxed);
+    bool idle = writes == _compactionWritesSeen;
+    _compactionWritesSeen = writes;
+    bool automatic = policy.enabled && idle;
+    if (!automatic && requested.empty()) {
+      return;
+    }
+
+    bool all = requested.count(std::string()) > 0;
+    for (const auto& [id, storage] : residentWarmInstances()) {
+      bool forced = all || requested.count(id) > 0;
+      if (!forced && !automatic) {
+        continue;
+      }
+      if (!forced) {
+        if (_warmWrites.load(std::memory_order_relaxed) != writes) {
+          automatic = false;  // writers are back; wait for the next quiet period
+          continue;
+        }
+        if (!needsCompaction(id, storage, policy)) {
+          continue;
+        }
+      }
+      compactWarmInstance(id, storage);
+    }
+  }
+
+  bool needsCompaction(const std::string& id, mmkv::MMKV* storage, const WarmCompactionPolicy& policy) {
+    size_t fileBytes = storage->totalSize();
+    size_t usedBytes = storage->actualSize();
+    // trim() leaves files of the default size alone
+    if (fileBytes < policy.minFileBytes || fileBytes <= static_cast<size_t>(mmkv::DEFAULT_MMAP_SIZE)) {
+      return false;
+    }
+    double live = static_cast<double>(measureLiveBytes(id, storage));
+    bool overwritten = static_cast<double>(usedBytes) >= live * policy.maxAmplification;
+    bool nearlyFull = usedBytes >= fileBytes / 2;
+    bool oversized = static_cast<double>(fileBytes) >= live * policy.maxAmplification * 4;
+    return (overwritten && nearlyFull) || oversized;
+  }
+
+  /**
+   * Approximate encoded size of an instance's current entries. Walks every
+   * key, so the result is reused until the next Warm write.
+   */
+  size_t measureLiveBytes(const std::string& id, mmkv::MMKV* storage) {
+    uint64_t writes = _warmWrites.load(std::memory_order_relaxed);
+    {
+      std::lock_guard<std::mutex> lock(_compactionMutex);
+      const WarmCompactionState& state = _compactionStates[id];
+      if (state.liveMeasuredAt == writes) {
+        return state.liveBytes;
+      }
+    }
+    size_t live = 0;
+    for (const std::string& key : storage->allKeys()) {
+      live += key.size() + 1 + storage->getValueSize(key, false);
+    }
+    std::lock_guard<std::mutex> lock(_compactionMutex);
+    WarmCompactionState& state = _compactionStates[id];
+    state.liveBytes = live;
+    state.liveMeasuredAt = writes;
+    return live;
+  }
+
+  /**
+   * MMKV's trim() rewrites the live entries and shrinks the file. It holds
+   * the instance's own lock, not _mutex, so only writers to this instance
+   * wait for it.
+   */
+  void compactWarmInstance(const std::string& id, mmkv::MMKV* storage) {
+    size_t before = storage->totalSize();
+    auto start = std::chrono::steady_clock::now();
+    storage->trim();
+    double durationMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    size_t after = storage->totalSize();
+    {
+      std::lock_guard<std::mutex> lock(_compactionMutex);
+      WarmCompactionState& state = _compactionStates[id];
+      state.compactions++;
+      state.lastDurationMs = durationMs;
+      state.lastCompactedAt = getCurrentTimestamp();
+      state.bytesReclaimed += before > after ? static_cast<double>(before - after) : 0;
+    }
+    SAM_LOG_DEBUG(_logger, LogCategory::WARM, "Compacted Warm instance '", id, "' in ", durationMs,
+                  " ms (", before, " -> ", after, " bytes)");
+  }
+
+  // -------------------------------------------------------------------------
+  // Cold Checkpoints
+  // -------------------------------------------------------------------------
+
+  /**
+   * One maintenance pass over the file-backed Cold databases. Databases asked
+   * for by checkpointCold are always checkpointed; the others only when
+   * enabled, and either idle with WAL frames to copy back (or a WAL file past
+   * truncateWalBytes), or past maxWalBytes while writes continue.
+   */
+  void runColdCheckpoints() {
+    ColdCheckpointPolicy policy;
+    std::set<std::string> requested;
+    {
+      std::lock_guard<std::mutex> lock(_checkpointMutex);
+      policy = _checkpointPolicy;
+      requested.swap(_checkpointRequests);
+    }
+    if (!policy.enabled && requested.empty()) {
+      return;
+    }
+    bool all = requested.count(std::string()) > 0;
+    for (const auto& [name, path] : fileColdDatabases()) {
+      bool forced = all || requested.count(name) > 0;
+      if (forced || policy.enabled) {
+        checkpointColdDatabase(name, path, policy, forced);
+      }
+    }
+  }
+
+  /**
+   * Checkpoint one database if it is due. PRAGMA data_version on the
+   * checkpoint connection changes whenever another connection commits, so an
+   * unchanged version means no writes since the last pass.
+   *
+   * PASSIVE never waits: it copies what it can while readers and writers
+   * carry on. TRUNCATE also resets the WAL to zero bytes, but holds the write
+   * lock while it waits for readers, so it is used only on an idle database
+   * whose WAL is large. If a long read makes it time out, later passes go
+   * back to PASSIVE until one copies everything, i.e. the read has ended.
+   */
+  void checkpointColdDatabase(const std::string& name, const std::string& path,
+                              const ColdCheckpointPolicy& policy, bool forced) {
+    uint64_t walBytes = walFileBytes(path);
+    if (walBytes == 0) {
+      return;  // nothing to copy back, or not opened yet (lazy Cold)
+    }
+    ColdCheckpointCursor& cursor = _checkpointCursors[name];
+    if (cursor.db == nullptr) {
+      if (sqlite3_open_v2(path.c_str(), &cursor.db, SQLITE_OPEN_READWRITE, nullptr) != SQLITE_OK) {
+        SAM_LOG_WARN(_logger, LogCategory::COLD, "Failed to open checkpoint connection for Cold storage '",
+                     name, "': ", sqlite3_errmsg(cursor.db));
+        sqlite3_close(cursor.db);
+        cursor.db = nullptr;
+        return;
+      }
+      sqlite3_busy_timeout(cursor.db, kCheckpointBusyTimeoutMs);
+    }
+
+    int64_t version = pragmaInteger(cursor.db, "data_version");
+    bool idle = version == cursor.seenVersion;
+    cursor.seenVersion = version;
+    bool pending = version != cursor.checkpointedVersion || cursor.incomplete;
+    bool oversized = walBytes >= policy.truncateWalBytes;
+    if (!forced && !(idle && (pending || oversized)) && !(pending && walBytes >= policy.maxWalBytes)) {
+      return;
+    }
+    bool truncate = forced || (idle && oversized && !cursor.truncateBlocked);
+
+    int logFrames = 0;
+    int copiedFrames = 0;
+    uint64_t start = monotonicNanos();
+    int rc = sqlite3_wal_checkpoint_v2(cursor.db, nullptr,
+                                       truncate ? SQLITE_CHECKPOINT_TRUNCATE : SQLITE_CHECKPOINT_PASSIVE,
+                                       &logFrames, &copiedFrames);
+    uint64_t elapsedNs = monotonicNanos() - start;
+    double durationMs = static_cast<double>(elapsedNs) / 1e6;
+    bool complete = rc == SQLITE_OK && copiedFrames >= logFrames;
+    cursor.incomplete = !complete;
+    if (complete) {
+      cursor.checkpointedVersion = version;
+      cursor.truncateBlocked = false;
+    } else if (truncate) {
+      cursor.truncateBlocked = true;
+    }
+
+#if SAM_METRICS
+    _operationStats[kOpColdCheckpoint].latency.record(elapsedNs);
+    if (rc != SQLITE_OK && rc != SQLITE_BUSY) {
+      _operationStats[kOpColdCheckpoint].errors.fetch_add(1, std::memory_order_relaxed);
+    }
+#endif
+    if (rc != SQLITE_OK && rc != SQLITE_BUSY) {
+      SAM_LOG_WARN(_logger, LogCategory::COLD, "Checkpoint of Cold storage '", name, "' failed: ",
+                   sqlite3_errmsg(cursor.db));
+    }
+    {
+      std::lock_guard<std::mutex> lock(_checkpointMutex);
+      ColdCheckpointState& state = _checkpointStates[name];
+      state.checkpoints++;
+      state.truncateCheckpoints += truncate ? 1 : 0;
+      state.incompleteCheckpoints += complete ? 0 : 1;
+      state.lastDurationMs = durationMs;
+      state.maxDurationMs = std::max(state.maxDurationMs, durationMs);
+      state.lastCheckpointAt = getCurrentTimestamp();
+    }
+    SAM_LOG_DEBUG(_logger, LogCategory::COLD, truncate ? "TRUNCATE" : "PASSIVE", " checkpoint of Cold storage '",
+                  name, "' in ", durationMs, " ms (", copiedFrames, "/", logFrames, " frames, ", walBytes,
+                  " WAL bytes)");
+  }
+
+  static uint64_t walFileBytes(const std::string& path) {
+    struct stat info;
+    if (stat((path + "-wal").c_str(), &info) != 0) {
+      return 0;
+    }
+    return static_cast<uint64_t>(info.st_size);
+  }
+
+  /**
+   * Name and path of each Cold database with a file, and so a WAL
+   */
+  std::vector<std::pair<std::string, std::string>> fileColdDatabases() {
+    std::vector<std::pair<std::string, std::string>> databases;
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (const auto& [name, path] : _coldDatabasePaths) {
+      if (!isInMemoryPath(path)) {
+        databases.emplace_back(name, path);
+      }
+    }
+    return databases;
+  }
+
+  /**
+   * wal_autocheckpoint for a connection: 0 while the checkpoint scheduler
+   * owns checkpoints, otherwise the database's tuning
+   */
+  int walAutocheckpointPages(const ColdTuning& tuning) const {
+    if (_checkpointsEnabled.load(std::memory_order_relaxed)) {
+      return 0;
+    }
+    return tuning.walAutocheckpointPages != ColdTuning::kUnset ? tuning.walAutocheckpointPages
+                                                               : kDefaultWalAutocheckpointPages;
+  }
+
+  /**
+   * Re-apply walAutocheckpointPages to every open connection after the
+   * scheduler is switched on or off
+   */
+  void applyWalAutocheckpoints() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (const auto& entry : _sqliteDatabases) {
+      if (entry.second != nullptr) {
+        sqlite3_wal_autocheckpoint(entry.second, walAutocheckpointPages(_coldTunings[entry.first]));
+      }
+    }
+    for (const auto& entry : _coldLanes) {
+      ColdLane* lane = entry.second.get();
+      if (lane->shared) {
+        continue;
+      }
+      _coldWorkers.submit(lane->dbName, [this, lane](bool cancelled) {
+        if (!cancelled && lane->db != nullptr) {
+          sqlite3_wal_autocheckpoint(lane->db, walAutocheckpointPages(lane->tuning));
+        }
+      });
+    }
+  }
+
+  // -------------------------------------------------------------------------
+  // Startup
+  // -------------------------------------------------------------------------
+
+  /**
+   * One prewarmWarm() call; its promise settles when the last instance is open
+   */
+  struct WarmPrewarm {
+    std::atomic<size_t> remaining{0};
+    std::mutex errorMutex;
+    std::optional<std::string> error;  // first failure
+    std::shared_ptr<Promise<ListenerResult>> promise;
+
+    void fail(std::string message) {
+      std::lock_guard<std::mutex> lock(errorMutex);
+      if (!error.has_value()) {
+        error = std::move(message);
+      }
+    }
+  };
+
+  /**
+   * Initialize MMKV once, at the configured or auto-detected root path. This
+   * uses the same default path that react-native-mmkv uses, so storage is
+   * shared if both libraries are present. Caller must hold _mutex.
+   */
+  bool initializeWarmGlobal(std::string& error, bool background) {
+    if (_warmGlobalInitialized) {
+      return true;
+    }
+    // Auto-detect default path if not explicitly set
+    if (_warmRootPath.empty()) {
+      _warmRootPath = getDefaultWarmPathInternal();
+      if (_warmRootPath.empty()) {
+        error = "Warm root path not set and could not auto-detect. "
+                "Call setWarmRootPath() first with your app's files directory + '/mmkv'";
+        return false;
+      }
+      SAM_LOG_DEBUG(_logger, LogCategory::WARM, "Auto-detected Warm root path: ", _warmRootPath);
+    }
+
+    uint64_t start = monotonicNanos();
+    mmkv::MMKV::initializeMMKV(_warmRootPath);
+    _warmGlobalInitialized = true;
+    recordStartupStage("warm.global", start, background);
+    SAM_LOG_DEBUG(_logger, LogCategory::WARM, "Warm storage globally initialized at: ", _warmRootPath);
+    return true;
+  }
+
+  /**
+   * Open one instance for prewarmWarm() on a worker, with its key and mode.
+   * MMKV reads and parses the whole file when it opens an instance, so its
+   * pages are faulted in here rather than on the first JS read. An instance
+   * that is already open is only checked against the config, and one that
+   * MMKV hands back with a different key or mode is not registered, the same
+   * rules initializeWarm applies.
+   */
+  void prewarmWarmInstance(const WarmPrewarmInstance& instance, WarmPrewarm& state, bool cancelled) {
+    const std::string& id = instance.instanceId;
+    if (cancelled) {
+      state.fail("Warm prewarm abandoned: SideFx was destroyed");
+    } else {
+      std::optional<std::string> key;
+      bool multiProcess = false;
+      if (instance.config.has_value()) {
+        key = instance.config->encryptionKey;
+        multiProcess = instance.config->multiProcess.value_or(false);
+      }
+      bool open;
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto existing = _warmInstances.find(id);
+        open = existing != _warmInstances.end();
+        if (open) {
+          checkPrewarmConfig(id, existing->second.storage, key, multiProcess, state);
+        }
+      }
+      if (!open) {
+        // Outside _mutex: instances open in parallel with each other and with JS calls
+        uint64_t start = monotonicNanos();
+        mmkv::MMKV* storage = getWarmInstance(id, key.has_value() ? &*key : nullptr, multiProcess);
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (storage == nullptr) {
+          state.fail("Failed to create Warm instance: " + id);
+        } else if (checkPrewarmConfig(id, storage, key, multiProcess, state) &&
+                   _warmInstances.find(id) == _warmInstances.end()) {
+          registerWarmInstance(id, storage);
+          recordStartupStage("warm:" + id, start, true);
+          SAM_LOG_DEBUG(_logger, LogCategory::WARM, "Prewarmed Warm instance: ", id, key.has_value() ? " (encrypted)" : "",
+                        multiProcess ? " (multi-process)" : "");
+        }
+      }
+    }
+    if (state.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      std::lock_guard<std::mutex> lock(state.errorMutex);
+      state.promise->resolve(ListenerResult(!state.error.has_value(), state.error));
+    }
+  }
+
+  /**
+   * Whether an open instance matches the key and mode prewarmWarm was given;
+   * fails `state` if not
+   */
+  static bool checkPrewarmConfig(const std::string& id, mmkv::MMKV* storage, const std::optional<std::string>& key,
+                                 bool multiProcess, WarmPrewarm& state) {
+    if (key.has_value() && storage->cryptKey() != *key) {
+      state.fail("Warm instance already open with a different encryption key: " + id);
+      return false;
+    }
+    if (multiProcess && !storage->isMultiProcess()) {
+      state.fail("Warm instance already open in single-process mode: " + id);
+      return false;
+    }
+    return true;
+  }
+
+  static bool isValidWarmKey(const std::string& key) {
+    return !key.empty() && key.size() <= kWarmKeyMaxBytes;
+  }
+
+  /**
+   * Record a startup stage that began at `startNs` and ends now. Caller must
+   * hold _mutex.
+   */
+  void recordStartupStage(std::string stage, uint64_t startNs, bool background) {
+    uint64_t endNs = monotonicNanos();
+    _startupStages.emplace_back(std::move(stage), static_cast<double>(startNs - _createdNs) / 1e6,
+                                static_cast<double>(endNs - startNs) / 1e6, background);
+  }
+
+  // -------------------------------------------------------------------------
+  // Memory governor
+  // -------------------------------------------------------------------------
+
+  /**
+   * Page cache, schema and prepared statement memory of one connection
+   */
+  static size_t coldConnectionBytes(sqlite3* db) {
+    size_t total = 0;
+    if (db == nullptr) {
+      return total;  // a lane whose connection failed to open
+    }
+    for (int op : {SQLITE_DBSTATUS_CACHE_USED, SQLITE_DBSTATUS_SCHEMA_USED, SQLITE_DBSTATUS_STMT_USED}) {
+      int current = 0;
+      int highwater = 0;
+      if (sqlite3_db_status(db, op, &current, &highwater, 0) == SQLITE_OK) {
+        total += static_cast<size_t>(current);
+      }
+    }
+    return total;
+  }
+
+  MemoryUsage measureMemory() {
+    size_t listenerBytes = 0;
+    size_t dispatchBytes = 0;
+    {
+      std::lock_guard<std::mutex> lock(_dispatchMutex);
+      listenerBytes = _listeners.memoryBytes() + _regexCache.size() * kRegexEstimateBytes;
+      dispatchBytes = _dispatchArena.bytesHeld() + _pendingEvents.capacity() * sizeof(PendingChangeEvent*) +
+                      (_batchRouteIds.capacity() + _coldCandidates.capacity()) * sizeof(uint32_t) +
+                      _pendingTransitions.capacity() * sizeof(MFETransition);
+    }
+
+    size_t warmMapped = 0;
+    size_t warmSnapshots = 0;
+    size_t resident = 0;
+    size_t instances = 0;
+    size_t coldBytes = 0;
+    size_t mfeBytes = 0;
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      instances = _warmInstances.size();
+      for (auto& entry : _warmInstances) {
+        if (entry.second.resident) {
+          // Files grow as they are written; the size recorded here is what
+          // eviction later reports as freed
+          entry.second.mappedBytes = entry.second.storage->totalSize();
+          warmMapped += entry.second.mappedBytes;
+          resident++;
+        }
+        if (entry.second.snapshot != nullptr) {
+          warmSnapshots += entry.second.snapshot->bytes;
+        }
+      }
+      for (const auto& entry : _sqliteDatabases) {
+        if (entry.second != nullptr) {
+          coldBytes += coldConnectionBytes(entry.second);
+        }
+      }
+      for (const auto& entry : _coldLanes) {
+        coldBytes += entry.second->memoryBytes.load(std::memory_order_relaxed);
+      }
+      mfeBytes = _mfeRecords.size() * (sizeof(MFERecord) + 64) +
+                 _mfeLoadSketches.size() * (sizeof(LoadTimeSketch) + 64);
+    }
+
+    std::lock_guard<std::mutex> lock(_governorMutex);
+    size_t total = warmMapped + warmSnapshots + coldBytes + listenerBytes + dispatchBytes + mfeBytes;
+    return MemoryUsage(static_cast<double>(_memoryBudget.load(std::memory_order_relaxed)),
+                       static_cast<double>(total),
+                       static_cast<double>(warmMapped),
+                       static_cast<double>(instances),
+                       static_cast<double>(resident),
+                       static_cast<double>(warmSnapshots),
+                       static_cast<double>(coldBytes),
+                       static_cast<double>(listenerBytes),
+                       static_cast<double>(dispatchBytes),
+                       static_cast<double>(mfeBytes),
+                       _warmEvictions,
+                       _lastPressure);
+  }
+
+  /**
+   * One governor pass (maintenance thread). Memory pressure evicts Warm
+   * instances - all of them when critical, those unused since the previous
+   * pass when moderate - and releases caches. Over budget, the least recently
+   * used instances are evicted until usage fits, then caches are released.
+   * The most recently used instance is never evicted for the budget.
+   */
+  void runMemoryGovernor() {
+    std::optional<MemoryPressureLevel> pressure;
+    {
+      std::lock_guard<std::mutex> lock(_governorMutex);
+      pressure.swap(_pendingPressure);
+    }
+
+    uint64_t idleMark = _governorUseMark;
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _governorUseMark = _warmUseClock;
+    }
+    if (pressure.has_value()) {
+      bool critical = *pressure == MemoryPressureLevel::CRITICAL;
+      auto [evicted, freed] = evictWarmInstances([&](const WarmInstance& instance) {
+        return critical || instance.lastUsed <= idleMark;
+      }, SIZE_MAX);
+      releaseCaches();
+      SAM_LOG_DEBUG(_logger, LogCategory::GENERAL, critical ? "Critical" : "Moderate",
+                    " memory pressure: evicted ", evicted, " Warm instances (", freed, " bytes)");
+    }
+
+    size_t budget = _memoryBudget.load(std::memory_order_relaxed);
+    if (budget == 0) {
+      return;
+    }
+    size_t total = static_cast<size_t>(measureMemory().totalBytes);
+    if (total <= budget) {
+      return;
+    }
+    uint64_t newest = 0;
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      newest = _warmUseClock;
+    }
+    size_t excess = total - budget;
+    size_t freed = evictWarmInstances([&](const WarmInstance& instance) {
+      return instance.lastUsed < newest;
+    }, excess).second;
+    if (freed < excess) {
+      releaseCaches();
+    }
+    SAM_LOG_DEBUG(_logger, LogCategory::GENERAL, "Memory budget exceeded by ", excess, " bytes; freed ", freed,
+                  " bytes of Warm mappings");
+  }
+
+  /**
+   * Evict resident instances accepted by `eligible`, least recently used
+   * first, until `target` mapped bytes are freed. Plaintext instances go
+   * before encrypted ones, which MMKV decrypts in full when it maps them
+   * back. Returns the instances evicted and the bytes freed.
+   */
+  template <typename Eligible>
+  std::pair<size_t, size_t> evictWarmInstances(Eligible&& eligible, size_t target) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::vector<std::pair<std::pair<bool, uint64_t>, WarmInstance*>> candidates;
+    for (auto& entry : _warmInstances) {
+      if (entry.second.resident && eligible(entry.second)) {
+        candidates.emplace_back(std::make_pair(entry.second.encrypted, entry.second.lastUsed), &entry.second);
+      }
+    }
+    std::sort(candidates.begin(), candidates.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+    size_t freed = 0;
+    size_t evicted = 0;
+    for (const auto& candidate : candidates) {
+      if (freed >= target) {
+        break;
+      }
+      WarmInstance& instance = *candidate.second;
+      instance.storage->clearMemoryCache();
+      instance.resident = false;
+      freed += instance.mappedBytes;
+      evicted++;
+    }
+    std::lock_guard<std::mutex> governorLock(_governorMutex);
+    _warmEvictions += static_cast<double>(evicted);
+    return {evicted, freed};
+  }
+
+  /**
+   * Give back memory that is rebuilt on demand: SQLite page caches, the
+   * dispatch arena beyond one block, compiled regexes
+   */
+  void releaseCaches() {
+    {
+      std::lock_guard<std::mutex> lock(_dispatchMutex);
+      _regexCache.clear();
+      if (_pendingEvents.empty()) {
+        // Nothing queued points into the arena between batches
+        _dispatchArena.trim();
+        _pendingEvents.shrink_to_fit();
+      }
+      _coldCandidates.shrink_to_fit();
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (const auto& entry : _sqliteDatabases) {
+      if (entry.second != nullptr) {
+        sqlite3_db_release_memory(entry.second);
+      }
+    }
+    for (const auto& entry : _coldLanes) {
+      ColdLane* lane = entry.second.get();
+      if (lane->shared) {
+        continue;
+      }
+      // The lane's connection belongs to its worker; release it in line
+      _coldWorkers.submit(lane->dbName, [lane](bool cancelled) {
+        if (!cancelled && lane->db != nullptr) {
+          sqlite3_db_release_memory(lane->db);
+          lane->memoryBytes.store(coldConnectionBytes(lane->db), std::memory_order_relaxed);
+        }
+      });
+    }
+  }
+
+  /**
+   * Forward the OS memory pressure notifications to the governor (iOS).
+   * On Android, JS forwards onTrimMemory levels via handleMemoryPressure.
+   * Caller must hold _mutex.
+   */
+  void startMemoryPressureSource() {
+#ifdef __APPLE__
+    if (_memoryPressureSource != nullptr) {
+      return;
+    }
+    _memoryPressureSource = dispatch_source_create(
+        DISPATCH_SOURCE_TYPE_MEMORYPRESSURE, 0, DISPATCH_MEMORYPRESSURE_WARN | DISPATCH_MEMORYPRESSURE_CRITICAL,
+        dispatch_get_global_queue(QOS_CLASS_UTILITY, 0));
+    HybridSideFx* self = this;
+    dispatch_source_t source = _memoryPressureSource;
+    dispatch_source_set_event_handler(_memoryPressureSource, ^{
+      unsigned long flags = dispatch_source_get_data(source);
+      self->handleMemoryPressure((flags & DISPATCH_MEMORYPRESSURE_CRITICAL) ? MemoryPressureLevel::CRITICAL
+                                                                           : MemoryPressureLevel::MODERATE);
+    });
+    dispatch_resume(_memoryPressureSource);
+#endif
+  }
+
+  // -------------------------------------------------------------------------
+  // MFE registry
+  // -------------------------------------------------------------------------
+
+  template <typename T>
+  static void mergeMFEField(std::optional<T>& field, const std::optional<T>& update) {
+    if (update.has_value()) {
+      field = update;
+    }
+  }
+
+  /**
+   * The registry's Warm instance, or nullptr until JS has initialized it.
+   * Caller must hold _mutex.
+   */
+  mmkv::MMKV* mfeStorage() {
+    auto instance = _warmInstances.find(kMFEInstanceId);
+    if (instance == _warmInstances.end()) {
+      return nullptr;
+    }
+    return useWarmInstance(instance->second);
+  }
+
+  /**
+   * Load persisted records the first time the registry's Warm instance is
+   * available. Records set before that are newer than anything on disk, so
+   * they win and are written out. Records left by the JS registry
+   * ("mfe.<id>" and "mfe.<id>.meta") are migrated to binary records and
+   * removed. Caller must hold _mutex.
+   */
+  void hydrateMFERegistry() {
+    if (_mfeHydrated) {
+      return;
+    }
+    mmkv::MMKV* storage = mfeStorage();
+    if (storage == nullptr) {
+      return;
+    }
+    _mfeHydrated = true;
+
+    std::vector<std::string> unsaved;
+    unsaved.reserve(_mfeRecords.size());
+    for (const auto& entry : _mfeRecords) {
+      unsaved.push_back(entry.first);
+    }
+
+    const std::string_view recordPrefix(kMFEKeyPrefix);
+    const std::string_view sketchPrefix(kMFELoadKeyPrefix);
+    size_t loaded = 0;
+    // Legacy state and metadata keys by MFE ID
+    std::unordered_map<std::string, std::pair<std::optional<std::string>, std::optional<std::string>>> legacy;
+    for (const std::string& key : storage->allKeys()) {
+      if (key.compare(0, mfe_record::legacy::kKeyPrefix.size(), mfe_record::legacy::kKeyPrefix) == 0) {
+        std::string_view name = std::string_view(key).substr(mfe_record::legacy::kKeyPrefix.size());
+        const std::string_view suffix = mfe_record::legacy::kMetaSuffix;
+        bool meta = name.size() > suffix.size() && name.substr(name.size() - suffix.size()) == suffix;
+        if (meta) {
+          name.remove_suffix(suffix.size());
+        }
+        std::string text;
+        if (storage->getString(key, text)) {
+          auto& entry = legacy[std::string(name)];
+          (meta ? entry.second : entry.first) = std::move(text);
+        }
+      } else if (key.compare(0, recordPrefix.size(), recordPrefix) == 0) {
+        std::string mfeId = key.substr(recordPrefix.size());
+        if (_mfeRecords.find(mfeId) != _mfeRecords.end()) {
+          continue;
+        }
+        mmkv::MMBuffer bytes = storage->getBytes(key);
+        std::optional<MFERecord> record = mfe_record::decode(mfeId, bytes.getPtr(), bytes.length());
+        if (!record.has_value()) {
+          SAM_LOG_WARN(_logger, LogCategory::WARM, "Ignoring unreadable MFE record: ", mfeId);
+          continue;
+        }
+        _mfeRecords.emplace(std::move(mfeId), std::move(*record));
+        loaded++;
+      } else if (key.compare(0, sketchPrefix.size(), sketchPrefix) == 0) {
+        std::string mfeId = key.substr(sketchPrefix.size());
+        mmkv::MMBuffer bytes = storage->getBytes(key);
+        std::optional<LoadTimeSketch> sketch = LoadTimeSketch::decode(bytes.getPtr(), bytes.length());
+        if (!sketch.has_value()) {
+          SAM_LOG_WARN(_logger, LogCategory::WARM, "Ignoring unreadable MFE load stats: ", mfeId);
+          continue;
+        }
+        // Loads recorded before the sketch was read are added to it
+        auto it = _mfeLoadSketches.find(mfeId);
+        if (it != _mfeLoadSketches.end()) {
+          sketch->merge(it->second);
+          it->second = *sketch;
+          persistMFELoadSketch(mfeId, it->second);
+        } else {
+          _mfeLoadSketches.emplace(std::move(mfeId), *sketch);
+        }
+      }
+    }
+    for (const std::string& mfeId : unsaved) {
+      persistMFERecord(_mfeRecords[mfeId]);
+    }
+    size_t migrated = migrateLegacyMFERecords(storage, legacy);
+    for (const auto& [mfeId, sketch] : _mfeLoadSketches) {
+      if (!storage->containsKey(kMFELoadKeyPrefix + mfeId)) {
+        persistMFELoadSketch(mfeId, sketch);
+      }
+    }
+    SAM_LOG_DEBUG(_logger, LogCategory::WARM, "Loaded ", loaded, " MFE records, migrated ", migrated);
+  }
+
+  /**
+   * Write legacy records as binary ones, unless a binary record already
+   * exists (it is newer), then delete the legacy keys. Caller must hold
+   * _mutex.
+   */
+  size_t migrateLegacyMFERecords(
+      mmkv::MMKV* storage,
+      const std::unordered_map<std::string, std::pair<std::optional<std::string>, std::optional<std::string>>>& legacy) {
+    size_t migrated = 0;
+    double now = getCurrentTimestamp();
+    for (const auto& [mfeId, entry] : legacy) {
+      const auto& [state, metaJson] = entry;
+      if (_mfeRecords.find(mfeId) == _mfeRecords.end()) {
+        std::optional<MFERecord> record = mfe_record::legacy::decode(mfeId, state, metaJson, now);
+        if (!record.has_value()) {
+          SAM_LOG_WARN(_logger, LogCategory::WARM, "Dropping unreadable legacy MFE state: ", mfeId);
+        } else {
+          persistMFERecord(*record);
+          _mfeRecords.emplace(mfeId, std::move(*record));
+          migrated++;
+        }
+      }
+      const std::string legacyKey = std::string(mfe_record::legacy::kKeyPrefix) + mfeId;
+      if (state.has_value()) {
+        storage->removeValueForKey(legacyKey);
+      }
+      if (metaJson.has_value()) {
+        storage->removeValueForKey(legacyKey + std::string(mfe_record::legacy::kMetaSuffix));
+      }
+    }
+    return migrated;
+  }
+
+  /**
+   * Add one load to an MFE's sketch and write it through.
+   * Caller must hold _mutex.
+   */
+  void recordMFELoadTimeLocked(const std::string& mfeId, double loadTimeMs) {
+    LoadTimeSketch& sketch = _mfeLoadSketches[mfeId];
+    sketch.record(loadTimeMs);
+    persistMFELoadSketch(mfeId, sketch);
+  }
+
+  /**
+   * Caller must hold _mutex
+   */
+  void persistMFELoadSketch(const std::string& mfeId, const LoadTimeSketch& sketch) {
+    mmkv::MMKV* storage = mfeStorage();
+    if (storage == nullptr) {
+      return;
+    }
+    sketch.encode(_mfeScratch);
+    mmkv::MMBuffer bytes(_mfeScratch.data(), _mfeScratch.size(), mmkv::MMBufferNoCopy);
+    if (!storage->set(bytes, kMFELoadKeyPrefix + mfeId)) {
+      SAM_LOG_WARN(_logger, LogCategory::WARM, "Failed to persist MFE load stats: ", mfeId);
+    }
+  }
+
+  static MFELoadStats toMFELoadStats(const std::string& mfeId, const LoadTimeSketch& sketch) {
+    LoadTimeSketch::Summary summary = sketch.summarize();
+    return MFELoadStats(mfeId, summary.count, summary.minMs, summary.maxMs, summary.meanMs,
+                        summary.p50Ms, summary.p95Ms);
+  }
+
+  /**
+   * Caller must hold _mutex
+   */
+  void persistMFERecord(const MFERecord& record) {
+    mmkv::MMKV* storage = mfeStorage();
+    if (storage == nullptr) {
+      return;
+    }
+    mfe_record::encode(record, _mfeScratch);
+    mmkv::MMBuffer bytes(_mfeScratch.data(), _mfeScratch.size(), mmkv::MMBufferNoCopy);
+    if (!storage->set(bytes, kMFEKeyPrefix + record.mfeId)) {
+      SAM_LOG_WARN(_logger, LogCategory::WARM, "Failed to persist MFE record: ", record.mfeId);
+    }
+  }
+
+  /**
+   * Queue a transition for the dispatcher; `record` is null when cleared.
+   * Enqueued under _mutex, so transitions of one MFE arrive in order.
+   */
+  void enqueueMFETransition(const std::string& mfeId, MFEPhase previous,
+                            const MFERecord* record, double timestamp) {
+    if (!_mfeTransitionsWanted.load(std::memory_order_relaxed)) {
+      return;
+    }
+    ChangeRecord change;
+    change.kind = ChangeRecord::Kind::MFETransition;
+    change.scope = mfeId;
+    change.oldValue.kind = ValueView::Kind::Number;
+    change.oldValue.numberValue = static_cast<double>(previous);
+    if (record != nullptr) {
+      change.newValue.kind = ValueView::Kind::String;
+      mfe_record::encode(*record, change.newValue.stringValue);
+    }
+    change.timestamp = timestamp;
+    enqueueChange(std::move(change));
+  }
+
+  /**
+   * Get the platform-specific default Warm storage path
+   * Internal version that can be called without override
+   */
+  std::string getDefaultWarmPathInternal() {
+#ifdef __APPLE__
+    // iOS/macOS: Use Library directory (same as react-native-mmkv)
+    @autoreleasepool {
+      NSArray *paths = NSSearchPathForDirectoriesInDomains(NSLibraryDirectory, NSUserDomainMask, YES);
+      NSString *libraryPath = [paths firstObject];
+      NSString *mmkvPath = [libraryPath stringByAppendingPathComponent:@"mmkv"];
+      return std::string([mmkvPath UTF8String]);
+    }
+#else
+    // Android: Return the path if already set, otherwise empty
+    // Android path must be set from Java side (Context.getFilesDir() + "/mmkv")
+    return _warmRootPath;
+#endif
+  }
+
+  double getCurrentTimestamp() const {
+    return static_cast<double>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch())
+            .count());
+  }
+
+  /**
+   * Materialize the public ListenerInfo for the listener at dense `index`
+   */
+  ListenerInfo createListenerInfo(uint32_t index) const {
+    const auto& cold = _listeners.cold(index);
+    return ListenerInfo(
+        _listeners.id(index),
+        cold.config,
+        cold.createdAt,
+        _listeners.triggerCount(index),
+        _listeners.lastTriggered(index),
+        (_listeners.flags(index) & ListenerTable::kPaused) != 0);
+  }
+
+  /**
+   * Debug mode is shorthand for "every log category at debug level"
+   */
+  void applyDebugMode(bool enabled) {
+    _debugMode = enabled;
+    _logger.setLevel(enabled ? LogLevel::Debug : LogLevel::Warn);
+  }
+
+  /**
+   * Bind positional parameters to a prepared statement
+   * SQLite params are 1-indexed
+   */
+  void bindColdParams(
+      sqlite3_stmt* stmt,
+      const std::optional<std::vector<std::variant<nitro::NullType, bool, std::string, double>>>& params) const {
+    if (!params.has_value()) {
+      return;
+    }
+    const auto& paramVec = params.value();
+    for (size_t i = 0; i < paramVec.size(); ++i) {
+      int paramIndex = static_cast<int>(i + 1);
+      const auto& param = paramVec[i];
+
+      if (std::holds_alternative<nitro::NullType>(param)) {
+        sqlite3_bind_null(stmt, paramIndex);
+      } else if (std::holds_alternative<bool>(param)) {
+        sqlite3_bind_int(stmt, paramIndex, std::get<bool>(param) ? 1 : 0);
+      } else if (std::holds_alternative<std::string>(param)) {
+        const std::string& str = std::get<std::string>(param);
+        sqlite3_bind_text(stmt, paramIndex, str.c_str(), static_cast<int>(str.length()), SQLITE_TRANSIENT);
+      } else if (std::holds_alternative<double>(param)) {
+        sqlite3_bind_double(stmt, paramIndex, std::get<double>(param));
+      }
+    }
+  }
+
+  /**
+   * Main connection for `dbName`, opened now if it was declared lazily, or
+   * nullptr with `error` set. Caller must hold _mutex.
+   */
+  sqlite3* coldDatabase(const std::string& dbName, std::string* error = nullptr) {
+    auto it = _sqliteDatabases.find(dbName);
+    if (it == _sqliteDatabases.end()) {
+      if (error != nullptr) {
+        *error = "Cold storage database '" + dbName + "' not initialized";
+      }
+      return nullptr;
+    }
+    if (it->second == nullptr) {
+      std::string openError;
+      it->second = openColdDatabase(dbName, _coldDatabasePaths[dbName], _coldTunings[dbName],
+                                    _coldMigrations[dbName], openError);
+      if (it->second == nullptr) {
+        // Left declared; the next call tries again
+        SAM_LOG_WARN(_logger, LogCategory::COLD, openError);
+        if (error != nullptr) {
+          *error = std::move(openError);
+        }
+      }
+    }
+    return it->second;
+  }
+
+  /**
+   * Open, configure and migrate a main connection, recording it as a
+   * startup stage. Caller must hold _mutex.
+   */
+  sqlite3* openColdDatabase(const std::string& dbName, const std::string& path, const ColdTuning& tuning,
+                            const std::vector<std::string>& migrations, std::string& error) {
+    uint64_t start = monotonicNanos();
+    sqlite3* db = nullptr;
+    if (sqlite3_open(path.c_str(), &db) != SQLITE_OK) {
+      error = "Failed to open Cold storage database: " + std::string(sqlite3_errmsg(db));
+      sqlite3_close(db);
+      return nullptr;
+    }
+
+    // Enable WAL mode for better concurrency
+    char* errMsg = nullptr;
+    sqlite3_exec(db, "PRAGMA journal_mode=WAL;", nullptr, nullptr, &errMsg);
+    if (errMsg) {
+      sqlite3_free(errMsg);
+    }
+
+    // Profile settings, including the busy timeout: async Cold calls write
+    // through their own connection, so wait for its write lock instead of
+    // failing with SQLITE_BUSY
+    std::string tuningError;
+    if (!tuning.apply(db, tuningError)) {
+      error = "Failed to configure Cold storage database: " + tuningError;
+      sqlite3_close(db);
+      return nullptr;
+    }
+    sqlite3_wal_autocheckpoint(db, walAutocheckpointPages(tuning));
+
+    if (!migrations.empty() && !migrateColdDatabase(dbName, db, migrations, error)) {
+      sqlite3_close(db);
+      return nullptr;
+    }
+
+    // Row-level change notifications for Cold listeners
+    sqlite3_update_hook(db, &HybridSideFx::onColdUpdate, this);
+
+    recordStartupStage("cold:" + dbName, start, false);
+    return db;
+  }
+
+  /**
+   * Prepare, bind and run one statement on `db`. Shared by executeCold and
+   * executeColdAsync; the caller must have exclusive use of `db` (hold _mutex
+   * for a main connection, or run on the connection's lane).
+   * @return SQLITE_OK, or the failing result code with `error` set
+   */
+  int runColdStatement(
+      sqlite3* db,
+      const std::string& sql,
+      const std::optional<std::vector<std::variant<nitro::NullType, bool, std::string, double>>>& params,
+      std::string& error) const {
+    // Prepare statement
+    sqlite3_stmt* stmt = nullptr;
+    int rc = sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr);
+
+    if (rc != SQLITE_OK) {
+      error = "SQL prepare error: " + std::string(sqlite3_errmsg(db));
+      return rc;
+    }
+
+    // Bind parameters if provided
+    bindColdParams(stmt, params);
+
+    // Execute statement
+    rc = sqlite3_step(stmt);
+    if (rc != SQLITE_DONE && rc != SQLITE_ROW) {
+      error = "SQL execution error: " + std::string(sqlite3_errmsg(db));
+      sqlite3_finalize(stmt);
+      return rc;
+    }
+    sqlite3_finalize(stmt);
+    return SQLITE_OK;
+  }
+
+  /**
+   * Run every statement in `sql` in order, following prepare's tail pointer,
+   * and step each one to completion; rows returned by queries are dropped.
+   * Stops at the first failure. Rows the update hook recorded in `changes`
+   * move to `applied` as each statement succeeds. The caller must have
+   * exclusive use of `db`, as for runColdStatement.
+   * @return SQLITE_OK, or the failing result code with `error` set
+   */
+  static int runColdScript(sqlite3* db, const std::string& sql, std::vector<ColdChange>& changes,
+                           std::vector<ColdChange>& applied, size_t& statements, std::string& error) {
+    const char* tail = sql.c_str();
+    const char* end = tail + sql.size();
+    while (tail < end) {
+      sqlite3_stmt* stmt = nullptr;
+      int rc = sqlite3_prepare_v2(db, tail, static_cast<int>(end - tail), &stmt, &tail);
+      if (rc != SQLITE_OK) {
+        error = "SQL prepare error in statement " + std::to_string(statements + 1) + ": " + sqlite3_errmsg(db);
+        changes.clear();
+        return rc;
+      }
+      if (stmt == nullptr) {
+        break;  // only whitespace or comments left
+      }
+      do {
+        rc = sqlite3_step(stmt);
+      } while (rc == SQLITE_ROW);
+      if (rc != SQLITE_DONE) {
+        error = "SQL execution error in statement " + std::to_string(statements + 1) + ": " + sqlite3_errmsg(db);
+        sqlite3_finalize(stmt);
+        changes.clear();
+        return rc;
+      }
+      sqlite3_finalize(stmt);
+      statements++;
+      applied.insert(applied.end(), std::make_move_iterator(changes.begin()), std::make_move_iterator(changes.end()));
+      changes.clear();
+    }
+    return SQLITE_OK;
+  }
+
+  /**
+   * Bring the schema up to date: migration i (1-based) takes PRAGMA
+   * user_version from i - 1 to i. The pending migrations and the version bump
+   * run in one IMMEDIATE transaction, so a failure leaves the database
+   * untouched at its old version. Runs before the update hook is installed,
+   * so listeners see no changes from migrations.
+   */
+  bool migrateColdDatabase(const std::string& dbName, sqlite3* db, const std::vector<std::string>& migrations,
+                           std::string& error) {
+    int64_t target = static_cast<int64_t>(migrations.size());
+    if (pragmaInteger(db, "user_version") >= target) {
+      return true;  // up to date; no write lock needed
+    }
+    if (sqlite3_exec(db, "BEGIN IMMEDIATE", nullptr, nullptr, nullptr) != SQLITE_OK) {
+      error = "Failed to start Cold storage migration: " + std::string(sqlite3_errmsg(db));
+      return false;
+    }
+    // Read again under the write lock: another process may have migrated
+    int64_t version = pragmaInteger(db, "user_version");
+    if (version >= target) {
+      sqlite3_exec(db, "COMMIT", nullptr, nullptr, nullptr);
+      return true;
+    }
+    std::vector<ColdChange> changes;
+    std::vector<ColdChange> applied;
+    for (int64_t i = std::max<int64_t>(version, 0); i < target; ++i) {
+      size_t statements = 0;
+      std::string scriptError;
+      if (runColdScript(db, migrations[static_cast<size_t>(i)], changes, applied, statements, scriptError) !=
+          SQLITE_OK) {
+        sqlite3_exec(db, "ROLLBACK", nullptr, nullptr, nullptr);
+        error = "Cold storage migration " + std::to_string(i + 1) + " failed: " + scriptError;
+        return false;
+      }
+    }
+    std::string bump = "PRAGMA user_version=" + std::to_string(target) + ";COMMIT";
+    if (sqlite3_exec(db, bump.c_str(), nullptr, nullptr, nullptr) != SQLITE_OK) {
+      error = "Failed to commit Cold storage migration: " + std::string(sqlite3_errmsg(db));
+      sqlite3_exec(db, "ROLLBACK", nullptr, nullptr, nullptr);
+      return false;
+    }
+    SAM_LOG_INFO(_logger, LogCategory::COLD, "Migrated Cold storage '", dbName, "' from version ", version, " to ",
+                 target);
+    return true;
+  }
+
+  /**
+   * Value of an integer PRAGMA, or -1 if it can't be read
+   */
+  static int64_t pragmaInteger(sqlite3* db, const char* pragma) {
+    int64_t value = -1;
+    sqlite3_stmt* stmt = nullptr;
+    std::string sql = std::string("PRAGMA ") + pragma;
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) == SQLITE_OK && sqlite3_step(stmt) == SQLITE_ROW) {
+      value = sqlite3_column_int64(stmt, 0);
+    }
+    sqlite3_finalize(stmt);
+    return value;
+  }
+
+  static std::string quoteColdIdentifier(const std::string& name) {
+    std::string quoted = "\"";
+    for (char c : name) {
+      quoted += c;
+      if (c == '"') {
+        quoted += '"';
+      }
+    }
+    return quoted + "\"";
+  }
+
+  static std::string quoteColdString(const std::string& value) {
+    std::string quoted = "'";
+    for (char c : value) {
+      quoted += c;
+      if (c == '\'') {
+        quoted += '\'';
+      }
+    }
+    return quoted + "'";
+  }
+
+  /**
+   * Column names of `table` in declaration order; empty if it doesn't exist
+   */
+  static std::vector<std::string> coldTableColumns(sqlite3* db, const std::string& table) {
+    std::vector<std::string> columns;
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db, "SELECT name FROM pragma_table_info(?)", -1, &stmt, nullptr) != SQLITE_OK) {
+      return columns;
+    }
+    sqlite3_bind_text(stmt, 1, table.c_str(), static_cast<int>(table.size()), SQLITE_TRANSIENT);
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+      const char* name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+      columns.emplace_back(name ? name : "");
+    }
+    sqlite3_finalize(stmt);
+    return columns;
+  }
+
+  /**
+   * Create or update the FTS5 index for declareColdSearch, as an external
+   * content table over `config.table` plus triggers that mirror each row
+   * change into it. SQLite runs the triggers for every connection's writes,
+   * so the index stays in sync however the table is written. The index is
+   * rebuilt only if its definition changed. Caller must hold _mutex.
+   */
+  bool createColdSearch(sqlite3* db, const ColdSearchConfig& config, std::string& error) {
+    if (config.columns.empty()) {
+      error = "No columns to index for '" + config.table + "'";
+      return false;
+    }
+    std::vector<std::string> tableColumns = coldTableColumns(db, config.table);
+    if (tableColumns.empty()) {
+      error = "Cold table '" + config.table + "' not found";
+      return false;
+    }
+    for (const std::string& column : config.columns) {
+      if (std::find(tableColumns.begin(), tableColumns.end(), column) == tableColumns.end()) {
+        error = "Column '" + column + "' not found in '" + config.table + "'";
+        return false;
+      }
+    }
+
+    const std::string table = quoteColdIdentifier(config.table);
+    const std::string index = quoteColdIdentifier(config.table + kSearchSuffix);
+    std::string columns;
+    std::string newValues;
+    std::string oldValues;
+    std::string changed = "old.rowid IS NOT new.rowid";
+    for (const std::string& column : config.columns) {
+      std::string quoted = quoteColdIdentifier(column);
+      columns += ", " + quoted;
+      newValues += ", new." + quoted;
+      oldValues += ", old." + quoted;
+      changed += " OR old." + quoted + " IS NOT new." + quoted;
+    }
+
+    // Stored verbatim in sqlite_master, so an unchanged declaration matches
+    std::string create = "CREATE VIRTUAL TABLE " + index + " USING fts5(" + columns.substr(2) +
+                         ", content=" + quoteColdString(config.table) +
+                         ", tokenize=" + quoteColdString(config.tokenizer.value_or("unicode61 remove_diacritics 2"));
+    if (config.prefixLengths.has_value() && !config.prefixLengths->empty()) {
+      std::string prefixes;
+      for (double length : config.prefixLengths.value()) {
+        if (length < 1 || length > 999 || std::floor(length) != length) {
+          error = "Invalid prefix length " + std::to_string(length);
+          return false;
+        }
+        prefixes += (prefixes.empty() ? "" : " ") + std::to_string(static_cast<int>(length));
+      }
+      create += ", prefix=" + quoteColdString(prefixes);
+    }
+    create += ")";
+
+    std::string existing;
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db, "SELECT sql FROM sqlite_master WHERE type = 'table' AND name = ?", -1, &stmt,
+                           nullptr) == SQLITE_OK) {
+      std::string name = config.table + kSearchSuffix;
+      sqlite3_bind_text(stmt, 1, name.c_str(), static_cast<int>(name.size()), SQLITE_TRANSIENT);
+      if (sqlite3_step(stmt) == SQLITE_ROW && sqlite3_column_text(stmt, 0) != nullptr) {
+        existing = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+      }
+      sqlite3_finalize(stmt);
+    }
+
+    std::string sql = "SAVEPOINT sam_search;";
+    for (const char* trigger : {"_ai", "_ad", "_au"}) {
+      sql += "DROP TRIGGER IF EXISTS " + quoteColdIdentifier(config.table + kSearchSuffix + trigger) + ";";
+    }
+    if (existing != create) {
+      sql += "DROP TABLE IF EXISTS " + index + ";" + create + ";" +
+             "INSERT INTO " + index + "(" + index + ") VALUES ('rebuild');";
+    }
+    std::string remove = "INSERT INTO " + index + "(" + index + ", rowid" + columns + ") VALUES ('delete', old.rowid" +
+                         oldValues + ");";
+    std::string insert = "INSERT INTO " + index + "(rowid" + columns + ") VALUES (new.rowid" + newValues + ");";
+    sql += "CREATE TRIGGER " + quoteColdIdentifier(config.table + kSearchSuffix + "_ai") + " AFTER INSERT ON " +
+           table + " BEGIN " + insert + " END;";
+    sql += "CREATE TRIGGER " + quoteColdIdentifier(config.table + kSearchSuffix + "_ad") + " AFTER DELETE ON " +
+           table + " BEGIN " + remove + " END;";
+    // Writes that leave the indexed text alone don't touch the index
+    sql += "CREATE TRIGGER " + quoteColdIdentifier(config.table + kSearchSuffix + "_au") + " AFTER UPDATE ON " +
+           table + " WHEN " + changed + " BEGIN " + remove + insert + " END;";
+    sql += "RELEASE sam_search;";
+
+    char* errMsg = nullptr;
+    if (sqlite3_exec(db, sql.c_str(), nullptr, nullptr, &errMsg) != SQLITE_OK) {
+      error = errMsg != nullptr ? errMsg : sqlite3_errmsg(db);
+      sqlite3_free(errMsg);
+      sqlite3_exec(db, "ROLLBACK TO sam_search; RELEASE sam_search;", nullptr, nullptr, nullptr);
+      return false;
+    }
+    return true;
+  }
+
+  /**
+   * FTS5 keeps an index in shadow tables "<index>_data", "_idx", "_docsize"
+   * and "_config"; of those only _data and _docsize have rowids, so only they
+   * reach the update hook. Their rows are index internals, not app data.
+   */
+  static bool isSearchShadowTable(const char* table) {
+    static constexpr std::string_view kData = "_fts_data";
+    static constexpr std::string_view kDocsize = "_fts_docsize";
+    std::string_view name(table);
+    return (name.size() > kData.size() && name.compare(name.size() - kData.size(), kData.size(), kData) == 0) ||
+           (name.size() > kDocsize.size() &&
+            name.compare(name.size() - kDocsize.size(), kDocsize.size(), kDocsize) == 0);
+  }
+
+  /**
+   * Run a query and serialize all rows as a JSON array into `out`
+   * Shared by queryCold, queryColdBuffer and queryColdAsync; the caller must
+   * have exclusive use of `db`, as for runColdStatement.
+   * @return SQLITE_OK, or the failing result code
+   */
+  int runColdQueryJson(
+      sqlite3* db,
+      const std::string& dbName,
+      const std::string& sql,
+      const std::optional<std::vector<std::variant<nitro::NullType, bool, std::string, double>>>& params,
+      std::string& out) {
+    SAM_LOG_DEBUG(_logger, LogCategory::COLD, "Query Cold storage '", dbName, "': ", sql);
+
+    // Prepare statement
+    sqlite3_stmt* stmt = nullptr;
+    int rc = sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr);
+
+    if (rc != SQLITE_OK) {
+      SAM_LOG_WARN(_logger, LogCategory::COLD, "SQL prepare error: ", sqlite3_errmsg(db));
+      return rc;
+    }
+
+    // Bind parameters if provided
+    bindColdParams(stmt, params);
+
+    // Column names are escaped once per statement, not once per row.
+    // Each prefix already carries its separator: {"a": / ,"b":
+    int columnCount = sqlite3_column_count(stmt);
+    std::vector<std::string> columnKeys;
+    columnKeys.reserve(static_cast<size_t>(columnCount));
+    for (int col = 0; col < columnCount; ++col) {
+      const char* colName = sqlite3_column_name(stmt, col);
+      columnKeys.push_back((col == 0 ? "{" : ",") + JsonWriter::escapeKey(colName ? colName : ""));
+    }
+
+    // Collect results as JSON array
+    JsonWriter json(4096);
+    json.raw('[');
+    bool firstRow = true;
+
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+      if (!firstRow) {
+        json.raw(',');
+      }
+      firstRow = false;
+
+      if (columnCount == 0) {
+        json.raw('{');
+      }
+
+      for (int col = 0; col < columnCount; ++col) {
+        json.raw(columnKeys[static_cast<size_t>(col)]);
+
+        int colType = sqlite3_column_type(stmt, col);
+        switch (colType) {
+          case SQLITE_INTEGER:
+            json.number(static_cast<int64_t>(sqlite3_column_int64(stmt, col)));
+            break;
+          case SQLITE_FLOAT:
+            json.number(sqlite3_column_double(stmt, col));
+            break;
+          case SQLITE_TEXT: {
+            const char* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, col));
+            int length = sqlite3_column_bytes(stmt, col);
+            json.string(std::string_view(text ? text : "", text ? static_cast<size_t>(length) : 0));
+            break;
+          }
+          case SQLITE_BLOB: {
+            // BLOBs are emitted as base64 strings
+            const auto* bytes = static_cast<const uint8_t*>(sqlite3_column_blob(stmt, col));
+            int length = sqlite3_column_bytes(stmt, col);
+            json.base64(bytes, bytes ? static_cast<size_t>(length) : 0);
+            break;
+          }
+          case SQLITE_NULL:
+          default:
+            json.null();
+            break;
+        }
+      }
+
+      json.raw('}');
+    }
+
+    if (rc == SQLITE_INTERRUPT) {
+      SAM_LOG_DEBUG(_logger, LogCategory::COLD, "Query interrupted on Cold storage '", dbName, "'");
+      sqlite3_finalize(stmt);
+      return rc;
+    }
+    if (rc != SQLITE_DONE) {
+      SAM_LOG_WARN(_logger, LogCategory::COLD, "SQL step error: ", sqlite3_errmsg(db));
+      sqlite3_finalize(stmt);
+      return rc;
+    }
+    sqlite3_finalize(stmt);
+
+    json.raw(']');
+    out = json.take();
+    return SQLITE_OK;
+  }
+
+  /**
+   * Read one database's rows for queryColdAcross into `out`, sorted on the
+   * order column and cut to the limit so the merge handles no more than it
+   * keeps. Runs on the database's lane.
+   * @return SQLITE_OK, or the failing result code
+   */
+  int runColdQueryColumns(
+      sqlite3* db,
+      const std::string& dbName,
+      const std::string& sql,
+      const std::optional<std::vector<std::variant<nitro::NullType, bool, std::string, double>>>& params,
+      const ColdAcrossQuery& query,
+      ColdColumns& out) {
+    SAM_LOG_DEBUG(_logger, LogCategory::COLD, "Query Cold storage '", dbName, "' across: ", sql);
+
+    sqlite3_stmt* stmt = nullptr;
+    int rc = sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr);
+    if (rc != SQLITE_OK) {
+      SAM_LOG_WARN(_logger, LogCategory::COLD, "SQL prepare error: ", sqlite3_errmsg(db));
+      return rc;
+    }
+    bindColdParams(stmt, params);
+    rc = out.read(stmt);
+    if (rc != SQLITE_OK) {
+      if (rc != SQLITE_INTERRUPT) {
+        SAM_LOG_WARN(_logger, LogCategory::COLD, "SQL step error: ", sqlite3_errmsg(db));
+      }
+      sqlite3_finalize(stmt);
+      return rc;
+    }
+    sqlite3_finalize(stmt);
+
+    if (query.orderBy.empty()) {
+      out.truncate(query.limit);
+      return SQLITE_OK;
+    }
+    std::optional<size_t> column = out.columnIndex(query.orderBy);
+    if (!column.has_value()) {
+      SAM_LOG_WARN(_logger, LogCategory::COLD, "queryColdAcross: no column '", query.orderBy,
+                   "' in the result from '", dbName, "'");
+      return SQLITE_ERROR;
+    }
+    out.sort(column.value(), query.descending, query.limit);
+    return SQLITE_OK;
+  }
+
+  /**
+   * Called once per part as it settles; the last one merges the parts and
+   * settles the queryColdAcross promise on its own worker thread
+   */
+  void finishColdAcrossPart(const std::shared_ptr<ColdAcrossQuery>& query) {
+    if (query->remaining.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+      return;
+    }
+    using QueryResult = std::variant<nitro::NullType, std::string>;
+    bool failed = query->failed.load(std::memory_order_relaxed);
+    if (query->error) {
+      query->promise->reject(query->error);
+    } else if (failed) {
+      query->promise->resolve(QueryResult(nitro::NullType()));
+    } else {
+      std::vector<const ColdColumns*> parts;
+      parts.reserve(query->parts.size());
+      for (const ColdColumns& part : query->parts) {
+        if (part.names() != query->parts[0].names()) {
+          SAM_LOG_WARN(_logger, LogCategory::COLD, "queryColdAcross: '", query->databases[parts.size()],
+                       "' returned different columns from '", query->databases[0], "'");
+          failed = true;
+          break;
+        }
+        parts.push_back(&part);
+      }
+      if (failed) {
+        query->promise->resolve(QueryResult(nitro::NullType()));
+      } else {
+        std::optional<size_t> column;
+        if (!query->orderBy.empty()) {
+          column = query->parts[0].columnIndex(query->orderBy);
+        }
+        query->promise->resolve(QueryResult(
+            ColdColumns::mergeJson(parts, query->databases, column, query->descending, query->limit)));
+      }
+    }
+
+#if SAM_METRICS
+    _operationStats[kOpQueryColdAcross].latency.record(monotonicNanos() - query->startedNs);
+    if (failed) {
+      _operationStats[kOpQueryColdAcross].errors.fetch_add(1, std::memory_order_relaxed);
+    }
+#endif
+  }
+
+  /**
+   * Shared by addListener and addStorageTrigger; an empty actionType makes a
+   * plain listener
+   */
+  ListenerResult registerListener(const std::string& id,
+                                  const ListenerConfig& config,
+                                  std::string actionType) {
+    OperationTimer timer(_operationStats[kOpAddListener]);
+    auto lock = lockTimed(_dispatchMutex, kOpListenerLockWait);
+
+    // Check if ID already exists
+    if (_listeners.find(id).has_value()) {
+      return timer.fail(ListenerResult(false, "Listener with ID '" + id + "' already exists"));
+    }
+
+    // Check max listeners limit
+    if (_listeners.size() >= _maxListeners) {
+      return timer.fail(ListenerResult(false, "Maximum listener limit reached"));
+    }
+
+    // Validate config
+    if (!config.warm.has_value() && !config.cold.has_value() &&
+        !config.combined.has_value()) {
+      return timer.fail(ListenerResult(false, "At least one of warm, cold, or combined must be specified"));
+    }
+    if (config.options.has_value()) {
+      const ListenerOptions& options = config.options.value();
+      if (!(options.debounceMs.value_or(0) >= 0) || !(options.throttleMs.value_or(0) >= 0)) {
+        return timer.fail(ListenerResult(false, "debounceMs and throttleMs must be non-negative numbers"));
+      }
+    }
+    // There is no "current value" of a table to fire with; read it with queryCold
+    bool fireImmediately = config.options.has_value() && config.options->fireImmediately.value_or(false);
+    if (fireImmediately && ListenerTable::warmConfigOf(config) == nullptr) {
+      SAM_LOG_DEBUG(_logger, LogCategory::LISTENERS, "Ignoring fireImmediately on Cold listener: ", id);
+      fireImmediately = false;
+    }
+
+    uint32_t index = _listeners.insert(id, config, getCurrentTimestamp(), std::move(actionType));
+    syncListenerCounts();
+    if (fireImmediately) {
+      holdImmediateEvents(index);
+    }
+
+    SAM_LOG_DEBUG(_logger, LogCategory::LISTENERS, "Added listener: ", id);
+
+    return ListenerResult(true, std::nullopt);
+  }
+
+  /**
+   * What collectWarmEvents/collectColdEvents do with a matched change
+   */
+  enum class Admission { Fire, Hold, Drop };
+
+  /**
+   * Apply a listener's AND logic, debounce and throttle to a change that
+   * matched it. A held change replaces the one already held, so a burst
+   * delivers its latest change: debounce holds it until `debounceMs` after
+   * the last change, throttle until the window reopens. Firing now updates
+   * the trigger stats. Caller must hold _dispatchMutex.
+   *
+   * @param index Dense index of the listener in _listeners
+   * @param source Side of a combined listener the change came from
+   * @param currentTime Change timestamp in milliseconds
+   * @param holdUntil Set to the delivery time when Hold is returned
+   */
+  Admission admitChange(uint32_t index, ChangeSource source, double currentTime, double& holdUntil) {
+    uint16_t& flags = _listeners.flags(index);
+    if (flags & ListenerTable::kPaused) {
+      return Admission::Drop;
+    }
+
+    // AND fires once both sides have changed since the last callback
+    if (flags & ListenerTable::kAndLogic) {
+      uint16_t own = source == ChangeSource::WARM ? ListenerTable::kWarmSideSeen : ListenerTable::kColdSideSeen;
+      uint16_t other = source == ChangeSource::WARM ? ListenerTable::kColdSideSeen : ListenerTable::kWarmSideSeen;
+      if (!(flags & other)) {
+        flags |= own;
+        return Admission::Drop;
+      }
+      flags &= static_cast<uint16_t>(~(ListenerTable::kWarmSideSeen | ListenerTable::kColdSideSeen));
+    }
+
+    if (flags & ListenerTable::kHasDebounce) {
+      holdUntil = currentTime + _listeners.debounceMs(index);
+      return Admission::Hold;
+    }
+    if (flags & ListenerTable::kHasThrottle) {
+      double nextAllowedTrigger = _listeners.nextAllowedTrigger(index);
+      // Within the window (0 = no window yet), or a trailing change already waiting
+      if (currentTime < nextAllowedTrigger || (flags & ListenerTable::kPendingEvent)) {
+        holdUntil = std::max(currentTime, nextAllowedTrigger);
+        SAM_LOG_DEBUG(_logger, LogCategory::DISPATCH, "Listener ", _listeners.id(index), " throttled, wait ",
+                      static_cast<int>(holdUntil - currentTime), "ms");
+        return Admission::Hold;
+      }
+    }
+
+    markFired(index, currentTime);
+    return Admission::Fire;
+  }
+
+  /**
+   * Record that a listener fired: trigger stats and the next throttle window
+   */
+  void markFired(uint32_t index, double currentTime) {
+    _listeners.triggerCount(index)++;
+    _listeners.lastTriggeredRaw(index) = currentTime;
+    if (_listeners.flags(index) & ListenerTable::kHasThrottle) {
+      _listeners.nextAllowedTrigger(index) = currentTime + _listeners.throttleMs(index);
+    }
+  }
+
+  /**
+   * The held change of a listener, replacing whatever it held before, due
+   * at `due`. Caller fills in the change. Caller must hold _dispatchMutex.
+   */
+  HeldEvent& holdChange(uint32_t index, double due) {
+    ListenerHandle handle = _listeners.handleOf(index);
+    HeldEvent& held = _heldChanges[handle.slot];
+    held.handle = handle;
+    held.due = due;
+    _listeners.flags(index) |= ListenerTable::kPendingEvent;
+    if (due < _heldDue.load(std::memory_order_relaxed)) {
+      _heldDue.store(due, std::memory_order_seq_cst);
+    }
+    return held;
+  }
+
+  /**
+   * Queue one SET event per key a new Warm listener matches, carrying the
+   * current value, for the dispatcher to deliver. Expired and absent keys
+   * are skipped. Caller must hold _dispatchMutex; _mutex is taken here.
+   */
+  void holdImmediateEvents(uint32_t index) {
+    const WarmListenerConfig* warm = ListenerTable::warmConfigOf(_listeners.cold(index).config);
+    std::string id = warm->instanceId.value_or("default");
+    ListenerHandle handle = _listeners.handleOf(index);
+    double now = getCurrentTimestamp();
+    size_t held = _immediateEvents.size();
+    {
+      auto storageLock = lockTimed(_mutex, kOpStorageLockWait);
+      auto instance = _warmInstances.find(id);
+      if (instance == _warmInstances.end()) {
+        return;
+      }
+      mmkv::MMKV* storage = useWarmInstance(instance->second);
+      bool keysOnly = _listeners.flags(index) & ListenerTable::kWarmKeysOnly;
+      std::vector<std::string> keys = keysOnly ? warm->keys.value() : storage->allKeys();
+      std::string scratch;
+      for (const std::string& key : keys) {
+        if (expireWarmKeyIfDue(id, instance->second, key)) {
+          continue;
+        }
+        ValueView value = readWarmValue(storage, key, scratch);
+        if (value.kind == ValueView::Kind::Absent ||
+            !matchesWarmConfig(*warm, key, keysOnly, ValueView(), value)) {
+          continue;
+        }
+        HeldEvent& event = _immediateEvents.emplace_back();
+        event.handle = handle;
+        event.source = ChangeSource::WARM;
+        event.operation = ChangeOperation::SET;
+        event.name = key;
+        event.newValue.assign(value);
+        event.timestamp = now;
+        event.due = now;
+      }
+    }
+    if (_immediateEvents.size() > held) {
+      _heldDue.store(now, std::memory_order_seq_cst);
+      wakeDispatcher();
+    }
+  }
+
+  // =========================================================================
+  // Change Dispatch Helpers
+  // =========================================================================
+
+  /**
+   * Read a Warm value with the same type detection getWarm uses.
+   * String results are written to `scratch` and viewed by the return value.
+   */
+  ValueView readWarmValue(mmkv::MMKV* storage, const std::string& key, std::string& scratch) const {
+    ValueView value;
+
+    // Check if key exists
+    if (!storage->containsKey(key)) {
+      return value;
+    }
+
+    // MMKV doesn't store type info, so we try each type in order
+    // First try string (most common for JSON data)
+    if (storage->getString(key, scratch)) {
+      return parseWarmString(scratch);
+    }
+
+    // Try bool
+    bool hasValue = false;
+    bool boolValue = storage->getBool(key, false, &hasValue);
+    if (hasValue) {
+      value.kind = ValueView::Kind::Bool;
+      value.boolValue = boolValue;
+      return value;
+    }
+
+    // Try double
+    double doubleValue = storage->getDouble(key, 0.0, &hasValue);
+    if (hasValue) {
+      value.kind = ValueView::Kind::Number;
+      value.numberValue = doubleValue;
+      return value;
+    }
+
+    value.kind = ValueView::Kind::Null;
+    return value;
+  }
+
+  /**
+   * Interpret a stored Warm string the way getWarm returns it:
+   * "true"/"false" become booleans and fully numeric strings become numbers
+   */
+  static ValueView parseWarmString(std::string_view text) {
+    ValueView value;
+    if (text == "true" || text == "false") {
+      value.kind = ValueView::Kind::Bool;
+      value.boolValue = text == "true";
+      return value;
+    }
+    double number = 0;
+    if (parseNumber(text, number)) {
+      value.kind = ValueView::Kind::Number;
+      value.numberValue = number;
+      return value;
+    }
+    value.kind = ValueView::Kind::String;
+    value.stringValue = text;
+    return value;
+  }
+
+  static bool parseNumber(std::string_view text, double& out) {
+    if (text.empty() || text.size() > 64) {
+      return false;
+    }
+    char buffer[65];
+    std::memcpy(buffer, text.data(), text.size());
+    buffer[text.size()] = '\0';
+    char* end = nullptr;
+    out = std::strtod(buffer, &end);
+    return end == buffer + text.size();
+  }
+
+  static ValueView valueViewOf(const std::variant<bool, std::string, double>& value) {
+    if (std::holds_alternative<std::string>(value)) {
+      return parseWarmString(std::get<std::string>(value));
+    }
+    ValueView view;
+    if (std::holds_alternative<bool>(value)) {
+      view.kind = ValueView::Kind::Bool;
+      view.boolValue = std::get<bool>(value);
+    } else {
+      view.kind = ValueView::Kind::Number;
+      view.numberValue = std::get<double>(value);
+    }
+    return view;
+  }
+
+  static ValueView valueViewOfColumn(sqlite3_stmt* stmt, int col) {
+    ValueView value;
+    switch (sqlite3_column_type(stmt, col)) {
+      case SQLITE_INTEGER:
+      case SQLITE_FLOAT:
+        value.kind = ValueView::Kind::Number;
+        value.numberValue = sqlite3_column_double(stmt, col);
+        break;
+      case SQLITE_TEXT:
+      case SQLITE_BLOB: {
+        const char* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, col));
+        value.kind = ValueView::Kind::String;
+        value.stringValue = std::string_view(text ? text : "", static_cast<size_t>(sqlite3_column_bytes(stmt, col)));
+        break;
+      }
+      default:
+        value.kind = ValueView::Kind::Null;
+        break;
+    }
+    return value;
+  }
+
+  static std::optional<std::variant<nitro::NullType, bool, std::string, double>> toEventValue(const ValueView& value) {
+    switch (value.kind) {
+      case ValueView::Kind::Absent: return std::nullopt;
+      case ValueView::Kind::Bool: return value.boolValue;
+      case ValueView::Kind::Number: return value.numberValue;
+      case ValueView::Kind::String: return std::string(value.stringValue);
+      default: return nitro::NullType();
+    }
+  }
+
+  template <typename T>
+  void trackGrowth(const std::vector<T>& buffer) {
+#if SAM_DISPATCH_ALLOC_STATS
+    if (buffer.size() == buffer.capacity()) {
+      _dispatchStats.bufferGrowths++;
+    }
+#else
+    (void)buffer;
+#endif
+  }
+
+  /**
+   * Glob match supporting '*' (any run) and '?' (any single character)
+   */
+  static bool globMatch(std::string_view pattern, std::string_view text) {
+    size_t p = 0, t = 0, starP = std::string_view::npos, starT = 0;
+    while (t < text.size()) {
+      if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == text[t])) {
+        ++p;
+        ++t;
+      } else if (p < pattern.size() && pattern[p] == '*') {
+        starP = p++;
+        starT = t;
+      } else if (starP != std::string_view::npos) {
+        p = starP + 1;
+        t = ++starT;
+      } else {
+        return false;
+      }
+    }
+    while (p < pattern.size() && pattern[p] == '*') {
+      ++p;
+    }
+    return p == pattern.size();
+  }
+
+  static bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) {
+      return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+      if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i]))) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static bool sameValue(const ValueView& a, const ValueView& b) {
+    if (a.kind != b.kind) {
+      return false;
+    }
+    switch (a.kind) {
+      case ValueView::Kind::Bool: return a.boolValue == b.boolValue;
+      case ValueView::Kind::Number: return a.numberValue == b.numberValue;
+      case ValueView::Kind::String: return a.stringValue == b.stringValue;
+      default: return true;
+    }
+  }
+
+  static bool toNumber(const ValueView& value, double& out) {
+    if (value.kind == ValueView::Kind::Number) {
+      out = value.numberValue;
+      return true;
+    }
+    return value.kind == ValueView::Kind::String && parseNumber(value.stringValue, out);
+  }
+
+  static bool equalsConditionValue(const ValueView& value, const std::variant<bool, std::string, double>& expected) {
+    if (std::holds_alternative<bool>(expected)) {
+      return value.kind == ValueView::Kind::Bool && value.boolValue == std::get<bool>(expected);
+    }
+    if (std::holds_alternative<double>(expected)) {
+      return value.kind == ValueView::Kind::Number && value.numberValue == std::get<double>(expected);
+    }
+    return value.kind == ValueView::Kind::String && value.stringValue == std::get<std::string>(expected);
+  }
+
+  static bool inConditionValues(const ValueView& value, const Condition& condition) {
+    if (!condition.values.has_value()) {
+      return false;
+    }
+    for (const auto& candidate : condition.values.value()) {
+      if (std::holds_alternative<double>(candidate)) {
+        if (value.kind == ValueView::Kind::Number && value.numberValue == std::get<double>(candidate)) {
+          return true;
+        }
+      } else if (value.kind == ValueView::Kind::String && value.stringValue == std::get<std::string>(candidate)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * Evaluate one condition against a value (see docs/CONDITIONS.md)
+   * @param previous Value before the change, used by 'changed'
+   */
+  bool evaluateCondition(const Condition& condition, const ValueView& value, const ValueView& previous) {
+    bool present = value.kind != ValueView::Kind::Absent && value.kind != ValueView::Kind::Null;
+    switch (condition.type) {
+      case ConditionType::EXISTS:
+        return present;
+      case ConditionType::NOTEXISTS:
+        return !present;
+      case ConditionType::EQUALS:
+        return condition.value.has_value() && equalsConditionValue(value, condition.value.value());
+      case ConditionType::NOTEQUALS:
+        return !condition.value.has_value() || !equalsConditionValue(value, condition.value.value());
+      case ConditionType::CONTAINS:
+      case ConditionType::STARTSWITH:
+      case ConditionType::ENDSWITH: {
+        if (value.kind != ValueView::Kind::String || !condition.value.has_value() ||
+            !std::holds_alternative<std::string>(condition.value.value())) {
+          return false;
+        }
+        std::string_view text = value.stringValue;
+        const std::string& needle = std::get<std::string>(condition.value.value());
+        if (condition.type == ConditionType::CONTAINS) {
+          return text.find(needle) != std::string_view::npos;
+        }
+        if (needle.size() > text.size()) {
+          return false;
+        }
+        return condition.type == ConditionType::STARTSWITH
+            ? text.compare(0, needle.size(), needle) == 0
+            : text.compare(text.size() - needle.size(), needle.size(), needle) == 0;
+      }
+      case ConditionType::MATCHESREGEX: {
+        if (value.kind != ValueView::Kind::String) {
+          return false;
+        }
+        const std::regex* regex = compiledRegex(condition);
+        return regex != nullptr &&
+            std::regex_search(value.stringValue.begin(), value.stringValue.end(), *regex);
+      }
+      case ConditionType::GREATERTHAN:
+      case ConditionType::LESSTHAN:
+      case ConditionType::GREATERTHANOREQUAL:
+      case ConditionType::LESSTHANOREQUAL: {
+        double actual = 0;
+        if (!toNumber(value, actual) || !condition.value.has_value() ||
+            !std::holds_alternative<double>(condition.value.value())) {
+          return false;
+        }
+        double expected = std::get<double>(condition.value.value());
+        switch (condition.type) {
+          case ConditionType::GREATERTHAN: return actual > expected;
+          case ConditionType::LESSTHAN: return actual < expected;
+          case ConditionType::GREATERTHANOREQUAL: return actual >= expected;
+          default: return actual <= expected;
+        }
+      }
+      case ConditionType::CHANGED:
+        return !sameValue(value, previous);
+      case ConditionType::IN:
+        return inConditionValues(value, condition);
+      case ConditionType::NOTIN:
+        return !inConditionValues(value, condition);
+    }
+    return false;
+  }
+
+  /**
+   * Compiled regex for a matchesRegex condition, cached by pattern.
+   * Returns nullptr for a missing or invalid pattern.
+   */
+  const std::regex* compiledRegex(const Condition& condition) {
+    std::string pattern;
+    if (condition.regex.has_value()) {
+      pattern = condition.regex.value();
+    } else if (condition.value.has_value() && std::holds_alternative<std::string>(condition.value.value())) {
+      pattern = std::get<std::string>(condition.value.value());
+    } else {
+      return nullptr;
+    }
+    auto it = _regexCache.find(pattern);
+    if (it == _regexCache.end()) {
+      try {
+        it = _regexCache.emplace(pattern, std::regex(pattern, std::regex::ECMAScript)).first;
+      } catch (const std::regex_error&) {
+        return nullptr;
+      }
+    }
+    return &it->second;
+  }
+
+  /**
+   * Cold half of Warm matching, run after the hot instance/key checks in
+   * collectWarmEvents. `keyMatched` says whether the exact-key filter hit.
+   */
+  bool matchesWarmConfig(const WarmListenerConfig& warm, std::string_view key, bool keyMatched,
+                         const ValueView& oldValue, const ValueView& newValue) {
+    // No keys and no patterns means "every key in this instance"
+    bool hasKeys = warm.keys.has_value() && !warm.keys->empty();
+    bool hasPatterns = warm.patterns.has_value() && !warm.patterns->empty();
+    if (!keyMatched && (hasKeys || hasPatterns)) {
+      if (hasPatterns) {
+        for (const auto& pattern : warm.patterns.value()) {
+          if (globMatch(pattern, key)) {
+            keyMatched = true;
+            break;
+          }
+        }
+      }
+      if (!keyMatched) {
+        return false;
+      }
+    }
+
+    // All conditions must pass
+    if (warm.conditions.has_value()) {
+      for (const auto& condition : warm.conditions.value()) {
+        if (!evaluateCondition(condition, newValue, oldValue)) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  static bool matchesColdConfig(const ColdListenerConfig& cold, const std::string& databaseName,
+                                std::string_view table, ColdOperation operation) {
+    // No database means "any database"
+    if (cold.databaseName.has_value() && cold.databaseName.value() != databaseName) {
+      return false;
+    }
+    // SQLite table names are case-insensitive
+    if (cold.table.has_value() && !equalsIgnoreCase(cold.table.value(), table)) {
+      return false;
+    }
+    if (cold.operations.has_value() && !cold.operations->empty()) {
+      bool found = false;
+      for (auto op : cold.operations.value()) {
+        if (op == operation) {
+          found = true;
+          break;
+        }
+      }
+      if (!found) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void pushPendingEvent(PendingChangeEvent* event) {
+    trackGrowth(_pendingEvents);
+    _pendingEvents.push_back(event);
+#if SAM_DISPATCH_ALLOC_STATS
+    _dispatchStats.eventsBuilt++;
+#endif
+  }
+
+  // -------------------------------------------------------------------------
+  // Change capture (writer side, caller holds _mutex)
+  // -------------------------------------------------------------------------
+
+  /**
+   * Write a Warm value and queue its change record. Single write path shared
+   * by setWarm and the native network keys. Caller must hold _mutex.
+   */
+  bool writeWarmValue(const std::string& instanceId, mmkv::MMKV* storage, const std::string& key,
+                      const std::variant<bool, std::string, double>& value) {
+    // Capture the previous value only when someone can observe it
+    bool observed = _warmListenerCount.load(std::memory_order_relaxed) > 0;
+    ValueView oldValue;
+    if (observed) {
+      oldValue = readWarmValue(storage, key, _scratchValue);
+    }
+
+    // Set value based on type
+    bool success = false;
+    if (std::holds_alternative<bool>(value)) {
+      success = storage->set(std::get<bool>(value), key);
+    } else if (std::holds_alternative<std::string>(value)) {
+      success = storage->set(std::get<std::string>(value), key);
+    } else if (std::holds_alternative<double>(value)) {
+      success = storage->set(std::get<double>(value), key);
+    }
+
+    _warmWrites.fetch_add(1, std::memory_order_relaxed);
+    if (success && observed) {
+      enqueueWarmChange(instanceId, key, ChangeOperation::SET, oldValue, valueViewOf(value));
+    }
+    if (success && _multiProcessWarm) {
+      syncWarmSnapshot(instanceId, storage, key);
+    }
+    return success;
+  }
+
+  /**
+   * Record this process's own write in a multi-process instance's snapshot,
+   * so the next diff doesn't report it as another process's. Caller must
+   * hold _mutex.
+   */
+  void syncWarmSnapshot(const std::string& instanceId, mmkv::MMKV* storage, const std::string& key) {
+    auto instance = _warmInstances.find(instanceId);
+    if (instance == _warmInstances.end() || instance->second.snapshot == nullptr) {
+      return;
+    }
+    WarmSnapshot& snapshot = *instance->second.snapshot;
+    ValueView value = readWarmValue(storage, key, _scratchValue);
+    if (value.kind == ValueView::Kind::Absent) {
+      snapshot.erase(key);
+    } else {
+      snapshot.set(key, value);
+    }
+  }
+
+  void enqueueWarmChange(const std::string& instanceId, const std::string& key, ChangeOperation operation,
+                         const ValueView& oldValue, const ValueView& newValue) {
+    ChangeRecord record;
+    record.source = ChangeSource::WARM;
+    record.operation = operation;
+    record.scope = instanceId;
+    record.name = key;
+    record.oldValue.assign(oldValue);
+    record.newValue.assign(newValue);
+    record.timestamp = getCurrentTimestamp();
+    enqueueChange(std::move(record));
+  }
+
+  /**
+   * Hand the rows recorded by the update hook for the last statement to the
+   * dispatcher, or drop them if the statement failed (and was rolled back).
+   * `changes` is _pendingColdChanges (caller holds _mutex) or an async
+   * lane's list (caller is the lane's job).
+   */
+  void enqueueColdChanges(const std::string& dbName, std::vector<ColdChange>& changes, bool succeeded) {
+    if (succeeded) {
+      double now = getCurrentTimestamp();
+      for (ColdChange& change : changes) {
+        ChangeRecord record;
+        record.source = ChangeSource::COLD;
+        record.operation = change.operation == SQLITE_INSERT ? ChangeOperation::INSERT
+            : change.operation == SQLITE_UPDATE ? ChangeOperation::UPDATE
+            : ChangeOperation::DELETE;
+        record.scope = dbName;
+        record.name = std::move(change.table);
+        record.rowId = change.rowId;
+        record.timestamp = now;
+        enqueueChange(std::move(record));
+      }
+    }
+    changes.clear();
+  }
+
+  /**
+   * sqlite3_update_hook callback. Only records the change: running queries on
+   * the connection from inside the hook is not allowed, and the statement may
+   * still fail, so records are queued once it has finished.
+   */
+  static void onColdUpdate(void* context, int operation, const char* /* dbName */,
+                           const char* table, sqlite3_int64 rowId) {
+    auto* self = static_cast<HybridSideFx*>(context);
+    if (self->_coldListenerCount.load(std::memory_order_relaxed) == 0 ||
+        (table != nullptr && isSearchShadowTable(table))) {
+      return;
+    }
+    self->_pendingColdChanges.push_back(ColdChange{operation, table ? table : "", rowId});
+  }
+
+  // -------------------------------------------------------------------------
+  // Async Cold lanes
+  // -------------------------------------------------------------------------
+
+  static size_t defaultColdWorkerCount() {
+    // Lanes are per database, so a few threads cover any realistic app
+    size_t cores = std::thread::hardware_concurrency();
+    return cores / 2 < 2 ? 2 : cores / 2 > 4 ? 4 : cores / 2;
+  }
+
+  static bool isInMemoryPath(const std::string& path) {
+    return path.empty() || path == ":memory:" || path.rfind("file::memory:", 0) == 0 ||
+           path.find("mode=memory") != std::string::npos;
+  }
+
+  /**
+   * Queue `run` on the database's lane and settle `promise` with its result.
+   * `run(db, rc)` is called on a worker thread with the lane's connection
+   * (nullptr if it can't be opened) and sets `rc` to SQLITE_OK on success.
+   * The promise is rejected instead if the request is cancelled before it
+   * finishes, or the object is destroyed before it starts.
+   * @return false, without queueing, if the database was never initialized
+   */
+  template <typename T, typename Run>
+  bool submitColdJob(const std::string& dbName, const std::optional<double>& cancelToken, Operation op,
+                     const std::shared_ptr<Promise<T>>& promise, Run&& run) {
+    ColdLane* lane;
+    {
+      auto lock = lockTimed(_mutex, kOpStorageLockWait);
+      auto pathIt = _coldDatabasePaths.find(dbName);
+      if (pathIt == _coldDatabasePaths.end()) {
+        return false;
+      }
+      std::unique_ptr<ColdLane>& slot = _coldLanes[dbName];
+      if (!slot) {
+        slot = std::make_unique<ColdLane>();
+        slot->owner = this;
+        slot->dbName = dbName;
+        slot->path = pathIt->second;
+        slot->tuning = _coldTunings[dbName];
+        slot->shared = isInMemoryPath(pathIt->second);
+        slot->migrated = _coldMigrations[dbName].empty();
+      }
+      lane = slot.get();
+    }
+
+    std::shared_ptr<ColdCancelState> cancel;
+    if (cancelToken.has_value()) {
+      std::lock_guard<std::mutex> lock(_coldCancelMutex);
+      auto token = static_cast<int64_t>(cancelToken.value());
+      std::shared_ptr<ColdCancelState>& entry = _coldCancelTokens[token];
+      if (!entry) {
+        entry = std::make_shared<ColdCancelState>();
+        entry->token = token;
+      }
+      entry->jobs++;
+      cancel = entry;
+    }
+
+    [[maybe_unused]] uint64_t submittedNs = SAM_METRICS ? monotonicNanos() : 0;
+    _coldWorkers.submit(dbName, [this, lane, cancel, op, submittedNs, promise,
+                                 run = std::forward<Run>(run)](bool shuttingDown) mutable {
+      int rc = SQLITE_OK;
+      bool cancelled = shuttingDown || (cancel && cancel->cancelled.load(std::memory_order_acquire));
+      std::optional<T> result;
+      if (!cancelled) {
+        if (lane->shared) {
+          // In-memory databases exist only on the main connection
+          auto lock = lockTimed(_mutex, kOpStorageLockWait);
+          sqlite3* db = coldDatabase(lane->dbName);
+          setColdCancelCheck(db, cancel.get());
+          result.emplace(run(db, rc));
+          setColdCancelCheck(db, nullptr);
+          enqueueColdChanges(lane->dbName, _pendingColdChanges, rc == SQLITE_OK);
+        } else {
+          sqlite3* db = openColdLane(*lane);
+          setColdCancelCheck(db, cancel.get());
+          result.emplace(run(db, rc));
+          setColdCancelCheck(db, nullptr);
+          enqueueColdChanges(lane->dbName, lane->pendingChanges, rc == SQLITE_OK);
+          lane->memoryBytes.store(coldConnectionBytes(db), std::memory_order_relaxed);
+        }
+        // A statement that completed before the cancel landed keeps its result
+        cancelled = rc == SQLITE_INTERRUPT && cancel && cancel->cancelled.load(std::memory_order_acquire);
+      }
+
+      if (cancelled) {
+        promise->reject(std::make_exception_ptr(std::runtime_error(
+            shuttingDown ? "Cold request abandoned: SideFx was destroyed" : "Cold request cancelled")));
+      } else {
+        promise->resolve(std::move(result.value()));
+      }
+      releaseColdCancelState(cancel);
+
+#if SAM_METRICS
+      _operationStats[op].latency.record(monotonicNanos() - submittedNs);
+      if (cancelled || rc != SQLITE_OK) {
+        _operationStats[op].errors.fetch_add(1, std::memory_order_relaxed);
+      }
+#else
+      (void)op;
+#endif
+    });
+    return true;
+  }
+
+  /**
+   * The lane's own connection, opened by its first job. Lane jobs only.
+   */
+  sqlite3* openColdLane(ColdLane& lane) {
+    if (lane.db != nullptr) {
+      return lane.db;
+    }
+    if (!lane.migrated) {
+      // With lazy Cold the main connection may not be open yet; it runs the
+      // migrations before this connection reads the schema
+      auto lock = lockTimed(_mutex, kOpStorageLockWait);
+      if (coldDatabase(lane.dbName) == nullptr) {
+        return nullptr;
+      }
+      lane.migrated = true;
+    }
+    sqlite3* db = nullptr;
+    if (sqlite3_open(lane.path.c_str(), &db) != SQLITE_OK) {
+      SAM_LOG_WARN(_logger, LogCategory::COLD,
+                   "Failed to open async connection for Cold storage '", lane.dbName, "': ", sqlite3_errmsg(db));
+      sqlite3_close(db);
+      return nullptr;
+    }
+    std::string tuningError;
+    if (!lane.tuning.apply(db, tuningError)) {
+      SAM_LOG_WARN(_logger, LogCategory::COLD,
+                   "Failed to configure async connection for Cold storage '", lane.dbName, "': ", tuningError);
+    }
+    sqlite3_wal_autocheckpoint(db, walAutocheckpointPages(lane.tuning));
+    sqlite3_update_hook(db, &HybridSideFx::onColdLaneUpdate, &lane);
+    lane.db = db;
+    SAM_LOG_DEBUG(_logger, LogCategory::COLD, "Opened async connection for Cold storage '", lane.dbName, "'");
+    return db;
+  }
+
+  /**
+   * Install (or with nullptr, remove) the cancellation check on `db`
+   */
+  static void setColdCancelCheck(sqlite3* db, ColdCancelState* cancel) {
+    if (db == nullptr) {
+      return;
+    }
+    if (cancel != nullptr) {
+      sqlite3_progress_handler(db, kColdProgressInterval, &HybridSideFx::onColdProgress, cancel);
+    } else {
+      sqlite3_progress_handler(db, 0, nullptr, nullptr);
+    }
+  }
+
+  /**
+   * sqlite3_progress_handler callback: non-zero aborts the running statement
+   * with SQLITE_INTERRUPT
+   */
+  static int onColdProgress(void* context) {
+    return static_cast<ColdCancelState*>(context)->cancelled.load(std::memory_order_relaxed) ? 1 : 0;
+  }
+
+  /**
+   * sqlite3_update_hook callback for lane connections; see onColdUpdate
+   */
+  static void onColdLaneUpdate(void* context, int operation, const char* /* dbName */,
+                               const char* table, sqlite3_int64 rowId) {
+    auto* lane = static_cast<ColdLane*>(context);
+    if (lane->owner->_coldListenerCount.load(std::memory_order_relaxed) == 0 ||
+        (table != nullptr && isSearchShadowTable(table))) {
+      return;
+    }
+    lane->pendingChanges.push_back(ColdChange{operation, table ? table : "", rowId});
+  }
+
+  /**
+   * Drop a finished job's hold on its token; the token is forgotten once
+   * nothing submitted under it is left
+   */
+  void releaseColdCancelState(const std::shared_ptr<ColdCancelState>& cancel) {
+    if (!cancel) {
       return;
     }
+    std::lock_guard<std::mutex> lock(_coldCancelMutex);
+    if (--cancel->jobs == 0) {
+      auto it = _coldCancelTokens.find(cancel->token);
+      if (it != _coldCancelTokens.end() && it->second == cancel) {
+        _coldCancelTokens.erase(it);
+      }
+    }
+  }
 
-    // Update latency and quality
-    _lastPingLatencyMs = latencyMs;
-    _internetQuality = latencyToQuality(latencyMs);
+  void enqueueChange(ChangeRecord&& record) {
+    std::call_once(_dispatcherStarted, [this]() {
+      _dispatcher = std::thread([this]() { runDispatcher(); });
+    });
+#if SAM_METRICS
+    record.enqueuedNs = monotonicNanos();
+#endif
+    _changesEnqueued.fetch_add(1, std::memory_order_acq_rel);
+    _changeQueue.push(std::move(record));
+    wakeDispatcher();
+  }
 
-    // A successful network call means internet is reachable!
-    // This is crucial for passive mode to work correctly.
-    _internetReachable = true;
-    _isCheckingOfflineRecovery = false;  // No longer need to check for recovery
+  /**
+   * Acquire `mutex`, recording how long the caller waited for it
+   */
+  std::unique_lock<std::mutex> lockTimed(std::mutex& mutex, [[maybe_unused]] Operation wait) {
+#if SAM_METRICS
+    if (mutex.try_lock()) {
+      _operationStats[wait].latency.record(0);
+      return std::unique_lock<std::mutex>(mutex, std::adopt_lock);
+    }
+    uint64_t start = monotonicNanos();
+    std::unique_lock<std::mutex> lock(mutex);
+    _operationStats[wait].latency.record(monotonicNanos() - start);
+    return lock;
+#else
+    return std::unique_lock<std::mutex>(mutex);
+#endif
+  }
 
-    if (_debugMode) {
-      logDebug("Reported network latency: " + std::to_string((int)latencyMs) + "ms, quality: " + _internetQuality + ", reachable: true");
+  /**
+   * Summarize every operation histogram, optionally starting a new interval
+   */
+  SAMMetrics collectMetrics(bool reset) {
+    uint64_t now = monotonicNanos();
+    uint64_t since = reset ? _metricsIntervalStart.exchange(now, std::memory_order_relaxed)
+                           : _metricsIntervalStart.load(std::memory_order_relaxed);
+
+    std::vector<OperationMetrics> operations;
+    operations.reserve(kOperationCount);
+    for (size_t op = 0; op < kOperationCount; ++op) {
+      OperationStats& stats = _operationStats[op];
+      LatencyHistogram::Summary summary = stats.latency.summarize(reset);
+      uint64_t errors = reset ? stats.errors.exchange(0, std::memory_order_relaxed)
+                              : stats.errors.load(std::memory_order_relaxed);
+      auto us = [](uint64_t ns) { return static_cast<double>(ns) / 1000.0; };
+      operations.emplace_back(
+          std::string(kOperationNames[op]),
+          static_cast<double>(summary.count),
+          static_cast<double>(errors),
+          summary.meanNs / 1000.0,
+          us(summary.minNs),
+          us(summary.maxNs),
+          us(summary.p50Ns),
+          us(summary.p90Ns),
+          us(summary.p99Ns),
+          us(summary.p999Ns));
     }
 
-    // Update Warm storage with the new quality
-    updateInternetQualityWarmKeys();
+    uint64_t enqueued = _changesEnqueued.load(std::memory_order_acquire);
+    uint64_t dispatched = _changesDispatched.load(std::memory_order_acquire);
+    uint64_t delivered = reset ? _eventsDelivered.exchange(0, std::memory_order_relaxed)
+                               : _eventsDelivered.load(std::memory_order_relaxed);
+    return SAMMetrics(
+        SAM_METRICS != 0,
+        static_cast<double>(now - since) / 1e6,
+        std::move(operations),
+        static_cast<double>(delivered),
+        static_cast<double>(enqueued > dispatched ? enqueued - dispatched : 0));
   }
 
-  void reportNetworkFailure() override {
-    std::lock_guard<std::mutex> lock(_mutex);
+  /**
+   * Mirror listener counts for writers. Caller must hold _dispatchMutex.
+   */
+  void syncListenerCounts() {
+    _warmListenerCount.store(_listeners.warmCount(), std::memory_order_relaxed);
+    _coldListenerCount.store(_listeners.coldCount(), std::memory_order_relaxed);
+  }
 
-    // A network failure means internet may be unreachable
-    _internetReachable = false;
-    _internetQuality = "offline";
-    _lastPingLatencyMs = -1;
-    _isCheckingOfflineRecovery = true;  // Start checking for recovery
+  // -------------------------------------------------------------------------
+  // Dispatcher thread
+  // -------------------------------------------------------------------------
 
-    if (_debugMode) {
-      logDebug("Reported network failure - starting offline recovery checks");
-    }
+  /**
+   * Drain the queue in batches: match each record against listeners, then
+   * deliver the whole batch in one handler call outside _dispatchMutex.
+   */
+  void runDispatcher() {
+    ChangeRecord record;
+    while (true) {
+      if (_heldDue.load(std::memory_order_seq_cst) <= getCurrentTimestamp()) {
+        flushHeldEvents();
+      }
+      if (!_changeQueue.pop(record)) {
+        if (_dispatcherStop.load(std::memory_order_acquire)) {
+          return;
+        }
+        parkDispatcher();
+        continue;
+      }
 
-    // Update Warm storage
-    updateInternetQualityWarmKeys();
+      [[maybe_unused]] uint64_t batchStart = SAM_METRICS ? monotonicNanos() : 0;
+      auto lock = lockTimed(_dispatchMutex, kOpListenerLockWait);
+      uint64_t processed = 0;
+      _batchEnqueuedNs.clear();
+      do {
+        _batchEnqueuedNs.push_back(record.enqueuedNs);
+        if (record.kind == ChangeRecord::Kind::MFETransition) {
+          collectMFETransition(record);
+        } else if (record.source == ChangeSource::WARM) {
+          collectWarmEvents(record);
+        } else {
+          collectColdEvents(record);
+        }
+        processed++;
+      } while (processed < kMaxDispatchBatch && _changeQueue.pop(record));
+      ChangeDelivery delivery = takeChangeEvents();
+      lock.unlock();
+      deliverChangeEvents(delivery);
+
+#if SAM_METRICS
+      uint64_t delivered = monotonicNanos();
+      _operationStats[kOpDispatchBatch].latency.record(delivered - batchStart);
+      for (uint64_t enqueuedNs : _batchEnqueuedNs) {
+        _operationStats[kOpDispatchLatency].latency.record(delivered - enqueuedNs);
+      }
+#endif
+      _eventsDelivered.fetch_add(delivery.events.size(), std::memory_order_relaxed);
+      _changesDispatched.fetch_add(processed, std::memory_order_acq_rel);
+      {
+        std::lock_guard<std::mutex> parkLock(_parkMutex);
+      }
+      _idleCv.notify_all();
+    }
   }
 
-  void setPingEndpoints(const std::vector<std::string>& endpoints) override {
-    std::lock_guard<std::mutex> lock(_mutex);
+  void parkDispatcher() {
+    std::unique_lock<std::mutex> lock(_parkMutex);
+    _dispatcherParked.store(true, std::memory_order_seq_cst);
+    // Re-check after publishing the flag: a push that raced with us either
+    // is visible now or will see the flag and wake us
+    double heldDue = _heldDue.load(std::memory_order_seq_cst);
+    double now = getCurrentTimestamp();
+    if (!_changeQueue.empty() || _dispatcherStop.load(std::memory_order_seq_cst) || heldDue <= now) {
+      _dispatcherParked.store(false, std::memory_order_relaxed);
+      return;
+    }
+    auto woken = [this]() {
+      return !_dispatcherParked.load(std::memory_order_seq_cst) ||
+             _dispatcherStop.load(std::memory_order_seq_cst);
+    };
+    if (heldDue == HUGE_VAL) {
+      _parkCv.wait(lock, woken);
+      return;
+    }
+    // Held events are due: sleep until then, unless something arrives first
+    _parkCv.wait_for(lock, std::chrono::duration<double, std::milli>(heldDue - now), woken);
+    _dispatcherParked.store(false, std::memory_order_seq_cst);
+  }
 
-    // Empty array resets to defaults
-    if (endpoints.empty()) {
-      _customPingEndpoints.clear();
-      if (_debugMode) {
-        logDebug("Reset ping endpoints to defaults");
+  /**
+   * Deliver held events that are due: trailing debounce/throttle changes and
+   * fireImmediately snapshots. A change whose throttle window was pushed out
+   * by an earlier delivery waits for the new window.
+   */
+  void flushHeldEvents() {
+    auto lock = lockTimed(_dispatchMutex, kOpListenerLockWait);
+    double now = getCurrentTimestamp();
+    double nextDue = HUGE_VAL;
+
+    for (HeldEvent& held : _immediateEvents) {
+      auto index = _listeners.resolve(held.handle);
+      if (index.has_value() && !(_listeners.flags(index.value()) & ListenerTable::kPaused) &&
+          triggerWanted(index.value())) {
+        markFired(index.value(), now);
+        pushHeldEvent(index.value(), held);
       }
-    } else {
-      _customPingEndpoints = endpoints;
-      if (_debugMode) {
-        logDebug("Set " + std::to_string(endpoints.size()) + " custom ping endpoints");
+    }
+    _immediateEvents.clear();
+
+    for (auto it = _heldChanges.begin(); it != _heldChanges.end();) {
+      HeldEvent& held = it->second;
+      auto index = _listeners.resolve(held.handle);
+      if (!index.has_value()) {
+        it = _heldChanges.erase(it);
+        continue;
+      }
+      uint16_t& flags = _listeners.flags(index.value());
+      if ((flags & ListenerTable::kHasThrottle) && held.due < _listeners.nextAllowedTrigger(index.value())) {
+        held.due = _listeners.nextAllowedTrigger(index.value());
       }
+      if (held.due > now) {
+        nextDue = std::min(nextDue, held.due);
+        ++it;
+        continue;
+      }
+      flags &= static_cast<uint16_t>(~ListenerTable::kPendingEvent);
+      if (!(flags & ListenerTable::kPaused) && triggerWanted(index.value())) {
+        markFired(index.value(), now);
+        pushHeldEvent(index.value(), held);
+      }
+      it = _heldChanges.erase(it);
     }
+    _heldDue.store(nextDue, std::memory_order_seq_cst);
 
-    // Reset endpoint index to start fresh with new endpoints
-    _pingEndpointIndex = 0;
+    ChangeDelivery delivery = takeChangeEvents();
+    lock.unlock();
+    deliverChangeEvents(delivery);
+    _eventsDelivered.fetch_add(delivery.events.size(), std::memory_order_relaxed);
   }
 
-private:
-  // Internal listener entry structure
-  struct ListenerEntry {
-    std::string id;
-    ListenerConfig config;
-    double createdAt;
-    double triggerCount;
-    std::optional<double> lastTriggered;
-    bool isPaused;
-
-    // Throttle state - tracks when callback can next be called
-    std::optional<double> nextAllowedTrigger;
-    // Pending event waiting for throttle window
-    bool hasPendingEvent;
-  };
-
-  // Thread safety
-  std::mutex _mutex;
-
-  // Listener storage
-  std::map<std::string, ListenerEntry> _listeners;
-
-  // Configuration
-  bool _debugMode;
-  size_t _maxListeners;
-
-  // Initialized storage instances
-  std::set<std::string> _warmInstances;
-  std::map<std::string, std::string> _coldDatabasePaths;
-
-  // Cold storage database handles
-  std::map<std::string, sqlite3*> _sqliteDatabases;
-
-  // Warm storage global initialization state
-  bool _warmGlobalInitialized = false;
-  std::string _warmRootPath;  // Empty string means use MMKV's default path
-
-  // Network monitoring state
-  bool _networkMonitoringActive = false;
-  NetworkState _currentNetworkState = NetworkState(
-      NetworkStatus::UNKNOWN,
-      ConnectionType::UNKNOWN,
-      false,   // isConnected
-      -1,      // isInternetReachable (-1 = unknown)
-      CellularGeneration::UNKNOWN,
-      -1,      // wifiStrength (-1 = unavailable)
-      false,   // isConnectionExpensive
-      0        // timestamp
-  );
-
-  // Internet quality tracking
-  double _lastPingLatencyMs = -1;  // -1 = unknown, >= 0 = latency in ms
-  std::string _internetQuality = "unknown";  // "excellent", "good", "fair", "poor", "offline", "unknown"
-  bool _internetReachable = false;  // True if internet is actually reachable (single source of truth)
-  bool _useActivePing = false;  // If true, use active HTTP pings. If false, rely on passive observation.
-  int _pingEndpointIndex = 0;  // Current endpoint index for round-robin
-  bool _isCheckingOfflineRecovery = false;  // If true, we're in offline state doing recovery checks
-  std::vector<std::string> _customPingEndpoints;  // User-defined endpoints (empty = use defaults)
+  /**
+   * Queue a held change as a PendingChangeEvent, copying its strings into
+   * the arena. Caller must hold _dispatchMutex.
+   */
+  void pushHeldEvent(uint32_t index, const HeldEvent& held) {
+    auto* event = _dispatchArena.make<PendingChangeEvent>();
+    event->listenerId = _listeners.id(index);
+    event->source = held.source;
+    event->operation = held.operation;
+    if (held.source == ChangeSource::WARM) {
+      event->key = _dispatchArena.copy(held.name);
+      event->oldValue = held.oldValue.view();
+      event->oldValue.stringValue = _dispatchArena.copy(event->oldValue.stringValue);
+      event->newValue = held.newValue.view();
+      event->newValue.stringValue = _dispatchArena.copy(event->newValue.stringValue);
+    } else {
+      event->table = _dispatchArena.copy(held.name);
+    }
+    event->hasRowId = held.hasRowId;
+    event->rowId = static_cast<double>(held.rowId);
+    event->hasRow = held.hasRow;
+    event->rowJson = held.hasRow ? _dispatchArena.copy(held.rowJson) : std::string_view();
+    event->timestamp = held.timestamp;
+    attachTriggerRoutes(index, event);
+    pushPendingEvent(event);
+  }
 
-#ifdef __APPLE__
-  nw_path_monitor_t _networkPathMonitor = nullptr;
-  dispatch_queue_t _networkQueue = nullptr;
-  dispatch_source_t _pingTimer = nullptr;
-#endif
+  void wakeDispatcher() {
+    // Only pay for the mutex when the dispatcher is actually asleep
+    if (_dispatcherParked.exchange(false, std::memory_order_seq_cst)) {
+      std::lock_guard<std::mutex> lock(_parkMutex);
+      _parkCv.notify_one();
+    }
+  }
 
-  // =========================================================================
-  // Helper Methods
-  // =========================================================================
+  void stopDispatcher() {
+    {
+      std::lock_guard<std::mutex> lock(_parkMutex);
+      _dispatcherStop.store(true, std::memory_order_seq_cst);
+      _dispatcherParked.store(false, std::memory_order_seq_cst);
+    }
+    _parkCv.notify_one();
+    if (_dispatcher.joinable()) {
+      _dispatcher.join();
+    }
+  }
 
   /**
-   * Get a Warm storage (MMKV) instance by ID
-   * Handles cross-platform differences in the MMKV API
+   * Match a Warm change against all listeners and queue events.
+   * Caller must hold _dispatchMutex.
    */
-  mmkv::MMKV* getWarmInstance(const std::string& id) {
-#ifdef __ANDROID__
-    // Android version has an additional size parameter
-    return mmkv::MMKV::mmkvWithID(id, mmkv::DEFAULT_MMAP_SIZE, mmkv::MMKV_SINGLE_PROCESS);
-#else
-    // iOS/macOS version
-    return mmkv::MMKV::mmkvWithID(id, mmkv::MMKV_SINGLE_PROCESS);
-#endif
+  void collectWarmEvents(const ChangeRecord& record) {
+    // Instance IDs and keys used by listeners are interned; anything not in
+    // the table can't match, and everything else compares as integers
+    uint32_t instanceAtom = _listeners.atomOf(record.scope);
+    if (instanceAtom == StringInterner::kNone) {
+      return;
+    }
+    std::string_view key = record.name;
+    uint32_t keyAtom = _listeners.atomOf(key);
+    ValueView oldValue = record.oldValue.view();
+    ValueView newValue = record.newValue.view();
+    double now = record.timestamp;
+
+    // Strings shared by every event for this change are copied into the arena once
+    std::string_view arenaKey;
+    bool copied = false;
+
+    uint32_t count = static_cast<uint32_t>(_listeners.size());
+    for (uint32_t i = 0; i < count; ++i) {
+      // Hot checks - contiguous arrays only
+      uint16_t flags = _listeners.flags(i);
+      if (!(flags & ListenerTable::kWatchesWarm) || (flags & ListenerTable::kPaused) ||
+          _listeners.warmInstance(i) != instanceAtom) {
+        continue;
+      }
+      bool keyMatched = keyAtom != StringInterner::kNone && _listeners.hasKey(i, keyAtom);
+      if (!keyMatched && (flags & ListenerTable::kWarmKeysOnly)) {
+        continue;
+      }
+
+      // Patterns and conditions need the config
+      const WarmListenerConfig* warm = ListenerTable::warmConfigOf(_listeners.cold(i).config);
+      if (!matchesWarmConfig(*warm, key, keyMatched, oldValue, newValue)) {
+        continue;
+      }
+      if (!triggerWanted(i)) {
+        continue;
+      }
+      double holdUntil = 0;
+      Admission admission = admitChange(i, ChangeSource::WARM, now, holdUntil);
+      if (admission == Admission::Drop) {
+        continue;
+      }
+      if (admission == Admission::Hold) {
+        HeldEvent& held = holdChange(i, holdUntil);
+        held.source = ChangeSource::WARM;
+        held.operation = record.operation;
+        held.name = record.name;
+        held.hasRowId = false;
+        held.oldValue = record.oldValue;
+        held.newValue = record.newValue;
+        held.hasRow = false;
+        held.timestamp = now;
+        continue;
+      }
+      if (!copied) {
+        arenaKey = _dispatchArena.copy(key);
+        oldValue.stringValue = _dispatchArena.copy(oldValue.stringValue);
+        newValue.stringValue = _dispatchArena.copy(newValue.stringValue);
+        copied = true;
+      }
+      auto* event = _dispatchArena.make<PendingChangeEvent>();
+      event->listenerId = _listeners.id(i);
+      event->source = ChangeSource::WARM;
+      event->operation = record.operation;
+      event->key = arenaKey;
+      event->hasRowId = false;
+      event->oldValue = oldValue;
+      event->newValue = newValue;
+      event->hasRow = false;
+      event->timestamp = now;
+      attachTriggerRoutes(i, event);
+      pushPendingEvent(event);
+    }
   }
 
   /**
-   * Get the platform-specific default Warm storage path
-   * Internal version that can be called without override
+   * Match a Cold row change against all listeners and queue events.
+   * The changed row is fetched and serialized at most once, however many
+   * listeners match it, and only if at least one listener does. Because this
+   * runs after the writer has returned, the payload reflects the row as of
+   * dispatch. Caller must hold _dispatchMutex; _mutex is taken for the fetch.
    */
-  std::string getDefaultWarmPathInternal() {
-#ifdef __APPLE__
-    // iOS/macOS: Use Library directory (same as react-native-mmkv)
-    @autoreleasepool {
-      NSArray *paths = NSSearchPathForDirectoriesInDomains(NSLibraryDirectory, NSUserDomainMask, YES);
-      NSString *libraryPath = [paths firstObject];
-      NSString *mmkvPath = [libraryPath stringByAppendingPathComponent:@"mmkv"];
-      return std::string([mmkvPath UTF8String]);
+  void collectColdEvents(const ChangeRecord& record) {
+    ColdOperation coldOp = record.operation == ChangeOperation::INSERT ? ColdOperation::INSERT
+        : record.operation == ChangeOperation::UPDATE ? ColdOperation::UPDATE
+        : ColdOperation::DELETE;
+
+    _coldCandidates.clear();
+    uint32_t count = static_cast<uint32_t>(_listeners.size());
+    for (uint32_t i = 0; i < count; ++i) {
+      uint16_t flags = _listeners.flags(i);
+      if (!(flags & ListenerTable::kWatchesCold) || (flags & ListenerTable::kPaused)) {
+        continue;
+      }
+      const ColdListenerConfig* cold = ListenerTable::coldConfigOf(_listeners.cold(i).config);
+      if (matchesColdConfig(*cold, record.scope, record.name, coldOp)) {
+        trackGrowth(_coldCandidates);
+        _coldCandidates.push_back(i);
+      }
+    }
+    if (_coldCandidates.empty()) {
+      return;
     }
-#else
-    // Android: Return the path if already set, otherwise empty
-    // Android path must be set from Java side (Context.getFilesDir() + "/mmkv")
-    return _warmRootPath;
-#endif
-  }
 
-  double getCurrentTimestamp() const {
-    return static_cast<double>(
-        std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::system_clock::now().time_since_epoch())
-            .count());
+    // Deleted rows are gone; everything else is read back once. Row
+    // conditions are evaluated while the statement is still open.
+    std::string_view rowJson;
+    bool hasRow = false;
+    if (coldOp != ColdOperation::DELETE) {
+      auto storageLock = lockTimed(_mutex, kOpStorageLockWait);
+      sqlite3_stmt* rowStmt = rowStatement(record.scope, record.name);
+      if (rowStmt != nullptr) {
+        sqlite3_bind_int64(rowStmt, 1, record.rowId);
+        int rc = sqlite3_step(rowStmt);
+        hasRow = rc == SQLITE_ROW;
+        if (rc != SQLITE_ROW && rc != SQLITE_DONE) {
+          // Table dropped or connection trouble: prepare afresh next time
+          dropRowStatement(record.scope, record.name);
+          rowStmt = nullptr;
+        }
+      }
+      if (hasRow) {
+        rowJson = serializeRow(rowStmt);
+      }
+      filterColdCandidates(hasRow ? rowStmt : nullptr);
+      if (rowStmt != nullptr) {
+        sqlite3_reset(rowStmt);
+        sqlite3_clear_bindings(rowStmt);
+      }
+    } else {
+      filterColdCandidates(nullptr);
+    }
+
+    std::string_view table;
+    for (uint32_t index : _coldCandidates) {
+      if (!triggerWanted(index)) {
+        continue;
+      }
+      double holdUntil = 0;
+      Admission admission = admitChange(index, ChangeSource::COLD, record.timestamp, holdUntil);
+      if (admission == Admission::Drop) {
+        continue;
+      }
+      if (admission == Admission::Hold) {
+        HeldEvent& held = holdChange(index, holdUntil);
+        held.source = ChangeSource::COLD;
+        held.operation = record.operation;
+        held.name = record.name;
+        held.hasRowId = true;
+        held.rowId = record.rowId;
+        held.oldValue = StoredValue();
+        held.newValue = StoredValue();
+        held.hasRow = hasRow;
+        held.rowJson.assign(rowJson);
+        held.timestamp = record.timestamp;
+        continue;
+      }
+      if (table.empty()) {
+        table = _dispatchArena.copy(record.name);
+      }
+      auto* event = _dispatchArena.make<PendingChangeEvent>();
+      event->listenerId = _listeners.id(index);
+      event->source = ChangeSource::COLD;
+      event->operation = record.operation;
+      event->table = table;
+      event->hasRowId = true;
+      event->rowId = static_cast<double>(record.rowId);
+      event->hasRow = hasRow;
+      event->rowJson = rowJson;
+      event->timestamp = record.timestamp;
+      attachTriggerRoutes(index, event);
+      pushPendingEvent(event);
+    }
   }
 
-  ListenerInfo createListenerInfo(const ListenerEntry& entry) const {
-    return ListenerInfo(
-        entry.id,
-        entry.config,
-        entry.createdAt,
-        entry.triggerCount,
-        entry.lastTriggered,
-        entry.isPaused);
+  /**
+   * The cached `SELECT * FROM table WHERE rowid = ?` for a Cold table,
+   * prepared on first use. Returns nullptr if the database isn't open or the
+   * table can't be read. Caller must hold _mutex.
+   */
+  sqlite3_stmt* rowStatement(const std::string& dbName, const std::string& table) {
+    auto& tables = _rowStmts[dbName];
+    auto cached = tables.find(table);
+    if (cached != tables.end()) {
+      return cached->second;
+    }
+    sqlite3* rowDb = coldDatabase(dbName);
+    if (rowDb == nullptr) {
+      return nullptr;
+    }
+    _rowSql.assign("SELECT * FROM \"");
+    for (char c : table) {
+      _rowSql += c;
+      if (c == '"') {
+        _rowSql += '"';
+      }
+    }
+    _rowSql += "\" WHERE rowid = ?";
+    sqlite3_stmt* rowStmt = nullptr;
+    if (sqlite3_prepare_v3(rowDb, _rowSql.c_str(), -1, SQLITE_PREPARE_PERSISTENT, &rowStmt, nullptr) != SQLITE_OK) {
+      sqlite3_finalize(rowStmt);
+      return nullptr;
+    }
+    tables.emplace(table, rowStmt);
+    return rowStmt;
   }
 
-  void logDebug(const std::string& message) const {
-    // Simple debug logging - can be enhanced per platform
-    std::cout << "[SAM] " << message << std::endl;
+  void dropRowStatement(const std::string& dbName, const std::string& table) {
+    auto& tables = _rowStmts[dbName];
+    auto cached = tables.find(table);
+    if (cached != tables.end()) {
+      sqlite3_finalize(cached->second);
+      tables.erase(cached);
+    }
   }
 
   /**
-   * Escape a string for JSON output
+   * Serialize the current row of `rowStmt` as a JSON object into the arena
    */
-  std::string escapeJsonString(const std::string& str) const {
-    std::ostringstream result;
-    for (char c : str) {
-      switch (c) {
-        case '"':  result << "\\\""; break;
-        case '\\': result << "\\\\"; break;
-        case '\b': result << "\\b";  break;
-        case '\f': result << "\\f";  break;
-        case '\n': result << "\\n";  break;
-        case '\r': result << "\\r";  break;
-        case '\t': result << "\\t";  break;
+  std::string_view serializeRow(sqlite3_stmt* rowStmt) {
+    _rowWriter.clear();
+    int columnCount = sqlite3_column_count(rowStmt);
+    _rowWriter.raw('{');
+    for (int col = 0; col < columnCount; ++col) {
+      if (col > 0) {
+        _rowWriter.raw(',');
+      }
+      const char* colName = sqlite3_column_name(rowStmt, col);
+      _rowWriter.string(colName ? colName : "");
+      _rowWriter.raw(':');
+      switch (sqlite3_column_type(rowStmt, col)) {
+        case SQLITE_INTEGER:
+          _rowWriter.number(static_cast<int64_t>(sqlite3_column_int64(rowStmt, col)));
+          break;
+        case SQLITE_FLOAT:
+          _rowWriter.number(sqlite3_column_double(rowStmt, col));
+          break;
+        case SQLITE_TEXT: {
+          const char* text = reinterpret_cast<const char*>(sqlite3_column_text(rowStmt, col));
+          _rowWriter.string(std::string_view(text ? text : "", static_cast<size_t>(sqlite3_column_bytes(rowStmt, col))));
+          break;
+        }
+        case SQLITE_BLOB: {
+          const auto* bytes = static_cast<const uint8_t*>(sqlite3_column_blob(rowStmt, col));
+          _rowWriter.base64(bytes, bytes ? static_cast<size_t>(sqlite3_column_bytes(rowStmt, col)) : 0);
+          break;
+        }
         default:
-          if ('\x00' <= c && c <= '\x1f') {
-            // Control characters - output as unicode escape
-            result << "\\u" << std::hex << std::setfill('0') << std::setw(4) << static_cast<int>(c);
-          } else {
-            result << c;
-          }
+          _rowWriter.null();
           break;
       }
     }
-    return result.str();
+    _rowWriter.raw('}');
+    return _dispatchArena.copy(std::string_view(_rowWriter.data(), _rowWriter.size()));
   }
 
   /**
-   * Check if a listener can fire based on throttle settings.
-   * Returns true if the callback can be invoked now.
-   * If false, the event should be queued for later dispatch.
-   *
-   * @param entry The listener entry to check
-   * @param currentTime Current timestamp in milliseconds
-   * @return true if callback can fire, false if throttled
+   * Drop candidates whose row conditions fail. Row conditions need the row,
+   * so they can't be satisfied by a delete or a row that is already gone.
    */
-  bool canFireCallback(ListenerEntry& entry, double currentTime) {
-    // Check if listener is paused
-    if (entry.isPaused) {
-      return false;
+  void filterColdCandidates(sqlite3_stmt* rowStmt) {
+    size_t kept = 0;
+    for (uint32_t index : _coldCandidates) {
+      const ColdListenerConfig* cold = ListenerTable::coldConfigOf(_listeners.cold(index).config);
+      if (cold->where.has_value() && !cold->where->empty()) {
+        if (rowStmt == nullptr || !rowMatches(rowStmt, cold->where.value())) {
+          continue;
+        }
+      }
+      _coldCandidates[kept++] = index;
     }
+    _coldCandidates.resize(kept);
+  }
 
-    // Check throttle settings
-    if (entry.config.options.has_value()) {
-      const auto& options = entry.config.options.value();
-      if (options.throttleMs.has_value()) {
-        double throttleMs = options.throttleMs.value();
-
-        // Check if we're within the throttle window
-        if (entry.nextAllowedTrigger.has_value()) {
-          if (currentTime < entry.nextAllowedTrigger.value()) {
-            // Still within throttle window - mark pending and don't fire
-            entry.hasPendingEvent = true;
-            if (_debugMode) {
-              double waitMs = entry.nextAllowedTrigger.value() - currentTime;
-              logDebug("Listener " + entry.id + " throttled, wait " +
-                       std::to_string(static_cast<int>(waitMs)) + "ms");
-            }
-            return false;
-          }
+  bool rowMatches(sqlite3_stmt* rowStmt, const std::vector<RowCondition>& where) {
+    int columnCount = sqlite3_column_count(rowStmt);
+    for (const auto& rowCondition : where) {
+      ValueView value;
+      for (int col = 0; col < columnCount; ++col) {
+        const char* colName = sqlite3_column_name(rowStmt, col);
+        if (colName != nullptr && equalsIgnoreCase(colName, rowCondition.column)) {
+          value = valueViewOfColumn(rowStmt, col);
+          break;
         }
-
-        // Can fire - update next allowed trigger time
-        entry.nextAllowedTrigger = currentTime + throttleMs;
+      }
+      if (!evaluateCondition(rowCondition.condition, value, ValueView())) {
+        return false;
       }
     }
+    return true;
+  }
 
-    // Update trigger stats
-    entry.triggerCount++;
-    entry.lastTriggered = currentTime;
-    entry.hasPendingEvent = false;
+  /**
+   * Queue an MFE transition for the transition handler.
+   * Caller must hold _dispatchMutex.
+   */
+  void collectMFETransition(const ChangeRecord& record) {
+    std::optional<MFERecord> current;
+    if (record.newValue.kind != ValueView::Kind::Absent) {
+      const std::string& bytes = record.newValue.stringValue;
+      current = mfe_record::decode(record.scope, bytes.data(), bytes.size());
+    }
+    _pendingTransitions.emplace_back(
+        record.scope, static_cast<MFEPhase>(record.oldValue.numberValue), std::move(current));
+  }
 
-    return true;
+  /**
+   * A storage trigger only fires while some missile route wants its action
+   * type; checked before throttling so an unwanted change doesn't use up the
+   * throttle window. Caller must hold _dispatchMutex.
+   */
+  bool triggerWanted(uint32_t index) {
+    if (!(_listeners.flags(index) & ListenerTable::kTrigger)) {
+      return true;
+    }
+    std::lock_guard<std::mutex> lock(_routerMutex);
+    return _actionRouter.hasMatch(_listeners.cold(index).actionType);
   }
 
   /**
-   * Record that a callback was fired for a listener.
-   * Updates trigger count and timestamp.
+   * Claim the routes a trigger event resolves, consuming pending takes, and
+   * record them on the event. Caller must hold _dispatchMutex.
    */
-  void recordTrigger(const std::string& id) {
-    auto it = _listeners.find(id);
-    if (it != _listeners.end()) {
-      double currentTime = getCurrentTimestamp();
-      it->second.triggerCount++;
-      it->second.lastTriggered = currentTime;
+  void attachTriggerRoutes(uint32_t index, PendingChangeEvent* event) {
+    event->routeBegin = static_cast<uint32_t>(_batchRouteIds.size());
+    event->routeCount = 0;
+    if (!(_listeners.flags(index) & ListenerTable::kTrigger)) {
+      event->actionType = {};
+      return;
+    }
+    event->actionType = _listeners.cold(index).actionType;
+    std::lock_guard<std::mutex> lock(_routerMutex);
+    _actionRouter.match(event->actionType, _routeMatches);
+    _batchRouteIds.insert(_batchRouteIds.end(), _routeMatches.begin(), _routeMatches.end());
+    event->routeCount = static_cast<uint32_t>(_routeMatches.size());
+  }
 
-      // Update throttle window if applicable
-      if (it->second.config.options.has_value()) {
-        const auto& options = it->second.config.options.value();
-        if (options.throttleMs.has_value()) {
-          it->second.nextAllowedTrigger = currentTime + options.throttleMs.value();
+  /**
+   * Materialize the pending batch into Nitro ChangeEvents and release the
+   * arena in one shot. Caller must hold _dispatchMutex; the returned delivery
+   * must be invoked after unlocking, because handlers may call back into SideFx.
+   */
+  ChangeDelivery takeChangeEvents() {
+    ChangeDelivery delivery;
+    if (!_pendingEvents.empty()) {
+      delivery.handler = _changeEventHandler;
+      if (delivery.handler) {
+        delivery.events.reserve(_pendingEvents.size());
+        for (const PendingChangeEvent* event : _pendingEvents) {
+          delivery.events.emplace_back(
+              std::string(event->listenerId),
+              event->source,
+              event->source == ChangeSource::WARM
+                  ? std::optional<std::string>(std::string(event->key)) : std::nullopt,
+              event->table.empty() ? std::nullopt : std::optional<std::string>(std::string(event->table)),
+              event->hasRowId ? std::optional<double>(event->rowId) : std::nullopt,
+              event->operation,
+              toEventValue(event->oldValue),
+              toEventValue(event->newValue),
+              event->hasRow ? std::optional<RowData>(RowData(std::string(event->rowJson))) : std::nullopt,
+              event->timestamp,
+              event->actionType.empty()
+                  ? std::nullopt : std::optional<std::string>(std::string(event->actionType)),
+              event->actionType.empty()
+                  ? std::nullopt
+                  : std::optional<std::vector<double>>(std::vector<double>(
+                        _batchRouteIds.begin() + event->routeBegin,
+                        _batchRouteIds.begin() + event->routeBegin + event->routeCount)));
         }
       }
+#if SAM_DISPATCH_ALLOC_STATS
+      _dispatchStats.batches++;
+#endif
+      _pendingEvents.clear();
+      _batchRouteIds.clear();
+    }
+    if (!_pendingTransitions.empty()) {
+      delivery.transitionHandler = _mfeTransitionHandler;
+      if (delivery.transitionHandler) {
+        delivery.transitions.swap(_pendingTransitions);
+      }
+      _pendingTransitions.clear();
+    }
+    _dispatchArena.reset();
+    return delivery;
+  }
+
+  static void deliverChangeEvents(const ChangeDelivery& delivery) {
+    if (delivery.handler && !delivery.events.empty()) {
+      (*delivery.handler)(delivery.events);
+    }
+    if (delivery.transitionHandler && !delivery.transitions.empty()) {
+      (*delivery.transitionHandler)(delivery.transitions);
     }
   }
 
@@ -1156,14 +5684,13 @@ private:
     // Store in Warm storage for reactive listeners
     updateNetworkWarmKeys();
 
-    if (_debugMode) {
-      logDebug("Network state updated: " + networkStatusToString(netStatus) +
-               ", type: " + connectionTypeToString(connType));
-    }
+    SAM_LOG_DEBUG(_logger, LogCategory::NETWORK, "Network state updated: ", networkStatusToString(netStatus),
+                  ", type: ", connectionTypeToString(connType));
   }
 
   /**
    * Update network state from SCNetworkReachability flags
+   * Caller must hold _mutex.
    */
   void updateNetworkStateFromReachabilityFlags(SCNetworkReachabilityFlags flags) {
     bool isReachable = (flags & kSCNetworkReachabilityFlagsReachable) != 0;
@@ -1253,10 +5780,12 @@ private:
       return CellularGeneration::UNKNOWN;
     }
   }
+#endif
 
   /**
    * Update Warm storage keys with current network state
    * This allows JS components to subscribe via useWarm
+   * Caller must hold _mutex.
    */
   void updateNetworkWarmKeys() {
     // Ensure Warm is initialized for network state
@@ -1271,24 +5800,23 @@ private:
           }
         }
         if (_warmGlobalInitialized) {
-          _warmInstances.insert("sam-network");
+          registerWarmInstance("sam-network");
         }
       }
     }
 
-    if (_warmInstances.find("sam-network") == _warmInstances.end()) {
+    auto instance = _warmInstances.find("sam-network");
+    if (instance == _warmInstances.end()) {
       return;  // Can't store without Warm
     }
-
-    mmkv::MMKV* storage = getWarmInstance("sam-network");
-    if (storage == nullptr) return;
+    mmkv::MMKV* storage = useWarmInstance(instance->second);
 
     // Store simplified network status for easy subscription
     // Values: "online", "offline", "unknown"
-    storage->set(networkStatusToString(_currentNetworkState.status), "NETWORK_STATUS");
+    writeWarmValue("sam-network", storage, "NETWORK_STATUS", networkStatusToString(_currentNetworkState.status));
 
     // Store connection type: "wifi", "cellular", "ethernet", "none", "unknown"
-    storage->set(connectionTypeToString(_currentNetworkState.type), "NETWORK_TYPE");
+    writeWarmValue("sam-network", storage, "NETWORK_TYPE", connectionTypeToString(_currentNetworkState.type));
 
     // Store signal quality indicator: "strong", "weak", "offline"
     std::string quality = "unknown";
@@ -1310,15 +5838,16 @@ private:
         }
       }
     }
-    storage->set(quality, "NETWORK_QUALITY");
+    writeWarmValue("sam-network", storage, "NETWORK_QUALITY", quality);
 
     // Store cellular generation if applicable
     if (_currentNetworkState.type == ConnectionType::CELLULAR) {
-      storage->set(cellularGenerationToString(_currentNetworkState.cellularGeneration), "CELLULAR_GENERATION");
+      writeWarmValue("sam-network", storage, "CELLULAR_GENERATION",
+                     cellularGenerationToString(_currentNetworkState.cellularGeneration));
     }
 
     // Store boolean for quick checks
-    storage->set(_currentNetworkState.isConnected, "IS_CONNECTED");
+    writeWarmValue("sam-network", storage, "IS_CONNECTED", _currentNetworkState.isConnected);
   }
 
   std::string networkStatusToString(NetworkStatus status) const {
@@ -1380,6 +5909,8 @@ private:
    * OFFLINE RECOVERY: When offline, always performs a check every 30 seconds
    * to detect when internet becomes available again. This runs regardless of
    * active ping mode setting.
+   *
+   * Caller must hold _mutex.
    */
   void checkInternetQualityAsync() {
     // If network layer says not connected, update state accordingly
@@ -1409,6 +5940,7 @@ private:
       return;
     }
 
+#ifdef __APPLE__
     @autoreleasepool {
       // Use NSURLSession to measure actual HTTP latency
       // This is more accurate than ping because it goes through the full network stack
@@ -1436,9 +5968,8 @@ private:
 
           if (error != nil) {
             // Request failed - internet may be unreachable
-            if (self->_debugMode) {
-              self->logDebug("Internet quality check failed: " + std::string([[error localizedDescription] UTF8String]));
-            }
+            SAM_LOG_DEBUG(self->_logger, LogCategory::NETWORK, "Internet quality check failed: ",
+                          [[error localizedDescription] UTF8String]);
             quality = "offline";
             latencyMs = -1;
             reachable = false;
@@ -1451,26 +5982,25 @@ private:
             quality = self->latencyToQuality(latencyMs);
             reachable = true;  // We got a successful response!
 
-            if (self->_debugMode) {
-              self->logDebug("Internet latency: " + std::to_string((int)latencyMs) + "ms, quality: " + quality + ", reachable: true");
-            }
-          }
-
-          // Update state (need to lock)
-          {
-            std::lock_guard<std::mutex> lock(self->_mutex);
-            self->_lastPingLatencyMs = latencyMs;
-            self->_internetQuality = quality;
-            self->_internetReachable = reachable;
-            self->_isCheckingOfflineRecovery = !reachable;  // Keep checking if still offline
+            SAM_LOG_DEBUG(self->_logger, LogCategory::NETWORK, "Internet latency: ", static_cast<int>(latencyMs),
+                          "ms, quality: ", quality, ", reachable: true");
           }
 
-          // Update Warm storage
+          // Update state and Warm storage under the same lock
+          std::lock_guard<std::mutex> lock(self->_mutex);
+          self->_lastPingLatencyMs = latencyMs;
+          self->_internetQuality = quality;
+          self->_internetReachable = reachable;
+          self->_isCheckingOfflineRecovery = !reachable;  // Keep checking if still offline
           self->updateInternetQualityWarmKeys();
         }];
 
       [task resume];
     }
+#else
+    // No native HTTP probe on this platform - latency and recovery come from
+    // the app's own requests via reportNetworkLatency()/reportNetworkFailure()
+#endif
   }
 
   /**
@@ -1487,29 +6017,29 @@ private:
 
   /**
    * Update Warm storage with internet quality values
+   * Caller must hold _mutex.
    */
   void updateInternetQualityWarmKeys() {
-    if (_warmInstances.find("sam-network") == _warmInstances.end()) {
+    auto instance = _warmInstances.find("sam-network");
+    if (instance == _warmInstances.end()) {
       return;
     }
-
-    mmkv::MMKV* storage = getWarmInstance("sam-network");
-    if (storage == nullptr) return;
+    mmkv::MMKV* storage = useWarmInstance(instance->second);
 
     // Store internet quality: "excellent", "good", "fair", "poor", "offline", "unknown"
-    storage->set(_internetQuality, "INTERNET_QUALITY");
+    writeWarmValue("sam-network", storage, "INTERNET_QUALITY", _internetQuality);
 
     // Store latency in ms (-1 if unknown/offline)
-    storage->set(_lastPingLatencyMs, "INTERNET_LATENCY_MS");
+    writeWarmValue("sam-network", storage, "INTERNET_LATENCY_MS", _lastPingLatencyMs);
 
     // Store combined quality that considers both network type and internet quality
     std::string combinedQuality = calculateCombinedQuality();
-    storage->set(combinedQuality, "NETWORK_QUALITY");
+    writeWarmValue("sam-network", storage, "NETWORK_QUALITY", combinedQuality);
 
     // INTERNET_REACHABLE: The single source of truth for app network operations
     // true = internet is verified reachable, safe to make API calls
     // false = internet is offline or unreachable, queue/skip network operations
-    storage->set(_internetReachable, "INTERNET_REACHABLE");
+    writeWarmValue("sam-network", storage, "INTERNET_REACHABLE", _internetReachable);
 
     // INTERNET_STATE: Simple state similar to APP_STATE
     // Values: "offline", "online", "online-weak"
@@ -1522,14 +6052,11 @@ private:
         internetState = "online";
       }
     }
-    storage->set(internetState, "INTERNET_STATE");
+    writeWarmValue("sam-network", storage, "INTERNET_STATE", internetState);
 
-    if (_debugMode) {
-      logDebug("Updated internet: state=" + internetState +
-               ", reachable=" + std::string(_internetReachable ? "true" : "false") +
-               ", quality=" + _internetQuality +
-               ", latency=" + std::to_string((int)_lastPingLatencyMs) + "ms");
-    }
+    SAM_LOG_DEBUG(_logger, LogCategory::NETWORK, "Updated internet: state=", internetState,
+                  ", reachable=", _internetReachable, ", quality=", _internetQuality,
+                  ", latency=", static_cast<int>(_lastPingLatencyMs), "ms");
   }
 
   /**
@@ -1575,7 +6102,6 @@ private:
 
     return "unknown";
   }
-#endif
 };
 
 } // namespace margelo::nitro::sam
@@ -0,0 +1,242 @@
+#pragma once
+
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SAM_JSON_SSE2 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define SAM_JSON_NEON 1
+#endif
+
+// Floating point std::to_chars needs libstdc++ 11 / libc++ 14. Apple's libc++
+// gates it behind iOS 16.3, so Apple builds use the snprintf fallback unless
+// the deployment target allows it and SAM_JSON_FLOAT_TO_CHARS is set explicitly.
+#ifndef SAM_JSON_FLOAT_TO_CHARS
+#if defined(__APPLE__)
+#define SAM_JSON_FLOAT_TO_CHARS 0
+#elif defined(__GLIBCXX__) && defined(__GNUC__) && __GNUC__ >= 11
+#define SAM_JSON_FLOAT_TO_CHARS 1
+#elif defined(_LIBCPP_VERSION) && _LIBCPP_VERSION >= 14000
+#define SAM_JSON_FLOAT_TO_CHARS 1
+#else
+#define SAM_JSON_FLOAT_TO_CHARS 0
+#endif
+#endif
+
+namespace margelo::nitro::sam {
+
+/**
+ * Append-only JSON writer over a growable buffer
+ *
+ * Built for the Cold query hot path: no iostreams, no temporary strings per
+ * value, SIMD scanning for bytes that need escaping and std::to_chars for
+ * numbers. The caller is responsible for structure (commas, brackets);
+ * the writer only guarantees that every value it emits is valid JSON.
+ */
+class JsonWriter {
+public:
+  JsonWriter() = default;
+  explicit JsonWriter(size_t reserveBytes) { _buf.reserve(reserveBytes); }
+
+  void reserve(size_t bytes) { _buf.reserve(bytes); }
+  void clear() { _buf.clear(); }
+
+  const char* data() const { return _buf.data(); }
+  size_t size() const { return _buf.size(); }
+
+  /**
+   * Move the serialized output out of the writer
+   */
+  std::string take() { return std::move(_buf); }
+
+  void raw(char c) { _buf.push_back(c); }
+  void raw(std::string_view text) { _buf.append(text.data(), text.size()); }
+
+  void null() { raw(std::string_view("null", 4)); }
+  void boolean(bool value) { value ? raw(std::string_view("true", 4)) : raw(std::string_view("false", 5)); }
+
+  void number(int64_t value) {
+    char tmp[24];
+    auto result = std::to_chars(tmp, tmp + sizeof(tmp), value);
+    _buf.append(tmp, static_cast<size_t>(result.ptr - tmp));
+  }
+
+  /**
+   * Shortest round-trip representation. NaN and infinities are not valid
+   * JSON and are emitted as null.
+   */
+  void number(double value) {
+    if (!std::isfinite(value)) {
+      null();
+      return;
+    }
+    char tmp[32];
+#if SAM_JSON_FLOAT_TO_CHARS
+    auto result = std::to_chars(tmp, tmp + sizeof(tmp), value);
+    _buf.append(tmp, static_cast<size_t>(result.ptr - tmp));
+#else
+    int len = std::snprintf(tmp, sizeof(tmp), "%.15g", value);
+    if (std::strtod(tmp, nullptr) != value) {
+      len = std::snprintf(tmp, sizeof(tmp), "%.17g", value);
+    }
+    _buf.append(tmp, static_cast<size_t>(len));
+#endif
+  }
+
+  /**
+   * Quoted, escaped string value
+   */
+  void string(std::string_view value) {
+    _buf.push_back('"');
+    appendEscaped(_buf, value.data(), value.size());
+    _buf.push_back('"');
+  }
+
+  /**
+   * Quoted base64 string value (used for BLOB columns)
+   */
+  void base64(const uint8_t* bytes, size_t length) {
+    static constexpr char kAlphabet[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    size_t start = _buf.size();
+    _buf.resize(start + 2 + ((length + 2) / 3) * 4);
+    char* out = _buf.data() + start;
+    *out++ = '"';
+
+    size_t i = 0;
+    for (; i + 3 <= length; i += 3) {
+      uint32_t triple = (static_cast<uint32_t>(bytes[i]) << 16) |
+                        (static_cast<uint32_t>(bytes[i + 1]) << 8) |
+                        static_cast<uint32_t>(bytes[i + 2]);
+      *out++ = kAlphabet[(triple >> 18) & 0x3F];
+      *out++ = kAlphabet[(triple >> 12) & 0x3F];
+      *out++ = kAlphabet[(triple >> 6) & 0x3F];
+      *out++ = kAlphabet[triple & 0x3F];
+    }
+    size_t remaining = length - i;
+    if (remaining > 0) {
+      uint32_t triple = static_cast<uint32_t>(bytes[i]) << 16;
+      if (remaining == 2) {
+        triple |= static_cast<uint32_t>(bytes[i + 1]) << 8;
+      }
+      *out++ = kAlphabet[(triple >> 18) & 0x3F];
+      *out++ = kAlphabet[(triple >> 12) & 0x3F];
+      *out++ = remaining == 2 ? kAlphabet[(triple >> 6) & 0x3F] : '=';
+      *out++ = '=';
+    }
+    *out = '"';
+  }
+
+  /**
+   * Escape `text` once so it can be re-emitted many times with raw()
+   * e.g. column names that repeat on every row of a result set
+   */
+  static std::string escapeKey(std::string_view text) {
+    std::string key;
+    key.reserve(text.size() + 3);
+    key.push_back('"');
+    appendEscaped(key, text.data(), text.size());
+    key.append("\":", 2);
+    return key;
+  }
+
+  /**
+   * Append `text` to `out` with JSON escaping applied
+   * Runs of safe bytes are copied in bulk; only the bytes found by the
+   * SIMD scan go through the per-character slow path.
+   */
+  static void appendEscaped(std::string& out, const char* text, size_t length) {
+    size_t runStart = 0;
+    size_t i = 0;
+    while (i < length) {
+      i = findEscape(text, i, length);
+      if (i >= length) {
+        break;
+      }
+      out.append(text + runStart, i - runStart);
+      appendEscapedChar(out, static_cast<unsigned char>(text[i]));
+      ++i;
+      runStart = i;
+    }
+    out.append(text + runStart, length - runStart);
+  }
+
+private:
+  std::string _buf;
+
+  static bool needsEscape(unsigned char c) {
+    return c < 0x20 || c == '"' || c == '\\';
+  }
+
+  /**
+   * Index of the first byte at or after `from` that needs escaping,
+   * or `length` if there is none
+   */
+  static size_t findEscape(const char* text, size_t from, size_t length) {
+    size_t i = from;
+#if defined(SAM_JSON_SSE2)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i controlMax = _mm_set1_epi8(0x1F);
+    for (; i + 16 <= length; i += 16) {
+      __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+      // Unsigned c <= 0x1F  <=>  max(c, 0x1F) == 0x1F
+      __m128i control = _mm_cmpeq_epi8(_mm_max_epu8(chunk, controlMax), controlMax);
+      __m128i special = _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash));
+      int mask = _mm_movemask_epi8(_mm_or_si128(control, special));
+      if (mask != 0) {
+        return i + static_cast<size_t>(__builtin_ctz(static_cast<unsigned>(mask)));
+      }
+    }
+#elif defined(SAM_JSON_NEON)
+    const uint8x16_t quote = vdupq_n_u8('"');
+    const uint8x16_t backslash = vdupq_n_u8('\\');
+    const uint8x16_t controlLimit = vdupq_n_u8(0x20);
+    for (; i + 16 <= length; i += 16) {
+      uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(text + i));
+      uint8x16_t hits = vorrq_u8(vcltq_u8(chunk, controlLimit),
+                                 vorrq_u8(vceqq_u8(chunk, quote), vceqq_u8(chunk, backslash)));
+      if (vmaxvq_u8(hits) != 0) {
+        break;  // locate the exact byte with the scalar loop below
+      }
+    }
+#endif
+    for (; i < length; ++i) {
+      if (needsEscape(static_cast<unsigned char>(text[i]))) {
+        return i;
+      }
+    }
+    return length;
+  }
+
+  static void appendEscapedChar(std::string& out, unsigned char c) {
+    switch (c) {
+      case '"':  out.append("\\\"", 2); break;
+      case '\\': out.append("\\\\", 2); break;
+      case '\b': out.append("\\b", 2);  break;
+      case '\f': out.append("\\f", 2);  break;
+      case '\n': out.append("\\n", 2);  break;
+      case '\r': out.append("\\r", 2);  break;
+      case '\t': out.append("\\t", 2);  break;
+      default: {
+        // Remaining control characters - output as unicode escape
+        static constexpr char kHex[] = "0123456789abcdef";
+        char escape[6] = {'\\', 'u', '0', '0', kHex[c >> 4], kHex[c & 0xF]};
+        out.append(escape, sizeof(escape));
+        break;
+      }
+    }
+  }
+};
+
+} // namespace margelo::nitro::sam
@@ -0,0 +1,233 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Operation metrics are on in every build, release included. The cost is two
+// clock reads and one atomic add per instrumented call; define SAM_METRICS=0
+// to compile the timers out entirely.
+#ifndef SAM_METRICS
+#define SAM_METRICS 1
+#endif
+
+namespace margelo::nitro::sam {
+
+/**
+ * Monotonic clock reading in nanoseconds, for latency measurement only
+ */
+inline uint64_t monotonicNanos() {
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                   std::chrono::steady_clock::now().time_since_epoch())
+                                   .count());
+}
+
+/**
+ * HDR-style log-linear bucketing of unsigned integers
+ *
+ * Values below 2 * 2^SubBucketBits each get their own bucket; above that
+ * each power of two is split into 2^SubBucketBits linear sub-buckets, so a
+ * bucket's upper bound is never more than 2^-SubBucketBits above any value
+ * in it. Values at or past 2^(MaxMagnitude + 1) land in the last bucket.
+ */
+template <unsigned SubBucketBits, unsigned MaxMagnitude>
+struct LogLinearBuckets {
+  static constexpr unsigned kSubBucketBits = SubBucketBits;
+  static constexpr uint64_t kSubBucketCount = uint64_t{1} << kSubBucketBits;
+  static constexpr uint64_t kLinearLimit = kSubBucketCount * 2;
+  static constexpr unsigned kMaxMagnitude = MaxMagnitude;
+  static constexpr size_t kBucketCount =
+      kLinearLimit + (kMaxMagnitude - kSubBucketBits) * kSubBucketCount;
+
+  static size_t bucketOf(uint64_t value) {
+    if (value < kLinearLimit) {
+      return static_cast<size_t>(value);
+    }
+    unsigned magnitude = 63u - static_cast<unsigned>(std::countl_zero(value));
+    if (magnitude > kMaxMagnitude) {
+      return kBucketCount - 1;
+    }
+    unsigned shift = magnitude - kSubBucketBits;
+    uint64_t sub = (value >> shift) - kSubBucketCount;
+    return static_cast<size_t>(kLinearLimit +
+                               (magnitude - kSubBucketBits - 1) * kSubBucketCount + sub);
+  }
+
+  /**
+   * Smallest value that maps to bucket `index`
+   */
+  static uint64_t lowerBound(size_t index) {
+    if (index < kLinearLimit) {
+      return index;
+    }
+    uint64_t offset = index - kLinearLimit;
+    unsigned shift = static_cast<unsigned>(offset / kSubBucketCount) + 1;
+    return (offset % kSubBucketCount + kSubBucketCount) << shift;
+  }
+
+  /**
+   * Largest value that maps to bucket `index`
+   */
+  static uint64_t upperBound(size_t index) {
+    if (index < kLinearLimit) {
+      return index;
+    }
+    uint64_t offset = index - kLinearLimit;
+    unsigned shift = static_cast<unsigned>(offset / kSubBucketCount) + 1;
+    uint64_t sub = offset % kSubBucketCount + kSubBucketCount;
+    return ((sub + 1) << shift) - 1;
+  }
+};
+
+/**
+ * Lock-free latency histogram with HDR-style log-linear buckets
+ *
+ * Values are nanoseconds. Below 64ns every value has its own bucket; above
+ * that each power of two is split into 32 linear sub-buckets, so a reported
+ * percentile is never more than ~3% above the recorded value. Values past
+ * ~68s land in the last bucket (the exact maximum is still tracked).
+ *
+ * record() is one relaxed atomic add plus a load, and may be called from any
+ * thread. As in HdrHistogram, only bucket counts are kept: min and mean are
+ * derived from the buckets, and only the maximum is tracked exactly.
+ * summarize() may run concurrently with record(); a reset summary can
+ * attribute a sample recorded mid-reset to either interval, never both.
+ */
+class LatencyHistogram {
+public:
+  using Buckets = LogLinearBuckets<5, 35>;                // 32 sub-buckets, 2^36ns ~ 68s
+  static constexpr size_t kBucketCount = Buckets::kBucketCount;                // 1024
+
+  struct Summary {
+    uint64_t count = 0;
+    double meanNs = 0;
+    uint64_t minNs = 0;
+    uint64_t maxNs = 0;
+    uint64_t p50Ns = 0;
+    uint64_t p90Ns = 0;
+    uint64_t p99Ns = 0;
+    uint64_t p999Ns = 0;
+  };
+
+  LatencyHistogram() {
+    for (auto& bucket : _buckets) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  LatencyHistogram(const LatencyHistogram&) = delete;
+  LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+  void record(uint64_t ns) {
+    _buckets[bucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+    uint64_t current = _maxNs.load(std::memory_order_relaxed);
+    while (ns > current &&
+           !_maxNs.compare_exchange_weak(current, ns, std::memory_order_relaxed)) {
+    }
+  }
+
+  /**
+   * Count and percentiles of everything recorded so far, optionally starting
+   * a new interval
+   */
+  Summary summarize(bool reset) {
+    std::array<uint64_t, kBucketCount> counts;
+    Summary summary;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+      counts[i] = reset ? _buckets[i].exchange(0, std::memory_order_relaxed)
+                        : _buckets[i].load(std::memory_order_relaxed);
+      summary.count += counts[i];
+    }
+    summary.maxNs = reset ? _maxNs.exchange(0, std::memory_order_relaxed)
+                          : _maxNs.load(std::memory_order_relaxed);
+    if (summary.count == 0) {
+      return Summary();
+    }
+
+    // Walk the buckets once, resolving each quantile as its rank is crossed
+    const double quantiles[] = {0.5, 0.9, 0.99, 0.999};
+    uint64_t* targets[] = {&summary.p50Ns, &summary.p90Ns, &summary.p99Ns, &summary.p999Ns};
+    size_t next = 0;
+    uint64_t seen = 0;
+    double total = 0;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+      if (counts[i] == 0) {
+        continue;
+      }
+      uint64_t lower = bucketLowerBound(i);
+      uint64_t upper = bucketUpperBound(i) < summary.maxNs ? bucketUpperBound(i) : summary.maxNs;
+      if (seen == 0) {
+        summary.minNs = lower;
+      }
+      seen += counts[i];
+      total += static_cast<double>(counts[i]) * (static_cast<double>(lower) + static_cast<double>(upper)) / 2;
+      while (next < 4 &&
+             static_cast<double>(seen) >= quantiles[next] * static_cast<double>(summary.count)) {
+        *targets[next] = upper;
+        next++;
+      }
+    }
+    summary.meanNs = total / static_cast<double>(summary.count);
+    return summary;
+  }
+
+  static size_t bucketOf(uint64_t ns) { return Buckets::bucketOf(ns); }
+  static uint64_t bucketLowerBound(size_t index) { return Buckets::lowerBound(index); }
+  static uint64_t bucketUpperBound(size_t index) { return Buckets::upperBound(index); }
+
+private:
+  std::array<std::atomic<uint64_t>, kBucketCount> _buckets;
+  std::atomic<uint64_t> _maxNs{0};
+};
+
+/**
+ * Latency plus error count for one instrumented operation
+ */
+struct OperationStats {
+  LatencyHistogram latency;
+  std::atomic<uint64_t> errors{0};
+};
+
+/**
+ * Times a scope into an OperationStats. Call fail() on error paths.
+ */
+class OperationTimer {
+public:
+#if SAM_METRICS
+  explicit OperationTimer(OperationStats& stats) : _stats(stats), _start(monotonicNanos()) {}
+
+  ~OperationTimer() {
+    _stats.latency.record(monotonicNanos() - _start);
+    if (_failed) {
+      _stats.errors.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+#else
+  explicit OperationTimer(OperationStats& stats) : _stats(stats), _start(0) {}
+#endif
+
+  OperationTimer(const OperationTimer&) = delete;
+  OperationTimer& operator=(const OperationTimer&) = delete;
+
+  /**
+   * Mark the operation failed and pass `result` through, so error returns
+   * stay one-liners: `return timer.fail(ListenerResult(false, ...));`
+   */
+  template <typename T>
+  T fail(T result) {
+    _failed = true;
+    return result;
+  }
+
+  void fail() { _failed = true; }
+
+private:
+  OperationStats& _stats;
+  uint64_t _start;
+  bool _failed = false;
+};
+
+} // namespace margelo::nitro::sam
@@ -0,0 +1,480 @@
+#pragma once
+
+#include "ListenerConfig.hpp"
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace margelo::nitro::sam {
+
+/**
+ * Reference-counted string interner
+ *
+ * Maps strings to dense 32-bit IDs so hot matching code compares integers
+ * instead of strings. Each interned string is stored exactly once; IDs are
+ * recycled once their last reference is released.
+ */
+class StringInterner {
+public:
+  static constexpr uint32_t kNone = std::numeric_limits<uint32_t>::max();
+
+  uint32_t acquire(std::string_view text) {
+    auto it = _ids.find(text);
+    if (it != _ids.end()) {
+      _refs[it->second]++;
+      return it->second;
+    }
+    uint32_t id;
+    if (!_free.empty()) {
+      id = _free.back();
+      _free.pop_back();
+    } else {
+      id = static_cast<uint32_t>(_strings.size());
+      _strings.emplace_back();
+      _refs.push_back(0);
+    }
+    _strings[id] = std::make_unique<std::string>(text);
+    _refs[id] = 1;
+    _ids.emplace(std::string_view(*_strings[id]), id);
+    return id;
+  }
+
+  void release(uint32_t id) {
+    if (id == kNone || id >= _refs.size() || _refs[id] == 0) {
+      return;
+    }
+    if (--_refs[id] == 0) {
+      _ids.erase(std::string_view(*_strings[id]));
+      _strings[id].reset();
+      _free.push_back(id);
+    }
+  }
+
+  /**
+   * ID of an already interned string, or kNone - never interns
+   */
+  uint32_t find(std::string_view text) const {
+    auto it = _ids.find(text);
+    return it == _ids.end() ? kNone : it->second;
+  }
+
+  /**
+   * Stable reference to the interned string (valid until released)
+   */
+  const std::string& str(uint32_t id) const { return *_strings[id]; }
+
+  void clear() {
+    _ids.clear();
+    _strings.clear();
+    _refs.clear();
+    _free.clear();
+  }
+
+  /**
+   * Approximate heap bytes held, hash nodes included
+   */
+  size_t memoryBytes() const {
+    size_t bytes = _strings.capacity() * sizeof(std::unique_ptr<std::string>) +
+                   (_refs.capacity() + _free.capacity()) * sizeof(uint32_t);
+    for (const auto& text : _strings) {
+      if (text) {
+        bytes += sizeof(std::string) + text->capacity();
+      }
+    }
+    bytes += _ids.size() * (sizeof(std::string_view) + sizeof(uint32_t) + 2 * sizeof(void*)) +
+             _ids.bucket_count() * sizeof(void*);
+    return bytes;
+  }
+
+private:
+  std::unordered_map<std::string_view, uint32_t> _ids;
+  std::vector<std::unique_ptr<std::string>> _strings;
+  std::vector<uint32_t> _refs;
+  std::vector<uint32_t> _free;
+};
+
+/**
+ * Stable reference to a listener that survives other listeners being removed.
+ * A handle whose generation no longer matches its slot is stale.
+ */
+struct ListenerHandle {
+  uint32_t slot = StringInterner::kNone;
+  uint32_t generation = 0;
+};
+
+/**
+ * Listener storage as a slot map with structure-of-arrays hot data
+ *
+ * Listeners live in dense arrays indexed 0..size()-1 (removal swaps the last
+ * listener into the hole), so dispatch walks contiguous memory. Everything
+ * needed to reject a listener without looking at its config - paused state,
+ * source mask, Warm instance, exact-key filter, throttle and debounce
+ * windows, AND-logic state, trigger stats - is split into separate hot
+ * arrays. The full ListenerConfig stays in the cold array and is only read
+ * for listeners that survive the hot checks or when ListenerInfo is
+ * materialized for getListeners().
+ *
+ * Not thread-safe; HybridSideFx guards it with its mutex.
+ */
+class ListenerTable {
+public:
+  // Hot flag bits
+  static constexpr uint16_t kPaused = 1 << 0;
+  static constexpr uint16_t kWatchesWarm = 1 << 1;
+  static constexpr uint16_t kWatchesCold = 1 << 2;
+  static constexpr uint16_t kWarmKeysOnly = 1 << 3;   // Warm filter is exact keys only
+  static constexpr uint16_t kHasThrottle = 1 << 4;
+  static constexpr uint16_t kPendingEvent = 1 << 5;   // a held-back change awaits delivery
+  static constexpr uint16_t kTrigger = 1 << 6;        // storage trigger for missile
+  static constexpr uint16_t kHasDebounce = 1 << 7;
+  static constexpr uint16_t kAndLogic = 1 << 8;       // combined listener with logic AND
+  static constexpr uint16_t kWarmSideSeen = 1 << 9;   // AND: Warm side matched since the last fire
+  static constexpr uint16_t kColdSideSeen = 1 << 10;  // AND: Cold side matched since the last fire
+
+  /**
+   * Cold data - touched only after the hot checks pass
+   */
+  struct ColdData {
+    uint32_t idAtom;             // interned listener ID
+    ListenerConfig config;
+    double createdAt;
+    std::string actionType;      // storage triggers only
+  };
+
+  size_t size() const { return _cold.size(); }
+  bool empty() const { return _cold.empty(); }
+  size_t warmCount() const { return _warmCount; }
+  size_t coldCount() const { return _coldCount; }
+
+  /**
+   * Approximate heap bytes held by the table. Heap data owned by the stored
+   * ListenerConfigs (patterns, SQL text) is not included.
+   */
+  size_t memoryBytes() const {
+    size_t bytes = _ids.memoryBytes() + _atoms.memoryBytes();
+    bytes += _slots.capacity() * sizeof(Slot);
+    bytes += (_freeSlots.capacity() + _slotOfAtom.capacity() + _slotOfDense.capacity() + _keyPool.capacity() +
+              _warmInstance.capacity() + _keyBegin.capacity() + _keyCount.capacity()) * sizeof(uint32_t);
+    bytes += _flags.capacity() * sizeof(uint16_t);
+    bytes += (_nextAllowedTrigger.capacity() + _throttleMs.capacity() + _debounceMs.capacity() +
+              _triggerCount.capacity() + _lastTriggered.capacity()) * sizeof(double);
+    bytes += _cold.capacity() * sizeof(ColdData);
+    return bytes;
+  }
+
+  /**
+   * Dense index of the listener with this ID, if any
+   */
+  std::optional<uint32_t> find(std::string_view id) const {
+    uint32_t atom = _ids.find(id);
+    if (atom == StringInterner::kNone || atom >= _slotOfAtom.size()) {
+      return std::nullopt;
+    }
+    uint32_t slot = _slotOfAtom[atom];
+    if (slot == StringInterner::kNone) {
+      return std::nullopt;
+    }
+    return _slots[slot].dense;
+  }
+
+  /**
+   * Resolve a handle to a dense index, or nullopt if the listener is gone
+   */
+  std::optional<uint32_t> resolve(ListenerHandle handle) const {
+    if (handle.slot >= _slots.size() || _slots[handle.slot].generation != handle.generation ||
+        _slots[handle.slot].dense == StringInterner::kNone) {
+      return std::nullopt;
+    }
+    return _slots[handle.slot].dense;
+  }
+
+  ListenerHandle handleOf(uint32_t dense) const {
+    uint32_t slot = _slotOfDense[dense];
+    return ListenerHandle{slot, _slots[slot].generation};
+  }
+
+  uint32_t insert(const std::string& id, const ListenerConfig& config, double createdAt,
+                  std::string actionType = {}) {
+    uint32_t atom = _ids.acquire(id);
+    if (atom >= _slotOfAtom.size()) {
+      _slotOfAtom.resize(atom + 1, StringInterner::kNone);
+    }
+
+    uint32_t slot;
+    if (!_freeSlots.empty()) {
+      slot = _freeSlots.back();
+      _freeSlots.pop_back();
+    } else {
+      slot = static_cast<uint32_t>(_slots.size());
+      _slots.push_back(Slot{});
+    }
+    uint32_t dense = static_cast<uint32_t>(_cold.size());
+    _slots[slot].dense = dense;
+    _slotOfAtom[atom] = slot;
+    _slotOfDense.push_back(slot);
+
+    const WarmListenerConfig* warm = warmConfigOf(config);
+    bool watchesCold = config.cold.has_value() ||
+        (config.combined.has_value() && config.combined->cold.has_value());
+
+    uint16_t flags = 0;
+    uint32_t instance = StringInterner::kNone;
+    uint32_t keyBegin = static_cast<uint32_t>(_keyPool.size());
+    uint32_t keyCount = 0;
+    if (warm != nullptr) {
+      flags |= kWatchesWarm;
+      instance = _atoms.acquire(warm->instanceId.value_or("default"));
+      bool hasKeys = warm->keys.has_value() && !warm->keys->empty();
+      bool hasPatterns = warm->patterns.has_value() && !warm->patterns->empty();
+      if (hasKeys && !hasPatterns) {
+        flags |= kWarmKeysOnly;
+      }
+      if (hasKeys) {
+        for (const auto& key : warm->keys.value()) {
+          _keyPool.push_back(_atoms.acquire(key));
+          keyCount++;
+        }
+      }
+      _warmCount++;
+    }
+    if (watchesCold) {
+      flags |= kWatchesCold;
+      _coldCount++;
+    }
+
+    if (!actionType.empty()) {
+      flags |= kTrigger;
+    }
+
+    // AND only means something when both sides are watched
+    if (config.combined.has_value() && config.combined->logic == CombineLogic::AND && warm != nullptr &&
+        watchesCold) {
+      flags |= kAndLogic;
+    }
+
+    double throttleMs = 0;
+    if (config.options.has_value() && config.options->throttleMs.value_or(0) > 0) {
+      flags |= kHasThrottle;
+      throttleMs = config.options->throttleMs.value();
+    }
+    double debounceMs = 0;
+    if (config.options.has_value() && config.options->debounceMs.value_or(0) > 0) {
+      flags |= kHasDebounce;
+      debounceMs = config.options->debounceMs.value();
+    }
+
+    _flags.push_back(flags);
+    _warmInstance.push_back(instance);
+    _keyBegin.push_back(keyBegin);
+    _keyCount.push_back(keyCount);
+    _nextAllowedTrigger.push_back(0);
+    _throttleMs.push_back(throttleMs);
+    _debounceMs.push_back(debounceMs);
+    _triggerCount.push_back(0);
+    _lastTriggered.push_back(std::numeric_limits<double>::quiet_NaN());
+    _cold.push_back(ColdData{atom, config, createdAt, std::move(actionType)});
+    return dense;
+  }
+
+  bool erase(std::string_view id) {
+    auto dense = find(id);
+    if (!dense.has_value()) {
+      return false;
+    }
+    eraseAt(dense.value());
+    return true;
+  }
+
+  void clear() {
+    _ids.clear();
+    _atoms.clear();
+    _slots.clear();
+    _freeSlots.clear();
+    _slotOfAtom.clear();
+    _slotOfDense.clear();
+    _keyPool.clear();
+    _keyPoolGarbage = 0;
+    _warmCount = 0;
+    _coldCount = 0;
+    _flags.clear();
+    _warmInstance.clear();
+    _keyBegin.clear();
+    _keyCount.clear();
+    _nextAllowedTrigger.clear();
+    _throttleMs.clear();
+    _debounceMs.clear();
+    _triggerCount.clear();
+    _lastTriggered.clear();
+    _cold.clear();
+  }
+
+  // Hot data accessors (dense index)
+  uint16_t& flags(uint32_t i) { return _flags[i]; }
+  uint16_t flags(uint32_t i) const { return _flags[i]; }
+  uint32_t warmInstance(uint32_t i) const { return _warmInstance[i]; }
+  double& nextAllowedTrigger(uint32_t i) { return _nextAllowedTrigger[i]; }
+  double throttleMs(uint32_t i) const { return _throttleMs[i]; }
+  double debounceMs(uint32_t i) const { return _debounceMs[i]; }
+  double& triggerCount(uint32_t i) { return _triggerCount[i]; }
+  double triggerCount(uint32_t i) const { return _triggerCount[i]; }
+  double& lastTriggeredRaw(uint32_t i) { return _lastTriggered[i]; }
+  std::optional<double> lastTriggered(uint32_t i) const {
+    return std::isnan(_lastTriggered[i]) ? std::nullopt : std::optional<double>(_lastTriggered[i]);
+  }
+
+  /**
+   * True if the listener's exact-key filter contains `keyAtom`
+   */
+  bool hasKey(uint32_t i, uint32_t keyAtom) const {
+    const uint32_t* begin = _keyPool.data() + _keyBegin[i];
+    const uint32_t* end = begin + _keyCount[i];
+    for (const uint32_t* it = begin; it != end; ++it) {
+      if (*it == keyAtom) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Cold data accessors (dense index)
+  const ColdData& cold(uint32_t i) const { return _cold[i]; }
+  const std::string& id(uint32_t i) const { return _ids.str(_cold[i].idAtom); }
+
+  /**
+   * Atom for a Warm instance ID or key, or kNone if no listener uses it.
+   * Lets dispatch reject listeners by integer comparison.
+   */
+  uint32_t atomOf(std::string_view text) const { return _atoms.find(text); }
+
+  static const WarmListenerConfig* warmConfigOf(const ListenerConfig& config) {
+    if (config.warm.has_value()) {
+      return &config.warm.value();
+    }
+    if (config.combined.has_value() && config.combined->warm.has_value()) {
+      return &config.combined->warm.value();
+    }
+    return nullptr;
+  }
+
+  static const ColdListenerConfig* coldConfigOf(const ListenerConfig& config) {
+    if (config.cold.has_value()) {
+      return &config.cold.value();
+    }
+    if (config.combined.has_value() && config.combined->cold.has_value()) {
+      return &config.combined->cold.value();
+    }
+    return nullptr;
+  }
+
+private:
+  struct Slot {
+    uint32_t dense = StringInterner::kNone;
+    uint32_t generation = 0;
+  };
+
+  void eraseAt(uint32_t dense) {
+    uint32_t last = static_cast<uint32_t>(_cold.size() - 1);
+    uint16_t flags = _flags[dense];
+
+    // Release interned strings owned by this listener
+    if (flags & kWatchesWarm) {
+      _atoms.release(_warmInstance[dense]);
+      for (uint32_t k = 0; k < _keyCount[dense]; ++k) {
+        _atoms.release(_keyPool[_keyBegin[dense] + k]);
+      }
+      _keyPoolGarbage += _keyCount[dense];
+      _warmCount--;
+    }
+    if (flags & kWatchesCold) {
+      _coldCount--;
+    }
+    uint32_t atom = _cold[dense].idAtom;
+    uint32_t slot = _slotOfDense[dense];
+    _slotOfAtom[atom] = StringInterner::kNone;
+    _ids.release(atom);
+    _slots[slot].dense = StringInterner::kNone;
+    _slots[slot].generation++;
+    _freeSlots.push_back(slot);
+
+    // Swap the last listener into the hole
+    if (dense != last) {
+      _flags[dense] = _flags[last];
+      _warmInstance[dense] = _warmInstance[last];
+      _keyBegin[dense] = _keyBegin[last];
+      _keyCount[dense] = _keyCount[last];
+      _nextAllowedTrigger[dense] = _nextAllowedTrigger[last];
+      _throttleMs[dense] = _throttleMs[last];
+      _debounceMs[dense] = _debounceMs[last];
+      _triggerCount[dense] = _triggerCount[last];
+      _lastTriggered[dense] = _lastTriggered[last];
+      _cold[dense] = std::move(_cold[last]);
+      _slotOfDense[dense] = _slotOfDense[last];
+      _slots[_slotOfDense[dense]].dense = dense;
+    }
+    _flags.pop_back();
+    _warmInstance.pop_back();
+    _keyBegin.pop_back();
+    _keyCount.pop_back();
+    _nextAllowedTrigger.pop_back();
+    _throttleMs.pop_back();
+    _debounceMs.pop_back();
+    _triggerCount.pop_back();
+    _lastTriggered.pop_back();
+    _cold.pop_back();
+    _slotOfDense.pop_back();
+
+    compactKeyPool();
+  }
+
+  /**
+   * Drop key ranges of removed listeners once they make up half the pool
+   */
+  void compactKeyPool() {
+    if (_keyPoolGarbage < 1024 || _keyPoolGarbage * 2 < _keyPool.size()) {
+      return;
+    }
+    std::vector<uint32_t> compacted;
+    compacted.reserve(_keyPool.size() - _keyPoolGarbage);
+    for (size_t i = 0; i < _keyBegin.size(); ++i) {
+      uint32_t begin = static_cast<uint32_t>(compacted.size());
+      compacted.insert(compacted.end(), _keyPool.begin() + _keyBegin[i],
+                       _keyPool.begin() + _keyBegin[i] + _keyCount[i]);
+      _keyBegin[i] = begin;
+    }
+    _keyPool.swap(compacted);
+    _keyPoolGarbage = 0;
+  }
+
+  StringInterner _ids;     // listener IDs
+  StringInterner _atoms;   // Warm instance IDs and keys referenced by listeners
+  std::vector<Slot> _slots;
+  std::vector<uint32_t> _freeSlots;
+  std::vector<uint32_t> _slotOfAtom;   // listener ID atom -> slot
+  std::vector<uint32_t> _slotOfDense;  // dense index -> slot
+  std::vector<uint32_t> _keyPool;      // exact-key atoms, ranges per listener
+  size_t _keyPoolGarbage = 0;
+  size_t _warmCount = 0;
+  size_t _coldCount = 0;
+
+  // Hot structure-of-arrays
+  std::vector<uint16_t> _flags;
+  std::vector<uint32_t> _warmInstance;
+  std::vector<uint32_t> _keyBegin;
+  std::vector<uint32_t> _keyCount;
+  std::vector<double> _nextAllowedTrigger;
+  std::vector<double> _throttleMs;
+  std::vector<double> _debounceMs;
+  std::vector<double> _triggerCount;
+  std::vector<double> _lastTriggered;  // NaN = never triggered
+
+  // Cold data
+  std::vector<ColdData> _cold;
+};
+
+} // namespace margelo::nitro::sam
@@ -0,0 +1,197 @@
+#pragma once
+
+#include "LatencyHistogram.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+
+namespace margelo::nitro::sam {
+
+/**
+ * Streaming summary of one MFE's load times
+ *
+ * Count, sum, min and max are exact; p50/p95 come from log-linear buckets
+ * over microseconds (16 sub-buckets per power of two, so a percentile is at
+ * most ~6% above the true value, up to ~71 minutes). record() is O(1) and
+ * the memory footprint is fixed however many loads are recorded.
+ *
+ * Persisted sparsely - only non-empty buckets - so a typical MFE whose load
+ * times span a few powers of two encodes in a couple hundred bytes:
+ *
+ *   offset  size  field
+ *        0     1  format (kFormat)
+ *        1     1  reserved
+ *        2     2  non-empty bucket count n
+ *        4     4  reserved
+ *        8     8  count (u64)
+ *       16     8  sum (f64, ms)
+ *       24     8  min (f64, ms)
+ *       32     8  max (f64, ms)
+ *       40  6 * n (u16 bucket index, u32 bucket count) pairs
+ *
+ * Not thread-safe.
+ */
+class LoadTimeSketch {
+public:
+  using Buckets = LogLinearBuckets<4, 31>;
+  static constexpr size_t kBucketCount = Buckets::kBucketCount;  // 464
+  static constexpr uint8_t kFormat = 1;
+  static constexpr size_t kHeaderSize = 40;
+  static constexpr size_t kPairSize = 6;
+
+  struct Summary {
+    double count = 0;
+    double minMs = 0;
+    double maxMs = 0;
+    double meanMs = 0;
+    double p50Ms = 0;
+    double p95Ms = 0;
+  };
+
+  LoadTimeSketch() { _buckets.fill(0); }
+
+  void record(double ms) {
+    if (!std::isfinite(ms) || ms < 0) {
+      return;
+    }
+    uint64_t us = static_cast<uint64_t>(ms * 1000.0);
+    uint32_t& bucket = _buckets[Buckets::bucketOf(us)];
+    if (bucket < UINT32_MAX) {
+      bucket++;
+    }
+    _minMs = _count == 0 ? ms : std::min(_minMs, ms);
+    _maxMs = _count == 0 ? ms : std::max(_maxMs, ms);
+    _sumMs += ms;
+    _count++;
+  }
+
+  /**
+   * Fold `other` into this sketch, e.g. loads recorded before the persisted
+   * sketch was read
+   */
+  void merge(const LoadTimeSketch& other) {
+    if (other._count == 0) {
+      return;
+    }
+    for (size_t i = 0; i < kBucketCount; ++i) {
+      uint64_t sum = static_cast<uint64_t>(_buckets[i]) + other._buckets[i];
+      _buckets[i] = static_cast<uint32_t>(std::min<uint64_t>(sum, UINT32_MAX));
+    }
+    _minMs = _count == 0 ? other._minMs : std::min(_minMs, other._minMs);
+    _maxMs = _count == 0 ? other._maxMs : std::max(_maxMs, other._maxMs);
+    _sumMs += other._sumMs;
+    _count += other._count;
+  }
+
+  uint64_t count() const { return _count; }
+
+  Summary summarize() const {
+    Summary summary;
+    if (_count == 0) {
+      return summary;
+    }
+    summary.count = static_cast<double>(_count);
+    summary.minMs = _minMs;
+    summary.maxMs = _maxMs;
+    summary.meanMs = _sumMs / static_cast<double>(_count);
+
+    // Bucket counts can saturate, so rank against their own total
+    uint64_t total = 0;
+    for (uint32_t bucket : _buckets) {
+      total += bucket;
+    }
+    const double p50Rank = 0.5 * static_cast<double>(total);
+    const double p95Rank = 0.95 * static_cast<double>(total);
+    uint64_t seen = 0;
+    bool p50Found = false;
+    summary.p50Ms = _maxMs;
+    summary.p95Ms = _maxMs;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+      if (_buckets[i] == 0) {
+        continue;
+      }
+      seen += _buckets[i];
+      if (!p50Found && static_cast<double>(seen) >= p50Rank) {
+        summary.p50Ms = upperMs(i);
+        p50Found = true;
+      }
+      if (static_cast<double>(seen) >= p95Rank) {
+        summary.p95Ms = upperMs(i);
+        break;
+      }
+    }
+    return summary;
+  }
+
+  void encode(std::string& out) const {
+    uint16_t used = 0;
+    for (uint32_t bucket : _buckets) {
+      used += bucket != 0 ? 1 : 0;
+    }
+    out.assign(kHeaderSize + used * kPairSize, '\0');
+    out[0] = static_cast<char>(kFormat);
+    std::memcpy(out.data() + 2, &used, sizeof(used));
+    std::memcpy(out.data() + 8, &_count, sizeof(_count));
+    std::memcpy(out.data() + 16, &_sumMs, sizeof(_sumMs));
+    std::memcpy(out.data() + 24, &_minMs, sizeof(_minMs));
+    std::memcpy(out.data() + 32, &_maxMs, sizeof(_maxMs));
+    size_t offset = kHeaderSize;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+      if (_buckets[i] == 0) {
+        continue;
+      }
+      uint16_t index = static_cast<uint16_t>(i);
+      std::memcpy(out.data() + offset, &index, sizeof(index));
+      std::memcpy(out.data() + offset + 2, &_buckets[i], sizeof(uint32_t));
+      offset += kPairSize;
+    }
+  }
+
+  /**
+   * Returns nullopt for truncated data or an unknown format
+   */
+  static std::optional<LoadTimeSketch> decode(const void* bytes, size_t size) {
+    const char* data = static_cast<const char*>(bytes);
+    if (size < kHeaderSize || static_cast<uint8_t>(data[0]) != kFormat) {
+      return std::nullopt;
+    }
+    uint16_t used;
+    std::memcpy(&used, data + 2, sizeof(used));
+    if (size != kHeaderSize + used * kPairSize) {
+      return std::nullopt;
+    }
+    LoadTimeSketch sketch;
+    std::memcpy(&sketch._count, data + 8, sizeof(sketch._count));
+    std::memcpy(&sketch._sumMs, data + 16, sizeof(sketch._sumMs));
+    std::memcpy(&sketch._minMs, data + 24, sizeof(sketch._minMs));
+    std::memcpy(&sketch._maxMs, data + 32, sizeof(sketch._maxMs));
+    for (size_t offset = kHeaderSize; offset < size; offset += kPairSize) {
+      uint16_t index;
+      std::memcpy(&index, data + offset, sizeof(index));
+      if (index >= kBucketCount) {
+        return std::nullopt;
+      }
+      std::memcpy(&sketch._buckets[index], data + offset + 2, sizeof(uint32_t));
+    }
+    return sketch;
+  }
+
+private:
+  // Bucket upper bound, clamped to the exact extremes
+  double upperMs(size_t bucket) const {
+    double ms = static_cast<double>(Buckets::upperBound(bucket)) / 1000.0;
+    return std::clamp(ms, _minMs, _maxMs);
+  }
+
+  uint64_t _count = 0;
+  double _sumMs = 0;
+  double _minMs = 0;
+  double _maxMs = 0;
+  std::array<uint32_t, kBucketCount> _buckets;
+};
+
+} // namespace margelo::nitro::sam
@@ -0,0 +1,357 @@
+#pragma once
+
+#include "LogCategory.hpp"
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+
+#include "MpscRing.hpp"
+
+#ifdef __ANDROID__
+#include <android/log.h>
+#endif
+
+#ifdef __APPLE__
+#include <os/log.h>
+#endif
+
+namespace margelo::nitro::sam {
+
+/**
+ * Log severity, lowest first. Exposed to JS as a number (0-5) because
+ * DEBUG and ERROR are common preprocessor macros in app builds.
+ */
+enum class LogLevel : uint8_t {
+  Trace = 0,
+  Debug = 1,
+  Info = 2,
+  Warn = 3,
+  Error = 4,
+  Off = 5,
+};
+
+/**
+ * Fixed-size log entry, formatted in place by the producer
+ */
+struct LogRecord {
+  static constexpr size_t kMaxText = 232;  // longer messages are truncated
+
+  double timestamp = 0;                    // Unix ms
+  LogLevel level = LogLevel::Info;
+  LogCategory category = LogCategory::GENERAL;
+  uint16_t length = 0;
+  char text[kMaxText];
+};
+
+/**
+ * Asynchronous structured logger
+ *
+ * Producers check a per-category level with one relaxed load; when the
+ * level is off nothing else happens (use SAM_LOG so the arguments are not
+ * even evaluated). Enabled messages are formatted straight into a slot of a
+ * lock-free ring buffer - no heap allocation, no locks, no I/O - and a
+ * background thread writes them to the platform sink:
+ *
+ * - Android: logcat (tag "SAM")
+ * - Apple: os_log, one log object per category
+ * - Elsewhere: stderr, flushed once per batch rather than per line
+ *
+ * If the ring is full, messages are dropped and counted; the flusher reports
+ * the count. The flusher thread is only started by the first enabled message.
+ */
+class Logger {
+public:
+  static constexpr size_t kCategoryCount = static_cast<size_t>(LogCategory::NETWORK) + 1;
+  static constexpr size_t kCapacity = 512;  // records, ~128KB
+
+  Logger() {
+    setLevel(LogLevel::Warn);
+  }
+
+  ~Logger() {
+    stop();
+  }
+
+  Logger(const Logger&) = delete;
+  Logger& operator=(const Logger&) = delete;
+
+  bool enabled(LogLevel level, LogCategory category) const {
+    return level >= static_cast<LogLevel>(
+        _levels[static_cast<size_t>(category)].load(std::memory_order_relaxed)) &&
+        level != LogLevel::Off;
+  }
+
+  LogLevel level(LogCategory category) const {
+    return static_cast<LogLevel>(_levels[static_cast<size_t>(category)].load(std::memory_order_relaxed));
+  }
+
+  void setLevel(LogCategory category, LogLevel level) {
+    _levels[static_cast<size_t>(category)].store(static_cast<uint8_t>(level), std::memory_order_relaxed);
+  }
+
+  void setLevel(LogLevel level) {
+    for (auto& categoryLevel : _levels) {
+      categoryLevel.store(static_cast<uint8_t>(level), std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * Format `parts` (strings, numbers, bools) into one message and queue it.
+   * Does not check the level; call through SAM_LOG.
+   */
+  template <typename... Parts>
+  void log(LogLevel level, LogCategory category, const Parts&... parts) {
+    std::call_once(_started, [this]() { start(); });
+    double timestamp = nowMs();
+    bool pushed = _ring->tryPush([&](LogRecord& record) {
+      record.timestamp = timestamp;
+      record.level = level;
+      record.category = category;
+      record.length = 0;
+      (append(record, parts), ...);
+    });
+    if (!pushed) {
+      _dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    _pushed.fetch_add(1, std::memory_order_acq_rel);
+    wake();
+  }
+
+  /**
+   * Block until every message queued before this call has been written
+   */
+  void flush() {
+    uint64_t target = _pushed.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(_parkMutex);
+    _flushedCv.wait(lock, [this, target]() {
+      return _written.load(std::memory_order_acquire) >= target ||
+             _stop.load(std::memory_order_acquire);
+    });
+  }
+
+  static const char* categoryName(LogCategory category) {
+    switch (category) {
+      case LogCategory::GENERAL: return "general";
+      case LogCategory::LISTENERS: return "listeners";
+      case LogCategory::WARM: return "warm";
+      case LogCategory::COLD: return "cold";
+      case LogCategory::DISPATCH: return "dispatch";
+      case LogCategory::NETWORK: return "network";
+    }
+    return "general";
+  }
+
+private:
+  // -------------------------------------------------------------------------
+  // Formatting (producer side)
+  // -------------------------------------------------------------------------
+
+  static double nowMs() {
+    return static_cast<double>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch())
+            .count());
+  }
+
+  static void appendText(LogRecord& record, std::string_view text) {
+    size_t room = LogRecord::kMaxText - record.length;
+    size_t count = text.size() < room ? text.size() : room;
+    std::memcpy(record.text + record.length, text.data(), count);
+    record.length = static_cast<uint16_t>(record.length + count);
+  }
+
+  template <typename T>
+  static void append(LogRecord& record, const T& part) {
+    if constexpr (std::is_same_v<T, bool>) {
+      appendText(record, part ? "true" : "false");
+    } else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+      appendText(record, std::string_view(part));
+    } else if constexpr (std::is_integral_v<T>) {
+      char buffer[24];
+      auto result = std::to_chars(buffer, buffer + sizeof(buffer), part);
+      appendText(record, std::string_view(buffer, static_cast<size_t>(result.ptr - buffer)));
+    } else if constexpr (std::is_floating_point_v<T>) {
+      char buffer[32];
+      int length = std::snprintf(buffer, sizeof(buffer), "%g", static_cast<double>(part));
+      appendText(record, std::string_view(buffer, length > 0 ? static_cast<size_t>(length) : 0));
+    } else {
+      static_assert(std::is_same_v<T, bool>, "Unsupported log argument type");
+    }
+  }
+
+  // -------------------------------------------------------------------------
+  // Flusher thread
+  // -------------------------------------------------------------------------
+
+  void start() {
+    _ring = std::make_unique<MpscRing<LogRecord>>(kCapacity);
+#ifdef __APPLE__
+    for (size_t i = 0; i < kCategoryCount; ++i) {
+      _osLogs[i] = os_log_create("react-native-s-a-m", categoryName(static_cast<LogCategory>(i)));
+    }
+#endif
+    _flusher = std::thread([this]() { run(); });
+  }
+
+  void run() {
+    while (true) {
+      uint64_t written = 0;
+      while (_ring->tryPop([this](const LogRecord& record) { write(record); })) {
+        written++;
+      }
+      uint64_t dropped = _dropped.exchange(0, std::memory_order_relaxed);
+      if (dropped > 0) {
+        LogRecord notice;
+        notice.timestamp = nowMs();
+        notice.level = LogLevel::Warn;
+        notice.category = LogCategory::GENERAL;
+        append(notice, dropped);
+        appendText(notice, " log messages dropped (buffer full)");
+        write(notice);
+      }
+      if (written > 0 || dropped > 0) {
+        endBatch();
+      }
+      if (written > 0) {
+        _written.fetch_add(written, std::memory_order_acq_rel);
+        {
+          std::lock_guard<std::mutex> lock(_parkMutex);
+        }
+        _flushedCv.notify_all();
+        continue;
+      }
+      if (_stop.load(std::memory_order_acquire)) {
+        return;
+      }
+      park();
+    }
+  }
+
+  void park() {
+    std::unique_lock<std::mutex> lock(_parkMutex);
+    _parked.store(true, std::memory_order_seq_cst);
+    // Re-check after publishing the flag, as the change dispatcher does
+    if (!_ring->empty() || _stop.load(std::memory_order_seq_cst)) {
+      _parked.store(false, std::memory_order_relaxed);
+      return;
+    }
+    _parkCv.wait(lock, [this]() {
+      return !_parked.load(std::memory_order_seq_cst) || _stop.load(std::memory_order_seq_cst);
+    });
+  }
+
+  void wake() {
+    if (_parked.exchange(false, std::memory_order_seq_cst)) {
+      std::lock_guard<std::mutex> lock(_parkMutex);
+      _parkCv.notify_one();
+    }
+  }
+
+  void stop() {
+    {
+      std::lock_guard<std::mutex> lock(_parkMutex);
+      _stop.store(true, std::memory_order_seq_cst);
+      _parked.store(false, std::memory_order_seq_cst);
+    }
+    _parkCv.notify_one();
+    _flushedCv.notify_all();
+    if (_flusher.joinable()) {
+      _flusher.join();
+    }
+  }
+
+  // -------------------------------------------------------------------------
+  // Platform sinks (flusher thread only)
+  // -------------------------------------------------------------------------
+
+  void write(const LogRecord& record) {
+    const char* category = categoryName(record.category);
+    int length = static_cast<int>(record.length);
+#if defined(__ANDROID__)
+    int priority = ANDROID_LOG_INFO;
+    switch (record.level) {
+      case LogLevel::Trace: priority = ANDROID_LOG_VERBOSE; break;
+      case LogLevel::Debug: priority = ANDROID_LOG_DEBUG; break;
+      case LogLevel::Info: priority = ANDROID_LOG_INFO; break;
+      case LogLevel::Warn: priority = ANDROID_LOG_WARN; break;
+      default: priority = ANDROID_LOG_ERROR; break;
+    }
+    __android_log_print(priority, "SAM", "[%s] %.*s", category, length, record.text);
+#elif defined(__APPLE__)
+    os_log_type_t type = OS_LOG_TYPE_DEFAULT;
+    switch (record.level) {
+      case LogLevel::Trace:
+      case LogLevel::Debug: type = OS_LOG_TYPE_DEBUG; break;
+      case LogLevel::Info: type = OS_LOG_TYPE_INFO; break;
+      case LogLevel::Warn: type = OS_LOG_TYPE_DEFAULT; break;
+      default: type = OS_LOG_TYPE_ERROR; break;
+    }
+    (void)category;
+    os_log_with_type(_osLogs[static_cast<size_t>(record.category)], type, "%{public}.*s",
+                     length, record.text);
+#else
+    static constexpr const char kLevels[] = {'T', 'D', 'I', 'W', 'E', '-'};
+    std::fprintf(stderr, "[SAM] %.0f %c/%s: %.*s\n", record.timestamp,
+                 kLevels[static_cast<size_t>(record.level)], category, length, record.text);
+#endif
+  }
+
+  void endBatch() {
+#if !defined(__ANDROID__) && !defined(__APPLE__)
+    std::fflush(stderr);
+#endif
+  }
+
+  std::array<std::atomic<uint8_t>, kCategoryCount> _levels;
+
+  std::unique_ptr<MpscRing<LogRecord>> _ring;
+  std::once_flag _started;
+  std::thread _flusher;
+  std::atomic<bool> _stop{false};
+  std::atomic<bool> _parked{false};
+  std::mutex _parkMutex;
+  std::condition_variable _parkCv;
+  std::condition_variable _flushedCv;
+  std::atomic<uint64_t> _pushed{0};
+  std::atomic<uint64_t> _written{0};
+  std::atomic<uint64_t> _dropped{0};
+
+#ifdef __APPLE__
+  std::array<os_log_t, kCategoryCount> _osLogs;
+#endif
+};
+
+} // namespace margelo::nitro::sam
+
+/**
+ * Log through `logger` if `level` is enabled for `category`. The message
+ * parts are only evaluated and formatted when it is.
+ */
+#define SAM_LOG(logger, level, category, ...)                 \
+  do {                                                        \
+    if ((logger).enabled((level), (category))) {              \
+      (logger).log((level), (category), __VA_ARGS__);         \
+    }                                                         \
+  } while (false)
+
+#define SAM_LOG_TRACE(logger, category, ...) \
+  SAM_LOG(logger, ::margelo::nitro::sam::LogLevel::Trace, category, __VA_ARGS__)
+#define SAM_LOG_DEBUG(logger, category, ...) \
+  SAM_LOG(logger, ::margelo::nitro::sam::LogLevel::Debug, category, __VA_ARGS__)
+#define SAM_LOG_INFO(logger, category, ...) \
+  SAM_LOG(logger, ::margelo::nitro::sam::LogLevel::Info, category, __VA_ARGS__)
+#define SAM_LOG_WARN(logger, category, ...) \
+  SAM_LOG(logger, ::margelo::nitro::sam::LogLevel::Warn, category, __VA_ARGS__)
+#define SAM_LOG_ERROR(logger, category, ...) \
+  SAM_LOG(logger, ::margelo::nitro::sam::LogLevel::Error, category, __VA_ARGS__)
@@ -0,0 +1,429 @@
+#pragma once
+
+#include "MFEPhase.hpp"
+#include "MFERecord.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace margelo::nitro::sam {
+
+/**
+ * Fixed-layout binary encoding of an MFE registry record
+ *
+ * One record per MFE is persisted as an MMKV bytes value, so reading the
+ * whole registry at startup is a key scan plus a memcpy per MFE - no JSON.
+ * Layout (host byte order; every supported target is little-endian):
+ *
+ *   offset  size  field
+ *        0     1  format (kFormat)
+ *        1     1  phase (MFEPhase)
+ *        2     1  present: bitmask of the optional fields below
+ *        3     1  reserved
+ *        4     2  version length
+ *        6     2  error message length
+ *        8     8  loadedAt      (f64, ms since epoch)
+ *       16     8  mountedAt
+ *       24     8  unmountedAt
+ *       32     8  loadTimeMs
+ *       40     8  updatedAt
+ *       48     -  version bytes, then error message bytes
+ *
+ * The MFE ID is the storage key and is not repeated in the record. Strings
+ * longer than 65535 bytes are truncated.
+ */
+namespace mfe_record {
+
+constexpr uint8_t kFormat = 1;
+constexpr size_t kHeaderSize = 48;
+
+enum Present : uint8_t {
+  kLoadedAt = 1 << 0,
+  kMountedAt = 1 << 1,
+  kUnmountedAt = 1 << 2,
+  kLoadTimeMs = 1 << 3,
+  kVersion = 1 << 4,
+  kErrorMessage = 1 << 5,
+};
+
+namespace detail {
+
+inline void putDouble(std::string& out, size_t offset, const std::optional<double>& value) {
+  double raw = value.value_or(0);
+  std::memcpy(out.data() + offset, &raw, sizeof(raw));
+}
+
+inline std::optional<double> getDouble(const char* data, size_t offset, bool present) {
+  if (!present) {
+    return std::nullopt;
+  }
+  double raw;
+  std::memcpy(&raw, data + offset, sizeof(raw));
+  return raw;
+}
+
+inline uint16_t clampLength(const std::optional<std::string>& text) {
+  if (!text.has_value()) {
+    return 0;
+  }
+  return static_cast<uint16_t>(text->size() > 0xFFFF ? 0xFFFF : text->size());
+}
+
+} // namespace detail
+
+/**
+ * Encode `record` into `out` (replacing its contents)
+ */
+inline void encode(const MFERecord& record, std::string& out) {
+  uint16_t versionLength = detail::clampLength(record.version);
+  uint16_t errorLength = detail::clampLength(record.errorMessage);
+  out.assign(kHeaderSize + versionLength + errorLength, '\0');
+
+  uint8_t present = 0;
+  present |= record.loadedAt.has_value() ? kLoadedAt : 0;
+  present |= record.mountedAt.has_value() ? kMountedAt : 0;
+  present |= record.unmountedAt.has_value() ? kUnmountedAt : 0;
+  present |= record.loadTimeMs.has_value() ? kLoadTimeMs : 0;
+  present |= record.version.has_value() ? kVersion : 0;
+  present |= record.errorMessage.has_value() ? kErrorMessage : 0;
+
+  out[0] = static_cast<char>(kFormat);
+  out[1] = static_cast<char>(record.phase);
+  out[2] = static_cast<char>(present);
+  std::memcpy(out.data() + 4, &versionLength, sizeof(versionLength));
+  std::memcpy(out.data() + 6, &errorLength, sizeof(errorLength));
+  detail::putDouble(out, 8, record.loadedAt);
+  detail::putDouble(out, 16, record.mountedAt);
+  detail::putDouble(out, 24, record.unmountedAt);
+  detail::putDouble(out, 32, record.loadTimeMs);
+  detail::putDouble(out, 40, record.updatedAt);
+  if (versionLength > 0) {
+    std::memcpy(out.data() + kHeaderSize, record.version->data(), versionLength);
+  }
+  if (errorLength > 0) {
+    std::memcpy(out.data() + kHeaderSize + versionLength, record.errorMessage->data(), errorLength);
+  }
+}
+
+/**
+ * Decode a record stored under `mfeId`. Returns nullopt for data that is
+ * truncated or written by an unknown format.
+ */
+inline std::optional<MFERecord> decode(const std::string& mfeId, const void* bytes, size_t size) {
+  const char* data = static_cast<const char*>(bytes);
+  if (size < kHeaderSize || static_cast<uint8_t>(data[0]) != kFormat) {
+    return std::nullopt;
+  }
+  uint8_t phase = static_cast<uint8_t>(data[1]);
+  if (phase > static_cast<uint8_t>(MFEPhase::FAILED)) {
+    return std::nullopt;
+  }
+  uint8_t present = static_cast<uint8_t>(data[2]);
+  uint16_t versionLength;
+  uint16_t errorLength;
+  std::memcpy(&versionLength, data + 4, sizeof(versionLength));
+  std::memcpy(&errorLength, data + 6, sizeof(errorLength));
+  if (size != kHeaderSize + versionLength + errorLength) {
+    return std::nullopt;
+  }
+
+  std::optional<std::string> version;
+  if (present & kVersion) {
+    version = std::string(data + kHeaderSize, versionLength);
+  }
+  std::optional<std::string> errorMessage;
+  if (present & kErrorMessage) {
+    errorMessage = std::string(data + kHeaderSize + versionLength, errorLength);
+  }
+  double updatedAt;
+  std::memcpy(&updatedAt, data + 40, sizeof(updatedAt));
+
+  return MFERecord(
+      mfeId,
+      static_cast<MFEPhase>(phase),
+      std::move(version),
+      std::move(errorMessage),
+      detail::getDouble(data, 8, present & kLoadedAt),
+      detail::getDouble(data, 16, present & kMountedAt),
+      detail::getDouble(data, 24, present & kUnmountedAt),
+      detail::getDouble(data, 32, present & kLoadTimeMs),
+      updatedAt);
+}
+
+/**
+ * Records written by the JS registry before the native one: the state string
+ * under "mfe.<id>" and, once any metadata was set, a JSON object under
+ * "mfe.<id>.meta" ({state, version, loadedAt, mountedAt, unmountedAt,
+ * errorMessage, loadTimeMs}). Only read, to migrate them at hydration.
+ */
+namespace legacy {
+
+constexpr std::string_view kKeyPrefix = "mfe.";
+constexpr std::string_view kMetaSuffix = ".meta";
+
+/**
+ * Phase for a legacy state string; any unknown state is a version
+ */
+inline MFEPhase phaseOf(std::string_view state) {
+  if (state.empty()) {
+    return MFEPhase::IDLE;
+  }
+  if (state == "loading") {
+    return MFEPhase::LOADING;
+  }
+  if (state == "loaded") {
+    return MFEPhase::LOADED;
+  }
+  if (state == "mounted") {
+    return MFEPhase::MOUNTED;
+  }
+  if (state == "error") {
+    return MFEPhase::FAILED;
+  }
+  return MFEPhase::VERSIONED;
+}
+
+namespace detail {
+
+inline void skipSpace(std::string_view json, size_t& at) {
+  while (at < json.size() && (json[at] == ' ' || json[at] == '\t' || json[at] == '\n' || json[at] == '\r')) {
+    at++;
+  }
+}
+
+inline void appendUtf8(std::string& out, uint32_t codePoint) {
+  if (codePoint < 0x80) {
+    out += static_cast<char>(codePoint);
+  } else if (codePoint < 0x800) {
+    out += static_cast<char>(0xC0 | (codePoint >> 6));
+    out += static_cast<char>(0x80 | (codePoint & 0x3F));
+  } else if (codePoint < 0x10000) {
+    out += static_cast<char>(0xE0 | (codePoint >> 12));
+    out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+    out += static_cast<char>(0x80 | (codePoint & 0x3F));
+  } else {
+    out += static_cast<char>(0xF0 | (codePoint >> 18));
+    out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+    out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+    out += static_cast<char>(0x80 | (codePoint & 0x3F));
+  }
+}
+
+inline bool readHex4(std::string_view json, size_t at, uint32_t& out) {
+  if (at + 4 > json.size()) {
+    return false;
+  }
+  out = 0;
+  for (size_t i = at; i < at + 4; ++i) {
+    char c = json[i];
+    out <<= 4;
+    if (c >= '0' && c <= '9') {
+      out |= static_cast<uint32_t>(c - '0');
+    } else if (c >= 'a' && c <= 'f') {
+      out |= static_cast<uint32_t>(c - 'a' + 10);
+    } else if (c >= 'A' && c <= 'F') {
+      out |= static_cast<uint32_t>(c - 'A' + 10);
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Read the JSON string starting at json[at] (the opening quote)
+ */
+inline bool readString(std::string_view json, size_t& at, std::string& out) {
+  out.clear();
+  at++;
+  while (at < json.size()) {
+    char c = json[at++];
+    if (c == '"') {
+      return true;
+    }
+    if (c != '\\') {
+      out += c;
+      continue;
+    }
+    if (at >= json.size()) {
+      return false;
+    }
+    switch (json[at++]) {
+      case '"':  out += '"'; break;
+      case '\\': out += '\\'; break;
+      case '/':  out += '/'; break;
+      case 'b':  out += '\b'; break;
+      case 'f':  out += '\f'; break;
+      case 'n':  out += '\n'; break;
+      case 'r':  out += '\r'; break;
+      case 't':  out += '\t'; break;
+      case 'u': {
+        uint32_t codePoint;
+        if (!readHex4(json, at, codePoint)) {
+          return false;
+        }
+        at += 4;
+        uint32_t low;
+        if (codePoint >= 0xD800 && codePoint <= 0xDBFF && at + 6 <= json.size() && json[at] == '\\' &&
+            json[at + 1] == 'u' && readHex4(json, at + 2, low) && low >= 0xDC00 && low <= 0xDFFF) {
+          codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+          at += 6;
+        }
+        appendUtf8(out, codePoint);
+        break;
+      }
+      default:
+        return false;
+    }
+  }
+  return false;
+}
+
+} // namespace detail
+
+/**
+ * Call `onString(name, text)` / `onNumber(name, value)` for each member of a
+ * flat JSON object (JSON.stringify output). true/false/null members are
+ * skipped. Returns false for anything else, including nested values.
+ */
+template <typename OnString, typename OnNumber>
+bool readFlatObject(std::string_view json, OnString&& onString, OnNumber&& onNumber) {
+  size_t at = 0;
+  detail::skipSpace(json, at);
+  if (at >= json.size() || json[at++] != '{') {
+    return false;
+  }
+  std::string name;
+  std::string text;
+  detail::skipSpace(json, at);
+  if (at < json.size() && json[at] == '}') {
+    return true;
+  }
+  while (at < json.size()) {
+    detail::skipSpace(json, at);
+    if (at >= json.size() || json[at] != '"' || !detail::readString(json, at, name)) {
+      return false;
+    }
+    detail::skipSpace(json, at);
+    if (at >= json.size() || json[at++] != ':') {
+      return false;
+    }
+    detail::skipSpace(json, at);
+    if (at >= json.size()) {
+      return false;
+    }
+    char c = json[at];
+    if (c == '"') {
+      if (!detail::readString(json, at, text)) {
+        return false;
+      }
+      onString(name, text);
+    } else if (c == '-' || (c >= '0' && c <= '9')) {
+      size_t end = at;
+      while (end < json.size() && json[end] != '\0' && std::strchr("+-.eE0123456789", json[end]) != nullptr) {
+        end++;
+      }
+      std::string number(json.substr(at, end - at));
+      char* parsed = nullptr;
+      double value = std::strtod(number.c_str(), &parsed);
+      if (parsed != number.c_str() + number.size()) {
+        return false;
+      }
+      onNumber(name, value);
+      at = end;
+    } else {
+      bool skipped = false;
+      for (std::string_view literal : {std::string_view("true"), std::string_view("false"), std::string_view("null")}) {
+        if (json.substr(at, literal.size()) == literal) {
+          at += literal.size();
+          skipped = true;
+          break;
+        }
+      }
+      if (!skipped) {
+        return false;
+      }
+    }
+    detail::skipSpace(json, at);
+    if (at >= json.size()) {
+      return false;
+    }
+    if (json[at] == '}') {
+      return true;
+    }
+    if (json[at++] != ',') {
+      return false;
+    }
+  }
+  return false;
+}
+
+/**
+ * Build a record from a legacy state string and metadata JSON, either of
+ * which may be missing. Unreadable metadata is ignored. The legacy format
+ * had no update time, so the latest timestamp in it (or `nowMs`) is used.
+ * Returns nullopt if there is nothing to migrate.
+ */
+inline std::optional<MFERecord> decode(const std::string& mfeId, const std::optional<std::string>& state,
+                                       const std::optional<std::string>& metaJson, double nowMs) {
+  std::optional<std::string> metaState;
+  MFERecord record(mfeId, MFEPhase::IDLE, std::nullopt, std::nullopt, std::nullopt, std::nullopt,
+                   std::nullopt, std::nullopt, 0);
+  bool metaRead = false;
+  if (metaJson.has_value()) {
+    MFERecord parsed = record;
+    metaRead = readFlatObject(
+        *metaJson,
+        [&](const std::string& name, const std::string& text) {
+          if (name == "state") {
+            metaState = text;
+          } else if (name == "version") {
+            parsed.version = text;
+          } else if (name == "errorMessage") {
+            parsed.errorMessage = text;
+          }
+        },
+        [&](const std::string& name, double value) {
+          if (name == "loadedAt") {
+            parsed.loadedAt = value;
+          } else if (name == "mountedAt") {
+            parsed.mountedAt = value;
+          } else if (name == "unmountedAt") {
+            parsed.unmountedAt = value;
+          } else if (name == "loadTimeMs") {
+            parsed.loadTimeMs = value;
+          }
+        });
+    if (metaRead) {
+      record = std::move(parsed);
+    } else {
+      metaState.reset();
+    }
+  }
+  if (!state.has_value() && !metaRead) {
+    return std::nullopt;
+  }
+
+  // The state key is written on every change; the metadata only sometimes
+  std::string current = state.has_value() ? *state : metaState.value_or("");
+  record.phase = phaseOf(current);
+  if (record.phase == MFEPhase::VERSIONED && !record.version.has_value()) {
+    record.version = current;
+  }
+  double updatedAt = 0;
+  for (const std::optional<double>& time : {record.loadedAt, record.mountedAt, record.unmountedAt}) {
+    updatedAt = std::max(updatedAt, time.value_or(0));
+  }
+  record.updatedAt = updatedAt > 0 ? updatedAt : nowMs;
+  return record;
+}
+
+} // namespace legacy
+
+} // namespace mfe_record
+
+} // namespace margelo::nitro::sam
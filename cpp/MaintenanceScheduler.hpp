@@ -0,0 +1,164 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+namespace margelo::nitro::sam {
+
+/**
+ * One background thread for periodic storage maintenance
+ *
+ * Each named task runs every `interval` on the same thread, so tasks never
+ * overlap one another and may share state without locking between them.
+ * runSoon() brings a task forward to the next loop iteration, e.g. for an
+ * explicit compaction request.
+ *
+ * The thread starts with the first task and sleeps until the next one is
+ * due. shutdown() waits for a running task and drops the rest.
+ */
+class MaintenanceScheduler {
+public:
+  using Clock = std::chrono::steady_clock;
+  using Task = std::function<void()>;
+
+  MaintenanceScheduler() = default;
+
+  ~MaintenanceScheduler() { shutdown(); }
+
+  MaintenanceScheduler(const MaintenanceScheduler&) = delete;
+  MaintenanceScheduler& operator=(const MaintenanceScheduler&) = delete;
+
+  /**
+   * Add `task` under `name`, replacing any task of that name. The first run
+   * is one interval from now.
+   */
+  void add(const std::string& name, std::chrono::milliseconds interval, Task&& task) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_stopping) {
+      return;
+    }
+    Entry& entry = _tasks[name];
+    entry.interval = interval;
+    entry.task = std::make_shared<Task>(std::move(task));
+    entry.due = Clock::now() + interval;
+    if (!_thread.joinable()) {
+      _thread = std::thread([this]() { run(); });
+    }
+    _cv.notify_one();
+  }
+
+  void remove(const std::string& name) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _tasks.erase(name);
+  }
+
+  bool contains(const std::string& name) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _tasks.find(name) != _tasks.end();
+  }
+
+  /**
+   * Change a task's interval; the next run is one new interval from now
+   */
+  void setInterval(const std::string& name, std::chrono::milliseconds interval) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _tasks.find(name);
+    if (it == _tasks.end()) {
+      return;
+    }
+    it->second.interval = interval;
+    it->second.due = Clock::now() + interval;
+    _cv.notify_one();
+  }
+
+  /**
+   * Run a task as soon as the thread is free; its schedule restarts after
+   */
+  void runSoon(const std::string& name) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _tasks.find(name);
+    if (it == _tasks.end()) {
+      return;
+    }
+    it->second.due = Clock::now();
+    it->second.rerun = name == _running;  // requested after the running pass began
+    _cv.notify_one();
+  }
+
+  void shutdown() {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (_stopping) {
+        return;
+      }
+      _stopping = true;
+      _tasks.clear();
+    }
+    _cv.notify_all();
+    if (_thread.joinable()) {
+      _thread.join();
+    }
+  }
+
+private:
+  struct Entry {
+    std::chrono::milliseconds interval{0};
+    Clock::time_point due;
+    std::shared_ptr<Task> task;  // shared so remove() during a run is safe
+    bool rerun = false;
+  };
+
+  void run() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (!_stopping) {
+      auto next = Clock::time_point::max();
+      std::string nextName;
+      for (const auto& [name, entry] : _tasks) {
+        if (entry.due < next) {
+          next = entry.due;
+          nextName = name;
+        }
+      }
+      if (nextName.empty()) {
+        _cv.wait(lock);
+        continue;
+      }
+      if (Clock::now() < next) {
+        _cv.wait_until(lock, next);
+        continue;  // tasks may have changed while waiting
+      }
+
+      Entry& entry = _tasks[nextName];
+      std::shared_ptr<Task> task = entry.task;
+      entry.rerun = false;
+      _running = nextName;
+      lock.unlock();
+      (*task)();
+      task = nullptr;
+      lock.lock();
+      _running.clear();
+
+      auto it = _tasks.find(nextName);
+      if (it != _tasks.end()) {
+        it->second.due = it->second.rerun ? Clock::now() : Clock::now() + it->second.interval;
+        it->second.rerun = false;
+      }
+    }
+  }
+
+  std::mutex _mutex;
+  std::condition_variable _cv;
+  std::unordered_map<std::string, Entry> _tasks;
+  std::thread _thread;
+  std::string _running;
+  bool _stopping = false;
+};
+
+} // namespace margelo::nitro::sam
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+namespace margelo::nitro::sam {
+
+/**
+ * Unbounded lock-free multi-producer / single-consumer queue
+ *
+ * Dmitry Vyukov's node-based MPSC design: push() is a single atomic exchange
+ * plus a release store, so writers on any thread never block each other or
+ * wait for the consumer. pop() must only ever be called from one thread.
+ *
+ * The queue is unbounded on purpose - producers may be holding locks the
+ * consumer needs, so they must never wait for space.
+ */
+template <typename T>
+class MpscQueue {
+public:
+  MpscQueue() : _head(new Node()), _tail(_head.load(std::memory_order_relaxed)) {}
+
+  ~MpscQueue() {
+    Node* node = _tail;
+    while (node != nullptr) {
+      Node* next = node->next.load(std::memory_order_relaxed);
+      delete node;
+      node = next;
+    }
+  }
+
+  MpscQueue(const MpscQueue&) = delete;
+  MpscQueue& operator=(const MpscQueue&) = delete;
+
+  /**
+   * Enqueue a value. Safe to call from any number of threads.
+   */
+  void push(T&& value) {
+    Node* node = new Node(std::move(value));
+    Node* prev = _head.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+  }
+
+  /**
+   * Dequeue into `out`. Consumer thread only.
+   * May report empty while a push is half-way through; the producer's
+   * wake-up after push completes covers that window.
+   */
+  bool pop(T& out) {
+    Node* tail = _tail;
+    Node* next = tail->next.load(std::memory_order_acquire);
+    if (next == nullptr) {
+      return false;
+    }
+    out = std::move(next->value);
+    _tail = next;  // `next` becomes the new stub
+    delete tail;
+    return true;
+  }
+
+  /**
+   * Consumer thread only
+   */
+  bool empty() const {
+    return _tail->next.load(std::memory_order_acquire) == nullptr;
+  }
+
+private:
+  struct Node {
+    Node() = default;
+    explicit Node(T&& v) : value(std::move(v)) {}
+    std::atomic<Node*> next{nullptr};
+    T value{};
+  };
+
+  alignas(64) std::atomic<Node*> _head;  // producers
+  alignas(64) Node* _tail;               // consumer
+};
+
+} // namespace margelo::nitro::sam
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace margelo::nitro::sam {
+
+/**
+ * Bounded lock-free multi-producer / single-consumer ring buffer
+ *
+ * Dmitry Vyukov's bounded queue: each slot carries a sequence number, so a
+ * producer claims a slot with one CAS on the enqueue position and publishes
+ * it with a release store. Nothing is allocated after construction. When the
+ * ring is full tryPush() fails instead of waiting, which makes it suitable
+ * for callers that must never block (e.g. logging under a lock).
+ *
+ * Entries are filled and read in place through callbacks, so large
+ * fixed-size records are never copied. Capacity must be a power of two.
+ */
+template <typename T>
+class MpscRing {
+public:
+  explicit MpscRing(size_t capacity)
+      : _mask(capacity - 1), _slots(std::make_unique<Slot[]>(capacity)) {
+    for (size_t i = 0; i < capacity; ++i) {
+      _slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  MpscRing(const MpscRing&) = delete;
+  MpscRing& operator=(const MpscRing&) = delete;
+
+  size_t capacity() const { return _mask + 1; }
+
+  /**
+   * Claim a slot and fill it with `fill(T&)`. Safe to call from any number
+   * of threads. Returns false, without calling `fill`, if the ring is full.
+   */
+  template <typename Fill>
+  bool tryPush(Fill&& fill) {
+    uint64_t pos = _enqueuePos.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+      slot = &_slots[pos & _mask];
+      uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+      int64_t diff = static_cast<int64_t>(sequence) - static_cast<int64_t>(pos);
+      if (diff == 0) {
+        if (_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = _enqueuePos.load(std::memory_order_relaxed);
+      }
+    }
+    fill(slot->value);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Hand the oldest published entry to `consume(const T&)`. Consumer thread
+   * only. Returns false if nothing is ready.
+   */
+  template <typename Consume>
+  bool tryPop(Consume&& consume) {
+    Slot& slot = _slots[_dequeuePos & _mask];
+    if (slot.sequence.load(std::memory_order_acquire) != _dequeuePos + 1) {
+      return false;
+    }
+    consume(static_cast<const T&>(slot.value));
+    slot.sequence.store(_dequeuePos + _mask + 1, std::memory_order_release);
+    _dequeuePos++;
+    return true;
+  }
+
+  /**
+   * Consumer thread only
+   */
+  bool empty() const {
+    return _slots[_dequeuePos & _mask].sequence.load(std::memory_order_acquire) != _dequeuePos + 1;
+  }
+
+private:
+  struct Slot {
+    std::atomic<uint64_t> sequence{0};
+    T value{};
+  };
+
+  const size_t _mask;
+  std::unique_ptr<Slot[]> _slots;
+  alignas(64) std::atomic<uint64_t> _enqueuePos{0};  // producers
+  alignas(64) uint64_t _dequeuePos = 0;              // consumer
+};
+
+} // namespace margelo::nitro::sam
@@ -0,0 +1,238 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace margelo::nitro::sam {
+
+/**
+ * Bytes in their own anonymous mapping, locked in RAM
+ *
+ * mlock() keeps the pages out of swap and, where MADV_DONTDUMP exists
+ * (Linux/Android), they are left out of core dumps. If the lock limit is
+ * reached the bytes are still kept, unlocked (locked() is false). The
+ * mapping is overwritten with zeros before it is unmapped.
+ */
+class SecureBytes {
+public:
+  SecureBytes() = default;
+
+  /**
+   * Copy `first` then `second` into a new mapping
+   */
+  explicit SecureBytes(std::string_view first, std::string_view second = {}) {
+    size_t size = first.size() + second.size();
+    if (size == 0) {
+      return;
+    }
+    size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t capacity = (size + page - 1) / page * page;
+    void* data = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (data == MAP_FAILED) {
+      throw std::bad_alloc();
+    }
+    _data = static_cast<char*>(data);
+    _capacity = capacity;
+    _size = size;
+    _locked = mlock(_data, _capacity) == 0;
+#ifdef MADV_DONTDUMP
+    madvise(_data, _capacity, MADV_DONTDUMP);
+#endif
+    std::memcpy(_data, first.data(), first.size());
+    std::memcpy(_data + first.size(), second.data(), second.size());
+  }
+
+  SecureBytes(SecureBytes&& other) noexcept { swap(other); }
+  SecureBytes& operator=(SecureBytes&& other) noexcept {
+    if (this != &other) {
+      release();
+      swap(other);
+    }
+    return *this;
+  }
+  SecureBytes(const SecureBytes&) = delete;
+  SecureBytes& operator=(const SecureBytes&) = delete;
+
+  ~SecureBytes() { release(); }
+
+  std::string_view view() const { return std::string_view(_data != nullptr ? _data : "", _size); }
+  size_t capacity() const { return _capacity; }
+  bool locked() const { return _locked; }
+
+private:
+  void swap(SecureBytes& other) noexcept {
+    std::swap(_data, other._data);
+    std::swap(_size, other._size);
+    std::swap(_capacity, other._capacity);
+    std::swap(_locked, other._locked);
+  }
+
+  void release() {
+    if (_data == nullptr) {
+      return;
+    }
+    // Volatile stores so the compiler can't drop them as dead before munmap
+    volatile char* bytes = _data;
+    for (size_t i = 0; i < _capacity; ++i) {
+      bytes[i] = 0;
+    }
+    if (_locked) {
+      munlock(_data, _capacity);
+    }
+    munmap(_data, _capacity);
+    _data = nullptr;
+    _size = 0;
+    _capacity = 0;
+    _locked = false;
+  }
+
+  char* _data = nullptr;
+  size_t _size = 0;
+  size_t _capacity = 0;
+  bool _locked = false;
+};
+
+/**
+ * Keychain values cached for SecureStorage, one per service
+ *
+ * A service is only cached after setTtl() gives it a TTL, so nothing is
+ * held in memory unless the app opts in. Each entry's username and
+ * password share one SecureBytes mapping. Expired entries are dropped on
+ * get() and by purgeExpired(); every eviction zeroes the entry's memory.
+ *
+ * erase() and clear() advance the generation of the services they drop. A
+ * reader captures generation() before its keychain call and passes it to
+ * put(), which refuses the value if the service was invalidated meanwhile,
+ * so a read that raced a set/delete can't cache the stale value.
+ * Not thread-safe.
+ */
+class SecureValueCache {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Value {
+    std::string username;
+    std::string password;
+  };
+
+  /**
+   * Cache `service` for `ttl` after each put(); zero stops caching it and
+   * evicts its entry
+   */
+  void setTtl(const std::string& service, std::chrono::milliseconds ttl) {
+    if (ttl.count() <= 0) {
+      _ttls.erase(service);
+      _entries.erase(service);
+      return;
+    }
+    _ttls[service] = ttl;
+  }
+
+  /**
+   * Replace `service`'s entry. Returns false, caching nothing, if the
+   * service has no TTL or was invalidated since `expectedGeneration`.
+   */
+  bool put(const std::string& service, std::string_view username, std::string_view password, Clock::time_point now,
+           std::optional<uint64_t> expectedGeneration = std::nullopt) {
+    auto ttl = _ttls.find(service);
+    if (ttl == _ttls.end()) {
+      return false;
+    }
+    if (expectedGeneration.has_value() && generation(service) != expectedGeneration.value()) {
+      return false;
+    }
+    _entries.insert_or_assign(service, Entry{SecureBytes(username, password), username.size(), now + ttl->second});
+    return true;
+  }
+
+  std::optional<Value> get(const std::string& service, Clock::time_point now) {
+    auto it = _entries.find(service);
+    if (it == _entries.end()) {
+      return std::nullopt;
+    }
+    if (it->second.expires <= now) {
+      _entries.erase(it);
+      return std::nullopt;
+    }
+    std::string_view bytes = it->second.bytes.view();
+    return Value{std::string(bytes.substr(0, it->second.usernameLength)),
+                 std::string(bytes.substr(it->second.usernameLength))};
+  }
+
+  /**
+   * Changes whenever `service` is invalidated by erase() or clear()
+   */
+  uint64_t generation(const std::string& service) const {
+    auto it = _generations.find(service);
+    return it == _generations.end() ? _clearedGeneration : std::max(it->second, _clearedGeneration);
+  }
+
+  void erase(const std::string& service) {
+    _entries.erase(service);
+    _generations[service] = ++_lastGeneration;
+  }
+
+  void clear() {
+    _entries.clear();
+    _generations.clear();
+    _clearedGeneration = ++_lastGeneration;
+  }
+
+  /**
+   * Drop entries expired by `now`; returns how many
+   */
+  size_t purgeExpired(Clock::time_point now) {
+    size_t purged = 0;
+    for (auto it = _entries.begin(); it != _entries.end();) {
+      if (it->second.expires <= now) {
+        it = _entries.erase(it);
+        purged++;
+      } else {
+        ++it;
+      }
+    }
+    return purged;
+  }
+
+  /**
+   * Earliest expiry among cached entries
+   */
+  std::optional<Clock::time_point> nextExpiry() const {
+    std::optional<Clock::time_point> next;
+    for (const auto& entry : _entries) {
+      if (!next.has_value() || entry.second.expires < *next) {
+        next = entry.second.expires;
+      }
+    }
+    return next;
+  }
+
+  size_t size() const { return _entries.size(); }
+
+private:
+  struct Entry {
+    SecureBytes bytes;                      // username then password
+    size_t usernameLength = 0;
+    Clock::time_point expires;
+  };
+
+  std::unordered_map<std::string, std::chrono::milliseconds> _ttls;
+  std::unordered_map<std::string, Entry> _entries;
+  std::unordered_map<std::string, uint64_t> _generations;  // last erase() of each service
+  uint64_t _clearedGeneration = 0;                         // last clear()
+  uint64_t _lastGeneration = 0;
+};
+
+} // namespace margelo::nitro::sam
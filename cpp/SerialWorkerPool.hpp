@@ -0,0 +1,136 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace margelo::nitro::sam {
+
+/**
+ * Fixed-size thread pool with per-key serial lanes
+ *
+ * Jobs submitted under the same lane run one at a time, in submission order;
+ * different lanes run in parallel on whichever worker is free. A lane is
+ * handed to a worker for one job and then re-queued behind the other ready
+ * lanes, so a busy lane can't starve the rest.
+ *
+ * Threads start on the first submit. shutdown() lets running jobs finish and
+ * calls every job still queued with `cancelled = true` (on a worker thread),
+ * so callers waiting on a job always hear back.
+ */
+class SerialWorkerPool {
+public:
+  using Job = std::function<void(bool cancelled)>;
+
+  explicit SerialWorkerPool(size_t threadCount) : _threadCount(threadCount > 0 ? threadCount : 1) {}
+
+  ~SerialWorkerPool() { shutdown(); }
+
+  SerialWorkerPool(const SerialWorkerPool&) = delete;
+  SerialWorkerPool& operator=(const SerialWorkerPool&) = delete;
+
+  /**
+   * Queue `job` behind everything already submitted to `lane`. After
+   * shutdown() the job is cancelled immediately on the calling thread.
+   */
+  void submit(const std::string& lane, Job&& job) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (_stopping) {
+      lock.unlock();
+      job(true);
+      return;
+    }
+    if (_threads.empty()) {
+      _threads.reserve(_threadCount);
+      for (size_t i = 0; i < _threadCount; ++i) {
+        _threads.emplace_back([this]() { run(); });
+      }
+    }
+    Lane& target = _lanes[lane];  // node-based: the address stays valid
+    target.jobs.push_back(std::move(job));
+    _queued++;
+    if (!target.scheduled) {
+      target.scheduled = true;
+      _ready.push_back(&target);
+      _cv.notify_one();
+    }
+  }
+
+  /**
+   * Jobs waiting to start, across all lanes
+   */
+  size_t pending() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _queued;
+  }
+
+  size_t threadCount() const { return _threadCount; }
+
+  void shutdown() {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (_stopping) {
+        return;
+      }
+      _stopping = true;
+    }
+    _cv.notify_all();
+    for (auto& thread : _threads) {
+      if (thread.joinable()) {
+        thread.join();
+      }
+    }
+  }
+
+private:
+  struct Lane {
+    std::deque<Job> jobs;
+    bool scheduled = false;  // in _ready or running on a worker
+  };
+
+  void run() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+      _cv.wait(lock, [this]() { return !_ready.empty() || _stopping; });
+      if (_ready.empty()) {
+        return;
+      }
+      Lane* lane = _ready.front();
+      _ready.pop_front();
+      Job job = std::move(lane->jobs.front());
+      lane->jobs.pop_front();
+      _queued--;
+      bool cancelled = _stopping;
+
+      lock.unlock();
+      job(cancelled);
+      job = nullptr;  // release captures before re-taking the lock
+      lock.lock();
+
+      if (lane->jobs.empty()) {
+        lane->scheduled = false;
+      } else {
+        _ready.push_back(lane);
+        _cv.notify_one();
+      }
+    }
+  }
+
+  const size_t _threadCount;
+  std::mutex _mutex;
+  std::condition_variable _cv;
+  std::unordered_map<std::string, Lane> _lanes;
+  std::deque<Lane*> _ready;
+  std::vector<std::thread> _threads;
+  size_t _queued = 0;
+  bool _stopping = false;
+};
+
+} // namespace margelo::nitro::sam
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace margelo::nitro::sam {
+
+/**
+ * Deadlines of the Warm keys written with a TTL
+ *
+ * A min-heap by deadline, plus each (instance, key)'s current deadline.
+ * Replacing or clearing a deadline only touches the map: heap entries that
+ * no longer match it are skipped when they reach the top, and dropped in
+ * bulk once they outnumber the live ones. Lookups don't allocate, so the
+ * read path can check every key. Deadlines are Unix epoch milliseconds.
+ * Not thread-safe.
+ */
+class WarmExpiryIndex {
+public:
+  struct Expired {
+    std::string instanceId;
+    std::string key;
+  };
+
+  void set(const std::string& instanceId, const std::string& key, double deadlineMs) {
+    if (_deadlines[instanceId].insert_or_assign(key, deadlineMs).second) {
+      _live++;
+    }
+    _heap.push_back(Entry{deadlineMs, instanceId, key});
+    std::push_heap(_heap.begin(), _heap.end(), later);
+    if (_heap.size() > 2 * _live + kRebuildSlack) {
+      rebuild();
+    }
+  }
+
+  /**
+   * Replace every deadline of `instanceId` with `deadlines`
+   */
+  void replace(const std::string& instanceId, const std::unordered_map<std::string, double>& deadlines) {
+    auto instance = _deadlines.find(instanceId);
+    if (instance != _deadlines.end()) {
+      _live -= instance->second.size();
+      _deadlines.erase(instance);
+    }
+    for (const auto& [key, deadlineMs] : deadlines) {
+      set(instanceId, key, deadlineMs);
+    }
+  }
+
+  /**
+   * Forget a key's deadline; returns false if it had none
+   */
+  bool clear(const std::string& instanceId, const std::string& key) {
+    auto instance = _deadlines.find(instanceId);
+    if (instance == _deadlines.end() || instance->second.erase(key) == 0) {
+      return false;
+    }
+    if (instance->second.empty()) {
+      _deadlines.erase(instance);
+    }
+    _live--;
+    return true;
+  }
+
+  std::optional<double> deadline(const std::string& instanceId, const std::string& key) const {
+    auto instance = _deadlines.find(instanceId);
+    if (instance == _deadlines.end()) {
+      return std::nullopt;
+    }
+    auto entry = instance->second.find(key);
+    if (entry == instance->second.end()) {
+      return std::nullopt;
+    }
+    return entry->second;
+  }
+
+  /**
+   * Remove up to `limit` keys due by `nowMs`, earliest first, appending them
+   * to `out`. Returns how many.
+   */
+  size_t popExpired(double nowMs, size_t limit, std::vector<Expired>& out) {
+    size_t popped = 0;
+    while (popped < limit && dropStale() && _heap.front().deadlineMs <= nowMs) {
+      std::pop_heap(_heap.begin(), _heap.end(), later);
+      Entry& entry = _heap.back();
+      clear(entry.instanceId, entry.key);
+      out.push_back(Expired{std::move(entry.instanceId), std::move(entry.key)});
+      _heap.pop_back();
+      popped++;
+    }
+    return popped;
+  }
+
+  /**
+   * Earliest live deadline
+   */
+  std::optional<double> nextDeadline() {
+    if (!dropStale()) {
+      return std::nullopt;
+    }
+    return _heap.front().deadlineMs;
+  }
+
+  bool empty() const { return _live == 0; }
+  size_t size() const { return _live; }
+
+private:
+  static constexpr size_t kRebuildSlack = 64;
+
+  struct Entry {
+    double deadlineMs;
+    std::string instanceId;
+    std::string key;
+  };
+
+  static bool later(const Entry& a, const Entry& b) { return a.deadlineMs > b.deadlineMs; }
+
+  bool isLive(const Entry& entry) const {
+    std::optional<double> current = deadline(entry.instanceId, entry.key);
+    return current.has_value() && *current == entry.deadlineMs;
+  }
+
+  /**
+   * Pop stale entries off the top; returns false if the heap is then empty
+   */
+  bool dropStale() {
+    while (!_heap.empty() && !isLive(_heap.front())) {
+      std::pop_heap(_heap.begin(), _heap.end(), later);
+      _heap.pop_back();
+    }
+    return !_heap.empty();
+  }
+
+  void rebuild() {
+    std::vector<Entry> heap;
+    heap.reserve(_live);
+    for (const auto& [instanceId, keys] : _deadlines) {
+      for (const auto& [key, deadlineMs] : keys) {
+        heap.push_back(Entry{deadlineMs, instanceId, key});
+      }
+    }
+    std::make_heap(heap.begin(), heap.end(), later);
+    _heap = std::move(heap);
+  }
+
+  std::vector<Entry> _heap;
+  std::unordered_map<std::string, std::unordered_map<std::string, double>> _deadlines;
+  size_t _live = 0;
+};
+
+} // namespace margelo::nitro::sam
@@ -5,19 +5,82 @@
 import { NitroModules } from 'react-native-nitro-modules';
 import type {
   SideFx as SideFxSpec,
+  ColdConfig,
   ListenerConfig,
   ChangeEvent,
   ListenerResult,
   ListenerInfo,
   SAMConfig,
   NetworkState,
+  DispatchAllocationStats,
+  SAMMetrics,
+  LogCategory,
+  MFELoadStats,
+  MFEPhase,
+  MFERecord,
+  MFERecordUpdate,
+  MFETransition,
+  MemoryPressureLevel,
+  MemoryUsage,
+  SecureCachedValue,
+  StartupConfig,
+  StartupStage,
+  WarmCompactionConfig,
+  WarmCompactionStats,
+  ColdCheckpointConfig,
+  ColdCheckpointStats,
+  ColdAcrossOptions,
+  ColdSearchConfig,
+  ColdSearchOptions,
+  WarmConfig,
+  WarmPrewarmInstance,
 } from './specs/SideFx.nitro';
+import { SecureStorage } from './secure';
 
 /**
  * Callback function type for listeners
  */
 export type ListenerCallback = (event: ChangeEvent) => void;
 
+/**
+ * Native log level, lowest first
+ */
+export type LogLevel = 'trace' | 'debug' | 'info' | 'warn' | 'error' | 'off';
+
+// Index = numeric level used by the native module
+const LOG_LEVELS: LogLevel[] = ['trace', 'debug', 'info', 'warn', 'error', 'off'];
+
+/**
+ * Handle for cancelling async Cold requests, e.g. when a screen unmounts
+ */
+export interface ColdCancelToken {
+  readonly id: number;
+  /** Cancel every request made with this token that has not finished yet */
+  cancel(): boolean;
+}
+
+/**
+ * Result of queryColdAcross, stored by column
+ */
+export interface ColdAcrossResult {
+  columns: string[];
+  databases: string[];
+  rowCount: number;
+  /** Each row's index into `databases` */
+  source: number[];
+  /** values[c][r] is column c of row r; BLOBs are base64 strings */
+  values: unknown[][];
+}
+
+/**
+ * A Warm instance for Air.prewarmWarm. An encrypted instance needs its key:
+ * `config.encryptionKey`, or `keyId` for a key kept in secure storage the way
+ * initializeWarmEncrypted keeps it.
+ */
+export interface WarmPrewarmOptions extends WarmPrewarmInstance {
+  keyId?: string;
+}
+
 // Get the native hybrid object directly
 const NativeSideFx = NitroModules.createHybridObject<SideFxSpec>('SideFx');
 
@@ -31,6 +94,19 @@ let defaultColdInitialized = false;
 // Default Cold storage database name (unique to S.A.M)
 export const DEFAULT_COLD_DB_NAME = 'sam_default';
 
+// Source of async Cold cancellation token IDs
+let nextColdCancelToken = 1;
+
+// Receives storage trigger events (registered by Missile)
+let storageActionHandler: ListenerCallback | null = null;
+
+// MFE transition listeners; the native handler is installed on first use
+const mfeTransitionListeners = new Set<(transition: MFETransition) => void>();
+let mfeTransitionHandlerInstalled = false;
+
+// Warm encryption keys by keyId, resolved from secure storage once per launch
+const warmKeyRequests = new Map<string, Promise<string>>();
+
 /**
  * Safely ensure the default Warm instance is initialized.
  * This handles the case where react-native-mmkv may have already initialized MMKV.
@@ -59,6 +135,37 @@ function ensureDefaultWarmInitialized(): void {
   }
 }
 
+/**
+ * Read the Warm encryption key stored under `keyId`, creating one on first
+ * use. Concurrent callers share one keychain round trip; a failure is not
+ * cached, so the next call retries.
+ * @internal
+ */
+function resolveWarmKey(keyId: string): Promise<string> {
+  let request = warmKeyRequests.get(keyId);
+  if (request === undefined) {
+    request = (async () => {
+      const options = {
+        service: `sam.warmKey.${keyId}`,
+        accessible: 'AfterFirstUnlockThisDeviceOnly' as const,
+      };
+      const stored = await SecureStorage.get(options);
+      if (stored !== null) {
+        return stored.password;
+      }
+      const key = NativeSideFx.createWarmEncryptionKey();
+      const result = await SecureStorage.set(keyId, key, options);
+      if (!result.success) {
+        throw new Error(result.error ?? 'Failed to store Warm encryption key');
+      }
+      return key;
+    })();
+    warmKeyRequests.set(keyId, request);
+    request.catch(() => warmKeyRequests.delete(keyId));
+  }
+  return request;
+}
+
 /**
  * Safely ensure the default Cold storage database is initialized.
  * Creates a SQLite database at the default path using S.A.M's unique database name.
@@ -255,17 +362,70 @@ export const Air = {
    * Initialize Warm adapter
    * On iOS, automatically uses Library/mmkv
    * On Android, call setWarmRootPath first
+   *
+   * Pass an encryptionKey to open the instance AES-encrypted. The decrypted
+   * instance stays open natively, so later calls for the same ID don't need
+   * the key; a different key fails.
+   *
+   * Pass multiProcess to share the instance with app extensions or other
+   * processes; their writes are delivered to listeners like local ones.
+   */
+  initializeWarm(instanceId?: string, config?: WarmConfig): ListenerResult {
+    return NativeSideFx.initializeWarm(instanceId, config);
+  },
+
+  /**
+   * Initialize an encrypted Warm instance whose key lives in secure storage
+   * (react-native-keychain) under `keyId`. The key is read once per keyId per
+   * launch; on first use a random key is generated and stored.
+   *
+   * @example
+   * ```typescript
+   * const result = await Air.initializeWarmEncrypted('session', 'session-key');
+   * if (result.success) {
+   *   Air.setWarm('token', token, 'session');
+   * }
+   * ```
    */
-  initializeWarm(instanceId?: string): ListenerResult {
-    return NativeSideFx.initializeWarm(instanceId);
+  async initializeWarmEncrypted(instanceId: string, keyId: string): Promise<ListenerResult> {
+    try {
+      const encryptionKey = await resolveWarmKey(keyId);
+      return NativeSideFx.initializeWarm(instanceId, { encryptionKey });
+    } catch (error) {
+      return {
+        success: false,
+        error: error instanceof Error ? error.message : 'Failed to resolve Warm encryption key',
+      };
+    }
+  },
+
+  /**
+   * Generate a random 16-character Warm encryption key natively
+   */
+  createWarmEncryptionKey(): string {
+    return NativeSideFx.createWarmEncryptionKey();
   },
 
   /**
    * Initialize Cold storage adapter
    * Call this after opening your database
+   *
+   * @example
+   * ```typescript
+   * Air.initializeCold('catalog', path, { profile: 'readHeavy' });
+   * Air.initializeCold('events', path, { profile: 'writeHeavy', walAutocheckpointPages: 8000 });
+   *
+   * // Bring the schema to user_version 2 in one transaction
+   * Air.initializeCold('app', path, {
+   *   migrations: [
+   *     'CREATE TABLE users (id INTEGER PRIMARY KEY, name TEXT);',
+   *     'ALTER TABLE users ADD COLUMN email TEXT;',
+   *   ],
+   * });
+   * ```
    */
-  initializeCold(databaseName: string, databasePath: string): ListenerResult {
-    return NativeSideFx.initializeCold(databaseName, databasePath);
+  initializeCold(databaseName: string, databasePath: string, config?: ColdConfig): ListenerResult {
+    return NativeSideFx.initializeCold(databaseName, databasePath, config);
   },
 
   /**
@@ -285,7 +445,63 @@ export const Air = {
   },
 
   /**
-   * Manually trigger Warm change check
+   * Configure the startup pipeline. With `lazyCold`, initializeCold only
+   * records the database and SQLite opens it on first use.
+   *
+   * @example
+   * ```typescript
+   * Air.configureStartup({ lazyCold: true });
+   * Air.initializeCold('app', dbPath); // no I/O yet
+   * ```
+   */
+  configureStartup(config: StartupConfig): void {
+    NativeSideFx.configureStartup(config);
+  },
+
+  /**
+   * Open Warm instances on native worker threads, in parallel, so the JS
+   * thread never waits for MMKV to load them. Each instance is opened with
+   * its config, which must match the one initializeWarm would use: an
+   * encrypted instance listed without its key would be read as plaintext.
+   *
+   * @example
+   * ```typescript
+   * Air.prewarmWarm([
+   *   { instanceId: 'feature-flags' },
+   *   { instanceId: 'shared', config: { multiProcess: true } },
+   *   { instanceId: 'session', keyId: 'session-key' },
+   * ]);
+   * ```
+   */
+  async prewarmWarm(instances: WarmPrewarmOptions[]): Promise<ListenerResult> {
+    let resolved: WarmPrewarmInstance[];
+    try {
+      resolved = await Promise.all(
+        instances.map(async ({ instanceId, config, keyId }) =>
+          keyId === undefined
+            ? { instanceId, config }
+            : { instanceId, config: { ...config, encryptionKey: await resolveWarmKey(keyId) } }
+        )
+      );
+    } catch (error) {
+      return {
+        success: false,
+        error: error instanceof Error ? error.message : 'Failed to resolve Warm encryption key',
+      };
+    }
+    return NativeSideFx.prewarmWarm(resolved);
+  },
+
+  /**
+   * Get how long each startup stage took (MMKV setup, each Warm instance,
+   * each Cold database) and whether it ran in the background
+   */
+  getStartupTimings(): StartupStage[] {
+    return NativeSideFx.getStartupTimings();
+  },
+
+  /**
+   * Check multi-process Warm instances for other processes' writes now
    */
   checkWarmChanges(): void {
     NativeSideFx.checkWarmChanges();
@@ -315,6 +531,41 @@ export const Air = {
     return NativeSideFx.isDebugMode();
   },
 
+  /**
+   * Set the native log level, for all categories or just one.
+   * Messages below the level are skipped before they are formatted.
+   * Native logs go to logcat (Android), os_log (iOS) or stderr.
+   * setDebugMode(true) is the same as setLogLevel('debug').
+   *
+   * @example
+   * ```typescript
+   * Air.setLogLevel('warn');
+   * Air.setLogLevel('debug', 'cold'); // SQL statements only
+   * ```
+   */
+  setLogLevel(level: LogLevel, category?: LogCategory): void {
+    const index = LOG_LEVELS.indexOf(level);
+    if (index === -1) {
+      console.warn(`[SAM] Unknown log level "${level}"; expected one of ${LOG_LEVELS.join(', ')}`);
+      return;
+    }
+    NativeSideFx.setLogLevel(index, category);
+  },
+
+  /**
+   * Get the native log level of a category (default: "general")
+   */
+  getLogLevel(category?: LogCategory): LogLevel {
+    return LOG_LEVELS[NativeSideFx.getLogLevel(category)] ?? 'off';
+  },
+
+  /**
+   * Wait until every queued native log message has been written
+   */
+  flushLogs(): void {
+    NativeSideFx.flushLogs();
+  },
+
   /**
    * Get version
    */
@@ -327,6 +578,10 @@ export const Air = {
    * @internal
    */
   _onChangeEvent(event: ChangeEvent): void {
+    if (event.actionType !== undefined) {
+      storageActionHandler?.(event);
+      return;
+    }
     const callback = callbacks.get(event.listenerId);
     if (callback) {
       try {
@@ -340,6 +595,42 @@ export const Air = {
     }
   },
 
+  /**
+   * Get allocation counters for the native change dispatch path.
+   * Counters are only maintained in debug builds of the native module;
+   * in a steady state `arenaBlockAllocations` and `bufferGrowths` stop growing.
+   */
+  getDispatchAllocationStats(): DispatchAllocationStats {
+    return NativeSideFx.getDispatchAllocationStats();
+  },
+
+  // ============================================================================
+  // Metrics
+  // ============================================================================
+
+  /**
+   * Get per-operation latency histograms (p50/p90/p99/p99.9) and counters.
+   * Metrics are always on; no debug mode required.
+   *
+   * @example
+   * ```typescript
+   * const { operations } = Air.getMetrics();
+   * const setWarm = operations.find((op) => op.name === 'setWarm');
+   * console.log(`setWarm p99: ${setWarm?.p99Us}us`);
+   * ```
+   */
+  getMetrics(): SAMMetrics {
+    return NativeSideFx.getMetrics();
+  },
+
+  /**
+   * Get metrics for the current interval and start a new one.
+   * Call periodically (e.g. once a minute) to report interval p99s.
+   */
+  snapshotAndResetMetrics(): SAMMetrics {
+    return NativeSideFx.snapshotAndResetMetrics();
+  },
+
   // ============================================================================
   // Storage Write/Read Methods
   // ============================================================================
@@ -350,6 +641,9 @@ export const Air = {
    * @param key The key to set
    * @param value The value to set (string, number, boolean)
    * @param instanceId Optional Warm instance ID (default: "default")
+   * @param ttlMs Optional time to live in milliseconds. Once it passes the
+   * key reads as null and is deleted, with a `delete` change event; a later
+   * write without ttlMs makes the key persistent again.
    * @returns Result indicating success or failure
    *
    * @example
@@ -359,18 +653,22 @@ export const Air = {
    *
    * // Set in specific Warm instance
    * Air.setWarm('settings.theme', 'dark', 'app-settings');
+   *
+   * // Cache an API response for five minutes
+   * Air.setWarm('api.feed', JSON.stringify(feed), 'api-cache', 5 * 60 * 1000);
    * ```
    */
   setWarm(
     key: string,
     value: string | number | boolean,
-    instanceId?: string
+    instanceId?: string,
+    ttlMs?: number
   ): ListenerResult {
     // Auto-initialize default instance if needed
     if (!instanceId || instanceId === 'default') {
       ensureDefaultWarmInitialized();
     }
-    return NativeSideFx.setWarm(key, value, instanceId);
+    return NativeSideFx.setWarm(key, value, instanceId, ttlMs);
   },
 
   /**
@@ -442,6 +740,36 @@ export const Air = {
     return NativeSideFx.executeCold(sql, params, databaseName);
   },
 
+  /**
+   * Execute every statement in a SQL script on Cold storage, in one native
+   * call. `executeCold` only runs the first statement of its SQL.
+   *
+   * Stops at the first failing statement; a transaction the script began is
+   * rolled back, otherwise statements before the failure stay applied.
+   *
+   * @param sql Statements separated by semicolons
+   * @param databaseName Optional database name (default: "sam_default")
+   * @returns Result indicating success or failure
+   *
+   * @example
+   * ```typescript
+   * Air.executeColdScript(`
+   *   BEGIN;
+   *   CREATE TABLE IF NOT EXISTS users (id INTEGER PRIMARY KEY, name TEXT);
+   *   CREATE INDEX IF NOT EXISTS users_name ON users (name);
+   *   COMMIT;
+   * `);
+   * ```
+   */
+  executeColdScript(sql: string, databaseName?: string): ListenerResult {
+    // Auto-initialize default Cold database if needed
+    if (!databaseName || databaseName === DEFAULT_COLD_DB_NAME) {
+      ensureDefaultColdInitialized();
+      return NativeSideFx.executeColdScript(sql, DEFAULT_COLD_DB_NAME);
+    }
+    return NativeSideFx.executeColdScript(sql, databaseName);
+  },
+
   /**
    * Query Cold storage and return results
    *
@@ -479,6 +807,482 @@ export const Air = {
     }
   },
 
+  // ============================================================================
+  // Zero-copy Buffer Reads
+  // ============================================================================
+
+  /**
+   * Get a Warm string/binary value as an ArrayBuffer backed by native memory.
+   *
+   * Use this for large values (JSON blobs of hundreds of KB) where building a
+   * JS string would add another full copy. Booleans and numbers should be
+   * read with `getWarm`.
+   *
+   * @param key The key to get
+   * @param instanceId Optional Warm instance ID (default: "default")
+   * @returns The raw bytes or null if not found
+   *
+   * @example
+   * ```typescript
+   * const buffer = Air.getWarmBuffer('cache.catalog');
+   * if (buffer) {
+   *   const catalog = JSON.parse(new TextDecoder().decode(buffer));
+   * }
+   * ```
+   */
+  getWarmBuffer(key: string, instanceId?: string): ArrayBuffer | null {
+    // Auto-initialize default instance if needed
+    if (!instanceId || instanceId === 'default') {
+      ensureDefaultWarmInitialized();
+    }
+    return NativeSideFx.getWarmBuffer(key, instanceId);
+  },
+
+  /**
+   * Query Cold storage and return the JSON-encoded rows as an ArrayBuffer.
+   *
+   * Same result shape as `queryCold`, but the native serialization buffer is
+   * handed to JS without being copied into a JS string first.
+   *
+   * @param sql The SQL query to execute
+   * @param params Optional parameters for the query
+   * @param databaseName Optional database name (default: "sam_default")
+   * @returns UTF-8 JSON bytes or null on error
+   */
+  queryColdBuffer(
+    sql: string,
+    params?: Array<string | number | boolean | null>,
+    databaseName?: string
+  ): ArrayBuffer | null {
+    // Auto-initialize default Cold database if needed
+    const dbName = (!databaseName || databaseName === DEFAULT_COLD_DB_NAME)
+      ? (ensureDefaultColdInitialized(), DEFAULT_COLD_DB_NAME)
+      : databaseName;
+    return NativeSideFx.queryColdBuffer(sql, params, dbName);
+  },
+
+  // ============================================================================
+  // Full-Text Search
+  // ============================================================================
+
+  /**
+   * Make a Cold table searchable with an FTS5 index
+   *
+   * The index lives in "<table>_fts" and is kept in sync by SQLite triggers,
+   * so every write to the table (executeCold, async, scripts) updates it.
+   * Call again after startup or a migration; an unchanged declaration
+   * costs almost nothing, and a changed one rebuilds the index.
+   *
+   * @example
+   * ```typescript
+   * Air.declareColdSearch({ table: 'messages', columns: ['subject', 'body'], prefixLengths: [2, 3] });
+   * ```
+   *
+   * @param config Table, columns and tokenizer
+   * @param databaseName Optional database name (default: "sam_default")
+   * @returns Result indicating success or failure
+   */
+  declareColdSearch(config: ColdSearchConfig, databaseName?: string): ListenerResult {
+    // Auto-initialize default Cold database if needed
+    const dbName = (!databaseName || databaseName === DEFAULT_COLD_DB_NAME)
+      ? (ensureDefaultColdInitialized(), DEFAULT_COLD_DB_NAME)
+      : databaseName;
+    return NativeSideFx.declareColdSearch(config, dbName);
+  },
+
+  /**
+   * Search a table declared with declareColdSearch, best match first
+   *
+   * Replaces `LIKE '%term%'` scans with an index lookup. Each row has the
+   * table's columns plus `_rowid`, `_score` (higher is better) and
+   * `_snippet`, the matching text with matches highlighted. Rows come back
+   * in the same UTF-8 JSON buffer as queryColdBuffer.
+   *
+   * @example
+   * ```typescript
+   * const buffer = Air.searchCold('messages', 'invoice*', { limit: 20, snippetColumn: 'body' });
+   * const hits = buffer ? JSON.parse(new TextDecoder().decode(buffer)) : [];
+   * ```
+   *
+   * @param table The declared table
+   * @param query FTS5 query: terms, "phrases", prefix*, AND / OR / NOT
+   * @param options Optional paging and snippet settings
+   * @param databaseName Optional database name (default: "sam_default")
+   * @returns UTF-8 JSON bytes or null on error (including query syntax errors)
+   */
+  searchCold(
+    table: string,
+    query: string,
+    options?: ColdSearchOptions,
+    databaseName?: string
+  ): ArrayBuffer | null {
+    // Auto-initialize default Cold database if needed
+    const dbName = (!databaseName || databaseName === DEFAULT_COLD_DB_NAME)
+      ? (ensureDefaultColdInitialized(), DEFAULT_COLD_DB_NAME)
+      : databaseName;
+    return NativeSideFx.searchCold(table, query, options, dbName);
+  },
+
+  // ============================================================================
+  // Warm Compaction
+  // ============================================================================
+
+  /**
+   * Configure background compaction of Warm instances.
+   *
+   * Warm files are append-only, so frequently written keys (network state,
+   * MFE states) leave overwritten entries behind until MMKV rewrites the file
+   * inline on the writing thread. The native scheduler compacts instances on
+   * a background thread once Warm writes have been idle for `idleMs`.
+   *
+   * @example
+   * ```typescript
+   * Air.configureWarmCompaction({ idleMs: 10000, maxAmplification: 3 });
+   * ```
+   */
+  configureWarmCompaction(config: WarmCompactionConfig): void {
+    NativeSideFx.configureWarmCompaction(config);
+  },
+
+  /**
+   * Compact a Warm instance (or all of them) in the background now,
+   * regardless of the configured thresholds
+   */
+  compactWarm(instanceId?: string): void {
+    NativeSideFx.compactWarm(instanceId);
+  },
+
+  /**
+   * Get file size, live bytes and compaction history per Warm instance
+   */
+  getWarmCompactionStats(instanceId?: string): WarmCompactionStats[] {
+    return NativeSideFx.getWarmCompactionStats(instanceId);
+  },
+
+  // ============================================================================
+  // Cold Checkpoints
+  // ============================================================================
+
+  /**
+   * Configure background WAL checkpoints of file-backed Cold databases.
+   *
+   * By default SQLite checkpoints inline, on whichever executeCold commit
+   * crosses wal_autocheckpoint. While enabled (the default), the native
+   * scheduler checkpoints on its own connection instead: PASSIVE once a
+   * database has been idle for `intervalMs`, TRUNCATE when the idle WAL is
+   * larger than `truncateWalBytes`.
+   *
+   * @example
+   * ```typescript
+   * Air.configureColdCheckpoints({ intervalMs: 5000, maxWalBytes: 32 * 1024 * 1024 });
+   * ```
+   */
+  configureColdCheckpoints(config: ColdCheckpointConfig): void {
+    NativeSideFx.configureColdCheckpoints(config);
+  },
+
+  /**
+   * Checkpoint a Cold database (or all of them) in the background now and
+   * truncate its WAL, regardless of the configured thresholds
+   */
+  checkpointCold(databaseName?: string): void {
+    NativeSideFx.checkpointCold(databaseName);
+  },
+
+  /**
+   * Get WAL size and checkpoint history per file-backed Cold database
+   */
+  getColdCheckpointStats(databaseName?: string): ColdCheckpointStats[] {
+    return NativeSideFx.getColdCheckpointStats(databaseName);
+  },
+
+  // ============================================================================
+  // Memory Governor
+  // ============================================================================
+
+  /**
+   * Get native memory use per subsystem. Set a budget in bytes with
+   * `Air.configure({ cacheSize })`; over budget, the governor evicts least
+   * recently used Warm instances (they remap on next access) and releases
+   * SQLite and dispatch caches.
+   */
+  getMemoryUsage(): MemoryUsage {
+    return NativeSideFx.getMemoryUsage();
+  },
+
+  /**
+   * Report OS memory pressure. iOS pressure is observed natively; on Android
+   * forward `onTrimMemory` levels (e.g. RUNNING_LOW → 'moderate',
+   * RUNNING_CRITICAL / COMPLETE → 'critical').
+   *
+   * @example
+   * ```typescript
+   * AppState.addEventListener('memoryWarning', () => Air.handleMemoryPressure('critical'));
+   * ```
+   */
+  handleMemoryPressure(level: MemoryPressureLevel): void {
+    NativeSideFx.handleMemoryPressure(level);
+  },
+
+  // ============================================================================
+  // Secure Value Cache
+  // ============================================================================
+
+  /**
+   * Cache keychain values for `service` natively for `ttlMs` after each
+   * SecureStorage read or write (0 disables, the default). Prefer
+   * `SecureStorage.configureCache`.
+   */
+  configureSecureCache(service: string, ttlMs: number): void {
+    NativeSideFx.configureSecureCache(service, ttlMs);
+  },
+
+  /**
+   * The service's cache invalidation generation; see cacheSecureValue
+   */
+  getSecureCacheGeneration(service: string): number {
+    return NativeSideFx.getSecureCacheGeneration(service);
+  },
+
+  /**
+   * Cache a keychain value; false if the service has no TTL, or if
+   * `generation` (captured before the keychain call) is stale because the
+   * service was invalidated since
+   */
+  cacheSecureValue(service: string, username: string, password: string, generation?: number): boolean {
+    return NativeSideFx.cacheSecureValue(service, username, password, generation);
+  },
+
+  /**
+   * The cached keychain value for `service`, synchronously
+   */
+  getCachedSecureValue(service: string): SecureCachedValue | undefined {
+    return NativeSideFx.getCachedSecureValue(service);
+  },
+
+  /**
+   * Drop the cached keychain value for `service`, or for every service
+   */
+  invalidateSecureValue(service?: string): void {
+    NativeSideFx.invalidateSecureValue(service);
+  },
+
+  // ============================================================================
+  // Async Cold Storage
+  // ============================================================================
+
+  /**
+   * Create a token that cancels the async Cold requests it is passed to
+   *
+   * @example
+   * ```typescript
+   * useEffect(() => {
+   *   const token = Air.createColdCancelToken();
+   *   Air.queryColdAsync('SELECT * FROM orders', [], undefined, token)
+   *     .then(setOrders)
+   *     .catch(() => {}); // rejected when cancelled
+   *   return () => token.cancel();
+   * }, []);
+   * ```
+   */
+  createColdCancelToken(): ColdCancelToken {
+    const id = nextColdCancelToken++;
+    return {
+      id,
+      cancel: () => NativeSideFx.cancelColdRequests(id),
+    };
+  },
+
+  /**
+   * Execute a SQL statement on a native worker thread
+   *
+   * Statements on the same database run one at a time in call order, so a
+   * sequence of async writes is applied exactly as issued. The JS thread is
+   * never blocked, even by a long statement.
+   *
+   * @param sql The SQL statement to execute
+   * @param params Optional parameters for the statement
+   * @param databaseName Optional database name (default: "sam_default")
+   * @param cancelToken Optional token from createColdCancelToken
+   * @returns Same result as executeCold; rejects if cancelled before finishing
+   */
+  executeColdAsync(
+    sql: string,
+    params?: Array<string | number | boolean | null>,
+    databaseName?: string,
+    cancelToken?: ColdCancelToken
+  ): Promise<ListenerResult> {
+    // Auto-initialize default Cold database if needed
+    const dbName = (!databaseName || databaseName === DEFAULT_COLD_DB_NAME)
+      ? (ensureDefaultColdInitialized(), DEFAULT_COLD_DB_NAME)
+      : databaseName;
+    return NativeSideFx.executeColdAsync(sql, params, dbName, cancelToken?.id);
+  },
+
+  /**
+   * Query Cold storage on a native worker thread
+   *
+   * Ordered with executeColdAsync calls on the same database: a query issued
+   * after an async write sees that write.
+   *
+   * @param sql The SQL query to execute
+   * @param params Optional parameters for the query
+   * @param databaseName Optional database name (default: "sam_default")
+   * @param cancelToken Optional token from createColdCancelToken
+   * @returns Array of row objects or null on error; rejects if cancelled
+   */
+  async queryColdAsync<T = unknown>(
+    sql: string,
+    params?: Array<string | number | boolean | null>,
+    databaseName?: string,
+    cancelToken?: ColdCancelToken
+  ): Promise<T | null> {
+    // Auto-initialize default Cold database if needed
+    const dbName = (!databaseName || databaseName === DEFAULT_COLD_DB_NAME)
+      ? (ensureDefaultColdInitialized(), DEFAULT_COLD_DB_NAME)
+      : databaseName;
+
+    const result = await NativeSideFx.queryColdAsync(sql, params, dbName, cancelToken?.id);
+    if (result === null) {
+      return null;
+    }
+    try {
+      return JSON.parse(result) as T;
+    } catch {
+      console.error('[SAM] Failed to parse Cold storage query result');
+      return null;
+    }
+  },
+
+  /**
+   * Run one query against several Cold databases in parallel
+   *
+   * Each database is queried on its own native worker and the rows are merged
+   * into one columnar result. With `orderBy`, rows are merged in that column's
+   * order; `limit` caps the merged rows. Every database must return the same
+   * columns.
+   *
+   * @example
+   * ```typescript
+   * const recent = await Air.queryColdAcross(
+   *   'SELECT id, total, created_at FROM orders WHERE created_at > ?',
+   *   ['tenant_a', 'tenant_b', 'tenant_c'],
+   *   [since],
+   *   { orderBy: 'created_at', descending: true, limit: 50 }
+   * );
+   * recent?.values[1]; // totals, newest first
+   * ```
+   *
+   * @param sql The SQL query to run on every database
+   * @param databaseNames Databases to query
+   * @param params Optional parameters for the query
+   * @param options Optional merge order and row limit
+   * @param cancelToken Optional token from createColdCancelToken
+   * @returns The merged rows, or null if any database fails; rejects if cancelled
+   */
+  async queryColdAcross(
+    sql: string,
+    databaseNames: string[],
+    params?: Array<string | number | boolean | null>,
+    options?: ColdAcrossOptions,
+    cancelToken?: ColdCancelToken
+  ): Promise<ColdAcrossResult | null> {
+    if (databaseNames.includes(DEFAULT_COLD_DB_NAME)) {
+      ensureDefaultColdInitialized();
+    }
+    const result = await NativeSideFx.queryColdAcross(sql, databaseNames, params, options, cancelToken?.id);
+    if (result === null) {
+      return null;
+    }
+    try {
+      return JSON.parse(result) as ColdAcrossResult;
+    } catch {
+      console.error('[SAM] Failed to parse Cold storage query result');
+      return null;
+    }
+  },
+
+  // ============================================================================
+  // MFE Registry
+  // ============================================================================
+
+  /**
+   * Set an MFE's phase and merge `update` into its native record.
+   * Records are fixed-layout binary values in the 'sam-mfe-registry' Warm
+   * instance (see src/mfe.ts for the string-state API built on this).
+   */
+  setMFERecord(mfeId: string, phase: MFEPhase, update?: MFERecordUpdate): MFERecord {
+    return NativeSideFx.setMFERecord(mfeId, phase, update);
+  },
+
+  /**
+   * Get one MFE's record
+   */
+  getMFERecord(mfeId: string): MFERecord | undefined {
+    return NativeSideFx.getMFERecord(mfeId);
+  },
+
+  /**
+   * Get every MFE record in a single call
+   */
+  getAllMFEStates(): MFERecord[] {
+    return NativeSideFx.getAllMFEStates();
+  },
+
+  /**
+   * Remove an MFE's record
+   */
+  clearMFERecord(mfeId: string): boolean {
+    return NativeSideFx.clearMFERecord(mfeId);
+  },
+
+  /**
+   * Add a load time to an MFE's aggregated stats. Loads timed by
+   * setMFERecord (loading -> loaded) are recorded automatically.
+   */
+  recordMFELoadTime(mfeId: string, loadTimeMs: number): void {
+    NativeSideFx.recordMFELoadTime(mfeId, loadTimeMs);
+  },
+
+  /**
+   * Get aggregated load stats for one MFE, or for every MFE
+   */
+  getMFELoadStats(mfeId?: string): MFELoadStats[] {
+    return NativeSideFx.getMFELoadStats(mfeId);
+  },
+
+  /**
+   * Clear aggregated load stats for one MFE, or for every MFE
+   */
+  resetMFELoadStats(mfeId?: string): void {
+    NativeSideFx.resetMFELoadStats(mfeId);
+  },
+
+  /**
+   * Listen for MFE state transitions, emitted by the native dispatcher
+   * @returns Function that removes the listener
+   */
+  onMFETransition(listener: (transition: MFETransition) => void): () => void {
+    if (!mfeTransitionHandlerInstalled) {
+      mfeTransitionHandlerInstalled = true;
+      NativeSideFx.setMFETransitionHandler((transitions: MFETransition[]) => {
+        for (const transition of transitions) {
+          mfeTransitionListeners.forEach((callback) => {
+            try {
+              callback(transition);
+            } catch (error) {
+              console.error('[SAM] Error in MFE transition listener:', error);
+            }
+          });
+        }
+      });
+    }
+    mfeTransitionListeners.add(listener);
+    return () => {
+      mfeTransitionListeners.delete(listener);
+    };
+  },
+
   // ============================================================================
   // Network Monitoring Methods
   // ============================================================================
@@ -721,8 +1525,48 @@ export const Air = {
 };
 
 // Register the event handler with native
-// This is called by native code when changes are detected
+// Native delivers every event produced by a single write in one batch
+NativeSideFx.setChangeEventHandler((events: ChangeEvent[]) => {
+  for (const event of events) {
+    Air._onChangeEvent(event);
+  }
+});
 (globalThis as unknown as Record<string, unknown>).__SAM_onChangeEvent = Air._onChangeEvent;
 
 // Export SideFx as an alias for backwards compatibility
 export const SideFx = Air;
+
+/**
+ * Native action-type router backing Missile's `take` matching
+ * (see src/missile). Not part of the public API.
+ * @internal
+ */
+export const ActionRoutes = {
+  add(patterns: string[], once: boolean): number {
+    return NativeSideFx.addActionRoute(patterns, once);
+  },
+  remove(routeId: number): boolean {
+    return NativeSideFx.removeActionRoute(routeId);
+  },
+  match(actionType: string): number[] {
+    return NativeSideFx.matchActionRoutes(actionType);
+  },
+};
+
+/**
+ * Native storage triggers backing Missile's `storageTrigger`: listeners whose
+ * events are delivered as actions instead of to a callback.
+ * Not part of the public API.
+ * @internal
+ */
+export const StorageTriggers = {
+  add(id: string, actionType: string, config: ListenerConfig): ListenerResult {
+    return NativeSideFx.addStorageTrigger(id, actionType, config);
+  },
+  remove(id: string): ListenerResult {
+    return NativeSideFx.removeListener(id);
+  },
+  setHandler(handler: ListenerCallback | null): void {
+    storageActionHandler = handler;
+  },
+};
@@ -10,6 +10,7 @@
  */
 
 import { Air, SideFx } from '../SideFx';
+import type { WarmPrewarmOptions } from '../SideFx';
 import { useWarm, useCold, useStorage } from '../hooks';
 import { SecureStorage } from '../secure';
 import { useSecure, useSecureCredentials } from '../useSecure';
@@ -25,6 +26,11 @@ import {
   getMFEMetadata,
   clearMFEState,
   getTrackedMFEs,
+  getAllMFEStates,
+  subscribeMFEStates,
+  recordMFELoadTime,
+  getMFELoadStats,
+  resetMFELoadStats,
 } from '../mfe';
 import { useMFEState, useMFEStates, useMFEControl } from '../useMFE';
 import type {
@@ -35,6 +41,7 @@ import type {
   WarmListenerConfig,
   ColdListenerConfig,
   CombinedListenerConfig,
+  WarmPrewarmInstance,
 } from '../specs/SideFx.nitro';
 
 // ============================================================================
@@ -128,6 +135,18 @@ describe('Capability: TypeScript support', () => {
     expect(config).toBeDefined();
   });
 
+  it('prewarms each Warm instance with its own config', () => {
+    // Type-level test - encrypted and shared instances carry their config
+    const instances: WarmPrewarmInstance[] = [
+      { instanceId: 'feature-flags' },
+      { instanceId: 'shared', config: { multiProcess: true } },
+      { instanceId: 'vault', config: { encryptionKey: 'k' } },
+    ];
+    // Air also resolves keychain keys by ID
+    const options: WarmPrewarmOptions[] = [...instances, { instanceId: 'session', keyId: 'session-key' }];
+    expect(options.length).toBe(4);
+  });
+
   it('supports generic types on queryCold', () => {
     // Type-level test for generic return type
     type User = { id: number; name: string };
@@ -185,6 +204,11 @@ describe('Capability: Secure storage (Keychain/Keystore)', () => {
     expect(typeof SecureStorage.getAllServices).toBe('function');
   });
 
+  it('SecureStorage has cache methods', () => {
+    expect(typeof SecureStorage.configureCache).toBe('function');
+    expect(typeof SecureStorage.getCached).toBe('function');
+  });
+
   it('SecureStorage has internet credentials methods', () => {
     expect(typeof SecureStorage.setInternetCredentials).toBe('function');
     expect(typeof SecureStorage.getInternetCredentials).toBe('function');
@@ -208,6 +232,11 @@ describe('Capability: Atomic updates', () => {
     expect(typeof Air.initializeWarm).toBe('function');
     // Method signature accepts optional instanceId
   });
+
+  it('setWarm accepts an optional TTL', () => {
+    // key, value, instanceId, ttlMs
+    expect(Air.setWarm.length).toBe(4);
+  });
 });
 
 // ============================================================================
@@ -542,6 +571,14 @@ describe('Capability: MFE state tracking', () => {
     expect(typeof getMFEState).toBe('function');
     expect(typeof getMFEMetadata).toBe('function');
     expect(typeof getTrackedMFEs).toBe('function');
+    expect(typeof getAllMFEStates).toBe('function');
+    expect(typeof subscribeMFEStates).toBe('function');
+  });
+
+  it('exports MFE load stats functions', () => {
+    expect(typeof recordMFELoadTime).toBe('function');
+    expect(typeof getMFELoadStats).toBe('function');
+    expect(typeof resetMFELoadStats).toBe('function');
   });
 
   it('exports MFERegistry convenience object', () => {
@@ -851,19 +888,60 @@ describe('API Surface', () => {
       'getDefaultWarmPath',
       'setWarmRootPath',
       'initializeWarm',
+      'initializeWarmEncrypted',
+      'createWarmEncryptionKey',
       'initializeCold',
       'isWarmInitialized',
       'isColdInitialized',
+      'configureStartup',
+      'prewarmWarm',
+      'getStartupTimings',
       'checkWarmChanges',
       'checkColdChanges',
       'setDebugMode',
       'isDebugMode',
+      'setLogLevel',
+      'getLogLevel',
+      'flushLogs',
       'getVersion',
       'setWarm',
       'getWarm',
       'deleteWarm',
       'executeCold',
+      'executeColdScript',
       'queryCold',
+      'getWarmBuffer',
+      'queryColdBuffer',
+      'declareColdSearch',
+      'searchCold',
+      'configureWarmCompaction',
+      'compactWarm',
+      'getWarmCompactionStats',
+      'configureColdCheckpoints',
+      'checkpointCold',
+      'getColdCheckpointStats',
+      'getMemoryUsage',
+      'handleMemoryPressure',
+      'configureSecureCache',
+      'getSecureCacheGeneration',
+      'cacheSecureValue',
+      'getCachedSecureValue',
+      'invalidateSecureValue',
+      'createColdCancelToken',
+      'executeColdAsync',
+      'queryColdAsync',
+      'queryColdAcross',
+      'setMFERecord',
+      'getMFERecord',
+      'getAllMFEStates',
+      'clearMFERecord',
+      'recordMFELoadTime',
+      'getMFELoadStats',
+      'resetMFELoadStats',
+      'onMFETransition',
+      'getDispatchAllocationStats',
+      'getMetrics',
+      'snapshotAndResetMetrics',
     ];
 
     expectedMethods.forEach((method) => {
@@ -0,0 +1,79 @@
+/**
+ * S.A.M Hooks Tests
+ *
+ * Runs the hooks outside a renderer (React's hooks are replaced with
+ * pass-throughs) and checks the listener config each one registers.
+ */
+
+jest.mock('react', () => ({
+  useRef: (initial: unknown) => ({ current: initial }),
+  useState: (initial: unknown) => [initial, () => {}],
+  useCallback: (fn: unknown) => fn,
+  useMemo: (factory: () => unknown) => factory(),
+  useEffect: (effect: () => void) => effect(),
+}));
+
+jest.mock('../SideFx', () => ({
+  DEFAULT_COLD_DB_NAME: 'sam_default',
+  Air: {
+    addListener: jest.fn(() => ({ success: true })),
+    removeListener: jest.fn(),
+    isWarmInitialized: jest.fn(() => true),
+    isColdInitialized: jest.fn(() => true),
+    initializeWarm: jest.fn(),
+  },
+}));
+
+import { Air } from '../SideFx';
+import { useWarm, useCold, useStorage } from '../hooks';
+import type { ListenerConfig } from '../specs/SideFx.nitro';
+
+const addListener = Air.addListener as jest.Mock;
+
+function registeredConfig(): ListenerConfig {
+  expect(addListener).toHaveBeenCalledTimes(1);
+  return addListener.mock.calls[0][1];
+}
+
+beforeEach(() => {
+  addListener.mockClear();
+});
+
+describe('fireImmediately defaults', () => {
+  it('useWarm fires immediately unless told not to', () => {
+    useWarm({ keys: ['user.name'] });
+    expect(registeredConfig().options?.fireImmediately).toBe(true);
+  });
+
+  it('useWarm keeps an explicit fireImmediately: false', () => {
+    useWarm({ keys: ['user.name'], options: { fireImmediately: false, throttleMs: 50 } });
+    const options = registeredConfig().options;
+    expect(options?.fireImmediately).toBe(false);
+    expect(options?.throttleMs).toBe(50);
+  });
+
+  it('useCold leaves fireImmediately unset', () => {
+    useCold({ table: 'orders' });
+    expect(registeredConfig().options?.fireImmediately).toBeUndefined();
+  });
+
+  it('useCold passes its options through unchanged', () => {
+    useCold({ table: 'orders', options: { debounceMs: 100 } });
+    expect(registeredConfig().options).toEqual({ debounceMs: 100 });
+  });
+
+  it('useStorage fires immediately when it has a Warm side', () => {
+    useStorage({ warm: { keys: ['auth.userId'] }, cold: { table: 'orders' } });
+    expect(registeredConfig().options?.fireImmediately).toBe(true);
+  });
+
+  it('useStorage does not fire immediately for a Cold-only config', () => {
+    useStorage({ cold: { table: 'orders' } });
+    expect(registeredConfig().options?.fireImmediately).toBe(false);
+  });
+
+  it('useStorage keeps an explicit fireImmediately', () => {
+    useStorage({ warm: { keys: ['auth.userId'] }, options: { fireImmediately: false } });
+    expect(registeredConfig().options?.fireImmediately).toBe(false);
+  });
+});
@@ -0,0 +1,188 @@
+/**
+ * MFE Registry Tests
+ *
+ * mfe.ts maps its state strings onto native records, or keeps them in an
+ * in-memory store when the native module is missing. Each test loads a fresh
+ * copy of the module against a mocked Air, with or without native support.
+ */
+
+jest.mock('../SideFx', () => ({
+  Air: {
+    isWarmInitialized: jest.fn(() => true),
+    initializeWarm: jest.fn(() => ({ success: true })),
+    setWarmRootPath: jest.fn(),
+    setMFERecord: jest.fn(),
+    getMFERecord: jest.fn(() => undefined),
+    getAllMFEStates: jest.fn(() => []),
+    clearMFERecord: jest.fn(),
+    recordMFELoadTime: jest.fn(),
+    getMFELoadStats: jest.fn(() => []),
+    resetMFELoadStats: jest.fn(),
+  },
+}));
+
+import type { MFERecord } from '../specs/SideFx.nitro';
+
+type MFEModule = typeof import('../mfe');
+
+function loadMFE(native: boolean): { mfe: MFEModule; air: Record<string, jest.Mock> } {
+  let mfe!: MFEModule;
+  let air!: Record<string, jest.Mock>;
+  jest.isolateModules(() => {
+    air = require('../SideFx').Air;
+    if (!native) {
+      air.isWarmInitialized.mockImplementation(() => {
+        throw new Error('native module not linked');
+      });
+    }
+    mfe = require('../mfe');
+  });
+  return { mfe, air };
+}
+
+function record(fields: Partial<MFERecord>): MFERecord {
+  return { mfeId: 'home', phase: 'idle', updatedAt: 0, ...fields };
+}
+
+beforeEach(() => {
+  jest.spyOn(console, 'log').mockImplementation(() => {});
+  jest.spyOn(console, 'warn').mockImplementation(() => {});
+});
+
+afterEach(() => {
+  jest.restoreAllMocks();
+});
+
+describe('state strings to native phases', () => {
+  it.each([
+    ['', 'idle'],
+    ['loading', 'loading'],
+    ['loaded', 'loaded'],
+    ['mounted', 'mounted'],
+    ['error', 'failed'],
+  ])('%p is written as %p', (state, phase) => {
+    const { mfe, air } = loadMFE(true);
+    mfe.setMFEState('home', state);
+    expect(air.setMFERecord).toHaveBeenCalledWith('home', phase, undefined);
+  });
+
+  it('writes any other state as a version', () => {
+    const { mfe, air } = loadMFE(true);
+    mfe.setMFEState('home', '1.2.0', { loadedAt: 5 });
+    expect(air.setMFERecord).toHaveBeenCalledWith(
+      'home',
+      'versioned',
+      expect.objectContaining({ version: '1.2.0', loadedAt: 5 })
+    );
+  });
+});
+
+describe('native records to state strings', () => {
+  it.each<[Partial<MFERecord>, string]>([
+    [{ phase: 'idle' }, ''],
+    [{ phase: 'loading' }, 'loading'],
+    [{ phase: 'loaded' }, 'loaded'],
+    [{ phase: 'mounted' }, 'mounted'],
+    [{ phase: 'failed' }, 'error'],
+    [{ phase: 'versioned', version: '3.0.0' }, '3.0.0'],
+    [{ phase: 'versioned' }, 'loaded'],
+  ])('%p reads as %p', (fields, state) => {
+    const { mfe, air } = loadMFE(true);
+    air.getMFERecord.mockReturnValue(record(fields));
+    expect(mfe.getMFEState('home')).toBe(state);
+  });
+
+  it('reads an untracked MFE as the empty state', () => {
+    const { mfe } = loadMFE(true);
+    expect(mfe.getMFEState('missing')).toBe('');
+    expect(mfe.getMFEMetadata('missing')).toBeNull();
+  });
+
+  it('builds metadata from every record field', () => {
+    const { mfe, air } = loadMFE(true);
+    air.getAllMFEStates.mockReturnValue([
+      record({ mfeId: 'cart', phase: 'failed', errorMessage: 'boom', loadedAt: 1, loadTimeMs: 20 }),
+    ]);
+    expect(mfe.getAllMFEStates()).toEqual({
+      cart: {
+        state: 'error',
+        version: undefined,
+        loadedAt: 1,
+        mountedAt: undefined,
+        unmountedAt: undefined,
+        errorMessage: 'boom',
+        loadTimeMs: 20,
+      },
+    });
+  });
+});
+
+describe('fallback store', () => {
+  it('keeps states in memory without the native module', () => {
+    const { mfe, air } = loadMFE(false);
+    mfe.markMFELoading('home');
+    expect(mfe.getMFEState('home')).toBe('loading');
+    mfe.markMFEError('home', 'boom');
+    expect(mfe.getMFEMetadata('home')).toEqual(expect.objectContaining({ state: 'error', errorMessage: 'boom' }));
+    mfe.clearMFEState('home');
+    expect(mfe.getMFEState('home')).toBe('');
+    expect(air.setMFERecord).not.toHaveBeenCalled();
+  });
+});
+
+describe('fallback load stats', () => {
+  it('summarizes recorded load times', () => {
+    const { mfe } = loadMFE(false);
+    // Recorded out of order; the stats sort them
+    for (let i = 100; i >= 1; i--) {
+      mfe.recordMFELoadTime('home', i);
+    }
+    expect(mfe.getMFELoadStats('home')).toEqual({
+      home: { mfeId: 'home', count: 100, minMs: 1, maxMs: 100, meanMs: 50.5, p50Ms: 50, p95Ms: 95 },
+    });
+  });
+
+  it('keeps only the most recent 256 samples', () => {
+    const { mfe } = loadMFE(false);
+    for (let i = 1; i <= 300; i++) {
+      mfe.recordMFELoadTime('home', i);
+    }
+    const stats = mfe.getMFELoadStats('home').home!;
+    expect(stats.count).toBe(256);
+    expect(stats.minMs).toBe(45);
+    expect(stats.maxMs).toBe(300);
+  });
+
+  it('markMFELoaded records the time since markMFELoading', () => {
+    const { mfe } = loadMFE(false);
+    const now = jest.spyOn(Date, 'now');
+    now.mockReturnValue(1000);
+    mfe.markMFELoading('home');
+    now.mockReturnValue(1250);
+    mfe.markMFELoaded('home', '2.0.0');
+    expect(mfe.getMFELoadStats().home).toEqual(expect.objectContaining({ count: 1, minMs: 250 }));
+    expect(mfe.getMFEMetadata('home')).toEqual(
+      expect.objectContaining({ state: '2.0.0', version: '2.0.0', loadTimeMs: 250 })
+    );
+  });
+
+  it('resets one MFE or all of them', () => {
+    const { mfe } = loadMFE(false);
+    mfe.recordMFELoadTime('home', 1);
+    mfe.recordMFELoadTime('cart', 2);
+    mfe.resetMFELoadStats('home');
+    expect(Object.keys(mfe.getMFELoadStats())).toEqual(['cart']);
+    mfe.resetMFELoadStats();
+    expect(mfe.getMFELoadStats()).toEqual({});
+  });
+
+  it('forwards to the native sketch when available', () => {
+    const { mfe, air } = loadMFE(true);
+    air.getMFELoadStats.mockReturnValue([
+      { mfeId: 'home', count: 1, minMs: 5, maxMs: 5, meanMs: 5, p50Ms: 5, p95Ms: 5 },
+    ]);
+    mfe.recordMFELoadTime('home', 5);
+    expect(air.recordMFELoadTime).toHaveBeenCalledWith('home', 5);
+    expect(mfe.getMFELoadStats('home').home?.count).toBe(1);
+  });
+});
@@ -0,0 +1,127 @@
+/**
+ * Missile Tests
+ *
+ * Channels and subscribers are plain JS. The native module is mocked and
+ * only loaded once something needs a native route or storage trigger.
+ */
+
+let mockSideFxLoads = 0;
+
+jest.mock('../SideFx', () => {
+  mockSideFxLoads++;
+  let nextRouteId = 1;
+  return {
+    ActionRoutes: {
+      add: jest.fn(() => nextRouteId++),
+      remove: jest.fn(() => true),
+      match: jest.fn(() => []),
+    },
+    StorageTriggers: {
+      add: jest.fn(() => ({ success: true })),
+      remove: jest.fn(() => ({ success: true })),
+      setHandler: jest.fn(),
+    },
+  };
+});
+
+import { channel, storageTrigger, subscribe } from '../missile';
+import type { Action } from '../missile';
+
+describe('channel buffers', () => {
+  it('expanding keeps every value in order as it grows past bufferSize', () => {
+    const ch = channel<number>({ buffer: 'expanding', bufferSize: 4 });
+    for (let i = 0; i < 25; i++) {
+      ch.put(i);
+    }
+    expect(ch.flush()).toEqual(Array.from({ length: 25 }, (_, i) => i));
+  });
+
+  it('keeps FIFO order when the ring wraps before growing', async () => {
+    const ch = channel<number>({ buffer: 'expanding', bufferSize: 4 });
+    [1, 2, 3].forEach((v) => ch.put(v));
+    expect(await ch.take()).toBe(1);
+    expect(await ch.take()).toBe(2);
+    // head is now mid-ring, so these wrap and then force a resize
+    [4, 5, 6, 7, 8, 9].forEach((v) => ch.put(v));
+    expect(ch.flush()).toEqual([3, 4, 5, 6, 7, 8, 9]);
+  });
+
+  it('sliding drops the oldest value on overflow', () => {
+    const ch = channel<number>({ buffer: 'sliding', bufferSize: 3 });
+    [1, 2, 3, 4, 5].forEach((v) => ch.put(v));
+    expect(ch.flush()).toEqual([3, 4, 5]);
+  });
+
+  it('dropping and fixed drop the new value on overflow', () => {
+    for (const buffer of ['dropping', 'fixed'] as const) {
+      const ch = channel<number>({ buffer, bufferSize: 3 });
+      [1, 2, 3, 4, 5].forEach((v) => ch.put(v));
+      expect(ch.flush()).toEqual([1, 2, 3]);
+    }
+  });
+
+  it('none drops values nobody is waiting for', () => {
+    const ch = channel<number>({ buffer: 'none' });
+    ch.put(1);
+    expect(ch.flush()).toEqual([]);
+  });
+
+  it('flush empties the buffer', () => {
+    const ch = channel<number>();
+    ch.put(1);
+    expect(ch.flush()).toEqual([1]);
+    expect(ch.flush()).toEqual([]);
+  });
+});
+
+describe('channel takers', () => {
+  it('hands values to waiting takers in the order they asked', async () => {
+    const ch = channel<string>({ buffer: 'none' });
+    const first = ch.take();
+    const second = ch.take();
+    ch.put('a');
+    ch.put('b');
+    expect(await first).toBe('a');
+    expect(await second).toBe('b');
+    expect(ch.flush()).toEqual([]);
+  });
+
+  it('close resolves waiting takers with undefined and ignores later puts', async () => {
+    const ch = channel<number>();
+    const pending = ch.take();
+    ch.close();
+    expect(ch.isClosed()).toBe(true);
+    expect(await pending).toBeUndefined();
+    ch.put(1);
+    expect(ch.flush()).toEqual([]);
+    expect(await ch.take()).toBeUndefined();
+  });
+});
+
+describe('native loading', () => {
+  it('does not load the native module for channels or subscribers', () => {
+    const unsubscribe = subscribe(() => {});
+    channel<number>().put(1);
+    unsubscribe();
+    expect(mockSideFxLoads).toBe(0);
+  });
+
+  it('installs the storage trigger handler on the first storageTrigger call', () => {
+    const stop = storageTrigger('storage/warm/TOKEN', { warm: { keys: ['TOKEN'] } });
+    storageTrigger('storage/warm/OTHER', { warm: { keys: ['OTHER'] } })();
+    expect(mockSideFxLoads).toBe(1);
+    const { StorageTriggers } = jest.requireMock('../SideFx');
+    expect(StorageTriggers.setHandler).toHaveBeenCalledTimes(1);
+
+    const received: Action[] = [];
+    const unsubscribe = subscribe((action) => received.push(action));
+    const handler = StorageTriggers.setHandler.mock.calls[0][0];
+    handler({ actionType: 'storage/warm/TOKEN', key: 'TOKEN', routeIds: [] });
+    expect(received.map((action) => action.type)).toEqual(['storage/warm/TOKEN']);
+
+    unsubscribe();
+    stop();
+    stop();
+    expect(StorageTriggers.remove).toHaveBeenCalledTimes(2);
+  });
+});
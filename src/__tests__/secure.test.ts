@@ -0,0 +1,122 @@
+/**
+ * Secure Storage Tests
+ *
+ * react-native-keychain and the native cache are both mocked. Values read or
+ * stored through SecureStorage are cached by service, except biometric
+ * items, which must prompt on every read.
+ */
+
+jest.mock('../SideFx', () => ({
+  Air: {
+    getCachedSecureValue: jest.fn(() => undefined),
+    cacheSecureValue: jest.fn(),
+    invalidateSecureValue: jest.fn(),
+    getSecureCacheGeneration: jest.fn(() => 7),
+    configureSecureCache: jest.fn(),
+  },
+}));
+
+jest.mock(
+  'react-native-keychain',
+  () => ({
+    ACCESSIBLE: {},
+    SECURITY_LEVEL: {},
+    ACCESS_CONTROL: { BIOMETRY_ANY: 'BiometryAny' },
+    getGenericPassword: jest.fn(async () => ({ username: 'user', password: 'token', service: 'auth' })),
+    setGenericPassword: jest.fn(async () => ({ service: 'auth' })),
+    resetGenericPassword: jest.fn(async () => true),
+  }),
+  { virtual: true }
+);
+
+import { Air } from '../SideFx';
+import { SecureStorage } from '../secure';
+
+const air = Air as unknown as Record<string, jest.Mock>;
+const keychain: Record<string, jest.Mock> = jest.requireMock('react-native-keychain');
+
+beforeEach(() => {
+  jest.clearAllMocks();
+  air.getCachedSecureValue.mockReturnValue(undefined);
+});
+
+describe('getCached', () => {
+  it('returns the natively cached value for the service', () => {
+    air.getCachedSecureValue.mockReturnValueOnce({ username: 'user', password: 'token' });
+    expect(SecureStorage.getCached({ service: 'auth' })).toEqual({
+      username: 'user',
+      password: 'token',
+      service: 'auth',
+    });
+    expect(air.getCachedSecureValue).toHaveBeenCalledWith('auth');
+  });
+
+  it('uses the default service', () => {
+    SecureStorage.getCached();
+    expect(air.getCachedSecureValue).toHaveBeenCalledWith('sam-secure');
+  });
+
+  it('returns null when nothing is cached', () => {
+    expect(SecureStorage.getCached({ service: 'auth' })).toBeNull();
+  });
+
+  it('never reads the cache for a biometric item', () => {
+    air.getCachedSecureValue.mockReturnValue({ username: 'user', password: 'token' });
+    expect(SecureStorage.getCached({ service: 'auth', requireBiometrics: true })).toBeNull();
+    expect(air.getCachedSecureValue).not.toHaveBeenCalled();
+  });
+});
+
+describe('get', () => {
+  it('serves a cached value without the keychain', async () => {
+    air.getCachedSecureValue.mockReturnValueOnce({ username: 'user', password: 'cached' });
+    expect(await SecureStorage.get({ service: 'auth' })).toEqual(
+      expect.objectContaining({ password: 'cached' })
+    );
+    expect(keychain.getGenericPassword).not.toHaveBeenCalled();
+  });
+
+  it('caches a keychain read with the generation captured before it', async () => {
+    expect(await SecureStorage.get({ service: 'auth' })).toEqual(
+      expect.objectContaining({ password: 'token' })
+    );
+    expect(air.cacheSecureValue).toHaveBeenCalledWith('auth', 'user', 'token', 7);
+  });
+
+  it('reads a biometric item from the keychain every time and never caches it', async () => {
+    air.getCachedSecureValue.mockReturnValue({ username: 'user', password: 'cached' });
+    const options = { service: 'auth', requireBiometrics: true };
+    expect(await SecureStorage.get(options)).toEqual(expect.objectContaining({ password: 'token' }));
+    expect(await SecureStorage.get(options)).toEqual(expect.objectContaining({ password: 'token' }));
+    expect(keychain.getGenericPassword).toHaveBeenCalledTimes(2);
+    expect(keychain.getGenericPassword).toHaveBeenCalledWith(
+      expect.objectContaining({ accessControl: 'BiometryAny' })
+    );
+    expect(air.cacheSecureValue).not.toHaveBeenCalled();
+  });
+});
+
+describe('set and delete', () => {
+  it('invalidates, then caches the stored value', async () => {
+    expect(await SecureStorage.set('user', 'token', { service: 'auth' })).toEqual({ success: true });
+    expect(air.invalidateSecureValue).toHaveBeenCalledWith('auth');
+    expect(air.cacheSecureValue).toHaveBeenCalledWith('auth', 'user', 'token', 7);
+  });
+
+  it('invalidates but does not cache a biometric item', async () => {
+    await SecureStorage.set('user', 'token', { service: 'auth', requireBiometrics: true });
+    expect(air.invalidateSecureValue).toHaveBeenCalledWith('auth');
+    expect(air.cacheSecureValue).not.toHaveBeenCalled();
+  });
+
+  it('does not cache a value the keychain refused', async () => {
+    keychain.setGenericPassword.mockResolvedValueOnce(false);
+    expect((await SecureStorage.set('user', 'token', { service: 'auth' })).success).toBe(false);
+    expect(air.cacheSecureValue).not.toHaveBeenCalled();
+  });
+
+  it('delete invalidates the cached value', async () => {
+    await SecureStorage.delete({ service: 'auth' });
+    expect(air.invalidateSecureValue).toHaveBeenCalledWith('auth');
+  });
+});
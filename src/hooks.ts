@@ -3,7 +3,7 @@
  * React Hooks for warm and cold storage
  */
 import { useEffect, useRef, useState, useCallback, useMemo } from 'react';
-import { Air } from './SideFx';
+import { Air, DEFAULT_COLD_DB_NAME } from './SideFx';
 import type {
   UseWarmConfig,
   UseWarmResult,
@@ -279,12 +279,11 @@ export function useCold<T = unknown>(
         queryParams: config.queryParams?.map((p) =>
           typeof p === 'boolean' ? (p ? 1 : 0) : p
         ),
-        databaseName: config.database ?? 'default',
-      },
-      options: {
-        ...config.options,
-        fireImmediately: config.options?.fireImmediately ?? true,
+        databaseName: config.database ?? DEFAULT_COLD_DB_NAME,
       },
+      // A table has no current value to fire with, so there is no
+      // fireImmediately default here; queryCold reads the initial rows
+      options: config.options,
     }),
     [
       config.table,
@@ -476,7 +475,7 @@ export function useStorage<TWarm = unknown, TCold = unknown>(
               queryParams: config.cold.queryParams?.map((p) =>
                 typeof p === 'boolean' ? (p ? 1 : 0) : p
               ),
-              databaseName: config.cold.database ?? 'default',
+              databaseName: config.cold.database ?? DEFAULT_COLD_DB_NAME,
             }
           : undefined,
         logic: config.logic ?? 'OR',
@@ -489,7 +488,8 @@ export function useStorage<TWarm = unknown, TCold = unknown>(
       },
       options: {
         ...config.options,
-        fireImmediately: config.options?.fireImmediately ?? true,
+        // Only the Warm side has current values to fire with
+        fireImmediately: config.options?.fireImmediately ?? config.warm !== undefined,
       },
     }),
     [config]
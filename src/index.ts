@@ -18,6 +18,9 @@ export type {
   Condition,
   WarmListenerConfig,
   ColdOperation,
+  ColdProfile,
+  ColdSynchronous,
+  ColdConfig,
   RowCondition,
   ColdListenerConfig,
   CombineLogic,
@@ -32,6 +35,31 @@ export type {
   ListenerResult,
   ListenerInfo,
   SAMConfig,
+  DispatchAllocationStats,
+  OperationMetrics,
+  SAMMetrics,
+  WarmConfig,
+  WarmPrewarmInstance,
+  WarmCompactionConfig,
+  WarmCompactionStats,
+  ColdCheckpointConfig,
+  ColdCheckpointStats,
+  ColdAcrossOptions,
+  ColdSearchConfig,
+  ColdSearchOptions,
+  ColdSearchOrder,
+  MemoryPressureLevel,
+  MemoryUsage,
+  SecureCachedValue,
+  StartupConfig,
+  StartupStage,
+  LogCategory,
+  // MFE registry types
+  MFEPhase,
+  MFELoadStats,
+  MFERecord,
+  MFERecordUpdate,
+  MFETransition,
   SideFx as SideFxSpec,
   // Network types
   NetworkStatus,
@@ -58,7 +86,13 @@ export type {
 export { SAMErrorCode } from './types';
 
 // Callback type
-export type { ListenerCallback } from './SideFx';
+export type {
+  ListenerCallback,
+  LogLevel,
+  ColdCancelToken,
+  ColdAcrossResult,
+  WarmPrewarmOptions,
+} from './SideFx';
 
 // MFE (Micro Frontend) State Tracking
 export {
@@ -77,6 +111,11 @@ export {
   markMFEError,
   clearMFEState,
   getTrackedMFEs,
+  getAllMFEStates,
+  subscribeMFEStates,
+  recordMFELoadTime,
+  getMFELoadStats,
+  resetMFELoadStats,
   addFallbackListener,
 } from './mfe';
 
@@ -1,17 +1,23 @@
 /**
  * S.A.M - MFE (Micro Frontend) State Tracker
  *
- * Provides Warm storage-based state tracking for federated modules.
+ * Provides native state tracking for federated modules.
  * Tracks loading states, versions, and mount/unmount events.
  *
+ * States live in the native MFE registry as fixed-layout binary records,
+ * persisted in the `sam-mfe-registry` Warm instance. Reading one MFE, or all
+ * of them, is a single native call, and state transitions are emitted by the
+ * native dispatcher.
+ *
  * Falls back to in-memory storage if native module is unavailable.
  */
 import { Air } from './SideFx';
+import type { MFELoadStats, MFEPhase, MFERecord, MFERecordUpdate } from './specs/SideFx.nitro';
 
 // Warm instance ID for MFE state tracking
 export const MFE_INSTANCE_ID = 'sam-mfe-registry';
 
-// Key prefix for MFE states
+// Key prefix for MFE states in the in-memory fallback store
 export const MFE_KEY_PREFIX = 'mfe.';
 
 // Flag to track if native module is available
@@ -24,6 +30,10 @@ const _fallbackStore: Map<string, string | number | boolean> = new Map();
 type FallbackListener = (key: string, value: string | number | boolean | null) => void;
 const _fallbackListeners: Set<FallbackListener> = new Set();
 
+// Recent load times per MFE for the fallback load stats (bounded)
+const FALLBACK_LOAD_SAMPLES = 256;
+const _fallbackLoadTimes: Map<string, number[]> = new Map();
+
 /**
  * Check if the native Air module is fully available
  */
@@ -151,37 +161,94 @@ export function initializeMFERegistry(warmRootPath?: string): void {
 }
 
 /**
- * Get the Warm key for an MFE
+ * Get the fallback store key for an MFE
  */
 function getMFEKey(mfeId: string): string {
   return `${MFE_KEY_PREFIX}${mfeId}`;
 }
 
 /**
- * Get the metadata key for an MFE
+ * Get the fallback store metadata key for an MFE
  */
 function getMetadataKey(mfeId: string): string {
   return `${MFE_KEY_PREFIX}${mfeId}.meta`;
 }
 
+/**
+ * Native phase for a state string. Any state that isn't a known phase is a
+ * version string.
+ */
+function phaseOf(state: MFEState): MFEPhase {
+  switch (state) {
+    case '':
+      return 'idle';
+    case 'loading':
+    case 'loaded':
+    case 'mounted':
+      return state;
+    case 'error':
+      return 'failed';
+    default:
+      return 'versioned';
+  }
+}
+
+/**
+ * State string for a native record
+ */
+function stateOf(record: MFERecord): MFEState {
+  switch (record.phase) {
+    case 'idle':
+      return '';
+    case 'versioned':
+      return record.version ?? 'loaded';
+    case 'failed':
+      return 'error';
+    default:
+      return record.phase;
+  }
+}
+
+function metadataOf(record: MFERecord): MFEMetadata {
+  return {
+    state: stateOf(record),
+    version: record.version,
+    loadedAt: record.loadedAt,
+    mountedAt: record.mountedAt,
+    unmountedAt: record.unmountedAt,
+    errorMessage: record.errorMessage,
+    loadTimeMs: record.loadTimeMs,
+  };
+}
+
+function updateOf(metadata?: Partial<MFEMetadata>): MFERecordUpdate | undefined {
+  if (!metadata) return undefined;
+  return {
+    version: metadata.version,
+    errorMessage: metadata.errorMessage,
+    loadedAt: metadata.loadedAt,
+    mountedAt: metadata.mountedAt,
+    unmountedAt: metadata.unmountedAt,
+    loadTimeMs: metadata.loadTimeMs,
+  };
+}
+
 /**
  * Get the current state of an MFE
  * @param mfeId The MFE identifier (e.g., 'demoHome', 'demoSettings')
  * @returns The MFE state or empty string if not tracked
  */
 export function getMFEState(mfeId: string): MFEState {
-  const key = getMFEKey(mfeId);
-
   if (!isNativeAvailable()) {
     // Use fallback store
-    const value = _fallbackStore.get(key);
+    const value = _fallbackStore.get(getMFEKey(mfeId));
     return (value as MFEState) ?? '';
   }
 
   try {
     initializeMFERegistry();
-    const value = Air.getWarm(key, MFE_INSTANCE_ID);
-    return (value as MFEState) ?? '';
+    const record = Air.getMFERecord(mfeId);
+    return record ? stateOf(record) : '';
   } catch {
     return '';
   }
@@ -193,11 +260,9 @@ export function getMFEState(mfeId: string): MFEState {
  * @returns MFE metadata or null if not found
  */
 export function getMFEMetadata(mfeId: string): MFEMetadata | null {
-  const metaKey = getMetadataKey(mfeId);
-
   if (!isNativeAvailable()) {
     // Use fallback store
-    const metaJson = _fallbackStore.get(metaKey);
+    const metaJson = _fallbackStore.get(getMetadataKey(mfeId));
     if (!metaJson || typeof metaJson !== 'string') {
       const state = getMFEState(mfeId);
       return state ? { state } : null;
@@ -211,21 +276,44 @@ export function getMFEMetadata(mfeId: string): MFEMetadata | null {
 
   try {
     initializeMFERegistry();
-    const metaJson = Air.getWarm(metaKey, MFE_INSTANCE_ID);
-    if (!metaJson || typeof metaJson !== 'string') {
-      const state = getMFEState(mfeId);
-      return state ? { state } : null;
-    }
-    try {
-      return JSON.parse(metaJson);
-    } catch {
-      return { state: getMFEState(mfeId) };
-    }
+    const record = Air.getMFERecord(mfeId);
+    return record ? metadataOf(record) : null;
   } catch {
     return null;
   }
 }
 
+/**
+ * Get the metadata of every tracked MFE in one call
+ * @returns MFE metadata keyed by MFE ID
+ */
+export function getAllMFEStates(): Record<string, MFEMetadata> {
+  const result: Record<string, MFEMetadata> = {};
+
+  if (!isNativeAvailable()) {
+    _fallbackStore.forEach((_, key) => {
+      if (!key.endsWith('.meta')) {
+        const mfeId = key.slice(MFE_KEY_PREFIX.length);
+        const metadata = getMFEMetadata(mfeId);
+        if (metadata) {
+          result[mfeId] = metadata;
+        }
+      }
+    });
+    return result;
+  }
+
+  try {
+    initializeMFERegistry();
+    for (const record of Air.getAllMFEStates()) {
+      result[record.mfeId] = metadataOf(record);
+    }
+  } catch (error) {
+    console.warn('[SAM] Failed to read MFE states:', error);
+  }
+  return result;
+}
+
 /**
  * Set the state of an MFE
  * @param mfeId The MFE identifier
@@ -264,23 +352,10 @@ export function setMFEState(
   try {
     initializeMFERegistry();
 
-    // Set the simple state value
-    Air.setWarm(stateKey, state, MFE_INSTANCE_ID);
-
-    // Update metadata if provided
-    if (metadata) {
-      const existingMeta = getMFEMetadata(mfeId) ?? { state: '' };
-      const newMeta: MFEMetadata = {
-        ...existingMeta,
-        ...metadata,
-        state,
-      };
-      Air.setWarm(
-        metaKey,
-        JSON.stringify(newMeta),
-        MFE_INSTANCE_ID
-      );
-    }
+    // One native call: the record merges `metadata` itself
+    const phase = phaseOf(state);
+    const update = phase === 'versioned' ? { ...metadata, version: state } : metadata;
+    Air.setMFERecord(mfeId, phase, updateOf(update));
   } catch (error) {
     console.warn('[SAM] Failed to set MFE state:', error);
   }
@@ -302,8 +377,15 @@ export function markMFELoading(mfeId: string): void {
  * @param version Optional version string
  */
 export function markMFELoaded(mfeId: string, version?: string): void {
+  if (isNativeAvailable()) {
+    // Native computes loadTimeMs from the loadedAt set by markMFELoading
+    setMFEState(mfeId, version ?? 'loaded', { version });
+    return;
+  }
+
   const loadedAt = getMFEMetadata(mfeId)?.loadedAt ?? Date.now();
   const loadTimeMs = Date.now() - loadedAt;
+  recordMFELoadTime(mfeId, loadTimeMs);
 
   setMFEState(mfeId, version ?? 'loaded', {
     version,
@@ -317,9 +399,7 @@ export function markMFELoaded(mfeId: string, version?: string): void {
  * @param mfeId The MFE identifier
  */
 export function markMFEMounted(mfeId: string): void {
-  const existing = getMFEMetadata(mfeId);
   setMFEState(mfeId, 'mounted', {
-    ...existing,
     mountedAt: Date.now(),
   });
 }
@@ -333,7 +413,6 @@ export function markMFEUnmounted(mfeId: string, keepLoaded = true): void {
   const existing = getMFEMetadata(mfeId);
   const newState = keepLoaded ? (existing?.version ?? 'loaded') : '';
   setMFEState(mfeId, newState, {
-    ...existing,
     unmountedAt: Date.now(),
   });
 }
@@ -370,27 +449,146 @@ export function clearMFEState(mfeId: string): void {
 
   try {
     initializeMFERegistry();
-    Air.deleteWarm(stateKey, MFE_INSTANCE_ID);
-    Air.deleteWarm(metaKey, MFE_INSTANCE_ID);
+    Air.clearMFERecord(mfeId);
   } catch (error) {
     console.warn('[SAM] Failed to clear MFE state:', error);
   }
 }
 
 /**
- * Get all tracked MFE IDs
- * Note: This requires iterating through known MFEs since MMKV doesn't support key listing
+ * Get the metadata of the given MFEs (null for untracked ones)
  */
 export function getTrackedMFEs(knownMFEs: string[]): Record<string, MFEMetadata | null> {
+  const all = getAllMFEStates();
   const result: Record<string, MFEMetadata | null> = {};
 
   for (const mfeId of knownMFEs) {
-    result[mfeId] = getMFEMetadata(mfeId);
+    result[mfeId] = all[mfeId] ?? null;
+  }
+
+  return result;
+}
+
+/**
+ * Listen for MFE state changes, from the native registry or the fallback store
+ * @param listener Called with the MFE ID and its new metadata (null once cleared)
+ * @returns Function that removes the listener
+ */
+export function subscribeMFEStates(
+  listener: (mfeId: string, metadata: MFEMetadata | null) => void
+): () => void {
+  // The fallback store writes the state and metadata keys one after the
+  // other; either notification re-reads both
+  const unsubscribeFallback = addFallbackListener((key) => {
+    const mfeId = key.slice(MFE_KEY_PREFIX.length).replace(/\.meta$/, '');
+    listener(mfeId, getMFEMetadata(mfeId));
+  });
+  if (!isNativeAvailable()) {
+    return unsubscribeFallback;
+  }
+
+  const unsubscribeNative = Air.onMFETransition((transition) => {
+    listener(transition.mfeId, transition.record ? metadataOf(transition.record) : null);
+  });
+  return () => {
+    unsubscribeFallback();
+    unsubscribeNative();
+  };
+}
+
+/**
+ * Add a load time to an MFE's aggregated stats.
+ * markMFELoaded records its own measurement; call this for loads timed elsewhere
+ * (e.g. by the module federation runtime).
+ * @param mfeId The MFE identifier
+ * @param loadTimeMs Load duration in milliseconds
+ */
+export function recordMFELoadTime(mfeId: string, loadTimeMs: number): void {
+  if (!isNativeAvailable()) {
+    const samples = _fallbackLoadTimes.get(mfeId) ?? [];
+    samples.push(loadTimeMs);
+    if (samples.length > FALLBACK_LOAD_SAMPLES) {
+      samples.shift();
+    }
+    _fallbackLoadTimes.set(mfeId, samples);
+    return;
+  }
+
+  try {
+    initializeMFERegistry();
+    Air.recordMFELoadTime(mfeId, loadTimeMs);
+  } catch (error) {
+    console.warn('[SAM] Failed to record MFE load time:', error);
+  }
+}
+
+/**
+ * Summarize the recent samples kept by the fallback store
+ */
+function fallbackLoadStats(mfeId: string, samples: number[]): MFELoadStats {
+  const sorted = [...samples].sort((a, b) => a - b);
+  const rank = (q: number) => sorted[Math.max(0, Math.ceil(q * sorted.length) - 1)];
+  return {
+    mfeId,
+    count: sorted.length,
+    minMs: sorted[0],
+    maxMs: sorted[sorted.length - 1],
+    meanMs: sorted.reduce((sum, value) => sum + value, 0) / sorted.length,
+    p50Ms: rank(0.5),
+    p95Ms: rank(0.95),
+  };
+}
+
+/**
+ * Get aggregated load times (count, min/max, mean, p50/p95) in one call
+ * @param mfeId Optional MFE identifier; all MFEs when omitted
+ * @returns Stats keyed by MFE ID
+ */
+export function getMFELoadStats(mfeId?: string): Record<string, MFELoadStats> {
+  const result: Record<string, MFELoadStats> = {};
+
+  if (!isNativeAvailable()) {
+    _fallbackLoadTimes.forEach((samples, id) => {
+      if (mfeId === undefined || id === mfeId) {
+        result[id] = fallbackLoadStats(id, samples);
+      }
+    });
+    return result;
   }
 
+  try {
+    initializeMFERegistry();
+    for (const stats of Air.getMFELoadStats(mfeId)) {
+      result[stats.mfeId] = stats;
+    }
+  } catch (error) {
+    console.warn('[SAM] Failed to read MFE load stats:', error);
+  }
   return result;
 }
 
+/**
+ * Clear aggregated load times
+ * @param mfeId Optional MFE identifier; all MFEs when omitted
+ */
+export function resetMFELoadStats(mfeId?: string): void {
+  if (!isNativeAvailable()) {
+    if (mfeId === undefined) {
+      _fallbackLoadTimes.clear();
+    } else {
+      _fallbackLoadTimes.delete(mfeId);
+    }
+    return;
+  }
+
+  try {
+    initializeMFERegistry();
+    Air.resetMFELoadStats(mfeId);
+  } catch (error) {
+    console.warn('[SAM] Failed to reset MFE load stats:', error);
+  }
+}
+
 /**
  * Check if native MFE tracking is available
  */
@@ -405,6 +603,11 @@ export const MFERegistry = {
   initialize: initializeMFERegistry,
   getState: getMFEState,
   getMetadata: getMFEMetadata,
+  getAllStates: getAllMFEStates,
+  subscribe: subscribeMFEStates,
+  recordLoadTime: recordMFELoadTime,
+  getLoadStats: getMFELoadStats,
+  resetLoadStats: resetMFELoadStats,
   setState: setMFEState,
   loading: markMFELoading,
   loaded: markMFELoaded,
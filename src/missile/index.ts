@@ -38,6 +38,8 @@ import {
   isThrottleEffect,
 } from './effects';
 
+import type { ChangeEvent, ListenerConfig } from '../specs/SideFx.nitro';
+
 // Re-export types and effects
 export * from './types';
 export * from './effects';
@@ -50,9 +52,31 @@ let taskIdCounter = 0;
 const tasks = new Map<string, TaskContext>();
 const taskPromises = new Map<string, Promise<any>>();
 const actionSubscribers = new Set<ActionSubscriber>();
-const pendingTakes = new Map<string, { pattern: Pattern; resolve: (action: Action) => void }>();
+// Takes on string patterns, keyed by native route ID (see ActionRoutes)
+const pendingTakes = new Map<number, (action: Action) => void>();
+// Takes on predicate patterns, which can't be routed natively; negative IDs
+const predicateTakes = new Map<number, { pattern: Pattern; resolve: (action: Action) => void }>();
+let predicateTakeCounter = 0;
+// Catch-all route held while subscribers or predicate takes exist, so storage
+// triggers keep firing for them; never in pendingTakes
+let observerRouteId: number | null = null;
+let storageTriggerCounter = 0;
+const storageTriggerIds = new Set<string>();
+let storageTriggerHandlerSet = false;
 let config: SagaMiddlewareConfig = {};
 
+// Loaded on first use, so importing Missile (channels, effects, subscribe)
+// doesn't need the native module
+let SideFxModule: typeof import('../SideFx') | null = null;
+
+function getSideFx(): typeof import('../SideFx') {
+  if (SideFxModule === null) {
+    // eslint-disable-next-line @typescript-eslint/no-var-requires
+    SideFxModule = require('../SideFx');
+  }
+  return SideFxModule!;
+}
+
 // ============================================================================
 // Pattern Matching
 // ============================================================================
@@ -82,17 +106,129 @@ function matchesPattern(action: Action, pattern: Pattern): boolean {
   return false;
 }
 
+/**
+ * The string patterns in `pattern`, or null if it contains a predicate
+ */
+function routablePatterns(pattern: Pattern): string[] | null {
+  if (typeof pattern === 'string') {
+    return [pattern];
+  }
+  if (Array.isArray(pattern) && pattern.every((p) => typeof p === 'string')) {
+    return pattern;
+  }
+  return null;
+}
+
+/**
+ * Wait for the next action matching `pattern`. String patterns are routed
+ * by the native trie, so dispatch cost doesn't grow with pending takes.
+ * @returns ID for removeTake
+ */
+function addTake(pattern: Pattern, resolve: (action: Action) => void): number {
+  const patterns = routablePatterns(pattern);
+  if (patterns === null) {
+    const takeId = --predicateTakeCounter;
+    predicateTakes.set(takeId, { pattern, resolve });
+    syncObserverRoute();
+    return takeId;
+  }
+  const routeId = getSideFx().ActionRoutes.add(patterns, true);
+  pendingTakes.set(routeId, resolve);
+  return routeId;
+}
+
+function removeTake(takeId: number): void {
+  if (takeId < 0) {
+    predicateTakes.delete(takeId);
+    syncObserverRoute();
+  } else if (pendingTakes.delete(takeId)) {
+    getSideFx().ActionRoutes.remove(takeId);
+  }
+}
+
+/**
+ * Native storage triggers only fire while a route wants their action type.
+ * Subscribers and predicate takes want every type but aren't routes, so a
+ * single "*" route stands in for them while any storage trigger exists.
+ */
+function syncObserverRoute(): void {
+  const wanted = storageTriggerIds.size > 0 && (actionSubscribers.size > 0 || predicateTakes.size > 0);
+  if (wanted && observerRouteId === null) {
+    observerRouteId = getSideFx().ActionRoutes.add(['*'], false);
+  } else if (!wanted && observerRouteId !== null) {
+    getSideFx().ActionRoutes.remove(observerRouteId);
+    observerRouteId = null;
+  }
+}
+
 // ============================================================================
 // Channel Implementation
 // ============================================================================
 
+/**
+ * FIFO ring buffer: O(1) push and shift, unlike Array.shift()
+ */
+class RingBuffer<T> {
+  private items: Array<T | undefined>;
+  private head = 0;
+  private count = 0;
+
+  constructor(capacity: number) {
+    this.items = new Array(Math.max(1, capacity));
+  }
+
+  get length(): number {
+    return this.count;
+  }
+
+  isFull(): boolean {
+    return this.count === this.items.length;
+  }
+
+  /**
+   * Append, doubling the capacity when full
+   */
+  push(value: T): void {
+    if (this.isFull()) {
+      const grown = new Array<T | undefined>(this.items.length * 2);
+      for (let i = 0; i < this.count; i++) {
+        grown[i] = this.items[(this.head + i) % this.items.length];
+      }
+      this.items = grown;
+      this.head = 0;
+    }
+    this.items[(this.head + this.count) % this.items.length] = value;
+    this.count++;
+  }
+
+  shift(): T | undefined {
+    if (this.count === 0) {
+      return undefined;
+    }
+    const value = this.items[this.head];
+    this.items[this.head] = undefined; // don't retain taken values
+    this.head = (this.head + 1) % this.items.length;
+    this.count--;
+    return value;
+  }
+
+  drain(): T[] {
+    const values: T[] = [];
+    while (this.count > 0) {
+      values.push(this.shift()!);
+    }
+    return values;
+  }
+}
+
 /**
  * Create a new channel for saga communication
  */
 export function channel<T>(config: ChannelConfig = {}): Channel<T> {
   const { buffer = 'expanding', bufferSize = 10 } = config;
-  const queue: T[] = [];
-  const takers: Array<(value: T) => void> = [];
+  // Bounded buffers never grow past bufferSize, so their ring never resizes
+  const queue = new RingBuffer<T>(bufferSize);
+  const takers = new RingBuffer<(value: T) => void>(4);
   let closed = false;
 
   return {
@@ -114,37 +250,32 @@ export function channel<T>(config: ChannelConfig = {}): Channel<T> {
       if (takers.length > 0) {
         const taker = takers.shift()!;
         taker(value);
-      } else {
-        // Apply buffer strategy
-        if (buffer === 'none') {
-          // Drop if no taker
-          return;
-        }
+        return;
+      }
 
-        if (buffer === 'dropping' && queue.length >= bufferSize) {
-          // Drop new value
-          return;
-        }
+      // Apply buffer strategy
+      if (buffer === 'none') {
+        // Drop if no taker
+        return;
+      }
 
-        if (buffer === 'sliding' && queue.length >= bufferSize) {
+      if (buffer !== 'expanding' && queue.length >= bufferSize) {
+        if (buffer === 'sliding') {
           // Remove oldest
           queue.shift();
-        }
-
-        queue.push(value);
-
-        // Enforce size for fixed buffer
-        if (buffer === 'fixed' && queue.length > bufferSize) {
-          queue.length = bufferSize;
+        } else {
+          // 'dropping' and 'fixed' drop the new value
+          return;
         }
       }
+
+      queue.push(value);
     },
 
     close(): void {
       closed = true;
       // Resolve all pending takers with undefined
-      takers.forEach((taker) => taker(undefined as any));
-      takers.length = 0;
+      takers.drain().forEach((taker) => taker(undefined as any));
     },
 
     isClosed(): boolean {
@@ -152,9 +283,7 @@ export function channel<T>(config: ChannelConfig = {}): Channel<T> {
     },
 
     flush(): T[] {
-      const items = [...queue];
-      queue.length = 0;
-      return items;
+      return queue.drain();
     },
   };
 }
@@ -297,12 +426,11 @@ async function runEffect(effect: AnyEffect, ctx: TaskContext): Promise<any> {
 
     // Take from action channel
     return new Promise<Action>((resolve) => {
-      const takeId = `take_${Date.now()}_${Math.random()}`;
-      pendingTakes.set(takeId, { pattern, resolve });
+      const takeId = addTake(pattern, resolve);
 
       // Register cancel callback
       ctx.cancelCallbacks.push(() => {
-        pendingTakes.delete(takeId);
+        removeTake(takeId);
       });
     });
   }
@@ -667,7 +795,19 @@ export function dispatch<T = any>(action: Action<T>): void {
     throw new Error('Action must have a type property');
   }
 
-  // Notify subscribers
+  // Resolve pending takes. Native matching removes the matched routes, and
+  // its cost depends on the action type, not on how many sagas are waiting.
+  deliverAction(
+    action,
+    pendingTakes.size > 0 ? getSideFx().ActionRoutes.match(action.type) : []
+  );
+}
+
+/**
+ * Hand an action to subscribers and to the takes on `routeIds`, which the
+ * caller has already matched (and so removed) natively
+ */
+function deliverAction(action: Action, routeIds: readonly number[]): void {
   actionSubscribers.forEach((subscriber) => {
     try {
       subscriber(action);
@@ -678,13 +818,67 @@ export function dispatch<T = any>(action: Action<T>): void {
     }
   });
 
-  // Resolve pending takes
-  pendingTakes.forEach((pending, takeId) => {
-    if (matchesPattern(action, pending.pattern)) {
-      pending.resolve(action);
-      pendingTakes.delete(takeId);
+  for (const routeId of routeIds) {
+    const resolve = pendingTakes.get(routeId);
+    if (resolve) {
+      pendingTakes.delete(routeId);
+      resolve(action);
     }
-  });
+  }
+
+  if (predicateTakes.size > 0) {
+    predicateTakes.forEach((pending, takeId) => {
+      if (matchesPattern(action, pending.pattern)) {
+        pending.resolve(action);
+        predicateTakes.delete(takeId);
+      }
+    });
+    syncObserverRoute();
+  }
+}
+
+// Storage trigger events arrive already matched: the native dispatcher
+// claimed their routes when it built the event
+function deliverStorageTrigger(event: ChangeEvent): void {
+  deliverAction({ type: event.actionType!, payload: event }, event.routeIds ?? []);
+}
+
+/**
+ * Dispatch an action whenever Warm or Cold storage changes as `config`
+ * describes, e.g. so a saga can `take` a token update without polling.
+ * Conditions are evaluated natively, and nothing crosses to JS while no
+ * take or subscriber wants `actionType`. The action's payload is the
+ * ChangeEvent.
+ *
+ * @example
+ * ```typescript
+ * storageTrigger('storage/warm/AUTH_TOKEN', { warm: { keys: ['AUTH_TOKEN'] } });
+ *
+ * function* authSaga() {
+ *   const { payload } = yield take('storage/warm/AUTH_TOKEN');
+ *   yield call(connectSocket, payload.newValue);
+ * }
+ * ```
+ */
+export function storageTrigger(actionType: string, triggerConfig: ListenerConfig): Unsubscribe {
+  const { StorageTriggers } = getSideFx();
+  if (!storageTriggerHandlerSet) {
+    StorageTriggers.setHandler(deliverStorageTrigger);
+    storageTriggerHandlerSet = true;
+  }
+  const id = `missile.trigger.${++storageTriggerCounter}`;
+  const result = StorageTriggers.add(id, actionType, triggerConfig);
+  if (!result.success) {
+    throw new Error(`[Missile] Failed to add storage trigger: ${result.error}`);
+  }
+  storageTriggerIds.add(id);
+  syncObserverRoute();
+  return () => {
+    if (storageTriggerIds.delete(id)) {
+      StorageTriggers.remove(id);
+      syncObserverRoute();
+    }
+  };
 }
 
 /**
@@ -728,7 +922,11 @@ export function cancelSaga(task: Task): void {
  */
 export function subscribe(subscriber: ActionSubscriber): Unsubscribe {
   actionSubscribers.add(subscriber);
-  return () => actionSubscribers.delete(subscriber);
+  syncObserverRoute();
+  return () => {
+    actionSubscribers.delete(subscriber);
+    syncObserverRoute();
+  };
 }
 
 /**
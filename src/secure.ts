@@ -7,6 +7,10 @@
  * This module is optional - react-native-keychain must be installed separately.
  */
 
+import { Air } from './SideFx';
+
+const DEFAULT_SERVICE = 'sam-secure';
+
 // Types for react-native-keychain (we define our own to avoid hard dependency)
 export interface SecureStorageOptions {
   /**
@@ -159,7 +163,7 @@ function buildKeychainOptions(
   keychain: typeof import('react-native-keychain')
 ): Record<string, unknown> {
   const opts: Record<string, unknown> = {
-    service: options?.service ?? 'sam-secure',
+    service: options?.service ?? DEFAULT_SERVICE,
   };
 
   if (options?.accessible) {
@@ -181,6 +185,14 @@ function buildKeychainOptions(
   return opts;
 }
 
+/**
+ * Service whose values may be cached natively. Biometric items are never
+ * cached, so every read of one still prompts.
+ */
+function cacheableService(options: SecureStorageOptions | undefined): string | null {
+  return options?.requireBiometrics ? null : (options?.service ?? DEFAULT_SERVICE);
+}
+
 /**
  * SecureStorage API
  *
@@ -247,6 +259,10 @@ export const SecureStorage = {
     value: string,
     options?: SecureStorageOptions
   ): Promise<SecureResult> {
+    const service = options?.service ?? DEFAULT_SERVICE;
+    Air.invalidateSecureValue(service);
+    // A set/delete racing this write invalidates again, and the value is not cached
+    const generation = Air.getSecureCacheGeneration(service);
     try {
       const keychain = getKeychain();
       const keychainOptions = buildKeychainOptions(options, keychain);
@@ -261,6 +277,10 @@ export const SecureStorage = {
         return { success: false, error: 'Failed to store secure value' };
       }
 
+      const cacheable = cacheableService(options);
+      if (cacheable !== null) {
+        Air.cacheSecureValue(cacheable, key, value, generation);
+      }
       return { success: true };
     } catch (error) {
       return {
@@ -289,6 +309,13 @@ export const SecureStorage = {
    * ```
    */
   async get(options?: SecureStorageOptions): Promise<SecureCredentials | null> {
+    const cached = SecureStorage.getCached(options);
+    if (cached !== null) {
+      return cached;
+    }
+    // Captured before the keychain read: if a set/delete lands while it is in
+    // flight, the value read may be stale and is not cached
+    const generation = Air.getSecureCacheGeneration(options?.service ?? DEFAULT_SERVICE);
     try {
       const keychain = getKeychain();
       const keychainOptions = buildKeychainOptions(options, keychain);
@@ -299,6 +326,10 @@ export const SecureStorage = {
         return null;
       }
 
+      const cacheable = cacheableService(options);
+      if (cacheable !== null) {
+        Air.cacheSecureValue(cacheable, result.username, result.password, generation);
+      }
       return {
         username: result.username,
         password: result.password,
@@ -309,6 +340,46 @@ export const SecureStorage = {
     }
   },
 
+  /**
+   * Read a value from the native cache, synchronously. Returns null when the
+   * service has no cache TTL, the value has not been read or stored since it
+   * expired, or it requires biometrics.
+   *
+   * @example
+   * ```typescript
+   * // In an HTTP interceptor
+   * const cached = SecureStorage.getCached({ service: 'auth' });
+   * const token = cached?.password ?? (await SecureStorage.get({ service: 'auth' }))?.password;
+   * ```
+   */
+  getCached(options?: SecureStorageOptions): SecureCredentials | null {
+    const service = cacheableService(options);
+    if (service === null) {
+      return null;
+    }
+    const cached = Air.getCachedSecureValue(service);
+    if (cached === undefined) {
+      return null;
+    }
+    return { username: cached.username, password: cached.password, service };
+  },
+
+  /**
+   * Cache a service's value natively for `ttlMs` after each get/set, so hot
+   * reads skip the keychain round trip. 0 turns caching off and drops the
+   * cached value. Cached values are held in locked memory that is zeroed on
+   * expiry, on set/delete and when caching is turned off; the keychain item
+   * itself is unchanged.
+   *
+   * @example
+   * ```typescript
+   * SecureStorage.configureCache('auth', 5 * 60 * 1000);
+   * ```
+   */
+  configureCache(service: string, ttlMs: number): void {
+    Air.configureSecureCache(service, ttlMs);
+  },
+
   /**
    * Check if a secure value exists
    *
@@ -342,6 +413,7 @@ export const SecureStorage = {
    * ```
    */
   async delete(options?: SecureStorageOptions): Promise<SecureResult> {
+    Air.invalidateSecureValue(options?.service ?? DEFAULT_SERVICE);
     try {
       const keychain = getKeychain();
       const keychainOptions = buildKeychainOptions(options, keychain);
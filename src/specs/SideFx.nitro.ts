@@ -61,6 +61,120 @@ export interface WarmListenerConfig {
  */
 export type ColdOperation = 'INSERT' | 'UPDATE' | 'DELETE';
 
+/**
+ * Options for initializeWarm
+ */
+export interface WarmConfig {
+  /**
+   * AES key, 1-16 bytes (MMKV encrypts with AES-128 in CFB mode). The
+   * instance is opened encrypted and every value is encrypted on disk. Opening
+   * an existing plaintext instance with a key (or an encrypted one without)
+   * reads garbage, so pick one per instance ID and keep it.
+   */
+  encryptionKey?: string;
+  /**
+   * Open in MMKV's multi-process mode, so app extensions and other processes
+   * can share the instance. Writes from other processes are detected natively
+   * and delivered to listeners like local ones. Off by default: the mode
+   * takes a file lock on every access.
+   */
+  multiProcess?: boolean;
+}
+
+/**
+ * SQLite tuning profile for a Cold database
+ * - default: SQLite's defaults (synchronous FULL), WAL and a 5s busy timeout
+ * - readHeavy: 256 MiB mmap, 16 MiB page cache, synchronous NORMAL
+ * - writeHeavy: 64 MiB mmap, 8 MiB page cache, synchronous NORMAL, fewer checkpoints
+ * - lowMemory: no mmap, 1 MiB page cache, temp tables on disk, frequent checkpoints
+ */
+export type ColdProfile = 'default' | 'readHeavy' | 'writeHeavy' | 'lowMemory';
+
+/**
+ * PRAGMA synchronous level
+ */
+export type ColdSynchronous = 'off' | 'normal' | 'full';
+
+/**
+ * Connection settings for initializeCold: a profile, plus overrides of its
+ * individual settings. Applied to every connection S.A.M opens on the database.
+ */
+export interface ColdConfig {
+  /** Baseline settings (default 'default') */
+  profile?: ColdProfile;
+  synchronous?: ColdSynchronous;
+  /** PRAGMA mmap_size; 0 disables memory-mapped I/O */
+  mmapSizeBytes?: number;
+  /** Page cache size per connection */
+  cacheSizeKiB?: number;
+  /** Keep temporary tables and indices in memory */
+  tempStoreMemory?: boolean;
+  /** PRAGMA wal_autocheckpoint while background checkpoints are disabled; 0 disables automatic checkpoints */
+  walAutocheckpointPages?: number;
+  /** How long a connection waits for another's write lock */
+  busyTimeoutMs?: number;
+  /**
+   * Schema migrations, oldest first. Migration i (1-based) takes PRAGMA
+   * user_version from i - 1 to i; pending ones run in one transaction when
+   * the database is opened. Each may hold several statements.
+   */
+  migrations?: string[];
+}
+
+/**
+ * Options for queryColdAcross
+ */
+export interface ColdAcrossOptions {
+  /** Merge rows in this result column's order (SQLite ordering, BINARY collation) */
+  orderBy?: string;
+  /** Descending order for orderBy (default false) */
+  descending?: boolean;
+  /** Keep at most this many merged rows */
+  limit?: number;
+}
+
+/**
+ * A Cold table made searchable with declareColdSearch
+ */
+export interface ColdSearchConfig {
+  /** Table whose rows are indexed; must have a rowid */
+  table: string;
+  /** Text columns to index */
+  columns: string[];
+  /** FTS5 tokenizer (default 'unicode61 remove_diacritics 2') */
+  tokenizer?: string;
+  /** Prefix lengths to index for fast prefix queries, e.g. [2, 3] */
+  prefixLengths?: number[];
+}
+
+/**
+ * Result order for searchCold
+ * - rank: best match first (BM25)
+ * - newest / oldest: by rowid, so insertion order for most tables; cheaper
+ *   than rank because matches are not scored
+ */
+export type ColdSearchOrder = 'rank' | 'newest' | 'oldest';
+
+/**
+ * Options for searchCold
+ */
+export interface ColdSearchOptions {
+  /** Maximum rows (default 50) */
+  limit?: number;
+  /** Rows to skip, for paging (default 0) */
+  offset?: number;
+  /** Default 'rank' */
+  order?: ColdSearchOrder;
+  /** Column to take the snippet from (default: the best-matching column) */
+  snippetColumn?: string;
+  /** Text before each match in the snippet (default '<b>') */
+  highlightOpen?: string;
+  /** Text after each match in the snippet (default '</b>') */
+  highlightClose?: string;
+  /** Snippet length in tokens, 1-64 (default 16) */
+  snippetTokens?: number;
+}
+
 /**
  * Row condition for Cold storage listeners
  */
@@ -105,6 +219,7 @@ export interface CorrelationConfig {
 export interface CombinedListenerConfig {
   warm?: WarmListenerConfig;
   cold?: ColdListenerConfig;
+  /** OR (default) fires on either side; AND once both sides changed since the last callback */
   logic?: CombineLogic;
   correlation?: CorrelationConfig;
 }
@@ -125,12 +240,16 @@ export interface ListenerOptions {
 
   /**
    * Throttle in milliseconds - minimum time between callback invocations.
-   * Ensures the callback is not called more frequently than this interval.
+   * Ensures the callback is not called more frequently than this interval;
+   * the latest change inside a window is delivered when the window ends.
    * @example throttleMs: 9000 - At most one callback every 9 seconds
    */
   throttleMs?: number;
 
-  /** Fire immediately with current value on registration */
+  /**
+   * Fire immediately with current value on registration: one SET event per
+   * matching Warm key. Ignored by Cold-only listeners.
+   */
   fireImmediately?: boolean;
 
   /** Enable debug logging for this listener */
@@ -182,6 +301,8 @@ export interface ChangeEvent {
   newValue?: string | number | boolean | null;
   row?: RowData;
   timestamp: number;
+  actionType?: string; // Set for storage triggers
+  routeIds?: number[]; // Missile routes resolved by this event (storage triggers)
 }
 
 // ============================================================================
@@ -218,9 +339,228 @@ export interface ListenerInfo {
 export interface SAMConfig {
   debug?: boolean;
   maxListeners?: number;
+  /** Native memory budget in bytes, enforced by the memory governor (0 = unlimited) */
   cacheSize?: number;
 }
 
+/**
+ * Native log category. Each category has its own log level.
+ */
+export type LogCategory =
+  | 'general'
+  | 'listeners'
+  | 'warm'
+  | 'cold'
+  | 'dispatch'
+  | 'network';
+
+/**
+ * Allocation counters for the native change dispatch path.
+ * Only maintained in debug builds of the native module (`enabled` is false
+ * in release builds and all counters stay 0).
+ */
+export interface DispatchAllocationStats {
+  enabled: boolean;
+  /** Dispatch batches that produced at least one event */
+  batches: number;
+  /** Change events built */
+  eventsBuilt: number;
+  /** Heap allocations made by the dispatch arena */
+  arenaBlockAllocations: number;
+  /** Bytes currently held by the dispatch arena */
+  arenaBytesReserved: number;
+  /** Largest number of arena bytes used by a single batch */
+  arenaHighWaterBytes: number;
+  /** Times a reusable dispatch buffer had to grow */
+  bufferGrowths: number;
+}
+
+/**
+ * Latency distribution and counters for one native operation.
+ * Latencies are in microseconds. Percentiles come from a log-linear
+ * histogram and are at most ~3% above the true value.
+ */
+export interface OperationMetrics {
+  /** Operation name, e.g. "setWarm", "dispatch.latency", "lock.storage" */
+  name: string;
+  /** Calls recorded */
+  count: number;
+  /** Calls that failed (error result or null due to an error) */
+  errors: number;
+  meanUs: number;
+  minUs: number;
+  maxUs: number;
+  p50Us: number;
+  p90Us: number;
+  p99Us: number;
+  p999Us: number;
+}
+
+/**
+ * Snapshot of the native metrics. Collected in release builds too.
+ */
+export interface SAMMetrics {
+  /** False if the native module was built with SAM_METRICS=0 */
+  enabled: boolean;
+  /** Length of the interval covered (since startup or the last reset) */
+  intervalMs: number;
+  operations: OperationMetrics[];
+  /** Change events delivered to the JS handler during the interval */
+  eventsDelivered: number;
+  /** Changes queued but not yet dispatched at snapshot time */
+  pendingChanges: number;
+}
+
+/**
+ * Background compaction of Warm instances (all fields optional; omitted
+ * fields keep their current value)
+ */
+export interface WarmCompactionConfig {
+  /** Compact automatically while Warm writes are idle (default true) */
+  enabled?: boolean;
+  /** How long Warm writes must pause before a compaction pass; also the check interval (default 5000) */
+  idleMs?: number;
+  /** Files smaller than this are never compacted automatically (default 65536) */
+  minFileBytes?: number;
+  /** Compact once the append log holds this many bytes per live byte (default 2) */
+  maxAmplification?: number;
+}
+
+/**
+ * File usage and compaction history of one Warm instance
+ */
+export interface WarmCompactionStats {
+  instanceId: string;
+  /** Size of the instance's file */
+  fileBytes: number;
+  /** Bytes used by the append log, overwritten entries included */
+  usedBytes: number;
+  /** Approximate encoded size of the current keys and values */
+  liveBytes: number;
+  /** Compactions run by the scheduler or compactWarm() */
+  compactions: number;
+  /** Duration of the last compaction */
+  lastCompactionMs: number;
+  /** When the last compaction finished (ms since epoch, 0 if never) */
+  lastCompactedAt: number;
+  /** File bytes released by all compactions */
+  bytesReclaimed: number;
+}
+
+/**
+ * Background WAL checkpoints of file-backed Cold databases (all fields
+ * optional; omitted fields keep their current value)
+ */
+export interface ColdCheckpointConfig {
+  /** Checkpoint on the maintenance thread instead of inline on commits (default true) */
+  enabled?: boolean;
+  /** Check interval; a database with no commit in one interval is idle (default 2000) */
+  intervalMs?: number;
+  /** Idle databases with a WAL this large get a TRUNCATE checkpoint (default 4 MiB) */
+  truncateWalBytes?: number;
+  /** Checkpoint even while writes continue once the WAL is this large (default 16 MiB) */
+  maxWalBytes?: number;
+}
+
+/**
+ * WAL size and checkpoint history of one Cold database
+ */
+export interface ColdCheckpointStats {
+  databaseName: string;
+  /** Current size of the WAL file */
+  walBytes: number;
+  /** Checkpoints run by the scheduler or checkpointCold() */
+  checkpoints: number;
+  /** Checkpoints that also reset the WAL file to zero bytes */
+  truncateCheckpoints: number;
+  /** Checkpoints that left frames behind because readers or writers were active */
+  incompleteCheckpoints: number;
+  /** Duration of the last checkpoint */
+  lastCheckpointMs: number;
+  /** Longest checkpoint so far */
+  maxCheckpointMs: number;
+  /** When the last checkpoint finished (ms since epoch, 0 if never) */
+  lastCheckpointAt: number;
+}
+
+// ============================================================================
+// Startup Types
+// ============================================================================
+
+/**
+ * A Warm instance for prewarmWarm and the config to open it with. The config
+ * must match the instance's initializeWarm config: key and mode are fixed
+ * when the file is first opened.
+ */
+export interface WarmPrewarmInstance {
+  instanceId: string;
+  config?: WarmConfig;
+}
+
+/**
+ * Startup pipeline options (all fields optional; omitted fields keep their
+ * current value)
+ */
+export interface StartupConfig {
+  /** Open Cold databases on first use instead of in initializeCold (default false) */
+  lazyCold?: boolean;
+}
+
+/**
+ * One timed step of startup: MMKV setup, a Warm instance or a Cold database opening
+ */
+export interface StartupStage {
+  /** "warm.global", "warm:<instanceId>" or "cold:<databaseName>" */
+  stage: string;
+  /** When the stage began, in ms since the native module was created */
+  startMs: number;
+  durationMs: number;
+  /** Whether the stage ran on a native worker rather than the calling thread */
+  background: boolean;
+}
+
+// ============================================================================
+// Memory Governor Types
+// ============================================================================
+
+/**
+ * OS memory pressure, as reported by the platform or forwarded from JS
+ */
+export type MemoryPressureLevel = 'normal' | 'moderate' | 'critical';
+
+/**
+ * Native memory held by each subsystem, in bytes
+ */
+export interface MemoryUsage {
+  /** SAMConfig.cacheSize (0 = unlimited) */
+  budgetBytes: number;
+  /** Sum of the subsystems below */
+  totalBytes: number;
+  /** Mapped file size of the resident Warm instances */
+  warmMappedBytes: number;
+  /** Initialized Warm instances */
+  warmInstances: number;
+  /** Warm instances currently mapped; evicted ones remap on next access */
+  warmResidentInstances: number;
+  /**
+   * Multi-process Warm instances' snapshots of the values last seen by this
+   * process (approximate). Values over 64 bytes are held as a hash.
+   */
+  warmSnapshotBytes: number;
+  /** SQLite page cache, schema and prepared statements across connections */
+  coldCacheBytes: number;
+  /** Listener table and compiled regex conditions (approximate) */
+  listenerBytes: number;
+  /** Change-event arena and dispatch buffers */
+  dispatchBytes: number;
+  /** MFE registry records and load-time sketches (approximate) */
+  mfeBytes: number;
+  /** Warm instances evicted by the governor since startup */
+  warmEvictions: number;
+  /** Most recent memory pressure level received */
+  lastPressure: MemoryPressureLevel;
+}
+
 // ============================================================================
 // Network Types
 // ============================================================================
@@ -269,6 +609,78 @@ export interface NetworkState {
   timestamp: number;
 }
 
+// ============================================================================
+// Secure Value Cache Types
+// ============================================================================
+
+/**
+ * A keychain item held by the native secure value cache
+ */
+export interface SecureCachedValue {
+  username: string;
+  password: string;
+}
+
+// ============================================================================
+// MFE Registry Types
+// ============================================================================
+
+/**
+ * Lifecycle phase of a micro-frontend
+ * 'versioned' is loaded under a version string (the version is the state).
+ */
+export type MFEPhase = 'idle' | 'loading' | 'loaded' | 'versioned' | 'mounted' | 'failed';
+
+/**
+ * State of one micro-frontend, stored natively as a fixed-layout binary record
+ */
+export interface MFERecord {
+  mfeId: string;
+  phase: MFEPhase;
+  version?: string;
+  errorMessage?: string;
+  loadedAt?: number;
+  mountedAt?: number;
+  unmountedAt?: number;
+  loadTimeMs?: number;
+  updatedAt: number;
+}
+
+/**
+ * Fields merged into an MFE record by setMFERecord (absent fields are kept)
+ */
+export interface MFERecordUpdate {
+  version?: string;
+  errorMessage?: string;
+  loadedAt?: number;
+  mountedAt?: number;
+  unmountedAt?: number;
+  loadTimeMs?: number;
+}
+
+/**
+ * Aggregated load times of one MFE (all in milliseconds)
+ * Percentiles come from a fixed-size log-bucket sketch (within ~6%).
+ */
+export interface MFELoadStats {
+  mfeId: string;
+  count: number;
+  minMs: number;
+  maxMs: number;
+  meanMs: number;
+  p50Ms: number;
+  p95Ms: number;
+}
+
+/**
+ * MFE state change, delivered by the native dispatcher
+ */
+export interface MFETransition {
+  mfeId: string;
+  previousPhase: MFEPhase;
+  record?: MFERecord; // Absent when the record was cleared
+}
+
 // ============================================================================
 // Main SideFx Hybrid Object Interface
 // ============================================================================
@@ -286,6 +698,15 @@ export interface SideFx extends HybridObject<{ ios: 'c++'; android: 'c++' }> {
    */
   addListener(id: string, config: ListenerConfig): ListenerResult;
 
+  /**
+   * Add a storage trigger: a listener whose events become missile actions
+   * @param id Unique identifier for this trigger (removed with removeListener)
+   * @param actionType Action type dispatched when the config matches
+   * @param config Listener configuration
+   * @returns Result indicating success or failure
+   */
+  addStorageTrigger(id: string, actionType: string, config: ListenerConfig): ListenerResult;
+
   /**
    * Remove a listener by ID
    * @param id The listener ID to remove
@@ -365,16 +786,26 @@ export interface SideFx extends HybridObject<{ ios: 'c++'; android: 'c++' }> {
    * Initialize Warm adapter
    * Must be called before Warm listeners will work
    * @param instanceId Warm instance ID (default: "default")
+   * @param config Optional encryption key. The decrypted instance stays open
+   *               natively, so the key is only needed again after a restart.
+   */
+  initializeWarm(instanceId?: string, config?: WarmConfig): ListenerResult;
+
+  /**
+   * Generate a random 16-character Warm encryption key from the platform's
+   * secure random source. Store it (e.g. in the Keychain) to reopen the
+   * instance on the next launch.
    */
-  initializeWarm(instanceId?: string): ListenerResult;
+  createWarmEncryptionKey(): string;
 
   /**
    * Initialize Cold storage adapter
    * Must be called before Cold storage listeners will work
    * @param databaseName Database name
    * @param databasePath Path to the database file
+   * @param config Optional tuning profile and PRAGMA overrides, applied when the database is opened
    */
-  initializeCold(databaseName: string, databasePath: string): ListenerResult;
+  initializeCold(databaseName: string, databasePath: string, config?: ColdConfig): ListenerResult;
 
   /**
    * Check if Warm storage is initialized
@@ -389,8 +820,10 @@ export interface SideFx extends HybridObject<{ ios: 'c++'; android: 'c++' }> {
   isColdInitialized(databaseName?: string): boolean;
 
   /**
-   * Manually trigger a check for Warm storage changes
-   * Useful if using a custom Warm setup
+   * Diff every multi-process Warm instance against its snapshot now and
+   * queue events for other processes' writes. Does not depend on MMKV's
+   * process-wide content change handler. No-op without multi-process
+   * instances.
    */
   checkWarmChanges(): void;
 
@@ -412,6 +845,26 @@ export interface SideFx extends HybridObject<{ ios: 'c++'; android: 'c++' }> {
    */
   setDebugMode(enabled: boolean): void;
 
+  /**
+   * Set the native log level
+   * Levels are numeric because DEBUG and ERROR are common preprocessor macros
+   * in app builds: 0 = trace, 1 = debug, 2 = info, 3 = warn, 4 = error, 5 = off.
+   * @param level Minimum level that is logged; out-of-range values are
+   *   clamped and non-finite ones are ignored
+   * @param category Category to change (default: all categories)
+   */
+  setLogLevel(level: number, category?: LogCategory): void;
+
+  /**
+   * Get the native log level of a category (default: "general")
+   */
+  getLogLevel(category?: LogCategory): number;
+
+  /**
+   * Block until every queued native log message has been written
+   */
+  flushLogs(): void;
+
   /**
    * Get version information
    */
@@ -426,12 +879,15 @@ export interface SideFx extends HybridObject<{ ios: 'c++'; android: 'c++' }> {
    * @param key The key to set
    * @param value The value to set (string, number, boolean)
    * @param instanceId Optional Warm instance ID (default: "default")
+   * @param ttlMs Optional time to live in milliseconds. The key is deleted
+   * once it passes; a write without ttlMs makes the key persistent again.
    * @returns Result indicating success or failure
    */
   setWarm(
     key: string,
     value: string | number | boolean,
-    instanceId?: string
+    instanceId?: string,
+    ttlMs?: number
   ): ListenerResult;
 
   /**
@@ -463,6 +919,16 @@ export interface SideFx extends HybridObject<{ ios: 'c++'; android: 'c++' }> {
     databaseName?: string
   ): ListenerResult;
 
+  /**
+   * Execute every statement in a SQL script on Cold storage, in order.
+   * Stops at the first failing statement; a transaction the script began is
+   * rolled back.
+   * @param sql Statements separated by semicolons
+   * @param databaseName Optional database name (default: "default")
+   * @returns Result indicating success or failure
+   */
+  executeColdScript(sql: string, databaseName?: string): ListenerResult;
+
   /**
    * Query Cold storage and return results as JSON
    * @param sql The SQL query to execute
@@ -476,6 +942,366 @@ export interface SideFx extends HybridObject<{ ios: 'c++'; android: 'c++' }> {
     databaseName?: string
   ): string | null;
 
+  // ============================================================================
+  // Zero-copy Buffer Reads
+  // ============================================================================
+
+  /**
+   * Get a Warm string/binary value as an ArrayBuffer backed by native memory
+   * Avoids converting large values (e.g. JSON blobs) into a JS string.
+   * Booleans and numbers should be read with getWarm.
+   * @param key The key to get
+   * @param instanceId Optional Warm instance ID (default: "default")
+   * @returns The raw UTF-8/binary bytes or null if not found
+   */
+  getWarmBuffer(key: string, instanceId?: string): ArrayBuffer | null;
+
+  /**
+   * Query Cold storage and return the JSON-encoded results as an ArrayBuffer
+   * The buffer owns the native serialization output, so it is not copied again.
+   * @param sql The SQL query to execute
+   * @param params Optional parameters for the query
+   * @param databaseName Optional database name (default: "default")
+   * @returns UTF-8 JSON bytes of query results or null on error
+   */
+  queryColdBuffer(
+    sql: string,
+    params?: Array<string | number | boolean | null>,
+    databaseName?: string
+  ): ArrayBuffer | null;
+
+  // ============================================================================
+  // Full-Text Search
+  // ============================================================================
+
+  /**
+   * Make a Cold table searchable. Creates an FTS5 index "<table>_fts" over
+   * the columns, fills it from the existing rows, and adds triggers that
+   * keep it in sync with every write to the table. Declaring the same table
+   * again is cheap; a changed declaration rebuilds the index.
+   * @param config Table, columns and tokenizer
+   * @param databaseName Optional database name (default: "default")
+   * @returns Result indicating success or failure
+   */
+  declareColdSearch(config: ColdSearchConfig, databaseName?: string): ListenerResult;
+
+  /**
+   * Search a table declared with declareColdSearch, best match first unless
+   * options.order says otherwise. Rows are returned as in queryColdBuffer, each with every table column
+   * plus "_rowid", "_score" (bm25; higher is better) and "_snippet".
+   * @param table The declared table
+   * @param query FTS5 query, e.g. 'invoice OR receipt', '"exact phrase"', 'inv*'
+   * @param options Optional paging and snippet settings
+   * @param databaseName Optional database name (default: "default")
+   * @returns UTF-8 JSON of the rows, or null on error
+   */
+  searchCold(
+    table: string,
+    query: string,
+    options?: ColdSearchOptions,
+    databaseName?: string
+  ): ArrayBuffer | null;
+
+  // ============================================================================
+  // Warm Compaction
+  // ============================================================================
+
+  /**
+   * Configure background compaction. Warm files are append-only: every write
+   * appends and MMKV rewrites the file inline, on the writing thread, once
+   * it fills up. The native scheduler compacts instances on its own thread
+   * while Warm writes are idle, before that happens.
+   */
+  configureWarmCompaction(config: WarmCompactionConfig): void;
+
+  /**
+   * Compact a Warm instance (or every instance) on the maintenance thread,
+   * regardless of thresholds. Returns immediately.
+   */
+  compactWarm(instanceId?: string): void;
+
+  /**
+   * File usage and compaction history of one Warm instance, or of every
+   * initialized instance
+   */
+  getWarmCompactionStats(instanceId?: string): WarmCompactionStats[];
+
+  // ============================================================================
+  // Cold Checkpoints
+  // ============================================================================
+
+  /**
+   * Configure background WAL checkpoints. SQLite otherwise checkpoints inline,
+   * on whichever commit crosses wal_autocheckpoint. While enabled, inline
+   * checkpoints are off and the native scheduler checkpoints each file-backed
+   * database on its own connection: PASSIVE while the database is idle or the
+   * WAL passes maxWalBytes, TRUNCATE once it is idle and the WAL is large.
+   */
+  configureColdCheckpoints(config: ColdCheckpointConfig): void;
+
+  /**
+   * TRUNCATE-checkpoint a Cold database (or every database) on the
+   * maintenance thread, regardless of thresholds. Returns immediately.
+   */
+  checkpointCold(databaseName?: string): void;
+
+  /**
+   * WAL size and checkpoint history of one file-backed Cold database, or of
+   * every one
+   */
+  getColdCheckpointStats(databaseName?: string): ColdCheckpointStats[];
+
+  // ============================================================================
+  // Startup
+  // ============================================================================
+
+  /**
+   * Configure the startup pipeline. Call before initializeCold for lazyCold
+   * to apply.
+   */
+  configureStartup(config: StartupConfig): void;
+
+  /**
+   * Initialize Warm instances on native worker threads, in parallel, each
+   * with its own config. Opening reads each file, so the first reads from JS
+   * don't fault pages in.
+   * @returns Resolves once every instance is open; failure names the first error
+   */
+  prewarmWarm(instances: WarmPrewarmInstance[]): Promise<ListenerResult>;
+
+  /**
+   * Timing of each startup stage so far, in the order they finished
+   */
+  getStartupTimings(): StartupStage[];
+
+  // ============================================================================
+  // Memory Governor
+  // ============================================================================
+
+  /**
+   * Native memory held per subsystem. With a budget (SAMConfig.cacheSize)
+   * the governor evicts least recently used Warm instances, then releases
+   * SQLite and dispatch caches, until usage fits.
+   */
+  getMemoryUsage(): MemoryUsage;
+
+  /**
+   * Report OS memory pressure. 'moderate' evicts Warm instances idle since
+   * the last governor pass, 'critical' evicts every instance; both release
+   * caches. iOS pressure is observed natively; on Android forward
+   * onTrimMemory levels here.
+   */
+  handleMemoryPressure(level: MemoryPressureLevel): void;
+
+  // ============================================================================
+  // Secure Value Cache
+  // ============================================================================
+
+  /**
+   * Cache keychain values for `service` for `ttlMs` after each read or
+   * write. 0 (the default for every service) disables caching and evicts
+   * the service's entry. Values are held in mlock'd memory that is zeroed
+   * when the entry expires or is invalidated.
+   */
+  configureSecureCache(service: string, ttlMs: number): void;
+
+  /**
+   * The service's invalidation generation. Capture it before a keychain call
+   * and pass it to cacheSecureValue, so a value read before a set/delete
+   * can't be cached after it.
+   */
+  getSecureCacheGeneration(service: string): number;
+
+  /**
+   * Cache a value just read from or written to the keychain. Returns false,
+   * caching nothing, if the service has no TTL or `generation` is given and
+   * the service was invalidated since.
+   */
+  cacheSecureValue(service: string, username: string, password: string, generation?: number): boolean;
+
+  /**
+   * The cached value for `service`, if present and not expired
+   */
+  getCachedSecureValue(service: string): SecureCachedValue | undefined;
+
+  /**
+   * Drop the cached value for `service`, or for every service
+   */
+  invalidateSecureValue(service?: string): void;
+
+  // ============================================================================
+  // Async Cold Storage
+  // ============================================================================
+
+  /**
+   * Execute a SQL statement on a native worker thread
+   * Statements on the same database run one at a time, in call order.
+   * @param sql The SQL statement to execute
+   * @param params Optional parameters for the statement
+   * @param databaseName Optional database name (default: "default")
+   * @param cancelToken Optional token for cancelColdRequests
+   * @returns Resolves with the same result as executeCold; rejects if cancelled
+   */
+  executeColdAsync(
+    sql: string,
+    params?: Array<string | number | boolean | null>,
+    databaseName?: string,
+    cancelToken?: number
+  ): Promise<ListenerResult>;
+
+  /**
+   * Query Cold storage on a native worker thread
+   * Ordered with executeColdAsync calls on the same database.
+   * @param sql The SQL query to execute
+   * @param params Optional parameters for the query
+   * @param databaseName Optional database name (default: "default")
+   * @param cancelToken Optional token for cancelColdRequests
+   * @returns Resolves with the JSON results or null on error; rejects if cancelled
+   */
+  queryColdAsync(
+    sql: string,
+    params?: Array<string | number | boolean | null>,
+    databaseName?: string,
+    cancelToken?: number
+  ): Promise<string | null>;
+
+  /**
+   * Cancel every async Cold request submitted with this token that has not
+   * finished yet. Queued requests never run; a running one is interrupted.
+   * @param cancelToken The token passed to executeColdAsync/queryColdAsync
+   * @returns true if anything was outstanding under the token
+   */
+  /**
+   * Run one query against several Cold databases in parallel, one native
+   * worker per database, and merge the rows into a single columnar result.
+   * With orderBy, each database's rows are sorted on its worker and then
+   * merged in order.
+   * @param sql The SQL query to execute on every database
+   * @param databaseNames Databases to query; every one must return the same columns
+   * @param params Optional parameters for the query
+   * @param options Optional merge order and row limit
+   * @param cancelToken Optional token for cancelColdRequests
+   * @returns Resolves with the columnar JSON result, or null if any database
+   *   fails, is unknown or returns different columns; rejects if cancelled
+   */
+  queryColdAcross(
+    sql: string,
+    databaseNames: string[],
+    params?: Array<string | number | boolean | null>,
+    options?: ColdAcrossOptions,
+    cancelToken?: number
+  ): Promise<string | null>;
+
+  cancelColdRequests(cancelToken: number): boolean;
+
+  // ============================================================================
+  // Change Dispatch
+  // ============================================================================
+
+  /**
+   * Register the handler that receives change events from native.
+   * Events produced by a single write are delivered together in one call.
+   * @param handler Called with every event of a dispatch batch
+   */
+  setChangeEventHandler(handler: (events: ChangeEvent[]) => void): void;
+
+  /**
+   * Get allocation counters for the change dispatch path (debug builds only)
+   */
+  getDispatchAllocationStats(): DispatchAllocationStats;
+
+  // ============================================================================
+  // Metrics
+  // ============================================================================
+
+  /**
+   * Get latency histograms and counters for every instrumented operation
+   * since startup or the last snapshotAndResetMetrics()
+   */
+  getMetrics(): SAMMetrics;
+
+  /**
+   * Same as getMetrics(), then start a new interval
+   * Use this for periodic reporting so each report covers one interval.
+   */
+  snapshotAndResetMetrics(): SAMMetrics;
+
+  // ============================================================================
+  // Action Routing (Missile)
+  // ============================================================================
+
+  /**
+   * Register an action route for the missile saga runtime
+   * @param patterns Exact action types, "prefix/*" or "*"
+   * @param once Remove the route after its first match (a pending take)
+   * @returns Route ID; IDs increase with registration order
+   */
+  addActionRoute(patterns: string[], once: boolean): number;
+
+  /**
+   * Remove an action route
+   * @returns false if the route was already removed
+   */
+  removeActionRoute(routeId: number): boolean;
+
+  /**
+   * Route IDs matching an action type, in registration order
+   * Routes added with once are removed by the match that returns them.
+   */
+  matchActionRoutes(actionType: string): number[];
+
+  // ============================================================================
+  // MFE Registry
+  // ============================================================================
+
+  /**
+   * Set an MFE's phase and merge `update` into its record.
+   * Moving from 'loading' to 'loaded'/'versioned' fills in loadTimeMs from
+   * loadedAt unless the update provides it. Persisted in the
+   * 'sam-mfe-registry' Warm instance once it is initialized.
+   * @returns The updated record
+   */
+  setMFERecord(mfeId: string, phase: MFEPhase, update?: MFERecordUpdate): MFERecord;
+
+  /**
+   * Get one MFE's record
+   */
+  getMFERecord(mfeId: string): MFERecord | undefined;
+
+  /**
+   * Get every MFE record in one call (e.g. to hydrate at startup)
+   */
+  getAllMFEStates(): MFERecord[];
+
+  /**
+   * Remove an MFE's record
+   * @returns false if there was none
+   */
+  clearMFERecord(mfeId: string): boolean;
+
+  /**
+   * Add one load time to an MFE's aggregated stats.
+   * setMFERecord records loads it times itself; use this for loads measured
+   * elsewhere. O(1) per call; persisted with the registry.
+   */
+  recordMFELoadTime(mfeId: string, loadTimeMs: number): void;
+
+  /**
+   * Aggregated load times of one MFE, or of every MFE when mfeId is omitted
+   */
+  getMFELoadStats(mfeId?: string): MFELoadStats[];
+
+  /**
+   * Clear aggregated load times of one MFE, or of every MFE
+   */
+  resetMFELoadStats(mfeId?: string): void;
+
+  /**
+   * Register the handler that receives MFE state transitions.
+   * Transitions are batched like change events.
+   */
+  setMFETransitionHandler(handler: (transitions: MFETransition[]) => void): void;
+
   // ============================================================================
   // Network Monitoring Methods
   // ============================================================================
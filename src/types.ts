@@ -258,7 +258,7 @@ export interface SAMConfig {
   debug?: boolean;
   /** Maximum number of listeners */
   maxListeners?: number;
-  /** Value cache size limit */
+  /** Native memory budget in bytes, enforced by the memory governor (0 = unlimited) */
   cacheSize?: number;
 }
 
@@ -5,14 +5,11 @@
  * MFE loading/fetching should be tracked at the module federation layer.
  */
 import { useCallback, useState, useEffect } from 'react';
-import { useWarm } from './hooks';
 import {
   MFERegistry,
-  MFE_INSTANCE_ID,
-  MFE_KEY_PREFIX,
   getMFEState,
   getMFEMetadata,
-  addFallbackListener,
+  subscribeMFEStates,
   type MFEState,
   type MFEMetadata,
 } from './mfe';
@@ -44,33 +41,18 @@ export function useMFEState(mfeId: string): {
     getMFEMetadata(mfeId)
   );
 
-  const watchKeys = [`${MFE_KEY_PREFIX}${mfeId}`, `${MFE_KEY_PREFIX}${mfeId}.meta`];
-
-  // Watch for changes via native MMKV (if available)
-  useWarm(
-    {
-      id: MFE_INSTANCE_ID,
-      keys: watchKeys,
-      options: {
-        fireImmediately: true,
-      },
-    },
-    () => {
-      setState(getMFEState(mfeId));
-      setMetadata(getMFEMetadata(mfeId));
-    }
-  );
-
-  // Also listen to fallback store changes (when native unavailable)
+  // Transitions carry the new record, so nothing is read back
   useEffect(() => {
-    const unsubscribe = addFallbackListener((key) => {
-      if (watchKeys.includes(key)) {
-        setState(getMFEState(mfeId));
-        setMetadata(getMFEMetadata(mfeId));
+    const current = getMFEMetadata(mfeId);
+    setState(current?.state ?? '');
+    setMetadata(current);
+    return subscribeMFEStates((changedId, changed) => {
+      if (changedId === mfeId) {
+        setState(changed?.state ?? '');
+        setMetadata(changed);
       }
     });
-    return unsubscribe;
-  }, [mfeId, watchKeys]);
+  }, [mfeId]);
 
   return {
     state,
@@ -118,36 +100,18 @@ export function useMFEStates(mfeIds: string[]): {
     MFERegistry.getAll(mfeIds)
   );
 
-  // Build keys to watch
-  const watchKeys = mfeIds.flatMap((id) => [
-    `${MFE_KEY_PREFIX}${id}`,
-    `${MFE_KEY_PREFIX}${id}.meta`,
-  ]);
-
-  // Watch for changes via native MMKV (if available)
-  useWarm(
-    {
-      id: MFE_INSTANCE_ID,
-      keys: watchKeys,
-      options: {
-        fireImmediately: true,
-      },
-    },
-    () => {
-      setStates(MFERegistry.getAll(mfeIds));
-    }
-  );
-
-  // Also listen to fallback store changes (when native unavailable)
+  // One bulk read on mount, then apply each transition's record. Keyed by
+  // the IDs' contents so an inline array doesn't resubscribe every render.
+  const idsKey = mfeIds.join('\n');
   useEffect(() => {
-    const unsubscribe = addFallbackListener((key) => {
-      // Check if this key is one we're watching
-      if (watchKeys.includes(key)) {
-        setStates(MFERegistry.getAll(mfeIds));
+    const ids = idsKey ? idsKey.split('\n') : [];
+    setStates(MFERegistry.getAll(ids));
+    return subscribeMFEStates((changedId, changed) => {
+      if (ids.includes(changedId)) {
+        setStates((previous) => ({ ...previous, [changedId]: changed }));
       }
     });
-    return unsubscribe;
-  }, [mfeIds, watchKeys]);
+  }, [idsKey]);
 
   const getState = useCallback(
     (mfeId: string): MFEState => {